@@ -0,0 +1,823 @@
+
+#include "stdafx.h"
+#include "BenchCalculator.h"
+#include "BenchInput.h"
+
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "..\calc_parser\TokenArray.h"
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\CalculatorCache.h"
+#include "..\calc_parser\Status.h"
+#include "..\calc_parser\BatchCompiler.h"
+#include "..\calc_parser\Threads.h"
+#include "..\calc_parser\FunctionDefinition.h"
+#include "..\calc_parser\ExpressionLibrary.h"
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace std;
+using namespace cbench;
+using namespace parser;
+using namespace calc;
+
+namespace parser_benchmarks {
+
+	const char* cb_rpnFileName = "calc_benchmarks_rpn.tmp";
+	string* cb_rpnText = NULL;
+	TokenArray* cb_rpnTokens = NULL;
+	StdFunctionLookupTable* cb_ftl = NULL;
+	StdConstantLookupTable* cb_clt = NULL;
+
+	void cb_setup() {
+		cb_rpnText = new string(generateRpnText(8 * 1024 * 1024));
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		cb_rpnTokens = new TokenArray();
+		cb_rpnTokens->tokenize(cb_rpnText->data(), cb_rpnText->size());
+		ofstream out(cb_rpnFileName, ofstream::out | ofstream::trunc | ofstream::binary);
+		out << *cb_rpnText;
+	}
+
+	void cb_cleanup() {
+		remove(cb_rpnFileName);
+		delete cb_rpnText;
+		delete cb_rpnTokens;
+		delete cb_ftl;
+		delete cb_clt;
+		cb_rpnText = NULL;
+		cb_rpnTokens = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double cb_loadFromFileStream() {
+		ifstream in(cb_rpnFileName, ifstream::in | ifstream::binary);
+		Calculator calculator(string("x"), cb_ftl, cb_clt, in);
+		return megabytes(*cb_rpnText);
+	}
+
+	double cb_loadFromMappedFile() {
+		SourceBuffer source((string(cb_rpnFileName)));
+		Calculator calculator(string("x"), cb_ftl, cb_clt, source);
+		return megabytes(*cb_rpnText);
+	}
+
+	double cb_loadFromBuffer() {
+		SourceBuffer source(cb_rpnText->data(), cb_rpnText->size());
+		Calculator calculator(string("x"), cb_ftl, cb_clt, source);
+		return megabytes(*cb_rpnText);
+	}
+
+	/* read the file in 64 KB chunks and push them as they are read */
+	double cb_loadPushedFromFile() {
+		ifstream in(cb_rpnFileName, ifstream::in | ifstream::binary);
+		RPNPushReader reader(string("x"), cb_ftl, cb_clt);
+		char chunk[64 * 1024];
+		while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0) {
+			reader.push(chunk, (size_t)in.gcount());
+		}
+		auto_ptr<Calculator> calculator = reader.finish();
+		return megabytes(*cb_rpnText);
+	}
+
+	/* translation only - the tokens are lexed in setup */
+	double cb_loadFromTokenArray() {
+		Calculator calculator(string("x"), cb_ftl, cb_clt, *cb_rpnTokens);
+		return megabytes(*cb_rpnText);
+	}
+
+	auto_ptr<BenchmarkCase> rpnLoadBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("RpnLoadBenchmarkCase (8 MB RPN)"), string("MB"),
+			cb_setup, cb_cleanup));
+		bc->addBenchmark("cb_loadFromFileStream", cb_loadFromFileStream);
+		bc->addBenchmark("cb_loadFromMappedFile", cb_loadFromMappedFile);
+		bc->addBenchmark("cb_loadFromBuffer", cb_loadFromBuffer);
+		bc->addBenchmark("cb_loadFromTokenArray", cb_loadFromTokenArray);
+		bc->addBenchmark("cb_loadPushedFromFile", cb_loadPushedFromFile);
+		return bc;
+	}
+
+	/* the redundant expressions, compiled as they are and shared */
+	vector<Calculator*>* cse_plain = NULL;
+	vector<Calculator*>* cse_shared = NULL;
+	const int cse_points = 1000;
+
+	void cse_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		cse_plain = new vector<Calculator*>();
+		cse_shared = new vector<Calculator*>();
+		vector<string> texts;
+		texts.push_back(string("sin(x)*sin(x) + sin(x)^2 / (1 + sin(x))"));
+		for (unsigned int i = 0; i < 63; i++) {
+			texts.push_back(generateRedundantExprText(1024, i + 1));
+		}
+		size_t nodes = 0;
+		size_t eliminated = 0;
+		int slots = 0;
+		for (auto it = texts.begin(); it != texts.end(); ++it) {
+			SourceBuffer source(it->data(), it->size());
+			cse_plain->push_back(Calculator::compile(string("x"), cb_ftl, cb_clt, source).release());
+			cse_shared->push_back(Calculator::compile(string("x"), cb_ftl, cb_clt, source, true).release());
+			FlatAst ast;
+			PrecedenceParser parser(source, cb_clt, cb_ftl);
+			parser.begin().expr(ast);
+			nodes += ast.size();
+			eliminated += cse_shared->back()->getEliminatedCount();
+			slots = max(slots, cse_shared->back()->getSlotCount());
+		}
+		cout << "  " << nodes << " nodes, eliminated " << eliminated << " ("
+			<< setprecision(1) << fixed << 100.0 * eliminated / nodes << " %), at most "
+			<< slots << " slots" << endl;
+	}
+
+	void cse_cleanup() {
+		for (size_t i = 0; i < cse_plain->size(); i++) {
+			delete (*cse_plain)[i];
+			delete (*cse_shared)[i];
+		}
+		delete cse_plain;
+		delete cse_shared;
+		delete cb_ftl;
+		delete cb_clt;
+		cse_plain = NULL;
+		cse_shared = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	/* evaluate every expression in the points of [0, 1) */
+	double cse_evaluate(vector<Calculator*>& calculators) {
+		volatile double sum = 0.0;
+		for (auto it = calculators.begin(); it != calculators.end(); ++it) {
+			for (int i = 0; i < cse_points; i++) {
+				sum = sum + (*it)->calculate(i / (double)cse_points);
+			}
+		}
+		return calculators.size() * cse_points / 1.0e6;
+	}
+
+	double cse_evaluatePlain() {
+		return cse_evaluate(*cse_plain);
+	}
+
+	double cse_evaluateShared() {
+		return cse_evaluate(*cse_shared);
+	}
+
+	auto_ptr<BenchmarkCase> cseBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("CseBenchmarkCase (64 redundant expressions x 1000 points)"), string("Mevals"),
+			cse_setup, cse_cleanup));
+		bc->addBenchmark("cse_evaluatePlain", cse_evaluatePlain);
+		bc->addBenchmark("cse_evaluateShared", cse_evaluateShared);
+		return bc;
+	}
+
+	/* expressions compiled again and again */
+	vector<string>* ccb_texts = NULL;
+	CalculatorCache* ccb_cache = NULL;
+	/* too small for the expressions - every compile misses */
+	CalculatorCache* ccb_smallCache = NULL;
+
+	void ccb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		ccb_texts = new vector<string>();
+		for (unsigned int i = 0; i < 1024; i++) {
+			ccb_texts->push_back(generateExprText(256, i + 1));
+		}
+		ccb_cache = new CalculatorCache(ccb_texts->size());
+		ccb_smallCache = new CalculatorCache(ccb_texts->size() / 2);
+		//the cache is warm
+		for (auto it = ccb_texts->begin(); it != ccb_texts->end(); ++it) {
+			ccb_cache->compile(string("x"), cb_ftl, cb_clt, *it);
+		}
+	}
+
+	void ccb_cleanup() {
+		delete ccb_cache;
+		delete ccb_smallCache;
+		delete ccb_texts;
+		delete cb_ftl;
+		delete cb_clt;
+		ccb_cache = NULL;
+		ccb_smallCache = NULL;
+		ccb_texts = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double ccb_compile() {
+		for (auto it = ccb_texts->begin(); it != ccb_texts->end(); ++it) {
+			SourceBuffer source(it->data(), it->size());
+			auto_ptr<Calculator> calculator = Calculator::compile(string("x"), cb_ftl, cb_clt, source);
+		}
+		return ccb_texts->size() / 1000.0;
+	}
+
+	double ccb_compileCached(CalculatorCache* cache) {
+		for (auto it = ccb_texts->begin(); it != ccb_texts->end(); ++it) {
+			cache->compile(string("x"), cb_ftl, cb_clt, *it);
+		}
+		return ccb_texts->size() / 1000.0;
+	}
+
+	double ccb_compileHit() {
+		return ccb_compileCached(ccb_cache);
+	}
+
+	double ccb_compileMiss() {
+		return ccb_compileCached(ccb_smallCache);
+	}
+
+	auto_ptr<BenchmarkCase> calculatorCacheBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("CalculatorCacheBenchmarkCase (1024 x 256 B expressions)"), string("Kprograms"),
+			ccb_setup, ccb_cleanup));
+		bc->addBenchmark("ccb_compile", ccb_compile);
+		bc->addBenchmark("ccb_compileHit", ccb_compileHit);
+		bc->addBenchmark("ccb_compileMiss", ccb_compileMiss);
+		return bc;
+	}
+
+	/* an expression being edited */
+	string* icb_text = NULL;
+	IncrementalCompiler* icb_compiler = NULL;
+	/* digits of floats in parentheses and outside of them */
+	vector<size_t>* icb_nested = NULL;
+	vector<size_t>* icb_outside = NULL;
+
+	void icb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		icb_text = new string(generateExprText(64 * 1024, 7));
+		icb_compiler = new IncrementalCompiler(string("x"), cb_ftl, cb_clt);
+		icb_compiler->compile(*icb_text);
+		icb_nested = new vector<size_t>();
+		icb_outside = new vector<size_t>();
+		int depth = 0;
+		for (size_t i = 0; i < icb_text->size(); i++) {
+			char c = (*icb_text)[i];
+			if (c == '(') {
+				depth++;
+			} else if (c == ')') {
+				depth--;
+			} else if (c >= '0' && c <= '9') {
+				(depth > 0 ? icb_nested : icb_outside)->push_back(i);
+			}
+		}
+	}
+
+	void icb_cleanup() {
+		delete icb_compiler;
+		delete icb_text;
+		delete icb_nested;
+		delete icb_outside;
+		delete cb_ftl;
+		delete cb_clt;
+		icb_compiler = NULL;
+		icb_text = NULL;
+		icb_nested = NULL;
+		icb_outside = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	/* another digit at the offset - still a float */
+	string icb_changeDigit(size_t offset) {
+		char c = (*icb_text)[offset];
+		(*icb_text)[offset] = (c == '9') ? '0' : c + 1;
+		return icb_text->substr(offset, 1);
+	}
+
+	/* 256 digits changed, the whole text compiled after each */
+	double icb_compileWhole() {
+		for (size_t i = 0; i < 256; i++) {
+			icb_changeDigit((*icb_nested)[i * 7 % icb_nested->size()]);
+			SourceBuffer source(icb_text->data(), icb_text->size());
+			auto_ptr<Calculator> calculator = Calculator::compile(string("x"), cb_ftl, cb_clt, source);
+		}
+		return 256 / 1000.0;
+	}
+
+	double icb_editDigits(const vector<size_t>& offsets, size_t count) {
+		for (size_t i = 0; i < count; i++) {
+			size_t offset = offsets[i * 7 % offsets.size()];
+			icb_compiler->edit(offset, 1, icb_changeDigit(offset));
+		}
+		return count / 1000.0;
+	}
+
+	/* in parentheses only the expression in them is compiled again */
+	double icb_editNested() {
+		return icb_editDigits(*icb_nested, 16384);
+	}
+
+	/* outside of parentheses the whole text is parsed again */
+	double icb_editOutside() {
+		return icb_editDigits(*icb_outside, 256);
+	}
+
+	auto_ptr<BenchmarkCase> incrementalBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("IncrementalBenchmarkCase (64 KB expression, a digit changed)"), string("Kedits"),
+			icb_setup, icb_cleanup));
+		bc->addBenchmark("icb_compileWhole", icb_compileWhole);
+		bc->addBenchmark("icb_editNested", icb_editNested);
+		bc->addBenchmark("icb_editOutside", icb_editOutside);
+		return bc;
+	}
+
+
+	/* expressions as they are typed: prefixes of valid expressions,
+	one in 8 complete - mostly invalid*/
+	vector<string>* vb_texts = NULL;
+
+	void vb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		vb_texts = new vector<string>();
+		for (unsigned int i = 0; i < 4096; i++) {
+			string text = generateExprText(64, i + 1);
+			if (i % 8 != 0) {
+				text.resize(text.size() * (i * 37 % 97) / 97);
+			}
+			vb_texts->push_back(text);
+		}
+	}
+
+	void vb_cleanup() {
+		delete vb_texts;
+		delete cb_ftl;
+		delete cb_clt;
+		vb_texts = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	/* errors thrown and caught */
+	double vb_validateThrowing() {
+		for (auto it = vb_texts->begin(); it != vb_texts->end(); ++it) {
+			SourceBuffer source(it->data(), it->size());
+			try {
+				Calculator::compile(string("x"), cb_ftl, cb_clt, source);
+			} catch (exception&) {
+				//rejected
+			}
+		}
+		return vb_texts->size() / 1000.0;
+	}
+
+	/* errors returned in the status */
+	double vb_validateStatus() {
+		Status status;
+		for (auto it = vb_texts->begin(); it != vb_texts->end(); ++it) {
+			SourceBuffer source(it->data(), it->size());
+			Calculator::compile(string("x"), cb_ftl, cb_clt, source, status);
+		}
+		return vb_texts->size() / 1000.0;
+	}
+
+	auto_ptr<BenchmarkCase> validationBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("ValidationBenchmarkCase (4096 typed expressions, mostly invalid)"), string("Kexpressions"),
+			vb_setup, vb_cleanup));
+		bc->addBenchmark("vb_validateThrowing", vb_validateThrowing);
+		bc->addBenchmark("vb_validateStatus", vb_validateStatus);
+		return bc;
+	}
+
+
+	/* builtin names and other names of the same lengths */
+	const char* bb_builtinNames[] = { "x", "sin", "cos", "exp", "log", "ONE", "ZERO", "PI", "E" };
+	const char* bb_otherNames[] = { "y", "tan", "abs", "sqr", "cot", "TWO", "FOUR", "PE", "F" };
+	const size_t bb_nameCount = sizeof(bb_builtinNames) / sizeof(bb_builtinNames[0]);
+	/* sum of the constants found - kept, so that nothing is optimized out */
+	double bb_sum = 0.0;
+
+	void bb_setup() {
+		for (size_t i = 0; i < bb_nameCount; i++) {
+			internSymbol(string(bb_otherNames[i]));
+		}
+	}
+
+	void bb_cleanup() {
+	}
+
+	double bb_intern(const char** names) {
+		size_t lengths[bb_nameCount];
+		for (size_t i = 0; i < bb_nameCount; i++) {
+			lengths[i] = strlen(names[i]);
+		}
+		const int count = 1024 * 1024;
+		for (int i = 0; i < count; i++) {
+			size_t n = i % bb_nameCount;
+			internSymbol(names[n], lengths[n]);
+		}
+		return count / 1000000.0;
+	}
+
+	/* found by the perfect hash, without locking */
+	double bb_internBuiltin() {
+		return bb_intern(bb_builtinNames);
+	}
+
+	/* found in the hash table under the read lock */
+	double bb_internOther() {
+		return bb_intern(bb_otherNames);
+	}
+
+	/* the standard tables created and looked up - nothing is allocated */
+	double bb_createTables() {
+		const int count = 64 * 1024;
+		for (int i = 0; i < count; i++) {
+			StdConstantLookupTable constants;
+			StdFunctionLookupTable functions;
+			double value;
+			if (constants.find(SYMBOL_PI, value)) {
+				bb_sum += value;
+			}
+		}
+		return count / 1000000.0;
+	}
+
+	auto_ptr<BenchmarkCase> builtinBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("BuiltinBenchmarkCase (names interned, standard tables created)"), string("Mops"),
+			bb_setup, bb_cleanup));
+		bc->addBenchmark("bb_internBuiltin", bb_internBuiltin);
+		bc->addBenchmark("bb_internOther", bb_internOther);
+		bc->addBenchmark("bb_createTables", bb_createTables);
+		return bc;
+	}
+
+
+	/* a library of expressions compiled at once */
+	vector<string>* bcb_texts = NULL;
+
+	void bcb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		bcb_texts = new vector<string>();
+		for (unsigned int i = 0; i < 64 * 1024; i++) {
+			bcb_texts->push_back(generateExprText(128, i + 1));
+		}
+	}
+
+	void bcb_cleanup() {
+		delete bcb_texts;
+		delete cb_ftl;
+		delete cb_clt;
+		bcb_texts = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double bcb_compile(unsigned int threadCount) {
+		BatchCompiler compiler(string("x"), cb_ftl, cb_clt, threadCount);
+		vector<BatchResult> results;
+		compiler.compile(*bcb_texts, results);
+		return bcb_texts->size() / 1000.0;
+	}
+
+	double bcb_compile1() {
+		return bcb_compile(1);
+	}
+
+	double bcb_compile2() {
+		return bcb_compile(2);
+	}
+
+	double bcb_compile4() {
+		return bcb_compile(4);
+	}
+
+	double bcb_compile8() {
+		return bcb_compile(8);
+	}
+
+	/* one thread per processor */
+	double bcb_compileAll() {
+		return bcb_compile(hardwareThreads());
+	}
+
+	auto_ptr<BenchmarkCase> batchCompileBenchmarkCase() {
+		stringstream name;
+		name << "BatchCompileBenchmarkCase (64K x 128 B expressions, "
+			<< hardwareThreads() << " processors)";
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(name.str(), string("Kexpressions"),
+			bcb_setup, bcb_cleanup));
+		bc->addBenchmark("bcb_compile1", bcb_compile1);
+		bc->addBenchmark("bcb_compile2", bcb_compile2);
+		bc->addBenchmark("bcb_compile4", bcb_compile4);
+		bc->addBenchmark("bcb_compile8", bcb_compile8);
+		bc->addBenchmark("bcb_compileAll", bcb_compileAll);
+		return bc;
+	}
+
+	/* the same value written at each use and bound once */
+	Calculator* leb_repeated = NULL;
+	Calculator* leb_bound = NULL;
+	const int leb_points = 1000 * 1000;
+
+	void leb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		string value("exp(-x*x)*sin(3*x)");
+		string repeated(value + "*(1-" + value + ") + " + value + "/(2+" + value + ")");
+		string bound("let a = " + value + " in a*(1-a) + a/(2+a)");
+		SourceBuffer repeatedSource(repeated.data(), repeated.size());
+		leb_repeated = Calculator::compile(string("x"), cb_ftl, cb_clt, repeatedSource).release();
+		SourceBuffer boundSource(bound.data(), bound.size());
+		leb_bound = Calculator::compile(string("x"), cb_ftl, cb_clt, boundSource).release();
+	}
+
+	void leb_cleanup() {
+		delete leb_repeated;
+		delete leb_bound;
+		delete cb_ftl;
+		delete cb_clt;
+		leb_repeated = NULL;
+		leb_bound = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double leb_evaluate(Calculator* calculator) {
+		volatile double sum = 0.0;
+		for (int i = 0; i < leb_points; i++) {
+			sum = sum + calculator->calculate(i / (double)leb_points);
+		}
+		return leb_points / 1.0e6;
+	}
+
+	double leb_evaluateRepeated() {
+		return leb_evaluate(leb_repeated);
+	}
+
+	double leb_evaluateBound() {
+		return leb_evaluate(leb_bound);
+	}
+
+	auto_ptr<BenchmarkCase> letBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("LetBenchmarkCase (a value used 4 times x 1M points)"), string("Mevals"),
+			leb_setup, leb_cleanup));
+		bc->addBenchmark("leb_evaluateRepeated", leb_evaluateRepeated);
+		bc->addBenchmark("leb_evaluateBound", leb_evaluateBound);
+		return bc;
+	}
+
+	/* a function of the library inlined, called by the RPN program and
+	written out by hand*/
+	Calculator* ilb_expanded = NULL;
+	Calculator* ilb_inlined = NULL;
+	Calculator* ilb_called = NULL;
+	const int ilb_points = 1000 * 1000;
+
+	void ilb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		//the library is compiled once
+		FunctionDefinition::define(*cb_ftl, cb_clt, string("g(t) = t*t*(3 - 2*t)"));
+		string expanded("x*x*(3 - 2*x) + (1-x)*(1-x)*(3 - 2*(1-x))/2");
+		string inlined("g(x) + g(1-x)/2");
+		SourceBuffer expandedSource(expanded.data(), expanded.size());
+		ilb_expanded = Calculator::compile(string("x"), cb_ftl, cb_clt, expandedSource).release();
+		SourceBuffer inlinedSource(inlined.data(), inlined.size());
+		ilb_inlined = Calculator::compile(string("x"), cb_ftl, cb_clt, inlinedSource).release();
+		stringstream called("x g 1 x - g 2 / +");
+		ilb_called = new Calculator(string("x"), cb_ftl, cb_clt, called);
+	}
+
+	void ilb_cleanup() {
+		delete ilb_expanded;
+		delete ilb_inlined;
+		delete ilb_called;
+		delete cb_ftl;
+		delete cb_clt;
+		ilb_expanded = NULL;
+		ilb_inlined = NULL;
+		ilb_called = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double ilb_evaluate(Calculator* calculator) {
+		volatile double sum = 0.0;
+		for (int i = 0; i < ilb_points; i++) {
+			sum = sum + calculator->calculate(i / (double)ilb_points);
+		}
+		return ilb_points / 1.0e6;
+	}
+
+	double ilb_evaluateExpanded() {
+		return ilb_evaluate(ilb_expanded);
+	}
+
+	double ilb_evaluateInlined() {
+		return ilb_evaluate(ilb_inlined);
+	}
+
+	double ilb_evaluateCalled() {
+		return ilb_evaluate(ilb_called);
+	}
+
+	auto_ptr<BenchmarkCase> inlineBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("InlineBenchmarkCase (2 calls x 1M points)"), string("Mevals"),
+			ilb_setup, ilb_cleanup));
+		bc->addBenchmark("ilb_evaluateExpanded", ilb_evaluateExpanded);
+		bc->addBenchmark("ilb_evaluateInlined", ilb_evaluateInlined);
+		bc->addBenchmark("ilb_evaluateCalled", ilb_evaluateCalled);
+		return bc;
+	}
+
+	/* a library of 64 functions of 64 constants, used by 4096
+	expressions; a constant changed recompiles its function and the 64
+	expressions which call it, or the whole library built again*/
+	const int elb_functions = 64;
+	const int elb_expressions = 4096;
+	const int elb_updates = 16;
+	ExpressionLibrary* elb_library = NULL;
+
+	void elb_fill(ExpressionLibrary& library, double value) {
+		for (int i = 0; i < elb_functions; i++) {
+			stringstream name;
+			name << "elb_c" << i;
+			library.setConstant(name.str(), value + i);
+			stringstream function;
+			function << "elb_f" << i << "(t) = t*(t - elb_c" << i << ") + sin(t)/elb_c" << i;
+			library.setFunction(function.str());
+		}
+		for (int i = 0; i < elb_expressions; i++) {
+			stringstream name;
+			name << "elb_e" << i;
+			stringstream expression;
+			expression << "elb_f" << i % elb_functions << "(x) * x + " << i;
+			library.setExpression(name.str(), expression.str());
+		}
+	}
+
+	void elb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		elb_library = new ExpressionLibrary(string("x"), cb_ftl, cb_clt);
+		elb_fill(*elb_library, 1.0);
+	}
+
+	void elb_cleanup() {
+		delete elb_library;
+		delete cb_ftl;
+		delete cb_clt;
+		elb_library = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double elb_updateDependents() {
+		for (int i = 0; i < elb_updates; i++) {
+			elb_library->setConstant(string("elb_c0"), 2.0 + i);
+		}
+		return elb_updates / 1.0e3;
+	}
+
+	double elb_rebuildAll() {
+		for (int i = 0; i < elb_updates; i++) {
+			StdFunctionLookupTable functionLookupTable;
+			StdConstantLookupTable constantLookupTable;
+			ExpressionLibrary library(string("x"), &functionLookupTable, &constantLookupTable);
+			elb_fill(library, 2.0 + i);
+		}
+		return elb_updates / 1.0e3;
+	}
+
+	auto_ptr<BenchmarkCase> libraryBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("LibraryBenchmarkCase (a constant of 64 changed x 16)"), string("Kupdates"),
+			elb_setup, elb_cleanup));
+		bc->addBenchmark("elb_updateDependents", elb_updateDependents);
+		bc->addBenchmark("elb_rebuildAll", elb_rebuildAll);
+		return bc;
+	}
+
+	/* the program of an expression run as the bytecode (calculate) and
+	element by element, a virtual call each (calculateByElements)*/
+	Calculator* byb_calculator = NULL;
+	const int byb_points = 1000 * 1000;
+
+	void byb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		string text("exp(-log(x)^2) * ((1+x)*(1-x)) + sin(x)/(x*x + 1) - 0.5*x");
+		SourceBuffer source(text.data(), text.size());
+		byb_calculator = Calculator::compile(string("x"), cb_ftl, cb_clt, source).release();
+	}
+
+	void byb_cleanup() {
+		delete byb_calculator;
+		delete cb_ftl;
+		delete cb_clt;
+		byb_calculator = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double byb_calculateBytecode() {
+		volatile double sum = 0.0;
+		for (int i = 1; i <= byb_points; i++) {
+			sum = sum + byb_calculator->calculate(i / (double)byb_points);
+		}
+		return byb_points / 1.0e6;
+	}
+
+	double byb_calculateByElements() {
+		volatile double sum = 0.0;
+		for (int i = 1; i <= byb_points; i++) {
+			sum = sum + byb_calculator->calculateByElements(i / (double)byb_points);
+		}
+		return byb_points / 1.0e6;
+	}
+
+	auto_ptr<BenchmarkCase> bytecodeBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("BytecodeBenchmarkCase (27 elements x 1M points)"), string("Mevals"),
+			byb_setup, byb_cleanup));
+		bc->addBenchmark("byb_calculateBytecode", byb_calculateBytecode);
+		bc->addBenchmark("byb_calculateByElements", byb_calculateByElements);
+		return bc;
+	}
+
+	/* the program evaluated a value at a time, for an array of them and
+	for a uniform grid*/
+	Calculator* blb_calculator = NULL;
+	const int blb_points = 1000 * 1000;
+	vector<double>* blb_xs = NULL;
+	vector<double>* blb_ys = NULL;
+
+	void blb_setup() {
+		cb_ftl = new StdFunctionLookupTable();
+		cb_clt = new StdConstantLookupTable();
+		string text("exp(-log(x)^2) * ((1+x)*(1-x)) + sin(x)/(x*x + 1) - 0.5*x");
+		SourceBuffer source(text.data(), text.size());
+		blb_calculator = Calculator::compile(string("x"), cb_ftl, cb_clt, source).release();
+		blb_xs = new vector<double>(blb_points);
+		blb_ys = new vector<double>(blb_points);
+		for (int i = 0; i < blb_points; i++) {
+			(*blb_xs)[i] = (i + 1) / (double)blb_points;
+		}
+	}
+
+	void blb_cleanup() {
+		delete blb_calculator;
+		delete blb_xs;
+		delete blb_ys;
+		delete cb_ftl;
+		delete cb_clt;
+		blb_calculator = NULL;
+		blb_xs = NULL;
+		blb_ys = NULL;
+		cb_ftl = NULL;
+		cb_clt = NULL;
+	}
+
+	double blb_calculateScalar() {
+		for (int i = 0; i < blb_points; i++) {
+			(*blb_ys)[i] = blb_calculator->calculate((*blb_xs)[i]);
+		}
+		return blb_points / 1.0e6;
+	}
+
+	double blb_calculateBlock() {
+		blb_calculator->calculate(&(*blb_xs)[0], &(*blb_ys)[0], blb_points);
+		return blb_points / 1.0e6;
+	}
+
+	double blb_calculateGrid() {
+		blb_calculator->calculate(1.0 / blb_points, 1.0 / blb_points, &(*blb_ys)[0], blb_points);
+		return blb_points / 1.0e6;
+	}
+
+	auto_ptr<BenchmarkCase> blockBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("BlockBenchmarkCase (27 elements x 1M points)"), string("Mevals"),
+			blb_setup, blb_cleanup));
+		bc->addBenchmark("blb_calculateScalar", blb_calculateScalar);
+		bc->addBenchmark("blb_calculateBlock", blb_calculateBlock);
+		bc->addBenchmark("blb_calculateGrid", blb_calculateGrid);
+		return bc;
+	}
+
+}
@@ -0,0 +1,47 @@
+#ifndef BENCH_CALCULATOR_H
+#define BENCH_CALCULATOR_H
+
+#include "CBench.h"
+#include <memory>
+
+namespace parser_benchmarks {
+
+	std::auto_ptr<cbench::BenchmarkCase> rpnLoadBenchmarkCase();
+
+	/* evaluation of common subexpressions once or at each occurrence */
+	std::auto_ptr<cbench::BenchmarkCase> cseBenchmarkCase();
+
+	/* compiling again, with and without the cache */
+	std::auto_ptr<cbench::BenchmarkCase> calculatorCacheBenchmarkCase();
+
+	/* compile latency after an edit: the whole text or the change */
+	std::auto_ptr<cbench::BenchmarkCase> incrementalBenchmarkCase();
+
+	/* rejecting invalid expressions: exceptions or status */
+	std::auto_ptr<cbench::BenchmarkCase> validationBenchmarkCase();
+
+	/* builtin names and the standard lookup tables */
+	std::auto_ptr<cbench::BenchmarkCase> builtinBenchmarkCase();
+
+	/* a library of expressions compiled on 1, 2, 4, 8 threads */
+	std::auto_ptr<cbench::BenchmarkCase> batchCompileBenchmarkCase();
+
+	/* a value computed at each use or bound by let */
+	std::auto_ptr<cbench::BenchmarkCase> letBenchmarkCase();
+
+	/* a defined function inlined, called, or written out by hand */
+	std::auto_ptr<cbench::BenchmarkCase> inlineBenchmarkCase();
+
+	/* a change of an expression library: its dependents recompiled or
+	the whole library*/
+	std::auto_ptr<cbench::BenchmarkCase> libraryBenchmarkCase();
+
+	/* a program run as the bytecode or element by element */
+	std::auto_ptr<cbench::BenchmarkCase> bytecodeBenchmarkCase();
+
+	/* a program evaluated a value at a time or a block at once */
+	std::auto_ptr<cbench::BenchmarkCase> blockBenchmarkCase();
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+
+#include "stdafx.h"
+#include "BenchFloat.h"
+#include "BenchInput.h"
+
+#include "..\calc_parser\FloatConv.h"
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+using namespace cbench;
+using namespace parser;
+
+namespace parser_benchmarks {
+
+	/* number of literals converted by each benchmark */
+	const size_t FB_LITERALS = 1000000;
+
+	/* all literals, 0-terminated, one after another */
+	string* fb_text = NULL;
+	vector<size_t>* fb_starts = NULL;
+	vector<double>* fb_values = NULL;
+
+	/* Literals as found in saved programs: short decimals,
+	17 significant digits and exponents in equal parts*/
+	void fb_setup() {
+		fb_text = new string();
+		fb_starts = new vector<size_t>();
+		fb_values = new vector<double>();
+		BenchRandom random(13);
+		stringstream literal;
+		literal.fill('0');
+		for (size_t i = 0; i < FB_LITERALS; i++) {
+			literal.str(string());
+			switch (i % 3) {
+			case 0:
+				literal << random.next(1000) << '.' << random.next(100);
+				break;
+			case 1:
+				literal << "0." << setw(5) << random.next(100000)
+					<< setw(6) << random.next(1000000) << setw(6) << random.next(1000000);
+				break;
+			default:
+				literal << 1 + random.next(9) << '.' << setw(5) << random.next(100000)
+					<< 'e' << (random.next(2) ? '+' : '-') << random.next(300);
+				break;
+			}
+			string text = literal.str();
+			fb_starts->push_back(fb_text->size());
+			fb_text->append(text);
+			fb_text->push_back('\0');
+			fb_values->push_back(strtod(text.c_str(), NULL));
+		}
+	}
+
+	void fb_cleanup() {
+		delete fb_text;
+		delete fb_starts;
+		delete fb_values;
+		fb_text = NULL;
+		fb_starts = NULL;
+		fb_values = NULL;
+	}
+
+	/* the way LexerStateFloat converted literals */
+	double fb_parseStream() {
+		double sum = 0.0;
+		for (size_t i = 0; i < FB_LITERALS; i++) {
+			stringstream in(fb_text->c_str() + (*fb_starts)[i]);
+			double value;
+			in >> value;
+			sum += value;
+		}
+		return FB_LITERALS / 1e6;
+	}
+
+	double fb_parseStrtod() {
+		double sum = 0.0;
+		for (size_t i = 0; i < FB_LITERALS; i++) {
+			sum += strtod(fb_text->c_str() + (*fb_starts)[i], NULL);
+		}
+		return FB_LITERALS / 1e6;
+	}
+
+	double fb_parseFloat() {
+		double sum = 0.0;
+		const char* text = fb_text->c_str();
+		for (size_t i = 0; i < FB_LITERALS; i++) {
+			const char* begin = text + (*fb_starts)[i];
+			//the end of a literal is the start of the next one - 1
+			const char* end = (i + 1 < FB_LITERALS)
+				? text + (*fb_starts)[i + 1] - 1
+				: text + fb_text->size() - 1;
+			double value;
+			parseFloat(begin, end, value);
+			sum += value;
+		}
+		return FB_LITERALS / 1e6;
+	}
+
+	/* the precision needed by a stream to write doubles exactly */
+	double fb_formatStream() {
+		stringstream out;
+		out.precision(17);
+		for (size_t i = 0; i < FB_LITERALS; i++) {
+			out << (*fb_values)[i] << ' ';
+		}
+		return FB_LITERALS / 1e6;
+	}
+
+	double fb_formatFloat() {
+		stringstream out;
+		char text[FLOAT_TEXT_SIZE];
+		for (size_t i = 0; i < FB_LITERALS; i++) {
+			out.write(text, formatFloat((*fb_values)[i], text));
+			out << ' ';
+		}
+		return FB_LITERALS / 1e6;
+	}
+
+	auto_ptr<BenchmarkCase> floatParseBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("FloatParseBenchmarkCase (1M literals)"), string("M literals"),
+			fb_setup, fb_cleanup));
+		bc->addBenchmark("fb_parseStream", fb_parseStream);
+		bc->addBenchmark("fb_parseStrtod", fb_parseStrtod);
+		bc->addBenchmark("fb_parseFloat", fb_parseFloat);
+		return bc;
+	}
+
+	auto_ptr<BenchmarkCase> floatFormatBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("FloatFormatBenchmarkCase (1M values)"), string("M values"),
+			fb_setup, fb_cleanup));
+		bc->addBenchmark("fb_formatStream", fb_formatStream);
+		bc->addBenchmark("fb_formatFloat", fb_formatFloat);
+		return bc;
+	}
+
+}
@@ -0,0 +1,17 @@
+#ifndef BENCH_FLOAT_H
+#define BENCH_FLOAT_H
+
+#include "CBench.h"
+#include <memory>
+
+namespace parser_benchmarks {
+
+	/* conversion of Float literals: stream, strtod, parseFloat */
+	std::auto_ptr<cbench::BenchmarkCase> floatParseBenchmarkCase();
+
+	/* writing doubles: stream with 17 digits, formatFloat */
+	std::auto_ptr<cbench::BenchmarkCase> floatFormatBenchmarkCase();
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+
+#include "stdafx.h"
+#include "BenchInput.h"
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+namespace parser_benchmarks {
+
+	/* random floating-point literal in the format of Calculator::save */
+	static void randomFloat(BenchRandom& random, stringstream& out) {
+		out << random.next(1000);
+		if (random.next(2) == 0) {
+			out << "." << random.next(1000) + 1;
+		}
+	}
+
+	string generateRpnText(size_t approxBytes) {
+		static const char* functions[] = { "sin", "cos", "exp", "log" };
+		static const char* constants[] = { "PI", "E", "ONE", "ZERO" };
+		static const char* operators[] = { "+", "-", "*", "/", "^" };
+		BenchRandom random(2013);
+		stringstream out;
+		size_t lineStart = 0;
+		//the stack holds exactly 1 value after each step
+		out << "x";
+		while ((size_t)out.tellp() < approxBytes) {
+			out << " ";
+			switch (random.next(4)) {
+			case 0:
+				out << functions[random.next(4)];
+				break;
+			case 1:
+				out << "~";
+				break;
+			default:
+				//push operand and reduce with a binary operator
+				switch (random.next(3)) {
+				case 0:
+					out << "x";
+					break;
+				case 1:
+					out << constants[random.next(4)];
+					break;
+				default:
+					randomFloat(random, out);
+				}
+				out << " " << operators[random.next(5)];
+			}
+			if ((size_t)out.tellp() - lineStart > 80) {
+				out << "\n";
+				lineStart = (size_t)out.tellp();
+			}
+		}
+		return out.str();
+	}
+
+	string generateExportedRpnText(size_t approxBytes) {
+		static const char* operators[] = { "+", "-", "*", "/", "^" };
+		BenchRandom random(2013);
+		stringstream out;
+		size_t lineStart = 0;
+		out << "x";
+		while ((size_t)out.tellp() < approxBytes) {
+			//operand: a full precision literal or the variable, aligned to 24 columns
+			size_t column = (size_t)out.tellp() - lineStart;
+			out << string(24 - column % 24, ' ');
+			if (random.next(4) == 0) {
+				out << "x";
+			} else {
+				out << random.next(1000) << ".";
+				for (int i = 0; i < 12; i++) {
+					out << random.next(10);
+				}
+			}
+			out << "    " << operators[random.next(5)];
+			if ((size_t)out.tellp() - lineStart > 100) {
+				out << "\n";
+				lineStart = (size_t)out.tellp();
+			}
+		}
+		return out.str();
+	}
+
+	/* random factor; nested expressions up to the given depth */
+	static void randomFactor(BenchRandom& random, stringstream& out, int depth) {
+		static const char* functions[] = { "sin", "cos", "exp", "log" };
+		static const char* constants[] = { "PI", "E", "ONE", "ZERO" };
+		static const char* operators[] = { "+", "-", "*", "/", "^" };
+		if (random.next(8) == 0) {
+			out << "-";
+		}
+		switch (depth > 0 ? random.next(6) : random.next(3)) {
+		case 0:
+			out << "x";
+			break;
+		case 1:
+			out << constants[random.next(4)];
+			break;
+		case 2:
+			randomFloat(random, out);
+			break;
+		case 3:
+			out << functions[random.next(4)] << "(";
+			randomFactor(random, out, depth - 1);
+			out << ")";
+			break;
+		default:
+			out << "(";
+			randomFactor(random, out, depth - 1);
+			out << " " << operators[random.next(5)] << " ";
+			randomFactor(random, out, depth - 1);
+			out << ")";
+		}
+	}
+
+	string generateExprText(size_t approxBytes, unsigned int seed) {
+		static const char* operators[] = { "+", "-", "*", "/", "^" };
+		BenchRandom random(seed);
+		stringstream out;
+		size_t lineStart = 0;
+		randomFactor(random, out, 3);
+		while ((size_t)out.tellp() < approxBytes) {
+			out << " " << operators[random.next(5)] << " ";
+			randomFactor(random, out, 3);
+			if ((size_t)out.tellp() - lineStart > 80) {
+				out << "\n";
+				lineStart = (size_t)out.tellp();
+			}
+		}
+		return out.str();
+	}
+
+	string generateRedundantExprText(size_t approxBytes, unsigned int seed) {
+		static const char* functions[] = { "sin", "cos", "exp", "log" };
+		static const char* operators[] = { "+", "-", "*", "/", "^" };
+		BenchRandom random(seed);
+		//a few calls of random arguments, each of them used many times
+		vector<string> calls;
+		for (int i = 0; i < 4; i++) {
+			stringstream call;
+			call << functions[random.next(4)] << "(";
+			randomFactor(random, call, 2);
+			call << ")";
+			calls.push_back(call.str());
+		}
+		stringstream out;
+		size_t lineStart = 0;
+		out << calls[random.next(4)];
+		while ((size_t)out.tellp() < approxBytes) {
+			out << " " << operators[random.next(5)] << " ";
+			if (random.next(2) == 0) {
+				out << calls[random.next(4)];
+			} else {
+				//a product of two of them, also repeated
+				out << "(" << calls[random.next(2)] << " * " << calls[2 + random.next(2)] << ")";
+			}
+			if ((size_t)out.tellp() - lineStart > 80) {
+				out << "\n";
+				lineStart = (size_t)out.tellp();
+			}
+		}
+		return out.str();
+	}
+
+	double megabytes(const string& text) {
+		return text.size() / (1024.0 * 1024.0);
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef BENCH_INPUT_H
+#define BENCH_INPUT_H
+
+#include <string>
+
+namespace parser_benchmarks {
+
+	/* Deterministic pseudo-random numbers (LCG), so that every
+	run and every platform measures exactly the same input*/
+	class BenchRandom {
+	private:
+		unsigned int state;
+	public:
+		BenchRandom(unsigned int seed) : state(seed) {
+		}
+
+		/* Returns: number in [0, n) */
+		unsigned int next(unsigned int n) {
+			state = state * 1103515245u + 12345u;
+			return (state >> 16) % n;
+		}
+	};
+
+	/* Generate a valid program in the Reverse Polish Notation
+	(as written by Calculator::save) of approximately the given size.
+	Uses the variable 'x', standard functions and constants*/
+	std::string generateRpnText(size_t approxBytes);
+
+	/* Generate a valid RPN program as exported by other tools:
+	floating-point literals with 15 significant digits, long
+	identifiers and columns aligned with runs of spaces*/
+	std::string generateExportedRpnText(size_t approxBytes);
+
+	/* Generate a valid expression in the infix notation (the grammar
+	of the Parser) of approximately the given size: a long sum of terms
+	with operators of all priorities, unary minus, function calls and
+	parentheses nested at most a few levels deep.
+	Different seeds give different expressions*/
+	std::string generateExprText(size_t approxBytes, unsigned int seed);
+
+	/* Generate a valid expression in the infix notation with many
+	common subexpressions: a sum of terms which are a few function
+	calls (with random arguments) and their products, as in generated
+	models. Different seeds give different expressions*/
+	std::string generateRedundantExprText(size_t approxBytes, unsigned int seed);
+
+	/* Size of the text in megabytes */
+	double megabytes(const std::string& text);
+}
+
+#endif
@@ -0,0 +1,170 @@
+
+#include "stdafx.h"
+#include "BenchLexer.h"
+#include "BenchInput.h"
+
+#include "..\calc_parser\Lexer.h"
+#include "..\calc_parser\DfaLexer.h"
+#include "..\calc_parser\BufferLexer.h"
+#include "..\calc_parser\Token.h"
+#include "..\calc_parser\TokenArray.h"
+#include "..\calc_parser\CharScan.h"
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace cbench;
+using namespace parser;
+
+namespace parser_benchmarks {
+
+	string* lb_rpnText = NULL;
+	TokenArray* lb_tokens = NULL;
+
+	void lb_setup() {
+		lb_rpnText = new string(generateRpnText(8 * 1024 * 1024));
+		lb_tokens = new TokenArray();
+	}
+
+	void lb_cleanup() {
+		delete lb_rpnText;
+		delete lb_tokens;
+		lb_rpnText = NULL;
+		lb_tokens = NULL;
+	}
+
+	/* lex the whole RPN text with the given lexer*/
+	template <class LexerType>
+	double lb_lexAll() {
+		stringstream in(*lb_rpnText);
+		LexerType lexer;
+		int lexems = 0;
+		auto_ptr<Lexem> lexem;
+		while ((lexem = lexer.next(in)).get() != NULL) {
+			lexems++;
+		}
+		return megabytes(*lb_rpnText);
+	}
+
+	double lb_stateLexer() {
+		return lb_lexAll<Lexer>();
+	}
+
+	double lb_dfaLexer() {
+		return lb_lexAll<DfaLexer>();
+	}
+
+	double lb_dfaLexerTokens() {
+		stringstream in(*lb_rpnText);
+		DfaLexer lexer;
+		Token token;
+		int lexems = 0;
+		while (lexer.next(in, token) != LK_EOF) {
+			lexems++;
+		}
+		return megabytes(*lb_rpnText);
+	}
+
+	double lb_bufferLexerLexems() {
+		BufferLexer lexer(lb_rpnText->data(), lb_rpnText->size());
+		int lexems = 0;
+		while (lexer.next() != LK_EOF) {
+			auto_ptr<Lexem> lexem = lexer.getLexem();
+			lexems++;
+		}
+		return megabytes(*lb_rpnText);
+	}
+
+	double lb_bufferLexer() {
+		BufferLexer lexer(lb_rpnText->data(), lb_rpnText->size());
+		int lexems = 0;
+		while (lexer.next() != LK_EOF) {
+			lexems++;
+		}
+		return megabytes(*lb_rpnText);
+	}
+
+	/* the array is reused - allocated only in the first run */
+	double lb_tokenArray() {
+		lb_tokens->tokenize(lb_rpnText->data(), lb_rpnText->size());
+		return megabytes(*lb_rpnText);
+	}
+
+	auto_ptr<BenchmarkCase> lexerBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("LexerBenchmarkCase (8 MB RPN)"), string("MB"),
+			lb_setup, lb_cleanup));
+		bc->addBenchmark("lb_stateLexer", lb_stateLexer);
+		bc->addBenchmark("lb_dfaLexer", lb_dfaLexer);
+		bc->addBenchmark("lb_dfaLexerTokens", lb_dfaLexerTokens);
+		bc->addBenchmark("lb_bufferLexerLexems", lb_bufferLexerLexems);
+		bc->addBenchmark("lb_bufferLexer", lb_bufferLexer);
+		bc->addBenchmark("lb_tokenArray", lb_tokenArray);
+		return bc;
+	}
+
+	string* sl_rpnText = NULL;
+	simd::SimdLevel sl_savedLevel = simd::SIMD_SCALAR;
+
+	void sl_setup() {
+		sl_rpnText = new string(generateRpnText(8 * 1024 * 1024));
+		sl_savedLevel = simd::getSimdLevel();
+	}
+
+	void sl_setupExported() {
+		sl_rpnText = new string(generateExportedRpnText(8 * 1024 * 1024));
+		sl_savedLevel = simd::getSimdLevel();
+	}
+
+	void sl_cleanup() {
+		simd::setSimdLevel(sl_savedLevel);
+		delete sl_rpnText;
+		sl_rpnText = NULL;
+	}
+
+	/* lex the text with the given level, if supported*/
+	double sl_lexAll(simd::SimdLevel level) {
+		if (simd::setSimdLevel(level) != level) {
+			return 0.0;
+		}
+		BufferLexer lexer(sl_rpnText->data(), sl_rpnText->size());
+		int lexems = 0;
+		while (lexer.next() != LK_EOF) {
+			lexems++;
+		}
+		return megabytes(*sl_rpnText);
+	}
+
+	double sl_scalar() {
+		return sl_lexAll(simd::SIMD_SCALAR);
+	}
+
+	double sl_sse2() {
+		return sl_lexAll(simd::SIMD_SSE2);
+	}
+
+	double sl_avx2() {
+		return sl_lexAll(simd::SIMD_AVX2);
+	}
+
+	auto_ptr<BenchmarkCase> simdLexerBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("SimdLexerBenchmarkCase (8 MB RPN)"), string("MB"),
+			sl_setup, sl_cleanup));
+		bc->addBenchmark("sl_scalar", sl_scalar);
+		bc->addBenchmark("sl_sse2", sl_sse2);
+		bc->addBenchmark("sl_avx2", sl_avx2);
+		return bc;
+	}
+
+	auto_ptr<BenchmarkCase> simdExportedLexerBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("SimdLexerBenchmarkCase (8 MB exported RPN)"), string("MB"),
+			sl_setupExported, sl_cleanup));
+		bc->addBenchmark("sl_scalar", sl_scalar);
+		bc->addBenchmark("sl_sse2", sl_sse2);
+		bc->addBenchmark("sl_avx2", sl_avx2);
+		return bc;
+	}
+
+}
@@ -0,0 +1,19 @@
+#ifndef BENCH_LEXER_H
+#define BENCH_LEXER_H
+
+#include "CBench.h"
+#include <memory>
+
+namespace parser_benchmarks {
+
+	std::auto_ptr<cbench::BenchmarkCase> lexerBenchmarkCase();
+
+	/* BufferLexer with scalar, SSE2 and AVX2 character classification */
+	std::auto_ptr<cbench::BenchmarkCase> simdLexerBenchmarkCase();
+
+	/* the same on exported RPN - long literals and runs of spaces */
+	std::auto_ptr<cbench::BenchmarkCase> simdExportedLexerBenchmarkCase();
+
+}
+
+#endif
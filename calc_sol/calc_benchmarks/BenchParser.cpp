@@ -0,0 +1,600 @@
+
+#include "stdafx.h"
+#include "BenchParser.h"
+#include "BenchInput.h"
+
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "..\calc_parser\TokenArray.h"
+#include "..\calc_parser\PushParser.h"
+#include "..\calc_parser\ParallelParser.h"
+#include "..\calc_parser\Threads.h"
+#include "..\calc_parser\Arena.h"
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace cbench;
+using namespace parser;
+using namespace calc;
+
+namespace parser_benchmarks {
+
+	/* many independent expressions of 1 KB each*/
+	vector<string>* pb_exprTexts = NULL;
+	/* tokens of each expression, lexed in setup */
+	vector<TokenArray*>* pb_exprTokens = NULL;
+	double pb_megabytes = 0.0;
+	StdFunctionLookupTable* pb_ftl = NULL;
+	StdConstantLookupTable* pb_clt = NULL;
+
+	void pb_setup() {
+		pb_exprTexts = new vector<string>();
+		pb_megabytes = 0.0;
+		for (unsigned int i = 0; i < 4096; i++) {
+			pb_exprTexts->push_back(generateExprText(1024, i + 1));
+			pb_megabytes += megabytes(pb_exprTexts->back());
+		}
+		pb_exprTokens = new vector<TokenArray*>();
+		for (auto it = pb_exprTexts->begin(); it != pb_exprTexts->end(); ++it) {
+			pb_exprTokens->push_back(new TokenArray());
+			pb_exprTokens->back()->tokenize(it->data(), it->size());
+		}
+		pb_ftl = new StdFunctionLookupTable();
+		pb_clt = new StdConstantLookupTable();
+	}
+
+	void pb_cleanup() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			delete *it;
+		}
+		delete pb_exprTokens;
+		delete pb_exprTexts;
+		delete pb_ftl;
+		delete pb_clt;
+		pb_exprTexts = NULL;
+		pb_exprTokens = NULL;
+		pb_ftl = NULL;
+		pb_clt = NULL;
+	}
+
+	double pb_parseStream() {
+		for (auto it = pb_exprTexts->begin(); it != pb_exprTexts->end(); ++it) {
+			stringstream in(*it);
+			Parser parser(in, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	double pb_parseBuffer() {
+		for (auto it = pb_exprTexts->begin(); it != pb_exprTexts->end(); ++it) {
+			SourceBuffer source(it->data(), it->size());
+			Parser parser(source, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	/* lexing only */
+	double pb_lexTokenArrays() {
+		TokenArray tokens;
+		for (auto it = pb_exprTexts->begin(); it != pb_exprTexts->end(); ++it) {
+			tokens.tokenize(it->data(), it->size());
+		}
+		return pb_megabytes;
+	}
+
+	/* parsing only - the tokens are lexed in setup */
+	double pb_parseTokenArrays() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	/* push every expression in chunks of the given size */
+	double pb_parsePushed(size_t chunk) {
+		for (auto it = pb_exprTexts->begin(); it != pb_exprTexts->end(); ++it) {
+			PushParser parser(pb_clt, pb_ftl);
+			for (size_t p = 0; p < it->size(); p += chunk) {
+				parser.push(it->data() + p, min(chunk, it->size() - p));
+			}
+			AstNode* ast = parser.finish();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	/* chunks as read from a pipe */
+	double pb_parsePushed4K() {
+		return pb_parsePushed(4096);
+	}
+
+	/* small chunks - many tokens are split */
+	double pb_parsePushed64() {
+		return pb_parsePushed(64);
+	}
+
+	auto_ptr<BenchmarkCase> parserBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("ParserBenchmarkCase (4096 x 1 KB expressions)"), string("MB"),
+			pb_setup, pb_cleanup));
+		bc->addBenchmark("pb_parseStream", pb_parseStream);
+		bc->addBenchmark("pb_parseBuffer", pb_parseBuffer);
+		bc->addBenchmark("pb_lexTokenArrays", pb_lexTokenArrays);
+		bc->addBenchmark("pb_parseTokenArrays", pb_parseTokenArrays);
+		bc->addBenchmark("pb_parsePushed4K", pb_parsePushed4K);
+		bc->addBenchmark("pb_parsePushed64", pb_parsePushed64);
+		return bc;
+	}
+
+	/* one expression of 16 MB */
+	string* ppb_exprText = NULL;
+
+	void ppb_setup() {
+		ppb_exprText = new string(generateExprText(16 * 1024 * 1024, 1));
+		pb_ftl = new StdFunctionLookupTable();
+		pb_clt = new StdConstantLookupTable();
+	}
+
+	void ppb_cleanup() {
+		delete ppb_exprText;
+		delete pb_ftl;
+		delete pb_clt;
+		ppb_exprText = NULL;
+		pb_ftl = NULL;
+		pb_clt = NULL;
+	}
+
+	/* Parser::expr - the base line */
+	double ppb_parseSequential() {
+		SourceBuffer source(ppb_exprText->data(), ppb_exprText->size());
+		Parser parser(source, pb_clt, pb_ftl);
+		AstNode* ast = parser.begin().expr();
+		delete ast;
+		return megabytes(*ppb_exprText);
+	}
+
+	double ppb_parseParallel(unsigned int threadCount) {
+		SourceBuffer source(ppb_exprText->data(), ppb_exprText->size());
+		ParallelParser parser(source, pb_clt, pb_ftl, threadCount);
+		AstNode* ast = parser.expr();
+		delete ast;
+		return megabytes(*ppb_exprText);
+	}
+
+	double ppb_parseParallel2() {
+		return ppb_parseParallel(2);
+	}
+
+	double ppb_parseParallel4() {
+		return ppb_parseParallel(4);
+	}
+
+	double ppb_parseParallel8() {
+		return ppb_parseParallel(8);
+	}
+
+	/* one thread per processor */
+	double ppb_parseParallelAll() {
+		return ppb_parseParallel(hardwareThreads());
+	}
+
+	auto_ptr<BenchmarkCase> parallelParserBenchmarkCase() {
+		stringstream name;
+		name << "ParallelParserBenchmarkCase (16 MB expression, "
+			<< hardwareThreads() << " processors)";
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(name.str(), string("MB"),
+			ppb_setup, ppb_cleanup));
+		bc->addBenchmark("ppb_parseSequential", ppb_parseSequential);
+		bc->addBenchmark("ppb_parseParallel2", ppb_parseParallel2);
+		bc->addBenchmark("ppb_parseParallel4", ppb_parseParallel4);
+		bc->addBenchmark("ppb_parseParallel8", ppb_parseParallel8);
+		bc->addBenchmark("ppb_parseParallelAll", ppb_parseParallelAll);
+		return bc;
+	}
+
+	/* arena reused by all parses, released after each one */
+	Arena* ab_arena = NULL;
+
+	void ab_setup() {
+		pb_setup();
+		ab_arena = new Arena();
+	}
+
+	void ab_cleanup() {
+		delete ab_arena;
+		ab_arena = NULL;
+		pb_cleanup();
+	}
+
+	/* every node allocated by new, the trees deleted node by node */
+	double ab_parseHeap() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	/* the nodes in the arena, the trees freed at once */
+	double ab_parseArena() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl, ab_arena);
+			parser.begin().expr();
+			ab_arena->release();
+		}
+		return pb_megabytes;
+	}
+
+	/* parse and translate to the RPN program */
+	double ab_compileHeap() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			Calculator calculator(string("x"), pb_ftl, pb_clt, ast);
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	double ab_compileArena() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl, ab_arena);
+			AstNode* ast = parser.begin().expr();
+			Calculator calculator(string("x"), pb_ftl, pb_clt, ast);
+			ab_arena->release();
+		}
+		return pb_megabytes;
+	}
+
+	auto_ptr<BenchmarkCase> astAllocationBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("AstAllocationBenchmarkCase (4096 x 1 KB expressions, lexed)"), string("MB"),
+			ab_setup, ab_cleanup));
+		bc->addBenchmark("ab_parseHeap", ab_parseHeap);
+		bc->addBenchmark("ab_parseArena", ab_parseArena);
+		bc->addBenchmark("ab_compileHeap", ab_compileHeap);
+		bc->addBenchmark("ab_compileArena", ab_compileArena);
+		return bc;
+	}
+
+	/* the 16 MB expression, lexed in setup */
+	TokenArray* lab_tokens = NULL;
+
+	void lab_setup() {
+		ppb_setup();
+		lab_tokens = new TokenArray();
+		lab_tokens->tokenize(ppb_exprText->data(), ppb_exprText->size());
+		ab_arena = new Arena();
+	}
+
+	void lab_cleanup() {
+		delete ab_arena;
+		delete lab_tokens;
+		ab_arena = NULL;
+		lab_tokens = NULL;
+		ppb_cleanup();
+	}
+
+	double lab_parseHeap() {
+		Parser parser(*lab_tokens, pb_clt, pb_ftl);
+		AstNode* ast = parser.begin().expr();
+		delete ast;
+		return megabytes(*ppb_exprText);
+	}
+
+	double lab_parseArena() {
+		Parser parser(*lab_tokens, pb_clt, pb_ftl, ab_arena);
+		parser.begin().expr();
+		ab_arena->release();
+		return megabytes(*ppb_exprText);
+	}
+
+	auto_ptr<BenchmarkCase> largeAstAllocationBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("LargeAstAllocationBenchmarkCase (16 MB expression, lexed)"), string("MB"),
+			lab_setup, lab_cleanup));
+		bc->addBenchmark("lab_parseHeap", lab_parseHeap);
+		bc->addBenchmark("lab_parseArena", lab_parseArena);
+		return bc;
+	}
+
+	/* the expression of the case, lexed in setup */
+	string* fab_exprText = NULL;
+	TokenArray* fab_tokens = NULL;
+	/* reused by the flat benchmarks */
+	FlatAst* fab_ast = NULL;
+	/* number of nodes of the expression, in millions */
+	double fab_millionNodes = 0.0;
+
+	/* Append an expression of about nodeCount nodes: groups of 10
+	expressions in parentheses, down to expressions of about 100 nodes.
+	No chain of operators is long, so the tree can be visited by
+	recursion at any size*/
+	void fab_appendExpr(stringstream& out, size_t nodeCount, unsigned int& seed) {
+		if (nodeCount <= 100) {
+			//about 3.3 bytes per node
+			out << generateExprText(nodeCount * 10 / 3, seed++);
+			return;
+		}
+		out << "(";
+		for (int i = 0; i < 10; i++) {
+			if (i > 0) {
+				out << (i % 2 == 0 ? " + " : " * ");
+			}
+			fab_appendExpr(out, nodeCount / 10, seed);
+		}
+		out << ")";
+	}
+
+	void fab_setup(size_t nodeCount) {
+		stringstream out;
+		unsigned int seed = 1;
+		fab_appendExpr(out, nodeCount, seed);
+		fab_exprText = new string(out.str());
+		fab_tokens = new TokenArray();
+		fab_tokens->tokenize(fab_exprText->data(), fab_exprText->size());
+		fab_ast = new FlatAst();
+		pb_ftl = new StdFunctionLookupTable();
+		pb_clt = new StdConstantLookupTable();
+
+		//memory of the nodes: the tree in an arena counts the bytes of
+		//the objects only, each of them is one heap allocation otherwise
+		Arena arena;
+		Parser treeParser(*fab_tokens, pb_clt, pb_ftl, &arena);
+		treeParser.begin().expr();
+		Parser flatParser(*fab_tokens, pb_clt, pb_ftl);
+		flatParser.begin().expr(*fab_ast);
+		double nodes = (double)fab_ast->size();
+		fab_millionNodes = nodes / 1.0e6;
+		cout << "  " << fab_ast->size() << " nodes, bytes per node: tree "
+			<< setprecision(1) << fixed << arena.getAllocatedSize() / nodes << " (+1 heap allocation), flat "
+			<< fab_ast->memorySize() / nodes << endl;
+	}
+
+	void fab_setup3() {
+		fab_setup(1000);
+	}
+
+	void fab_setup4() {
+		fab_setup(10 * 1000);
+	}
+
+	void fab_setup5() {
+		fab_setup(100 * 1000);
+	}
+
+	void fab_setup6() {
+		fab_setup(1000 * 1000);
+	}
+
+	void fab_setup7() {
+		fab_setup(10 * 1000 * 1000);
+	}
+
+	void fab_cleanup() {
+		delete fab_exprText;
+		delete fab_tokens;
+		delete fab_ast;
+		delete pb_ftl;
+		delete pb_clt;
+		fab_exprText = NULL;
+		fab_tokens = NULL;
+		fab_ast = NULL;
+		pb_ftl = NULL;
+		pb_clt = NULL;
+	}
+
+	/* the small expressions are parsed many times */
+	int fab_repeats() {
+		return fab_millionNodes < 0.5 ? (int)(1.0 / fab_millionNodes) : 1;
+	}
+
+	double fab_parseTree() {
+		int repeats = fab_repeats();
+		for (int i = 0; i < repeats; i++) {
+			Parser parser(*fab_tokens, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return fab_millionNodes * repeats;
+	}
+
+	double fab_parseFlat() {
+		int repeats = fab_repeats();
+		for (int i = 0; i < repeats; i++) {
+			Parser parser(*fab_tokens, pb_clt, pb_ftl);
+			parser.begin().expr(*fab_ast);
+		}
+		return fab_millionNodes * repeats;
+	}
+
+	/* parse and translate to the RPN program */
+	double fab_compileTree() {
+		int repeats = fab_repeats();
+		for (int i = 0; i < repeats; i++) {
+			Parser parser(*fab_tokens, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			Calculator calculator(string("x"), pb_ftl, pb_clt, ast);
+			delete ast;
+		}
+		return fab_millionNodes * repeats;
+	}
+
+	double fab_compileFlat() {
+		int repeats = fab_repeats();
+		for (int i = 0; i < repeats; i++) {
+			Parser parser(*fab_tokens, pb_clt, pb_ftl);
+			parser.begin().expr(*fab_ast);
+			Calculator calculator(string("x"), pb_ftl, pb_clt, *fab_ast);
+		}
+		return fab_millionNodes * repeats;
+	}
+
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase(string size, BenchmarkFixtureFunc setup) {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("FlatAstBenchmarkCase (") + size + " nodes, lexed)", string("Mnodes"),
+			setup, fab_cleanup));
+		bc->addBenchmark("fab_parseTree", fab_parseTree);
+		bc->addBenchmark("fab_parseFlat", fab_parseFlat);
+		bc->addBenchmark("fab_compileTree", fab_compileTree);
+		bc->addBenchmark("fab_compileFlat", fab_compileFlat);
+		return bc;
+	}
+
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase3() {
+		return flatAstBenchmarkCase(string("10^3"), fab_setup3);
+	}
+
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase4() {
+		return flatAstBenchmarkCase(string("10^4"), fab_setup4);
+	}
+
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase5() {
+		return flatAstBenchmarkCase(string("10^5"), fab_setup5);
+	}
+
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase6() {
+		return flatAstBenchmarkCase(string("10^6"), fab_setup6);
+	}
+
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase7() {
+		return flatAstBenchmarkCase(string("10^7"), fab_setup7);
+	}
+
+	/* reused by the flat benchmarks */
+	FlatAst* prb_ast = NULL;
+
+	void prb_setup() {
+		pb_setup();
+		prb_ast = new FlatAst();
+	}
+
+	void prb_cleanup() {
+		delete prb_ast;
+		prb_ast = NULL;
+		pb_cleanup();
+	}
+
+	/* recursive descent - the base line */
+	double prb_parseTree() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	double prb_parsePrecedenceTree() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			PrecedenceParser parser(**it, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	double prb_parseFlat() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl);
+			parser.begin().expr(*prb_ast);
+		}
+		return pb_megabytes;
+	}
+
+	double prb_parsePrecedenceFlat() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			PrecedenceParser parser(**it, pb_clt, pb_ftl);
+			parser.begin().expr(*prb_ast);
+		}
+		return pb_megabytes;
+	}
+
+	auto_ptr<BenchmarkCase> precedenceParserBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("PrecedenceParserBenchmarkCase (4096 x 1 KB expressions, lexed)"), string("MB"),
+			prb_setup, prb_cleanup));
+		bc->addBenchmark("prb_parseTree", prb_parseTree);
+		bc->addBenchmark("prb_parsePrecedenceTree", prb_parsePrecedenceTree);
+		bc->addBenchmark("prb_parseFlat", prb_parseFlat);
+		bc->addBenchmark("prb_parsePrecedenceFlat", prb_parsePrecedenceFlat);
+		return bc;
+	}
+
+	/* the AST route: parse the tree, translate it and delete it */
+	double cpb_compileTree() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl);
+			AstNode* ast = parser.begin().expr();
+			Calculator calculator(string("x"), pb_ftl, pb_clt, ast);
+			delete ast;
+		}
+		return pb_megabytes;
+	}
+
+	double cpb_compileArenaTree() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			Parser parser(**it, pb_clt, pb_ftl, ab_arena);
+			AstNode* ast = parser.begin().expr();
+			Calculator calculator(string("x"), pb_ftl, pb_clt, ast);
+			ab_arena->release();
+		}
+		return pb_megabytes;
+	}
+
+	double cpb_compileFlat() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			PrecedenceParser parser(**it, pb_clt, pb_ftl);
+			parser.begin().expr(*prb_ast);
+			Calculator calculator(string("x"), pb_ftl, pb_clt, *prb_ast);
+		}
+		return pb_megabytes;
+	}
+
+	/* single pass, no AST at all */
+	double cpb_compileDirect() {
+		for (auto it = pb_exprTokens->begin(); it != pb_exprTokens->end(); ++it) {
+			auto_ptr<Calculator> calculator = Calculator::compile(string("x"), pb_ftl, pb_clt, **it);
+		}
+		return pb_megabytes;
+	}
+
+	void cpb_setup() {
+		ab_setup();
+		prb_ast = new FlatAst();
+	}
+
+	void cpb_cleanup() {
+		delete prb_ast;
+		prb_ast = NULL;
+		ab_cleanup();
+	}
+
+	auto_ptr<BenchmarkCase> compileBenchmarkCase() {
+		auto_ptr<BenchmarkCase> bc = auto_ptr<BenchmarkCase>(
+			new BenchmarkCase(string("CompileBenchmarkCase (4096 x 1 KB expressions, lexed)"), string("MB"),
+			cpb_setup, cpb_cleanup));
+		bc->addBenchmark("cpb_compileTree", cpb_compileTree);
+		bc->addBenchmark("cpb_compileArenaTree", cpb_compileArenaTree);
+		bc->addBenchmark("cpb_compileFlat", cpb_compileFlat);
+		bc->addBenchmark("cpb_compileDirect", cpb_compileDirect);
+		return bc;
+	}
+
+}
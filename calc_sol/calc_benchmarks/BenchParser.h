@@ -0,0 +1,35 @@
+#ifndef BENCH_PARSER_H
+#define BENCH_PARSER_H
+
+#include "CBench.h"
+#include <memory>
+
+namespace parser_benchmarks {
+
+	std::auto_ptr<cbench::BenchmarkCase> parserBenchmarkCase();
+
+	std::auto_ptr<cbench::BenchmarkCase> parallelParserBenchmarkCase();
+
+	std::auto_ptr<cbench::BenchmarkCase> astAllocationBenchmarkCase();
+
+	std::auto_ptr<cbench::BenchmarkCase> largeAstAllocationBenchmarkCase();
+
+	/* the flat and the pointer AST of 10^3 ... 10^7 nodes */
+	std::auto_ptr<cbench::BenchmarkCase> flatAstBenchmarkCase3();
+
+	std::auto_ptr<cbench::BenchmarkCase> flatAstBenchmarkCase4();
+
+	std::auto_ptr<cbench::BenchmarkCase> flatAstBenchmarkCase5();
+
+	std::auto_ptr<cbench::BenchmarkCase> flatAstBenchmarkCase6();
+
+	std::auto_ptr<cbench::BenchmarkCase> flatAstBenchmarkCase7();
+
+	std::auto_ptr<cbench::BenchmarkCase> precedenceParserBenchmarkCase();
+
+	/* compile latency: through the AST and in a single pass */
+	std::auto_ptr<cbench::BenchmarkCase> compileBenchmarkCase();
+
+}
+
+#endif
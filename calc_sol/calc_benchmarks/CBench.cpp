@@ -0,0 +1,47 @@
+
+#include "stdafx.h"
+#include "CBench.h"
+#include <new>
+#include <cstdlib>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/* Replacement of the global operator new/delete: counts allocations,
+so that benchmarks can report heap allocations next to the time.
+The counter is incremented atomically - benchmarks may allocate
+from many threads*/
+static volatile long long cbenchAllocations = 0;
+
+void* operator new(size_t size) {
+#ifdef _WIN32
+	InterlockedIncrement64(&cbenchAllocations);
+#else
+	__sync_fetch_and_add(&cbenchAllocations, 1);
+#endif
+	void* p = malloc(size > 0 ? size : 1);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) throw() {
+	free(p);
+}
+
+void operator delete[](void* p) throw() {
+	free(p);
+}
+
+namespace cbench {
+
+	long long allocationCount() {
+		return cbenchAllocations;
+	}
+
+}
@@ -0,0 +1,158 @@
+#ifndef CBENCH_H
+#define CBENCH_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+
+namespace cbench {
+
+	/* Measured function.
+	Returns: number of units (bytes, tokens, samples...) processed
+	by the function; used to report throughput*/
+	typedef double (*BenchmarkFunc)();
+
+	/* setup / cleanup of a benchmark case */
+	typedef void (*BenchmarkFixtureFunc)();
+
+	/* Number of heap allocations (operator new) made by the program
+	so far; counted by the replacement operator new in CBench.cpp */
+	long long allocationCount();
+
+	/* Measure elapsed time */
+	class Stopwatch {
+	private:
+		clock_t start;
+	public:
+		Stopwatch() : start(clock()) {
+		}
+
+		double elapsedSeconds() {
+			return (double)(clock() - start) / CLOCKS_PER_SEC;
+		}
+	};
+
+	class Benchmark {
+	private:
+		std::string name;
+		BenchmarkFunc func;
+	public:
+		Benchmark(std::string name, BenchmarkFunc func)
+			: name(name), func(func) {
+		}
+
+		std::string getName() {
+			return name;
+		}
+
+		double runBenchmark() {
+			return func();
+		}
+	};
+
+	/* Group of benchmarks measuring the same work in different ways.
+	The first benchmark is the baseline for the others*/
+	class BenchmarkCase {
+	private:
+		std::string name;
+		/* name of the unit returned by benchmark functions */
+		std::string unit;
+		std::vector<Benchmark> benchmarks;
+		BenchmarkFixtureFunc setup;
+		BenchmarkFixtureFunc cleanup;
+	public:
+		BenchmarkCase(std::string name, std::string unit,
+			BenchmarkFixtureFunc setup, BenchmarkFixtureFunc cleanup)
+			: name(name), unit(unit), setup(setup), cleanup(cleanup) {
+		}
+
+		void addBenchmark(std::string name, BenchmarkFunc func) {
+			benchmarks.push_back(Benchmark(name, func));
+		}
+
+		void callSetup() {
+			setup();
+		}
+
+		void callCleanup() {
+			cleanup();
+		}
+
+		std::vector<Benchmark>& getBenchmarks() {
+			return benchmarks;
+		}
+
+		std::string getName() {
+			return name;
+		}
+
+		std::string getUnit() {
+			return unit;
+		}
+	};
+
+	/* Runs every benchmark a few times and reports the best time,
+	the throughput and the speedup against the first benchmark of the case*/
+	class StdoutBenchmarkRunner {
+	private:
+		std::vector<BenchmarkCase> benchmarkCases;
+		int repeats;
+
+		/* Returns: best throughput (units per second) */
+		double runBenchmark(BenchmarkCase& bc, Benchmark& b) {
+			double bestSeconds = -1.0;
+			double units = 0.0;
+			long long allocations = 0;
+			for (int i = 0; i < repeats; i++) {
+				long long allocationsBefore = allocationCount();
+				Stopwatch stopwatch;
+				units = b.runBenchmark();
+				double seconds = stopwatch.elapsedSeconds();
+				allocations = allocationCount() - allocationsBefore;
+				if (bestSeconds < 0.0 || seconds < bestSeconds) {
+					bestSeconds = seconds;
+				}
+			}
+			if (bestSeconds <= 0.0) {
+				//below clock resolution
+				bestSeconds = 1.0 / CLOCKS_PER_SEC;
+			}
+			double throughput = units / bestSeconds;
+			std::cout << "  " << std::left << std::setw(40) << b.getName()
+				<< std::right << std::setw(10) << std::fixed << std::setprecision(1)
+				<< bestSeconds * 1000.0 << " ms "
+				<< std::setw(14) << std::setprecision(2) << throughput
+				<< " " << bc.getUnit() << "/s"
+				<< std::setw(12) << allocations << " allocs";
+			return throughput;
+		}
+
+	public:
+		StdoutBenchmarkRunner(std::vector<BenchmarkCase> benchmarkCases, int repeats)
+			: benchmarkCases(benchmarkCases), repeats(repeats) {
+		}
+
+		void run() {
+			for (auto it = benchmarkCases.begin(); it != benchmarkCases.end(); ++it) {
+				std::cout << it->getName() << std::endl;
+				it->callSetup();
+				double baseline = 0.0;
+				std::vector<Benchmark>& benchmarks = it->getBenchmarks();
+				for (auto b = benchmarks.begin(); b != benchmarks.end(); ++b) {
+					double throughput = runBenchmark(*it, *b);
+					if (b == benchmarks.begin()) {
+						baseline = throughput;
+					} else if (baseline > 0.0) {
+						std::cout << "  x" << std::setprecision(2) << throughput / baseline;
+					}
+					std::cout << std::endl;
+				}
+				it->callCleanup();
+			}
+		}
+	};
+}
+
+#endif
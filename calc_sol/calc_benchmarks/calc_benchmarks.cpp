@@ -0,0 +1,82 @@
+// calc_benchmarks.cpp : Defines the entry point for the console application.
+//
+
+#include "stdafx.h"
+#include "CBench.h"
+#include "BenchLexer.h"
+#include "BenchFloat.h"
+#include "BenchParser.h"
+#include "BenchCalculator.h"
+
+using namespace cbench;
+using namespace std;
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+
+	auto_ptr<BenchmarkCase> lexerBenchmarkCase = parser_benchmarks::lexerBenchmarkCase();
+	auto_ptr<BenchmarkCase> simdLexerBenchmarkCase = parser_benchmarks::simdLexerBenchmarkCase();
+	auto_ptr<BenchmarkCase> simdExportedLexerBenchmarkCase = parser_benchmarks::simdExportedLexerBenchmarkCase();
+	auto_ptr<BenchmarkCase> floatParseBenchmarkCase = parser_benchmarks::floatParseBenchmarkCase();
+	auto_ptr<BenchmarkCase> floatFormatBenchmarkCase = parser_benchmarks::floatFormatBenchmarkCase();
+	auto_ptr<BenchmarkCase> parserBenchmarkCase = parser_benchmarks::parserBenchmarkCase();
+	auto_ptr<BenchmarkCase> parallelParserBenchmarkCase = parser_benchmarks::parallelParserBenchmarkCase();
+	auto_ptr<BenchmarkCase> astAllocationBenchmarkCase = parser_benchmarks::astAllocationBenchmarkCase();
+	auto_ptr<BenchmarkCase> largeAstAllocationBenchmarkCase = parser_benchmarks::largeAstAllocationBenchmarkCase();
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase3 = parser_benchmarks::flatAstBenchmarkCase3();
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase4 = parser_benchmarks::flatAstBenchmarkCase4();
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase5 = parser_benchmarks::flatAstBenchmarkCase5();
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase6 = parser_benchmarks::flatAstBenchmarkCase6();
+	auto_ptr<BenchmarkCase> flatAstBenchmarkCase7 = parser_benchmarks::flatAstBenchmarkCase7();
+	auto_ptr<BenchmarkCase> precedenceParserBenchmarkCase = parser_benchmarks::precedenceParserBenchmarkCase();
+	auto_ptr<BenchmarkCase> compileBenchmarkCase = parser_benchmarks::compileBenchmarkCase();
+	auto_ptr<BenchmarkCase> rpnLoadBenchmarkCase = parser_benchmarks::rpnLoadBenchmarkCase();
+	auto_ptr<BenchmarkCase> cseBenchmarkCase = parser_benchmarks::cseBenchmarkCase();
+	auto_ptr<BenchmarkCase> calculatorCacheBenchmarkCase = parser_benchmarks::calculatorCacheBenchmarkCase();
+	auto_ptr<BenchmarkCase> incrementalBenchmarkCase = parser_benchmarks::incrementalBenchmarkCase();
+	auto_ptr<BenchmarkCase> validationBenchmarkCase = parser_benchmarks::validationBenchmarkCase();
+	auto_ptr<BenchmarkCase> builtinBenchmarkCase = parser_benchmarks::builtinBenchmarkCase();
+	auto_ptr<BenchmarkCase> batchCompileBenchmarkCase = parser_benchmarks::batchCompileBenchmarkCase();
+	auto_ptr<BenchmarkCase> letBenchmarkCase = parser_benchmarks::letBenchmarkCase();
+	auto_ptr<BenchmarkCase> inlineBenchmarkCase = parser_benchmarks::inlineBenchmarkCase();
+	auto_ptr<BenchmarkCase> libraryBenchmarkCase = parser_benchmarks::libraryBenchmarkCase();
+	auto_ptr<BenchmarkCase> bytecodeBenchmarkCase = parser_benchmarks::bytecodeBenchmarkCase();
+	auto_ptr<BenchmarkCase> blockBenchmarkCase = parser_benchmarks::blockBenchmarkCase();
+	vector<BenchmarkCase> benchmarkCases = vector<BenchmarkCase>();
+
+	benchmarkCases.push_back( *(lexerBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(simdLexerBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(simdExportedLexerBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(floatParseBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(floatFormatBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(parserBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(parallelParserBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(astAllocationBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(largeAstAllocationBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(flatAstBenchmarkCase3.get()) );
+	benchmarkCases.push_back( *(flatAstBenchmarkCase4.get()) );
+	benchmarkCases.push_back( *(flatAstBenchmarkCase5.get()) );
+	benchmarkCases.push_back( *(flatAstBenchmarkCase6.get()) );
+	benchmarkCases.push_back( *(flatAstBenchmarkCase7.get()) );
+	benchmarkCases.push_back( *(precedenceParserBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(compileBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(rpnLoadBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(cseBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(calculatorCacheBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(incrementalBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(validationBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(builtinBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(batchCompileBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(letBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(inlineBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(libraryBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(bytecodeBenchmarkCase.get()) );
+	benchmarkCases.push_back( *(blockBenchmarkCase.get()) );
+
+	StdoutBenchmarkRunner benchmarkRunner = StdoutBenchmarkRunner(benchmarkCases, 3);
+	benchmarkRunner.run();
+
+	//read one character from input
+	cin.get();
+	return 0;
+}
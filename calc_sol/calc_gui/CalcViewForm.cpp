@@ -1,3 +1,3 @@
-#include "StdAfx.h"
-#include "CalcViewForm.h"
-
+#include "StdAfx.h"
+#include "CalcViewForm.h"
+
@@ -0,0 +1,91 @@
+
+#include "stdafx.h"
+#include "Arena.h"
+#include <new>
+
+namespace parser {
+
+	/*** Arena *** *** *** *** *** *** *** *** *** *** *** ***/
+
+	/* chunk memory starts at this alignment */
+	static const size_t CHUNK_ALIGNMENT = 16;
+
+	/* header size, rounded up so that the memory is aligned */
+	static const size_t CHUNK_HEADER_SIZE = 2 * CHUNK_ALIGNMENT;
+
+	Arena::Arena()
+		: chunks(NULL)
+		, position(NULL)
+		, end(NULL)
+		, nextChunkSize(FIRST_CHUNK_SIZE)
+		, allocatedSize(0) {
+	}
+
+	Arena::~Arena() {
+		while (chunks != NULL) {
+			Chunk* next = chunks->next;
+			::operator delete(chunks);
+			chunks = next;
+		}
+	}
+
+	void Arena::addChunk(size_t size) {
+		Chunk* chunk = (Chunk*)::operator new(CHUNK_HEADER_SIZE + size);
+		chunk->size = size;
+		chunk->next = chunks;
+		chunks = chunk;
+		position = (char*)chunk + CHUNK_HEADER_SIZE;
+		end = position + size;
+	}
+
+	void* Arena::allocateInNewChunk(size_t size, size_t alignment) {
+		size_t chunkSize = nextChunkSize;
+		if (chunkSize < size + alignment) {
+			//a large object - a chunk of its own
+			chunkSize = size + alignment;
+		}
+		addChunk(chunkSize);
+		if (nextChunkSize < MAX_CHUNK_SIZE) {
+			nextChunkSize *= 2;
+		}
+		return allocate(size, alignment);
+	}
+
+	void Arena::release() {
+		//keep the largest chunk
+		Chunk* largest = NULL;
+		while (chunks != NULL) {
+			Chunk* next = chunks->next;
+			if (largest == NULL || chunks->size > largest->size) {
+				if (largest != NULL) {
+					::operator delete(largest);
+				}
+				largest = chunks;
+			} else {
+				::operator delete(chunks);
+			}
+			chunks = next;
+		}
+		chunks = largest;
+		if (chunks != NULL) {
+			chunks->next = NULL;
+			position = (char*)chunks + CHUNK_HEADER_SIZE;
+			end = position + chunks->size;
+		} else {
+			position = NULL;
+			end = NULL;
+		}
+		allocatedSize = 0;
+	}
+
+	size_t Arena::getChunkCount() const {
+		size_t count = 0;
+		for (Chunk* chunk = chunks; chunk != NULL; chunk = chunk->next) {
+			count++;
+		}
+		return count;
+	}
+
+	/*** End of Arena *** *** *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,99 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+
+namespace parser {
+
+	/* Source of memory for objects which are allocated together, in
+	the manner of std::pmr::memory_resource (Visual Studio 2010 has
+	no <memory_resource>)*/
+	class MemoryResource {
+	public:
+		virtual ~MemoryResource() {
+		}
+
+		/* Returns: size bytes aligned to alignment (a power of 2).
+		Throws std::bad_alloc*/
+		virtual void* allocate(size_t size, size_t alignment) = 0;
+
+		/* give back the memory returned by allocate with the same size */
+		virtual void deallocate(void* p, size_t size, size_t alignment) = 0;
+	};
+
+	/* Bump allocator: objects are placed one after another in large
+	chunks, allocating is moving a pointer. Single objects are never
+	freed - deallocate does nothing; release frees all of them at once.
+	Destructors of the objects are not called, so the objects must not
+	hold other resources.
+
+	Chunks double in size up to MAX_CHUNK_SIZE. Release keeps the
+	largest chunk, so an arena reused for objects of the same size
+	allocates nothing from the heap. Not synchronized*/
+	class Arena : public MemoryResource {
+	private:
+		/* header of a chunk; the memory follows */
+		struct Chunk {
+			Chunk* next;
+			size_t size;
+		};
+
+		/* chunks, the current one first */
+		Chunk* chunks;
+		/* free memory of the current chunk */
+		char* position;
+		char* end;
+		/* size of the next chunk */
+		size_t nextChunkSize;
+		/* bytes given by allocate since the last release */
+		size_t allocatedSize;
+
+		/* start a chunk of at least size bytes */
+		void addChunk(size_t size);
+
+		/* not copyable */
+		Arena(const Arena& other);
+		Arena& operator =(const Arena& other);
+	public:
+		static const size_t FIRST_CHUNK_SIZE = 4 * 1024;
+		static const size_t MAX_CHUNK_SIZE = 1024 * 1024;
+
+		Arena();
+
+		/* frees all chunks */
+		virtual ~Arena();
+
+		virtual void* allocate(size_t size, size_t alignment) {
+			//the fast path: the current chunk has room
+			char* p = (char*)(((size_t)position + alignment - 1) & ~(alignment - 1));
+			if (p + size > end || p < position) {
+				return allocateInNewChunk(size, alignment);
+			}
+			position = p + size;
+			allocatedSize += size;
+			return p;
+		}
+
+		/* memory is freed by release */
+		virtual void deallocate(void* p, size_t size, size_t alignment) {
+		}
+
+		/* allocate when the current chunk is full */
+		void* allocateInNewChunk(size_t size, size_t alignment);
+
+		/* Free all objects at once; the memory of the largest chunk is
+		reused by the next allocations*/
+		void release();
+
+		/* bytes given by allocate since the last release */
+		size_t getAllocatedSize() const {
+			return allocatedSize;
+		}
+
+		/* number of chunks held */
+		size_t getChunkCount() const;
+	};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "stdafx.h"
+#include "BatchCompiler.h"
+#include "TokenArray.h"
+#include "Threads.h"
+
+using namespace std;
+using namespace parser;
+
+namespace calc {
+
+	/*** BatchCompiler *** *** *** *** *** *** *** *** *** *** ***/
+
+	/* compiles the expressions of a chunk */
+	class CompileChunkTask : public Task {
+	private:
+		const string& variableName;
+		FunctionLookupTable* functionLookupTable;
+		ConstantLookupTable* constantLookupTable;
+		bool shareSubexpressions;
+		const vector<string>& texts;
+		size_t first;
+		size_t end;
+		vector<BatchResult>& results;
+	public:
+		/* the expressions not compiled */
+		size_t errorCount;
+
+		CompileChunkTask(const string& variableName,
+			FunctionLookupTable* functionLookupTable, ConstantLookupTable* constantLookupTable,
+			bool shareSubexpressions, const vector<string>& texts, size_t first, size_t end,
+			vector<BatchResult>& results)
+			: variableName(variableName)
+			, functionLookupTable(functionLookupTable)
+			, constantLookupTable(constantLookupTable)
+			, shareSubexpressions(shareSubexpressions)
+			, texts(texts)
+			, first(first)
+			, end(end)
+			, results(results)
+			, errorCount(0) {
+		}
+
+		virtual void run() {
+			//the arrays of the tokens are reused by the expressions
+			TokenArray tokens;
+			for (size_t i = first; i < end; i++) {
+				const string& text = texts[i];
+				BatchResult& result = results[i];
+				result.program.reset();
+				if (tokens.tokenize(text.data(), text.size(), result.status)) {
+					auto_ptr<Calculator> program = Calculator::compile(variableName,
+						functionLookupTable, constantLookupTable, tokens, result.status,
+						shareSubexpressions);
+					result.program = shared_ptr<const Calculator>(program.release());
+				}
+				if (!result.status.isOk()) {
+					errorCount++;
+				}
+			}
+		}
+	};
+
+	BatchCompiler::BatchCompiler(const string& variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		unsigned int threadCount,
+		bool shareSubexpressions)
+		: variableName(variableName)
+		, functionLookupTable(functionLookupTable)
+		, constantLookupTable(constantLookupTable)
+		, threadCount(threadCount > 0 ? threadCount : hardwareThreads())
+		, shareSubexpressions(shareSubexpressions)
+		, chunkSize(CHUNK_SIZE) {
+	}
+
+	size_t BatchCompiler::compile(const vector<string>& texts, vector<BatchResult>& results) {
+		results.clear();
+		results.resize(texts.size());
+		vector<CompileChunkTask*> chunks;
+		vector<Task*> tasks;
+		for (size_t first = 0; first < texts.size(); first += chunkSize) {
+			size_t end = (texts.size() - first > chunkSize) ? first + chunkSize : texts.size();
+			chunks.push_back(new CompileChunkTask(variableName,
+				functionLookupTable, constantLookupTable, shareSubexpressions,
+				texts, first, end, results));
+			tasks.push_back(chunks.back());
+		}
+		runTasks(tasks, threadCount);
+		size_t errorCount = 0;
+		for (size_t i = 0; i < chunks.size(); i++) {
+			errorCount += chunks[i]->errorCount;
+			delete chunks[i];
+		}
+		return errorCount;
+	}
+
+	/*** End of BatchCompiler *** *** *** *** *** *** *** *** ***/
+
+}
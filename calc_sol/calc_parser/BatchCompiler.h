@@ -0,0 +1,78 @@
+#ifndef BATCH_COMPILER_H
+#define BATCH_COMPILER_H
+
+#include "Calculator.h"
+#include "Status.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace calc {
+
+	/* Program or error of one expression of a batch */
+	struct BatchResult {
+		/* the program; NULL on an error */
+		std::shared_ptr<const Calculator> program;
+		/* the error compile would throw; ok with a program */
+		parser::Status status;
+	};
+
+	/* Compiles a batch of expressions (a library of models) on many
+	threads, each of them as Calculator::compile does.
+
+	The threads share the lookup tables and the symbol table: the
+	lookup tables are only read (LookupTable::find) and must not be
+	changed while compiling, the symbols are interned under the lock
+	of the symbol table (builtin names without it). The expressions
+	are compiled in chunks, taken by the threads in their order (see
+	parser::runTasks); the result of an expression is written by one
+	thread only, at the index of the expression - the results are in
+	the order of the input, whatever the number of threads*/
+	class BatchCompiler {
+	private:
+		std::string variableName;
+
+		/* a table to lookup function by name */
+		parser::FunctionLookupTable* functionLookupTable;
+
+		/* a table to lookup constant by name */
+		parser::ConstantLookupTable* constantLookupTable;
+
+		unsigned int threadCount;
+
+		bool shareSubexpressions;
+
+		/* expressions compiled by one task */
+		size_t chunkSize;
+
+		/* not copyable */
+		BatchCompiler(const BatchCompiler& other);
+		BatchCompiler& operator =(const BatchCompiler& other);
+	public:
+		/* default of setChunkSize */
+		static const size_t CHUNK_SIZE = 256;
+
+		/* Compile on at most threadCount threads (including the calling
+		one); threadCount 0 is the number of processors. The tables must
+		outlive the compiler*/
+		BatchCompiler(const std::string& variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			unsigned int threadCount,
+			bool shareSubexpressions = false);
+
+		/* a thread takes the expressions by this many (CHUNK_SIZE by
+		default, at least 1)*/
+		void setChunkSize(size_t size) {
+			chunkSize = size > 0 ? size : 1;
+		}
+
+		/* Compile the texts; results[i] is the program or the error of
+		texts[i]. Errors of the expressions are never thrown.
+		Returns: number of the expressions not compiled (errors)*/
+		size_t compile(const std::vector<std::string>& texts, std::vector<BatchResult>& results);
+	};
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+
+#include "stdafx.h"
+#include "BufferLexer.h"
+#include "DfaLexer.h"
+#include "CharScan.h"
+#include "FloatConv.h"
+#include <string>
+
+using namespace std;
+
+namespace parser {
+
+	using namespace dfa;
+
+	/*** BufferLexer *** *** *** *** *** *** *** *** *** *** ***/
+
+	BufferLexer::BufferLexer(const char* data, size_t length)
+		: begin(data), end(data + length) {
+		init();
+	}
+
+	BufferLexer::BufferLexer(const char* data, size_t length, size_t offset)
+		: begin(data), end(data + length) {
+		init();
+		if (offset > 0) {
+			//as if the text before were lexed already
+			pos = begin + offset;
+		}
+	}
+
+	BufferLexer::BufferLexer(const SourceBuffer& source)
+		: begin(source.getData()), end(source.getData() + source.getLength()) {
+		init();
+	}
+
+	void BufferLexer::init() {
+		//nothing read yet
+		pos = NULL;
+		scanner = &simd::charScanner();
+		eof = false;
+		errorAt = NULL;
+		errorText = NULL;
+
+		countedUpTo = begin;
+		lineStart = begin;
+		lineCounter = 1;
+	}
+
+	LexemKind BufferLexer::next() {
+		if (!scan()) {
+			Status status;
+			scanError(status);
+			status.raise();
+		}
+		return token.kind;
+	}
+
+	LexemKind BufferLexer::next(Status& status) {
+		if (!scan()) {
+			scanError(status);
+			//nothing more is read
+			pos = end;
+			eof = true;
+			token.kind = LK_EOF;
+			token.text = TextSpan(end, 0);
+			token.offset = end - begin;
+			token.symbol = NO_SYMBOL;
+		}
+		return token.kind;
+	}
+
+	void BufferLexer::scanError(Status& status) {
+		if (errorAt == NULL) {
+			status.setUnknownToken(-1, -1, errorText);
+			return;
+		}
+		int lineNo, charNo;
+		position(errorAt, lineNo, charNo);
+		status.setUnknownToken(lineNo, charNo, errorText);
+	}
+
+	bool BufferLexer::scan() {
+		if (eof) {
+			token.kind = LK_EOF;
+			token.text = TextSpan(end, 0);
+			token.offset = end - begin;
+			token.symbol = NO_SYMBOL;
+			return true;
+		}
+		const char* p = (pos != NULL) ? pos : begin;
+
+		//skip white spaces; a single space is checked here,
+		//longer runs are skipped by the scanner
+		if (p != end && charClass(*p) == CC_SPACE) {
+			++p;
+			if (p != end && charClass(*p) == CC_SPACE) {
+				p = scanner->skipSpaces(p, end);
+			}
+		}
+		if (p == end) {
+			pos = end;
+			eof = true;
+			token.kind = LK_EOF;
+			token.text = TextSpan(end, 0);
+			token.offset = end - begin;
+			token.symbol = NO_SYMBOL;
+			return true;
+		}
+		int state = transitionTable[S_START][charClass(*p)];
+		if (state == T_ERROR) {
+			//there is no state in which lexer can process input
+			pos = p;
+			errorAt = p;
+			errorText = NULL;
+			return false;
+		}
+
+		//the longest sequence of characters accepted by the automaton
+		const char* lexemBegin = p++;
+		for (;;) {
+			if (p == end) {
+				break;
+			}
+			int cc = charClass(*p);
+			//runs of digits and identifier characters are skipped by the scanner
+			if (state == S_IDENT && (cc == CC_LETTER || cc == CC_EXP || cc == CC_DIGIT)) {
+				p = scanner->skipIdentifier(p, end);
+				continue;
+			}
+			if ((state == S_INT || state == S_FRAC) && cc == CC_DIGIT) {
+				p = scanner->skipDigits(p, end);
+				continue;
+			}
+			int nextState = transitionTable[state][cc];
+			if (nextState < 0) {
+				break;
+			}
+			state = nextState;
+			++p;
+		}
+		pos = p;
+		eof = (p == end);
+
+		if (stateErrorTable[state] != NULL) {
+			//incomplete float: ends with dot '.' or without exponent digits
+			errorAt = eof ? NULL : p;
+			errorText = stateErrorTable[state];
+			return false;
+		}
+		if (!eof && transitionTable[S_START][charClass(*p)] == T_ERROR) {
+			//the current input doesn't start the next token
+			errorAt = p;
+			errorText = NULL;
+			return false;
+		}
+
+		token.kind = stateKindTable[state];
+		token.text = TextSpan(lexemBegin, p - lexemBegin);
+		token.offset = lexemBegin - begin;
+		if (token.kind == LK_IDENTIFIER && isFloatKeyword(lexemBegin, p - lexemBegin)) {
+			token.kind = LK_FLOAT;
+		}
+		if (token.kind == LK_FLOAT) {
+			token.value = parseFloatLexem(lexemBegin, p);
+		}
+		token.symbol = (token.kind == LK_IDENTIFIER)
+			? findSymbol(lexemBegin, p - lexemBegin)
+			: NO_SYMBOL;
+		return true;
+	}
+
+	LexemKind BufferLexer::next(Token& token) {
+		LexemKind kind = next();
+		token = this->token;
+		return kind;
+	}
+
+	auto_ptr<Lexem> BufferLexer::getLexem() {
+		return toLexem(token);
+	}
+
+	void BufferLexer::position(const char* c, int& lineNo, int& charNo) {
+		//positions are requested in increasing order - count only new lines
+		for (const char* p = countedUpTo; p <= c; ++p) {
+			if (*p == '\n') {
+				lineCounter++;
+				lineStart = p + 1;
+			}
+		}
+		if (c >= countedUpTo) {
+			countedUpTo = c + 1;
+		}
+		lineNo = lineCounter;
+		charNo = (int)(c - lineStart + 1);
+	}
+
+	void BufferLexer::currentPosition(int& lineNo, int& charNo) {
+		if (pos == NULL || (eof && end == begin)) {
+			//nothing read
+			lineNo = 1;
+			charNo = 0;
+		} else if (eof) {
+			//the last character read
+			position(end - 1, lineNo, charNo);
+		} else {
+			position(pos, lineNo, charNo);
+		}
+	}
+
+	int BufferLexer::getCharNo() {
+		int lineNo, charNo;
+		currentPosition(lineNo, charNo);
+		return charNo;
+	}
+
+	int BufferLexer::getLineNo() {
+		int lineNo, charNo;
+		currentPosition(lineNo, charNo);
+		return lineNo;
+	}
+
+	/*** End of BufferLexer *** *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,132 @@
+#ifndef BUFFER_LEXER_H
+#define BUFFER_LEXER_H
+
+#include "Lexer.h"
+#include "SourceBuffer.h"
+#include "Token.h"
+#include "CharScan.h"
+#include "Status.h"
+#include <memory>
+
+namespace parser {
+
+	/* Lexer for contiguous, in-memory source text (a buffer or
+	a memory-mapped file, see SourceBuffer).
+
+	Recognizes the grammar of the "Lexer" class with the tables
+	of DfaLexer, reports the same errors at the same line/character,
+	but works directly on the characters: identifiers are views
+	into the source and floats are converted from the source,
+	without copying characters and without stream calls.
+	Runs of white spaces, digits and identifier characters are
+	classified many characters at a time (see CharScan.h).
+
+	Line and character numbers are computed only when requested.
+	Token texts stay valid as long as the source text exists*/
+	class BufferLexer : public TokenSource {
+	private:
+		/* the source text */
+		const char* begin;
+		const char* end;
+
+		/* current input - the first character after the last lexem */
+		const char* pos;
+
+		/* classification of character runs (SIMD or scalar) */
+		const simd::CharScanner* scanner;
+
+		/* End of source occured*/
+		bool eof;
+
+		/* the last lexem */
+		Token token;
+
+		/* line/character counting resumes from here:
+		position of lineStart in the source is lineCounter:1*/
+		const char* countedUpTo;
+		const char* lineStart;
+		int lineCounter;
+
+		/* the error of the last scan: the character it is at (NULL
+		- the end of the source, no position) and the text (or NULL)*/
+		const char* errorAt;
+		const char* errorText;
+
+		/* Read next lexem into token.
+		Returns: false on an error (see errorAt); nothing is thrown*/
+		bool scan();
+
+		/* report the error of the last scan in the status */
+		void scanError(Status& status);
+
+		/* compute line and character number of the character c */
+		void position(const char* c, int& lineNo, int& charNo);
+
+		/* position of the current input, as reported by the "Lexer" class */
+		void currentPosition(int& lineNo, int& charNo);
+
+		void init();
+	public:
+		BufferLexer(const char* data, size_t length);
+
+		/* Start lexing at the offset, which must not be inside a token
+		(see TokenArray::relex); offsets, lines and characters are still
+		counted from the beginning of the data*/
+		BufferLexer(const char* data, size_t length, size_t offset);
+
+		/* the source buffer must outlive this object */
+		BufferLexer(const SourceBuffer& source);
+
+		/* Read next lexem from the source.
+		Returns: kind of the lexem; LK_EOF at the end of the source.
+		Throws UnknownTokenException*/
+		LexemKind next();
+
+		/* Read next lexem from the source; an error is set in the status
+		instead of thrown, and the lexer stops there.
+		Returns: kind of the lexem; LK_EOF at the end of the source
+		and on an error*/
+		LexemKind next(Status& status);
+
+		/* Read next lexem from the source into the given token.
+		Returns: kind of the lexem; LK_EOF at the end of the source.
+		Throws UnknownTokenException*/
+		virtual LexemKind next(Token& token);
+
+		/* the last lexem */
+		const Token& getToken() {
+			return token;
+		}
+
+		/* kind of the last lexem */
+		LexemKind getKind() {
+			return token.kind;
+		}
+
+		/* value of the last lexem; only for LK_FLOAT*/
+		double getValue() {
+			return token.value;
+		}
+
+		/* text of the last lexem; a view into the source*/
+		TextSpan getText() {
+			return token.text;
+		}
+
+		/* Lexem object for the last lexem (compatibility with the Lexer API)
+		Returns: NULL auto_ptr for LK_EOF*/
+		std::auto_ptr<Lexem> getLexem();
+
+		/* verify end of source */
+		bool isEof() {
+			return eof;
+		}
+
+		virtual int getCharNo();
+
+		virtual int getLineNo();
+	};
+
+}
+
+#endif
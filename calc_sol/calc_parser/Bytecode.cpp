@@ -0,0 +1,387 @@
+#include "stdafx.h"
+#include "Bytecode.h"
+#include <algorithm>
+#include <cmath>
+
+/* GCC and clang take the address of a label: each operation jumps
+straight to the next one (direct threading)*/
+#if defined(__GNUC__)
+#define BYTECODE_COMPUTED_GOTO
+#endif
+
+using namespace std;
+using namespace parser;
+
+namespace calc {
+
+	/*** Bytecode *** *** *** *** *** *** *** *** *** *** *** ***/
+
+	Bytecode::Bytecode()
+		: elementCount(0)
+		, depth(0)
+		, maxDepth(0)
+		, errorSymbolNo(0)
+		, unusedCount(0) {
+	}
+
+	void Bytecode::clear() {
+		code.clear();
+		values.clear();
+		functions.clear();
+		elementCount = 0;
+		depth = 0;
+		maxDepth = 0;
+		errorSymbolNo = 0;
+		unusedCount = 0;
+		starts.clear();
+		depths.clear();
+	}
+
+	void Bytecode::element(int count, int pushed) {
+		elementCount++;
+		if (errorSymbolNo != 0) {
+			return;
+		}
+		if (depth < count) {
+			errorSymbolNo = elementCount;
+			return;
+		}
+		depth += pushed - count;
+		if (depth > maxDepth) {
+			maxDepth = depth;
+		}
+	}
+
+	void Bytecode::addValue(double value) {
+		element(0, 1);
+		code.push_back(BC_VALUE);
+		code.push_back((int)values.size());
+		values.push_back(value);
+	}
+
+	void Bytecode::addVariable() {
+		element(0, 1);
+		code.push_back(BC_VARIABLE);
+	}
+
+	void Bytecode::addNegation() {
+		element(1, 1);
+		code.push_back(BC_NEGATION);
+	}
+
+	void Bytecode::addBinary(BytecodeOp opcode) {
+		element(2, 1);
+		code.push_back(opcode);
+	}
+
+	void Bytecode::addCall(Function1Arg* function) {
+		element(1, 1);
+		code.push_back(BC_CALL);
+		code.push_back((int)functions.size());
+		functions.push_back(function);
+	}
+
+	void Bytecode::addStore(int slot) {
+		//the value stays on the stack
+		element(1, 1);
+		code.push_back(BC_STORE);
+		code.push_back(slot);
+	}
+
+	void Bytecode::addLoad(int slot) {
+		element(0, 1);
+		code.push_back(BC_LOAD);
+		code.push_back(slot);
+	}
+
+	bool Bytecode::end() {
+		code.push_back(BC_END);
+		if (errorSymbolNo == 0 && depth != 1) {
+			errorSymbolNo = elementCount + 1;
+		}
+		return isValid();
+	}
+
+	/* ints of the operation: the opcode and its operand, if any */
+	static inline int width(int op) {
+		return (op == BC_VALUE || op == BC_CALL || op == BC_STORE || op == BC_LOAD) ? 2 : 1;
+	}
+
+	/* values the operation pushes less those it pops */
+	static inline int stackEffect(int op) {
+		switch (op) {
+		case BC_VALUE:
+		case BC_VARIABLE:
+		case BC_LOAD:
+			return 1;
+		case BC_ADD:
+		case BC_SUB:
+		case BC_MUL:
+		case BC_DIV:
+		case BC_POWER:
+			return -1;
+		default:
+			return 0;
+		}
+	}
+
+	void Bytecode::index() {
+		starts.clear();
+		depths.clear();
+		int current = 0;
+		for (size_t pc = 0; code[pc] != BC_END; pc += width(code[pc])) {
+			starts.push_back((int)pc);
+			current += stackEffect(code[pc]);
+			depths.push_back(current);
+		}
+	}
+
+	bool Bytecode::replace(int first, int removed, const Bytecode& part) {
+		if (errorSymbolNo != 0 || code.empty() || part.errorSymbolNo != 0 || part.depth != 1
+			|| removed <= 0 || first < 0 || first + removed > elementCount) {
+				return false;
+		}
+		if ((int)starts.size() != elementCount) {
+			index();
+		}
+		int before = first > 0 ? depths[first - 1] : 0;
+		int end = first + removed;
+		if (depths[end - 1] - before != 1) {
+			//not a subexpression
+			return false;
+		}
+		int removedMax = *max_element(depths.begin() + first, depths.begin() + end);
+		int begin = starts[first];
+		int codeEnd = (end < elementCount) ? starts[end] : (int)code.size() - 1;
+		for (int pc = begin; pc < codeEnd; pc += width(code[pc])) {
+			if (code[pc] == BC_VALUE || code[pc] == BC_CALL) {
+				unusedCount++;
+			}
+		}
+
+		//the operations of the part; their operands index the pools
+		//after the others
+		vector<int> partCode(part.code);
+		vector<int> partStarts;
+		vector<int> partDepths;
+		int current = before;
+		for (int pc = 0; pc < (int)partCode.size(); pc += width(partCode[pc])) {
+			int op = partCode[pc];
+			if (op == BC_VALUE) {
+				partCode[pc + 1] += (int)values.size();
+			} else if (op == BC_CALL) {
+				partCode[pc + 1] += (int)functions.size();
+			}
+			partStarts.push_back(begin + pc);
+			current += stackEffect(op);
+			partDepths.push_back(current);
+		}
+		code.erase(code.begin() + begin, code.begin() + codeEnd);
+		code.insert(code.begin() + begin, partCode.begin(), partCode.end());
+		values.insert(values.end(), part.values.begin(), part.values.end());
+		functions.insert(functions.end(), part.functions.begin(), part.functions.end());
+
+		//the elements after the part are moved, at the same depths
+		int moved = (int)partCode.size() - (codeEnd - begin);
+		if (moved != 0) {
+			for (size_t i = end; i < starts.size(); i++) {
+				starts[i] += moved;
+			}
+		}
+		starts.erase(starts.begin() + first, starts.begin() + end);
+		starts.insert(starts.begin() + first, partStarts.begin(), partStarts.end());
+		depths.erase(depths.begin() + first, depths.begin() + end);
+		depths.insert(depths.begin() + first, partDepths.begin(), partDepths.end());
+		elementCount += part.elementCount - removed;
+		if (removedMax < maxDepth) {
+			maxDepth = max(maxDepth, before + part.maxDepth);
+		} else {
+			//the deepest elements may be gone
+			maxDepth = *max_element(depths.begin(), depths.end());
+		}
+		return true;
+	}
+
+	/*
+	Technological note:
+	the operations are written once; the macros make them the labels
+	of the computed goto or the cases of the switch. sp points past the
+	top of the stack*/
+	double Bytecode::run(double variableValue, double* stack, double* slots) const {
+		const int* pc = code.data();
+		const double* pool = values.data();
+		Function1Arg* const* called = functions.data();
+		double* sp = stack;
+#ifdef BYTECODE_COMPUTED_GOTO
+		//in the order of BytecodeOp
+		static void* const labels[] = {
+			&&L_BC_VALUE, &&L_BC_VARIABLE, &&L_BC_NEGATION,
+			&&L_BC_ADD, &&L_BC_SUB, &&L_BC_MUL, &&L_BC_DIV, &&L_BC_POWER,
+			&&L_BC_CALL, &&L_BC_STORE, &&L_BC_LOAD, &&L_BC_END
+		};
+#define BYTECODE_OP(op) L_##op:
+#define BYTECODE_NEXT goto *labels[*pc++]
+		BYTECODE_NEXT;
+#else
+#define BYTECODE_OP(op) case op:
+#define BYTECODE_NEXT break
+		for (;;) switch (*pc++) {
+#endif
+		BYTECODE_OP(BC_VALUE)
+			*sp++ = pool[*pc++];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_VARIABLE)
+			*sp++ = variableValue;
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_NEGATION)
+			sp[-1] = -sp[-1];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_ADD)
+			sp--;
+			sp[-1] = sp[-1] + sp[0];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_SUB)
+			sp--;
+			sp[-1] = sp[-1] - sp[0];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_MUL)
+			sp--;
+			sp[-1] = sp[-1] * sp[0];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_DIV)
+			sp--;
+			sp[-1] = sp[-1] / sp[0];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_POWER)
+			sp--;
+			sp[-1] = pow(sp[-1], sp[0]);
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_CALL)
+			sp[-1] = called[*pc++]->eval(sp[-1]);
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_STORE)
+			slots[*pc++] = sp[-1];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_LOAD)
+			*sp++ = slots[*pc++];
+			BYTECODE_NEXT;
+		BYTECODE_OP(BC_END)
+			return sp[-1];
+#ifndef BYTECODE_COMPUTED_GOTO
+		default:
+			//should not occur
+			throw "illegal state";
+		}
+#endif
+#undef BYTECODE_OP
+#undef BYTECODE_NEXT
+	}
+
+	/*
+	Technological note:
+	top is the column of the top of the stack. The loops of the
+	arithmetic operations are simple enough to be vectorized - the same
+	operations on the same values, the same results*/
+	void Bytecode::runBlock(const double* variableValues, double* results, size_t count,
+		double* stack, double* slots) const {
+
+			const int* pc = code.data();
+			double* top = stack - count;
+			for (;;) {
+				switch (*pc++) {
+				case BC_VALUE: {
+					top += count;
+					double value = values[*pc++];
+					for (size_t i = 0; i < count; i++) {
+						top[i] = value;
+					}
+					break;
+				}
+				case BC_VARIABLE:
+					top += count;
+					for (size_t i = 0; i < count; i++) {
+						top[i] = variableValues[i];
+					}
+					break;
+				case BC_NEGATION:
+					for (size_t i = 0; i < count; i++) {
+						top[i] = -top[i];
+					}
+					break;
+				case BC_ADD: {
+					double* left = top - count;
+					for (size_t i = 0; i < count; i++) {
+						left[i] = left[i] + top[i];
+					}
+					top = left;
+					break;
+				}
+				case BC_SUB: {
+					double* left = top - count;
+					for (size_t i = 0; i < count; i++) {
+						left[i] = left[i] - top[i];
+					}
+					top = left;
+					break;
+				}
+				case BC_MUL: {
+					double* left = top - count;
+					for (size_t i = 0; i < count; i++) {
+						left[i] = left[i] * top[i];
+					}
+					top = left;
+					break;
+				}
+				case BC_DIV: {
+					double* left = top - count;
+					for (size_t i = 0; i < count; i++) {
+						left[i] = left[i] / top[i];
+					}
+					top = left;
+					break;
+				}
+				case BC_POWER: {
+					double* left = top - count;
+					for (size_t i = 0; i < count; i++) {
+						left[i] = pow(left[i], top[i]);
+					}
+					top = left;
+					break;
+				}
+				case BC_CALL: {
+					Function1Arg* function = functions[*pc++];
+					for (size_t i = 0; i < count; i++) {
+						top[i] = function->eval(top[i]);
+					}
+					break;
+				}
+				case BC_STORE: {
+					double* slot = slots + *pc++ * count;
+					for (size_t i = 0; i < count; i++) {
+						slot[i] = top[i];
+					}
+					break;
+				}
+				case BC_LOAD: {
+					top += count;
+					const double* slot = slots + *pc++ * count;
+					for (size_t i = 0; i < count; i++) {
+						top[i] = slot[i];
+					}
+					break;
+				}
+				case BC_END:
+					for (size_t i = 0; i < count; i++) {
+						results[i] = top[i];
+					}
+					return;
+				default:
+					//should not occur
+					throw "illegal state";
+				}
+			}
+	}
+
+	/*** End of Bytecode *** *** *** *** *** *** *** *** *** *** ***/
+
+}
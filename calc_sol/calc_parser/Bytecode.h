@@ -0,0 +1,157 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "Parser.h"
+#include <vector>
+
+namespace calc {
+
+	/* Operations of the bytecode; an operand follows the opcode where
+	noted*/
+	enum BytecodeOp {
+		/* push the value of the pool; operand: index in the pool */
+		BC_VALUE = 0,
+		/* push the value of the variable */
+		BC_VARIABLE,
+		BC_NEGATION,
+		BC_ADD,
+		BC_SUB,
+		BC_MUL,
+		BC_DIV,
+		BC_POWER,
+		/* apply the function of the slot; operand: index of the slot */
+		BC_CALL,
+		/* keep the top in the slot of a shared subexpression; operand:
+		the slot*/
+		BC_STORE,
+		/* push the value of the slot; operand: the slot */
+		BC_LOAD,
+		/* the top is the result */
+		BC_END
+	};
+
+	/* The program of a Calculator as a contiguous stream of opcodes
+	with their operands, a pool of the values and the slots of the
+	functions called - the RPN elements translated one by one (see
+	Calculator). The interpreter (run) reads the stream in a tight loop
+	on a stack given by the caller: no virtual call but those of the
+	functions, no allocation. It jumps from one operation straight to
+	the next by the computed goto of GCC and clang, by a switch with
+	other compilers. The operations are those of the elements, in the
+	same order - the results are exactly the same.
+
+	The depth of the stack is tracked as the program is built: the
+	maximum is the size of the stack run needs, an operation with too
+	few operands makes the program invalid (the number of its element
+	is kept), as does a result which isn't the only value left*/
+	class Bytecode {
+	private:
+		/* opcodes and operands */
+		std::vector<int> code;
+		/* the pool of the values */
+		std::vector<double> values;
+		/* the slots of the functions */
+		std::vector<parser::Function1Arg*> functions;
+		/* elements added */
+		int elementCount;
+		/* values on the stack after the elements added, and at most */
+		int depth;
+		int maxDepth;
+		/* number of the element (1-indexed) of the first error; 0 -
+		no error*/
+		int errorSymbolNo;
+		/* values and functions of the pools no element uses any more
+		(see replace)*/
+		size_t unusedCount;
+		/* offset in the stream of each element and the depth of the
+		stack after it; made by the first replace, empty before*/
+		std::vector<int> starts;
+		std::vector<int> depths;
+
+		/* fill starts and depths from the stream */
+		void index();
+
+		/* the next element pops count values and pushes pushed ones */
+		void element(int count, int pushed);
+	public:
+		Bytecode();
+
+		/* remove all the elements */
+		void clear();
+
+		/*** the elements of the program, in the order of RPN ***/
+
+		void addValue(double value);
+		void addVariable();
+		void addNegation();
+		/* opcode: BC_ADD ... BC_POWER */
+		void addBinary(BytecodeOp opcode);
+		void addCall(parser::Function1Arg* function);
+		void addStore(int slot);
+		void addLoad(int slot);
+
+		/* The program is complete; no element is added after that.
+		Returns: false if invalid (see getErrorSymbolNo)*/
+		bool end();
+
+		/* Replace the elements first ... first + removed - 1 of the
+		program (valid, complete) by the elements of the part, which is
+		not complete: a subexpression by another one. The stream is
+		spliced, without a call per element: the first replace indexes
+		the elements by a scan of the stream, the later ones only move
+		the operations after the change. The values and the functions
+		of the part are added to the pools, those of the elements
+		removed stay there unused (see getUnusedCount).
+		The program is the one the elements would add, but for the
+		indexes in the pools.
+		Returns: false if the elements removed or the part don't leave
+		one value on the stack - the program is not changed; add all
+		the elements again*/
+		bool replace(int first, int removed, const Bytecode& part);
+
+		/* values and functions of the pools not used since replace */
+		size_t getUnusedCount() const {
+			return unusedCount;
+		}
+
+		/* the program ends well: each operation has its operands and
+		the result is the only value left*/
+		bool isValid() const {
+			return errorSymbolNo == 0;
+		}
+
+		/* number of the element (1-indexed, as StatementException)
+		of the error; elements + 1 if too many values are left*/
+		int getErrorSymbolNo() const {
+			return errorSymbolNo;
+		}
+
+		/* number of the values on the stack at once, at most */
+		int getMaxDepth() const {
+			return maxDepth;
+		}
+
+		/* length of the stream, with the operands */
+		size_t size() const {
+			return code.size();
+		}
+
+		/* Evaluate the program for the value of the variable. The stack
+		has room for getMaxDepth values, the slots for those of the
+		shared subexpressions. Only if valid (see end); many threads
+		may run the same program at once*/
+		double run(double variableValue, double* stack, double* slots) const;
+
+		/* Evaluate the program for count values of the variable at once:
+		each operation is done for all of them before the next one, so
+		an operation is dispatched once per block, not once per value.
+		The results are exactly those of run. The stack and the slots are
+		columns of count values: room for getMaxDepth * count values and
+		count values per slot*/
+		void runBlock(const double* variableValues, double* results, size_t count,
+			double* stack, double* slots) const;
+	};
+
+}
+
+#endif
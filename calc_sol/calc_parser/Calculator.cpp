@@ -1,593 +1,1469 @@
-#include "stdafx.h"
-#include "Calculator.h"
-#include "Lexer.h"
-#include "Parser.h"
-#include <vector>
-#include <stack>
-#include <istream>
-#include <ostream>
-#include <cmath> //power
-#include <string>
-
-namespace calc {
-
-	using namespace std;
-	using namespace parser;
-
-	/* encapsulate values needed when evaluating */
-	class EvaluationContext {
-	private: 
-		/* current number of symbol processed (1-indexed)*/
-		int symbolNo;
-		/* stack used to evaluate according to RPN*/
-		std::stack<double> outStack;
-		/* (x) variable's value */
-		double variableValue;
-	public:
-		EvaluationContext(double variableValue) 
-			: symbolNo(1), variableValue(variableValue) {
-				;
-		}
-
-		/* move forward by 1 symbol*/
-		void inc() {
-			++symbolNo;
-		}
-
-		double getVariableValue() {
-			return variableValue;
-		}
-
-		/* put output of evaluation to the stack*/
-		void pushOutput(double d) {
-			outStack.push(d);
-		}
-
-		/* pop one value from the stack*/
-		double popOutput() {
-			if (outStack.empty()) {
-				throw StatementException(symbolNo);
-			}
-			double el = outStack.top();
-			outStack.pop();
-			return el;
-		}
-
-		/* It is called only after evaluation ends; returns theresult of evaluation*/
-		double getResult() {
-			if (outStack.size() != 1) {
-				throw StatementException(symbolNo);
-			}
-			return outStack.top();
-		}
-	};
-
-	/* Element of a stack created to represent
-	Reverse Polish Notation.
-	Each subclass represents specialized element type. I chose such
-	approach, because I want to process inputs in a polymorphic way
-	and avoid having if(dynamic_casts<>)-like statements everywhere*/
-	class RPNElement {
-	public:
-		RPNElement() {;}
-		/* evaluate this operation */
-		virtual void evaluate(EvaluationContext& ctx) = 0;
-		/* save to stream */
-		virtual void toStream(ostream& o) = 0;
-	};
-
-	/* A literal floating-point value. No operands */
-	class RPNValueElement : public RPNElement {
-	private:
-		double value;
-	public:
-		RPNValueElement(double value) 
-			: RPNElement(),
-			value(value) {
-				;
-		}
-
-		virtual void evaluate(EvaluationContext& ctx) {
-			//input floating-point values are just stacked in the output
-			ctx.pushOutput(value);
-		}
-
-		virtual void toStream(ostream& o) {
-			o << value;
-		}
-	};
-
-	class RPNFunction1ArgElement : public RPNElement {
-	private:
-		string name;
-		Function1Arg* func;
-	public:
-		RPNFunction1ArgElement(string name, Function1Arg* func) 
-			: name(name), func(func) {;}
-
-		virtual void evaluate(EvaluationContext& ctx) {
-			//1. pop function arg
-			//2. execute operation(operand1)
-			//3. push back the result
-			double arg1 = ctx.popOutput();
-			ctx.pushOutput(func->eval(arg1));
-		}
-
-		virtual void toStream(ostream& o) {
-			o << name;
-		}
-	};
-
-	/* Unary operator */
-	class RPNUnaryOperatorElement : public RPNElement  {
-	public:
-		RPNUnaryOperatorElement() : RPNElement() {
-		}
-		virtual void evaluate(EvaluationContext& ctx) {
-			//unary operation:
-			//1. pop operand1
-			//2. execute operation(operand1)
-			//3. push back the result
-			double operand = ctx.popOutput();
-			ctx.pushOutput(operation(operand));
-		}
-
-		/* GoF template method; inheriting classes implement just
-		the pure operation */
-		virtual double operation(double operand) = 0;
-	};
-
-	class RPNUnaryNegationElement : public RPNUnaryOperatorElement {
-	public:
-		RPNUnaryNegationElement() :RPNUnaryOperatorElement(){
-			;
-		}
-
-		virtual double operation(double operand) {
-			return -operand;
-		}
-
-		virtual void toStream(ostream& o) {
-			o << '~';
-		}
-	};
-
-	/* Binary operator */
-	class RPNBinaryOperatorElement : public RPNElement  {
-	public:
-		virtual void evaluate(EvaluationContext& ctx) {
-			//binary operation:
-			//1. pop operand2
-			//2. pop operand1
-			//3. execute operation(operand1, operand2)
-			//4. push back the result
-			double operand2 = ctx.popOutput();
-			double operand1 = ctx.popOutput();
-			ctx.pushOutput(operation(operand1, operand2));
-		}
-		/* GoF template method; inheriting classes implement just
-		the pure operation */
-		virtual double operation(double operand1, double operand2) = 0;
-	};
-
-	class RPNPlusElement : public RPNBinaryOperatorElement {
-	public:
-		RPNPlusElement() {;}
-		virtual double operation(double operand1, double operand2) {
-			return operand1+operand2;
-		}
-
-		virtual void toStream(ostream& o) {
-			o << '+';
-		}
-	};
-
-	class RPNMinusElement : public RPNBinaryOperatorElement {
-	public:
-		RPNMinusElement() {;}
-		virtual double operation(double operand1, double operand2) {
-			return operand1-operand2;
-		}
-
-		virtual void toStream(ostream& o) {
-			o << '-';
-		}
-	};
-
-	class RPNMulElement : public RPNBinaryOperatorElement {
-	public:
-		RPNMulElement() {;}
-		virtual double operation(double operand1, double operand2) {
-			return operand1*operand2;
-		}
-
-		virtual void toStream(ostream& o) {
-			o << '*';
-		}
-	};
-
-	class RPNDivElement : public RPNBinaryOperatorElement {
-	public:
-		RPNDivElement() {;}
-		virtual double operation(double operand1, double operand2) {
-			return operand1/operand2;
-		}
-
-		virtual void toStream(ostream& o) {
-			o << '/';
-		}
-	};
-
-	class RPNPowElement : public RPNBinaryOperatorElement {
-	public:
-		RPNPowElement() {;}
-		virtual double operation(double operand1, double operand2) {
-			return pow(operand1, operand2);
-		}
-
-		virtual void toStream(ostream& o) {
-			o << '^';
-		}
-	};
-
-	/* A variable which may be evaluated */
-	class RPNVariableElement : public RPNElement {
-	private:
-		string varName;
-	public:
-		RPNVariableElement(string varName)
-			: varName(varName) {
-				;
-		}
-
-		virtual void evaluate(EvaluationContext& ctx) {
-			//input variable - evaluate variable's value and stack in the output
-			ctx.pushOutput(ctx.getVariableValue());
-		}
-
-		virtual void toStream(ostream& o) {
-			o << varName;
-		}
-	};
-
-
-	/* Translate input from Lexer into a series RPNElements.*/
-	class Lexem2SymbolVisitor : public LexemVisitor {
-	private:
-		/* context value */
-		string variableName;
-		/* context value */
-		parser::FunctionLookupTable* functionLookupTable;
-		/* context value */
-		parser::ConstantLookupTable* constantLookupTable;
-		/* count symbols */
-		int symbolCounter;
-		/* result */
-		vector<RPNElement*> rpnSymbols;
-	public:
-		Lexem2SymbolVisitor(			
-			string variableName,
-			parser::FunctionLookupTable* functionLookupTable,
-			parser::ConstantLookupTable* constantLookupTable) 
-			: 
-		variableName(variableName),
-			functionLookupTable(functionLookupTable),
-			constantLookupTable(constantLookupTable),	
-			symbolCounter(1) {
-				;
-		}
-
-		vector<RPNElement*> getSymbols() {
-			return rpnSymbols;
-		}
-
-		virtual void visit(MinusLexem& minusLexem) {
-			rpnSymbols.push_back(new RPNMinusElement());
-		}
-
-		virtual void visit(PlusLexem& plusLexem) {
-			rpnSymbols.push_back(new RPNPlusElement());
-		}
-
-		virtual void visit(MulLexem& mulLexem) {
-			rpnSymbols.push_back(new RPNMulElement());
-		}
-
-		virtual void visit(DivLexem& divLexem) {
-			rpnSymbols.push_back(new RPNDivElement());
-		}
-
-		virtual void visit(CParenLexem& cParenLexem) {
-			throw StatementException("symbol not supported for RPN");
-		}
-
-		virtual void visit(OParenLexem& oParenLexem) {
-			throw StatementException("symbol not supported for RPN");
-		}
-
-		virtual void visit(TildeLexem& tildeLexem) {
-			rpnSymbols.push_back(new RPNUnaryNegationElement());
-		}
-
-		/* ~ 'tilde' is used to represent the unary negation */
-		virtual void visit(FloatLexem& floatLexem) {
-			rpnSymbols.push_back(new RPNValueElement(floatLexem.getValue()));
-		}
-
-
-		virtual void visit(DashLexem& floatLexem) {
-			rpnSymbols.push_back(new RPNPowElement());
-		}
-
-		virtual void visit(IdentifierLexem& identifierLexem) {
-			string id = identifierLexem.toString();
-			if (id == variableName) {
-				//the identifier represents simply the variable 
-				rpnSymbols.push_back(new RPNVariableElement(variableName));
-			} else {
-				RPNElement* el = NULL;
-				if (functionLookupTable != NULL
-					&& functionLookupTable->exists(id)) {
-						//if identifier corresponds to a function name
-						el = new RPNFunction1ArgElement(
-							id,
-							functionLookupTable->lookup(id));
-				}
-				if (el == NULL && constantLookupTable != NULL
-					&& constantLookupTable->exists(id)) {
-						//constant are at this stage translated to numerical values
-						el = new RPNValueElement(constantLookupTable->lookup(id));
-				}
-				if (el != NULL) {
-					rpnSymbols.push_back(el);
-				} else {
-					throw StatementException("illegal symbol. not a function, constant or variable");
-					//throw "illegal symbol. not a function, constant or variable";
-				}
-			} 
-		}
-	};
-
-	/* Translate AST tree into a series of RPNElements (each element
-	represents one symbol in the Reverse Polish Notation)*/
-	class Ast2RPNVisitor : public AstVisitor {
-	private:
-		/* context value */
-		string variableName;
-		/* context value */
-		parser::FunctionLookupTable* functionLookupTable;
-		/* context value */
-		parser::ConstantLookupTable* constantLookupTable;
-		/* count symbols */
-		int symbolCounter;
-		/* result */
-		vector<RPNElement*> rpnSymbols;
-	public:
-		Ast2RPNVisitor(			
-			string variableName,
-			parser::FunctionLookupTable* functionLookupTable,
-			parser::ConstantLookupTable* constantLookupTable) 
-			: 
-		variableName(variableName),
-			functionLookupTable(functionLookupTable),
-			constantLookupTable(constantLookupTable),	
-			symbolCounter(1) {
-				;
-		}
-
-		vector<RPNElement*> getSymbols() {
-			return rpnSymbols;
-		}
-
-		virtual void visit(FloatLiteralAstNode& floatLiteralNode) {
-			rpnSymbols.push_back(new RPNValueElement(floatLiteralNode.getLiteralValue()));
-		}
-
-		virtual void visit(VariableAstNode& variableNode) {
-			if (variableNode.getVarIdentifier() != variableName) {
-				throw StatementException(symbolCounter, string("unknown variable name"));
-			}
-			rpnSymbols.push_back(new RPNVariableElement(variableName));
-		}
-
-		virtual void visit(UnaryNegationAstNode& unaryNegationNode) {
-			rpnSymbols.push_back(new RPNUnaryNegationElement());
-		}
-
-		virtual void visit(AddOperatorAstNode& addOperatorNode) {
-			rpnSymbols.push_back(new RPNPlusElement());
-		}
-
-		virtual void visit(SubOperatorAstNode& subOperatorNode) {
-			rpnSymbols.push_back(new RPNMinusElement());
-		}
-
-		virtual void visit(MulOperatorAstNode& mulOperatorNode) {
-			rpnSymbols.push_back(new RPNMulElement());
-		}
-
-		virtual void visit(DivOperatorAstNode& divOperatorNode) {
-			rpnSymbols.push_back(new RPNDivElement());
-		}
-
-		virtual void visit(PowerOperatorAstNode& powerOperatorNode) {
-			rpnSymbols.push_back(new RPNPowElement());
-		}
-
-		virtual void visit(FunctionCall1ArgAstNode& funcCallNode) {
-			string funcName = funcCallNode.getFunctionName();
-			if (functionLookupTable->exists(funcName)) {
-				//check if function is defined
-				Function1Arg* func = functionLookupTable->lookup(funcName);
-				rpnSymbols.push_back(new RPNFunction1ArgElement(funcName, func));
-			} else {
-				throw StatementException(symbolCounter, string("unknown function " + funcName));
-			}
-		}
-
-		virtual void visit(ConstantAstNode& constantNode) {
-			rpnSymbols.push_back(new RPNValueElement(constantNode.getValue()));
-		}
-	};
-
-	Calculator::Calculator(
-		string variableName,
-		FunctionLookupTable* functionLookupTable,
-		ConstantLookupTable* constantLookupTable,
-		istream& inputStream)
-		:
-	variableName(variableName),
-		functionLookupTable(functionLookupTable),
-		constantLookupTable(constantLookupTable) {
-
-			constructFromStream(inputStream);
-	}
-
-	Calculator::Calculator(
-		string variableName,
-		FunctionLookupTable* functionLookupTable,
-		ConstantLookupTable* constantLookupTable,
-		parser::AstNode* ast) 
-		:
-	variableName(variableName),
-		functionLookupTable(functionLookupTable),
-		constantLookupTable(constantLookupTable) {
-
-			Ast2RPNVisitor visitor(variableName, 
-				functionLookupTable, 
-				constantLookupTable);
-
-			ast->visitPostOrder(visitor);
-
-			input = visitor.getSymbols();
-	}
-
-	Calculator::~Calculator() {
-		for (auto it = input.begin(); it != input.end(); ++it) {
-			delete (*it);
-		}
-	}
-
-	void Calculator::constructFromStream(std::istream& inputStream) {
-		Lexer lexer;
-		auto_ptr<Lexem> lexem;
-		Lexem2SymbolVisitor l2sVisitor(
-			this->variableName,
-			this->functionLookupTable,
-			this->constantLookupTable);
-
-		int symbolNo = 1;
-		//transform symbols into reverse-polish-notation objects
-		while ((lexem = lexer.next(inputStream)).get() != NULL) {
-			try {
-				lexem->accept(l2sVisitor);
-				symbolNo++;
-			} catch (StatementException& e) {
-				throw StatementException(symbolNo, e.whatStr());
-			}
-		}
-
-		//object-oriented representation of the chain of symbols
-		//in Reverse Polish Notation
-		//in the order left->right
-		this->input = l2sVisitor.getSymbols();
-
-
-	}
-
-	void Calculator::save(std::ostream& outputStream) {
-		int i = 0;
-		for (auto it = input.begin(); it != input.end(); ++it, ++i) {
-			//for each symbol, output to stream and separate using spaces
-			if (i > 0) {
-				outputStream << " ";
-			}
-			(*it)->toStream(outputStream);
-		}
-	}
-
-
-	double Calculator::calculate(double varValue) {
-		if (input.empty()) {
-			return 0.0;
-		}
-		EvaluationContext ctx(varValue);
-		/* for each symbol, call evaluation method, which is polymorphically
-		executed on each RPN-element (symbol) in a different manner*/
-		for (auto it = input.begin(); it != input.end(); ++it) {
-			(*it)->evaluate(ctx);
-			ctx.inc();
-		}
-		return ctx.getResult();
-	}
-
-
-	
-	/*** Some basic functions ***/
-
-	double FunctionIdentity::eval(double in) {
-		return in;
-	}
-
-	double FunctionSin::eval(double in) {
-		return sin(in);
-	}
-
-	double FunctionCos::eval(double in) {
-		return cos(in);
-	}
-
-	double FunctionExp::eval(double in) {
-		return exp(in);
-	}
-
-	double FunctionLog::eval(double in) {
-		return log(in);
-	}
-
-	/*** Standard lookup tables ***/
-
-	StdConstantLookupTable::StdConstantLookupTable() 
-	: ConstantLookupTable() {
-		add(string("ONE"), 1.0f);
-		add(string("ZERO"), 0.0f);
-		add(string("PI"), 3.1415926535897932384626433832795f);
-		add(string("E"), 2.7182818284590452353602874713527f);
-	}
-
-	StdFunctionLookupTable::StdFunctionLookupTable()
-		: FunctionLookupTable() {
-			add(string("sin"), new FunctionSin());
-			add(string("cos"), new FunctionCos());
-			add(string("exp"), new FunctionExp());
-			add(string("log"), new FunctionLog());
-	}
-
-	/*** End of Some basic functions ***/
-
-	StatementException::StatementException(string s) {
-		s = "Invalid statement: " + s; 
-	}
-
-	StatementException::StatementException(int symbolNo) {
-		stringstream sb;
-		sb << "Invalid statement at symbol no " << symbolNo; 
-		this->s = sb.str();
-	}
-
-	StatementException::StatementException(int symbolNo, string s) {
-		stringstream sb;
-		sb << "Invalid statement at symbol no " << symbolNo 
-			<< " " << s;
-		this->s = sb.str();
-	}
-
-	const char *StatementException::what() const {
-		return s.c_str();
-	}
-
-	std::string StatementException::whatStr() {
-		return s;
-	}
-}
-
+#include "stdafx.h"
+#include "Calculator.h"
+#include "Lexer.h"
+#include "Token.h"
+#include "TokenArray.h"
+#include "FloatConv.h"
+#include "Parser.h"
+#include "PrecedenceParser.h"
+#include "SharedAst.h"
+#include "Bytecode.h"
+#include <vector>
+#include <stack>
+#include <istream>
+#include <ostream>
+#include <cmath> //power
+#include <algorithm>
+#include <string>
+
+namespace calc {
+
+	using namespace std;
+	using namespace parser;
+
+	/* encapsulate values needed when evaluating */
+	class EvaluationContext {
+	private: 
+		/* current number of symbol processed (1-indexed)*/
+		int symbolNo;
+		/* stack used to evaluate according to RPN*/
+		std::stack<double> outStack;
+		/* (x) variable's value */
+		double variableValue;
+		/* values of the shared subexpressions */
+		std::vector<double> slots;
+	public:
+		EvaluationContext(double variableValue, int slotCount) 
+			: symbolNo(1), variableValue(variableValue), slots(slotCount) {
+				;
+		}
+
+		/* move forward by 1 symbol*/
+		void inc() {
+			++symbolNo;
+		}
+
+		double getVariableValue() {
+			return variableValue;
+		}
+
+		/* put output of evaluation to the stack*/
+		void pushOutput(double d) {
+			outStack.push(d);
+		}
+
+		/* pop one value from the stack*/
+		double popOutput() {
+			if (outStack.empty()) {
+				throw StatementException(symbolNo);
+			}
+			double el = outStack.top();
+			outStack.pop();
+			return el;
+		}
+
+		/* keep the value on the top of the stack in the slot */
+		void store(int slot) {
+			if (outStack.empty()) {
+				throw StatementException(symbolNo);
+			}
+			slots[slot] = outStack.top();
+		}
+
+		/* put the value kept in the slot to the stack */
+		void load(int slot) {
+			outStack.push(slots[slot]);
+		}
+
+		/* It is called only after evaluation ends; returns theresult of evaluation*/
+		double getResult() {
+			if (outStack.size() != 1) {
+				throw StatementException(symbolNo);
+			}
+			return outStack.top();
+		}
+	};
+
+	/* Element of a stack created to represent
+	Reverse Polish Notation.
+	Each subclass represents specialized element type. I chose such
+	approach, because I want to process inputs in a polymorphic way
+	and avoid having if(dynamic_casts<>)-like statements everywhere*/
+	class RPNElement {
+	public:
+		RPNElement() {;}
+		/* evaluate this operation */
+		virtual void evaluate(EvaluationContext& ctx) = 0;
+		/* save to stream */
+		virtual void toStream(ostream& o) = 0;
+		/* add the operations of this element to the bytecode */
+		virtual void assemble(Bytecode& code) = 0;
+		/* The elements (indexes first ... last - 1 of the program) saved
+		instead of this one; false - this one is saved by toStream*/
+		virtual bool getSavedRange(size_t& first, size_t& last) {
+			return false;
+		}
+	};
+
+	/* A literal floating-point value. No operands */
+	class RPNValueElement : public RPNElement {
+	private:
+		double value;
+	public:
+		RPNValueElement(double value) 
+			: RPNElement(),
+			value(value) {
+				;
+		}
+
+		virtual void evaluate(EvaluationContext& ctx) {
+			//input floating-point values are just stacked in the output
+			ctx.pushOutput(value);
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addValue(value);
+		}
+
+		virtual void toStream(ostream& o) {
+			//shortest text which is loaded back as the same value;
+			//Float lexems have no sign - a negative value is negated
+			char text[FLOAT_TEXT_SIZE];
+			size_t length = formatFloat(value, text);
+			if (text[0] == '-') {
+				o.write(text + 1, length - 1);
+				o << " ~";
+			} else {
+				o.write(text, length);
+			}
+		}
+	};
+
+	class RPNFunction1ArgElement : public RPNElement {
+	private:
+		/* interned function name */
+		int symbol;
+		Function1Arg* func;
+	public:
+		RPNFunction1ArgElement(int symbol, Function1Arg* func) 
+			: symbol(symbol), func(func) {;}
+
+		virtual void evaluate(EvaluationContext& ctx) {
+			//1. pop function arg
+			//2. execute operation(operand1)
+			//3. push back the result
+			double arg1 = ctx.popOutput();
+			ctx.pushOutput(func->eval(arg1));
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addCall(func);
+		}
+
+		virtual void toStream(ostream& o) {
+			o << symbolName(symbol);
+		}
+	};
+
+	/* Unary operator */
+	class RPNUnaryOperatorElement : public RPNElement  {
+	public:
+		RPNUnaryOperatorElement() : RPNElement() {
+		}
+		virtual void evaluate(EvaluationContext& ctx) {
+			//unary operation:
+			//1. pop operand1
+			//2. execute operation(operand1)
+			//3. push back the result
+			double operand = ctx.popOutput();
+			ctx.pushOutput(operation(operand));
+		}
+
+		/* GoF template method; inheriting classes implement just
+		the pure operation */
+		virtual double operation(double operand) = 0;
+	};
+
+	class RPNUnaryNegationElement : public RPNUnaryOperatorElement {
+	public:
+		RPNUnaryNegationElement() :RPNUnaryOperatorElement(){
+			;
+		}
+
+		virtual double operation(double operand) {
+			return -operand;
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addNegation();
+		}
+
+		virtual void toStream(ostream& o) {
+			o << '~';
+		}
+	};
+
+	/* Binary operator */
+	class RPNBinaryOperatorElement : public RPNElement  {
+	public:
+		virtual void evaluate(EvaluationContext& ctx) {
+			//binary operation:
+			//1. pop operand2
+			//2. pop operand1
+			//3. execute operation(operand1, operand2)
+			//4. push back the result
+			double operand2 = ctx.popOutput();
+			double operand1 = ctx.popOutput();
+			ctx.pushOutput(operation(operand1, operand2));
+		}
+		/* GoF template method; inheriting classes implement just
+		the pure operation */
+		virtual double operation(double operand1, double operand2) = 0;
+	};
+
+	class RPNPlusElement : public RPNBinaryOperatorElement {
+	public:
+		RPNPlusElement() {;}
+		virtual double operation(double operand1, double operand2) {
+			return operand1+operand2;
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addBinary(BC_ADD);
+		}
+
+		virtual void toStream(ostream& o) {
+			o << '+';
+		}
+	};
+
+	class RPNMinusElement : public RPNBinaryOperatorElement {
+	public:
+		RPNMinusElement() {;}
+		virtual double operation(double operand1, double operand2) {
+			return operand1-operand2;
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addBinary(BC_SUB);
+		}
+
+		virtual void toStream(ostream& o) {
+			o << '-';
+		}
+	};
+
+	class RPNMulElement : public RPNBinaryOperatorElement {
+	public:
+		RPNMulElement() {;}
+		virtual double operation(double operand1, double operand2) {
+			return operand1*operand2;
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addBinary(BC_MUL);
+		}
+
+		virtual void toStream(ostream& o) {
+			o << '*';
+		}
+	};
+
+	class RPNDivElement : public RPNBinaryOperatorElement {
+	public:
+		RPNDivElement() {;}
+		virtual double operation(double operand1, double operand2) {
+			return operand1/operand2;
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addBinary(BC_DIV);
+		}
+
+		virtual void toStream(ostream& o) {
+			o << '/';
+		}
+	};
+
+	class RPNPowElement : public RPNBinaryOperatorElement {
+	public:
+		RPNPowElement() {;}
+		virtual double operation(double operand1, double operand2) {
+			return pow(operand1, operand2);
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addBinary(BC_POWER);
+		}
+
+		virtual void toStream(ostream& o) {
+			o << '^';
+		}
+	};
+
+	/* A variable which may be evaluated */
+	class RPNVariableElement : public RPNElement {
+	private:
+		/* interned variable name */
+		int symbol;
+	public:
+		RPNVariableElement(int symbol)
+			: symbol(symbol) {
+				;
+		}
+
+		virtual void evaluate(EvaluationContext& ctx) {
+			//input variable - evaluate variable's value and stack in the output
+			ctx.pushOutput(ctx.getVariableValue());
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addVariable();
+		}
+
+		virtual void toStream(ostream& o) {
+			o << symbolName(symbol);
+		}
+	};
+
+
+	/* Keep the value of a shared subexpression in a slot, for the loads
+	of its other occurrences; the value stays on the stack*/
+	class RPNStoreElement : public RPNElement {
+	private:
+		int slot;
+	public:
+		RPNStoreElement(int slot)
+			: slot(slot) {
+				;
+		}
+
+		virtual void evaluate(EvaluationContext& ctx) {
+			ctx.store(slot);
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addStore(slot);
+		}
+
+		virtual void toStream(ostream& o) {
+		}
+
+		/* nothing is saved - the text has no slots */
+		virtual bool getSavedRange(size_t& first, size_t& last) {
+			first = last = 0;
+			return true;
+		}
+	};
+
+	/* Value of a shared subexpression, computed and stored before */
+	class RPNLoadElement : public RPNElement {
+	private:
+		int slot;
+		/* elements of the subexpression in the program */
+		size_t first;
+		size_t last;
+	public:
+		RPNLoadElement(int slot, size_t first, size_t last)
+			: slot(slot), first(first), last(last) {
+				;
+		}
+
+		virtual void evaluate(EvaluationContext& ctx) {
+			ctx.load(slot);
+		}
+
+		virtual void assemble(Bytecode& code) {
+			code.addLoad(slot);
+		}
+
+		virtual void toStream(ostream& o) {
+		}
+
+		/* the subexpression is saved again, as it was parsed */
+		virtual bool getSavedRange(size_t& first, size_t& last) {
+			first = this->first;
+			last = this->last;
+			return true;
+		}
+	};
+
+	/* Translate tokens from the lexer into a series RPNElements.*/
+	class Lexem2SymbolTranslator {
+	private:
+		/* context value - interned variable name */
+		int variableSymbol;
+		/* context value */
+		parser::FunctionLookupTable* functionLookupTable;
+		/* context value */
+		parser::ConstantLookupTable* constantLookupTable;
+		/* count symbols */
+		int symbolCounter;
+		/* result */
+		vector<RPNElement*> rpnSymbols;
+		/* why the last token was not translated; NULL if none */
+		const char* error;
+	public:
+		Lexem2SymbolTranslator(			
+			int variableSymbol,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable) 
+			: 
+		variableSymbol(variableSymbol),
+			functionLookupTable(functionLookupTable),
+			constantLookupTable(constantLookupTable),	
+			symbolCounter(1),
+			error(NULL) {
+				;
+		}
+
+		const char* getError() const {
+			return error;
+		}
+
+		vector<RPNElement*> getSymbols() {
+			return rpnSymbols;
+		}
+
+		/* Translate the token; ~ 'tilde' is used to represent the unary negation.
+		Returns: false if the token is not an RPN symbol (see getError)*/
+		bool add(const Token& token) {
+			switch (token.kind) {
+			case LK_FLOAT:
+				rpnSymbols.push_back(new RPNValueElement(token.value));
+				break;
+			case LK_IDENTIFIER:
+				//a name not interned (NO_SYMBOL) is not defined
+				return addIdentifier(token.symbol);
+			case LK_PLUS:
+				rpnSymbols.push_back(new RPNPlusElement());
+				break;
+			case LK_MINUS:
+				rpnSymbols.push_back(new RPNMinusElement());
+				break;
+			case LK_MUL:
+				rpnSymbols.push_back(new RPNMulElement());
+				break;
+			case LK_DIV:
+				rpnSymbols.push_back(new RPNDivElement());
+				break;
+			case LK_DASH:
+				rpnSymbols.push_back(new RPNPowElement());
+				break;
+			case LK_TILDE:
+				rpnSymbols.push_back(new RPNUnaryNegationElement());
+				break;
+			default:
+				error = "symbol not supported for RPN";
+				return false;
+			}
+			return true;
+		}
+
+		/* identifier is the variable, a function or a constant */
+		bool addIdentifier(int symbol) {
+			if (symbol == variableSymbol) {
+				//the identifier represents simply the variable 
+				rpnSymbols.push_back(new RPNVariableElement(variableSymbol));
+			} else {
+				RPNElement* el = NULL;
+				Function1Arg* func;
+				double value;
+				if (functionLookupTable != NULL
+					&& functionLookupTable->find(symbol, func)) {
+						//if identifier corresponds to a function name
+						el = new RPNFunction1ArgElement(symbol, func);
+				}
+				if (el == NULL && constantLookupTable != NULL
+					&& constantLookupTable->find(symbol, value)) {
+						//constant are at this stage translated to numerical values
+						el = new RPNValueElement(value);
+				}
+				if (el == NULL) {
+					error = "illegal symbol. not a function, constant or variable";
+					return false;
+				}
+				rpnSymbols.push_back(el);
+			} 
+			return true;
+		}
+	};
+
+	/* Translate AST tree into a series of RPNElements (each element
+	represents one symbol in the Reverse Polish Notation)*/
+	class Ast2RPNVisitor : public AstVisitor {
+	private:
+		/* context value - interned variable name */
+		int variableSymbol;
+		/* context value */
+		parser::FunctionLookupTable* functionLookupTable;
+		/* context value */
+		parser::ConstantLookupTable* constantLookupTable;
+		/* count symbols */
+		int symbolCounter;
+		/* result */
+		vector<RPNElement*> rpnSymbols;
+	public:
+		Ast2RPNVisitor(			
+			int variableSymbol,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable) 
+			: 
+		variableSymbol(variableSymbol),
+			functionLookupTable(functionLookupTable),
+			constantLookupTable(constantLookupTable),	
+			symbolCounter(1) {
+				;
+		}
+
+		vector<RPNElement*> getSymbols() {
+			return rpnSymbols;
+		}
+
+		virtual void visit(FloatLiteralAstNode& floatLiteralNode) {
+			rpnSymbols.push_back(new RPNValueElement(floatLiteralNode.getLiteralValue()));
+		}
+
+		virtual void visit(VariableAstNode& variableNode) {
+			if (variableNode.getSymbol() != variableSymbol) {
+				throw StatementException(symbolCounter, string("unknown variable name"));
+			}
+			rpnSymbols.push_back(new RPNVariableElement(variableSymbol));
+		}
+
+		virtual void visit(UnaryNegationAstNode& unaryNegationNode) {
+			rpnSymbols.push_back(new RPNUnaryNegationElement());
+		}
+
+		virtual void visit(AddOperatorAstNode& addOperatorNode) {
+			rpnSymbols.push_back(new RPNPlusElement());
+		}
+
+		virtual void visit(SubOperatorAstNode& subOperatorNode) {
+			rpnSymbols.push_back(new RPNMinusElement());
+		}
+
+		virtual void visit(MulOperatorAstNode& mulOperatorNode) {
+			rpnSymbols.push_back(new RPNMulElement());
+		}
+
+		virtual void visit(DivOperatorAstNode& divOperatorNode) {
+			rpnSymbols.push_back(new RPNDivElement());
+		}
+
+		virtual void visit(PowerOperatorAstNode& powerOperatorNode) {
+			rpnSymbols.push_back(new RPNPowElement());
+		}
+
+		virtual void visit(FunctionCall1ArgAstNode& funcCallNode) {
+			int symbol = funcCallNode.getSymbol();
+			Function1Arg* func;
+			if (functionLookupTable->find(symbol, func)) {
+				//check if function is defined
+				rpnSymbols.push_back(new RPNFunction1ArgElement(symbol, func));
+			} else {
+				throw StatementException(symbolCounter, string("unknown function " + symbolName(symbol)));
+			}
+		}
+
+		virtual void visit(ConstantAstNode& constantNode) {
+			rpnSymbols.push_back(new RPNValueElement(constantNode.getValue()));
+		}
+	};
+
+	/* Translate the nodes given by the parser straight into RPNElements,
+	the same ones as Ast2RPNVisitor creates. The parser gives them in
+	post-order, which is the order of the RPN, so each node becomes an
+	element at once; the node numbers are the indexes of the elements*/
+	class RPNCompiler : public PostOrderBuilder {
+	private:
+		/* context value - interned variable name */
+		int variableSymbol;
+		/* an unknown variable was found */
+		bool unknownVariable;
+		/* result; owned until taken */
+		vector<RPNElement*> rpnSymbols;
+
+		int add(RPNElement* element) {
+			rpnSymbols.push_back(element);
+			return (int)rpnSymbols.size() - 1;
+		}
+	public:
+		RPNCompiler(int variableSymbol)
+			: variableSymbol(variableSymbol)
+			, unknownVariable(false) {
+		}
+
+		virtual ~RPNCompiler() {
+			for (auto it = rpnSymbols.begin(); it != rpnSymbols.end(); ++it) {
+				delete (*it);
+			}
+		}
+
+		/* reserve room for the elements of the tokens (never more) */
+		void reserve(size_t tokenCount) {
+			rpnSymbols.reserve(tokenCount);
+		}
+
+		/* Set the StatementException of the AST translated by
+		Ast2RPNVisitor - only once the whole expression is parsed, so
+		syntax errors come first.
+		Returns: false on an error*/
+		bool check(Status& status) {
+			if (unknownVariable) {
+				status.setStatementError(1, "unknown variable name");
+				return false;
+			}
+			return true;
+		}
+
+		/* number of the elements - index of the next one */
+		size_t size() const {
+			return rpnSymbols.size();
+		}
+
+		/* add the element of the node of the flat tree */
+		int addNode(const FlatAst& ast, int node) {
+			FlatOpcode opcode = ast.getOpcode(node);
+			switch (opcode) {
+			case FO_FLOAT:
+				return addFloat(ast.getValue(node));
+			case FO_VARIABLE:
+				return addVariable(ast.getSymbol(node));
+			case FO_CONSTANT:
+				return addConstant(ast.getSymbol(node), ast.getValue(node));
+			case FO_NEGATION:
+				return addNegation(ast.getLeft(node));
+			case FO_CALL:
+				return addCall(ast.getSymbol(node), ast.getFunction(node), ast.getLeft(node));
+			default:
+				return addBinary(opcode, ast.getLeft(node), ast.getRight(node));
+			}
+		}
+
+		void addStore(int slot) {
+			add(new RPNStoreElement(slot));
+		}
+
+		/* the value of the elements first ... last - 1, stored before */
+		void addLoad(int slot, size_t first, size_t last) {
+			add(new RPNLoadElement(slot, first, last));
+		}
+
+		/* the result; the caller owns the elements */
+		vector<RPNElement*> takeSymbols() {
+			vector<RPNElement*> symbols;
+			symbols.swap(rpnSymbols);
+			return symbols;
+		}
+
+		virtual int addFloat(double value) {
+			return add(new RPNValueElement(value));
+		}
+
+		virtual int addVariable(int symbol) {
+			if (symbol != variableSymbol) {
+				unknownVariable = true;
+			}
+			return add(new RPNVariableElement(variableSymbol));
+		}
+
+		virtual int addConstant(int symbol, double value) {
+			return add(new RPNValueElement(value));
+		}
+
+		virtual int addNegation(int arg) {
+			return add(new RPNUnaryNegationElement());
+		}
+
+		virtual int addBinary(FlatOpcode opcode, int left, int right) {
+			switch (opcode) {
+			case FO_ADD:
+				return add(new RPNPlusElement());
+			case FO_SUB:
+				return add(new RPNMinusElement());
+			case FO_MUL:
+				return add(new RPNMulElement());
+			case FO_DIV:
+				return add(new RPNDivElement());
+			case FO_POWER:
+				return add(new RPNPowElement());
+			default:
+				//should not occur
+				throw "illegal state";
+			}
+		}
+
+		virtual int addCall(int symbol, Function1Arg* function, int arg) {
+			//the parser has looked the function up already
+			return add(new RPNFunction1ArgElement(symbol, function));
+		}
+
+		virtual int addReference(int value) {
+			//let expressions are compiled from the DAG (see compile)
+			throw "illegal state";
+		}
+
+		virtual int endScope(int value, int body) {
+			throw "illegal state";
+		}
+	};
+
+	/* Translate the DAG built by SharedAstBuilder: the first use of a
+	node used more than once evaluates it and keeps the value in a slot
+	(RPNStoreElement), the other uses load the value (RPNLoadElement).
+	The slot is freed after the last use and reused by the next shared
+	node. Leaves are as cheap to push as to load - they are never kept.
+
+	The nodes are emitted in the order of the tree (a depth-first walk
+	from the root), with an explicit stack - any depth is translated.
+	eliminatedCount is the number of the operations of the tree the loads
+	replace (as many as size_t holds).
+	Returns: number of the slots*/
+	static int compileShared(const FlatAst& dag, int root, const vector<int>& uses, RPNCompiler& compiler,
+		size_t& eliminatedCount) {
+
+		//operations of the tree of each node - the arguments come first
+		vector<size_t> operations(dag.size(), 0);
+		for (int node = 0; node <= root; node++) {
+			FlatOpcode opcode = dag.getOpcode(node);
+			if (opcode == FO_FLOAT || opcode == FO_VARIABLE || opcode == FO_CONSTANT) {
+				continue;
+			}
+			size_t count = operations[dag.getLeft(node)];
+			if (opcode != FO_NEGATION && opcode != FO_CALL) {
+				size_t right = operations[dag.getRight(node)];
+				count = (count > (size_t)-1 - right) ? (size_t)-1 : count + right;
+			}
+			operations[node] = (count == (size_t)-1) ? count : count + 1;
+		}
+		eliminatedCount = 0;
+		//slot of a node stored, uses left and its elements
+		vector<int> slotOfNode(dag.size(), -1);
+		vector<int> usesLeft(dag.size(), 0);
+		vector<size_t> firstElement(dag.size(), 0);
+		vector<size_t> lastElement(dag.size(), 0);
+		vector<int> freeSlots;
+		int slotCount = 0;
+		//a node to emit, or ~node - its arguments are emitted already
+		vector<int> work;
+		work.push_back(root);
+		while (!work.empty()) {
+			int item = work.back();
+			work.pop_back();
+			if (item < 0) {
+				int node = ~item;
+				compiler.addNode(dag, node);
+				if (uses[node] > 1) {
+					int slot;
+					if (freeSlots.empty()) {
+						slot = slotCount++;
+					} else {
+						slot = freeSlots.back();
+						freeSlots.pop_back();
+					}
+					lastElement[node] = compiler.size();
+					compiler.addStore(slot);
+					slotOfNode[node] = slot;
+					usesLeft[node] = uses[node] - 1;
+				}
+				continue;
+			}
+			int slot = slotOfNode[item];
+			if (slot >= 0) {
+				compiler.addLoad(slot, firstElement[item], lastElement[item]);
+				size_t replaced = operations[item];
+				eliminatedCount = (eliminatedCount > (size_t)-1 - replaced) ? (size_t)-1 : eliminatedCount + replaced;
+				if (--usesLeft[item] == 0) {
+					freeSlots.push_back(slot);
+				}
+				continue;
+			}
+			FlatOpcode opcode = dag.getOpcode(item);
+			if (opcode == FO_FLOAT || opcode == FO_VARIABLE || opcode == FO_CONSTANT) {
+				compiler.addNode(dag, item);
+				continue;
+			}
+			firstElement[item] = compiler.size();
+			work.push_back(~item);
+			//the left argument is emitted first
+			if (opcode != FO_NEGATION && opcode != FO_CALL) {
+				work.push_back(dag.getRight(item));
+			}
+			work.push_back(dag.getLeft(item));
+		}
+		return slotCount;
+	}
+
+	/* throw the exception of the error in the status; nothing if ok */
+	static void raiseError(const Status& status) {
+		if (status.getKind() == Status::ST_STATEMENT_ERROR) {
+			string text = status.getText();
+			if (text.empty()) {
+				throw StatementException(status.getSymbolNo());
+			}
+			throw StatementException(status.getSymbolNo(), text);
+		}
+		status.raise();
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		istream& inputStream)
+		:
+	variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+
+			Status status;
+			if (!constructFromStream(inputStream, status)) {
+				raiseError(status);
+			}
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		parser::AstNode* ast) 
+		:
+	variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+
+			Ast2RPNVisitor visitor(variableSymbol, 
+				functionLookupTable, 
+				constantLookupTable);
+
+			ast->visitPostOrder(visitor);
+
+			input = visitor.getSymbols();
+			assemble();
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const FlatAst& ast) 
+		:
+	variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+
+			Ast2RPNVisitor visitor(variableSymbol, 
+				functionLookupTable, 
+				constantLookupTable);
+
+			//the same visitor - a linear scan of the nodes
+			ast.visitPostOrder(visitor);
+
+			input = visitor.getSymbols();
+			assemble();
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const SourceBuffer& source)
+		:
+	variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+
+			Status status;
+			if (!constructFromSource(source, status)) {
+				raiseError(status);
+			}
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const TokenArray& tokens)
+		:
+	variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+
+			Status status;
+			if (!constructFromTokens(tokens, status)) {
+				raiseError(status);
+			}
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const vector<RPNElement*>& input)
+		:
+	input(input),
+		variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+
+			assemble();
+	}
+
+	Calculator::Calculator(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable)
+		:
+	variableName(variableName),
+		variableSymbol(internSymbol(variableName)),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		slotCount(0),
+		eliminatedCount(0) {
+	}
+
+	auto_ptr<Calculator> Calculator::create(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		istream& inputStream,
+		Status& status) {
+
+			auto_ptr<Calculator> calculator(new Calculator(variableName,
+				functionLookupTable, constantLookupTable));
+			if (!calculator->constructFromStream(inputStream, status)) {
+				return auto_ptr<Calculator>();
+			}
+			return calculator;
+	}
+
+	auto_ptr<Calculator> Calculator::create(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const SourceBuffer& source,
+		Status& status) {
+
+			auto_ptr<Calculator> calculator(new Calculator(variableName,
+				functionLookupTable, constantLookupTable));
+			if (!calculator->constructFromSource(source, status)) {
+				return auto_ptr<Calculator>();
+			}
+			return calculator;
+	}
+
+	auto_ptr<Calculator> Calculator::create(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const TokenArray& tokens,
+		Status& status) {
+
+			auto_ptr<Calculator> calculator(new Calculator(variableName,
+				functionLookupTable, constantLookupTable));
+			if (!calculator->constructFromTokens(tokens, status)) {
+				return auto_ptr<Calculator>();
+			}
+			return calculator;
+	}
+
+	/* The expression has let bindings - Assign is a part of a let only -
+	or calls a function defined by an expression, which is inlined: the
+	argument is bound to the parameter*/
+	static bool hasBindings(const TokenArray& tokens, FunctionLookupTable* functionLookupTable) {
+		Function1Arg* function;
+		for (size_t i = 0; i < tokens.size(); i++) {
+			LexemKind kind = tokens.getKind(i);
+			if (kind == LK_ASSIGN) {
+				return true;
+			}
+			if (kind == LK_IDENTIFIER && functionLookupTable != NULL
+				&& functionLookupTable->find(tokens.getSymbol(i), function)
+				&& function->getDefinition() != NULL) {
+					return true;
+			}
+		}
+		return false;
+	}
+
+	auto_ptr<Calculator> Calculator::compile(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const SourceBuffer& source,
+		bool shareSubexpressions) {
+
+			Status status;
+			auto_ptr<Calculator> calculator = compile(variableName,
+				functionLookupTable, constantLookupTable, source, status, shareSubexpressions);
+			raiseError(status);
+			return calculator;
+	}
+
+	auto_ptr<Calculator> Calculator::compile(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const TokenArray& tokens,
+		bool shareSubexpressions) {
+
+			Status status;
+			auto_ptr<Calculator> calculator = compile(variableName,
+				functionLookupTable, constantLookupTable, tokens, status, shareSubexpressions);
+			raiseError(status);
+			return calculator;
+	}
+
+	auto_ptr<Calculator> Calculator::compile(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const SourceBuffer& source,
+		Status& status,
+		bool shareSubexpressions) {
+
+			TokenArray tokens;
+			if (!tokens.tokenize(source, status)) {
+				return auto_ptr<Calculator>();
+			}
+			return compile(variableName, functionLookupTable, constantLookupTable, tokens,
+				status, shareSubexpressions);
+	}
+
+	auto_ptr<Calculator> Calculator::compile(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const TokenArray& tokens,
+		Status& status,
+		bool shareSubexpressions) {
+
+			RPNCompiler compiler(internSymbol(variableName));
+			//one element per token at most
+			compiler.reserve(tokens.size());
+			PrecedenceParser parser(tokens, constantLookupTable, functionLookupTable);
+			parser.begin();
+			//the value of a binding is computed once - kept in a slot
+			//as a shared subexpression
+			if (!shareSubexpressions && !hasBindings(tokens, functionLookupTable)) {
+				if (!parser.expr(compiler, status) || !compiler.check(status)) {
+					return auto_ptr<Calculator>();
+				}
+				return auto_ptr<Calculator>(new Calculator(variableName,
+					functionLookupTable, constantLookupTable, compiler.takeSymbols()));
+			}
+			FlatAst dag;
+			SharedAstBuilder builder(dag);
+			int root;
+			if (!parser.expr(builder, root, status)) {
+				return auto_ptr<Calculator>();
+			}
+			vector<int> uses;
+			builder.countUses(root, uses);
+			size_t eliminatedCount;
+			int slotCount = compileShared(dag, root, uses, compiler, eliminatedCount);
+			if (!compiler.check(status)) {
+				return auto_ptr<Calculator>();
+			}
+			auto_ptr<Calculator> calculator(new Calculator(variableName,
+				functionLookupTable, constantLookupTable, compiler.takeSymbols()));
+			calculator->slotCount = slotCount;
+			calculator->eliminatedCount = eliminatedCount;
+			return calculator;
+	}
+
+	Calculator::~Calculator() {
+		for (auto it = input.begin(); it != input.end(); ++it) {
+			delete (*it);
+		}
+	}
+
+	bool Calculator::constructFromStream(std::istream& inputStream, Status& status) {
+		TokenArray tokens;
+		return tokens.tokenize(inputStream, status)
+			&& constructFromTokens(tokens, status);
+	}
+
+	bool Calculator::constructFromSource(const SourceBuffer& source, Status& status) {
+		TokenArray tokens;
+		return tokens.tokenize(source, status)
+			&& constructFromTokens(tokens, status);
+	}
+
+	bool Calculator::constructFromTokens(const TokenArray& tokens, Status& status) {
+		status.clear();
+		Lexem2SymbolTranslator translator(
+			this->variableSymbol,
+			this->functionLookupTable,
+			this->constantLookupTable);
+
+		int symbolNo = 1;
+		//transform symbols into reverse-polish-notation objects;
+		//the last token is LK_EOF
+		size_t count = tokens.size() - 1;
+		for (size_t i = 0; i < count; i++) {
+			if (!translator.add(tokens.getToken(i))) {
+				//the calculator is not created - delete the elements
+				vector<RPNElement*> symbols = translator.getSymbols();
+				for (auto it = symbols.begin(); it != symbols.end(); ++it) {
+					delete (*it);
+				}
+				status.setStatementError(symbolNo, translator.getError());
+				return false;
+			}
+			symbolNo++;
+		}
+
+		//object-oriented representation of the chain of symbols
+		//in Reverse Polish Notation
+		//in the order left->right
+		this->input = translator.getSymbols();
+		return assemble(status);
+	}
+
+	void Calculator::save(std::ostream& outputStream) const {
+		int written = 0;
+		saveElements(outputStream, 0, input.size(), written);
+	}
+
+	void Calculator::saveElements(std::ostream& outputStream, size_t first, size_t last, int& written) const {
+		for (size_t i = first; i < last; i++) {
+			//a shared subexpression is saved at each use
+			size_t savedFirst, savedLast;
+			if (input[i]->getSavedRange(savedFirst, savedLast)) {
+				saveElements(outputStream, savedFirst, savedLast, written);
+				continue;
+			}
+			//for each symbol, output to stream and separate using spaces
+			if (written > 0) {
+				outputStream << " ";
+			}
+			input[i]->toStream(outputStream);
+			written++;
+		}
+	}
+
+
+	void Calculator::assemble() {
+		Status status;
+		if (!assemble(status)) {
+			raiseError(status);
+		}
+	}
+
+	bool Calculator::assemble(Status& status) {
+		code.clear();
+		for (auto it = input.begin(); it != input.end(); ++it) {
+			(*it)->assemble(code);
+		}
+		if (input.empty()) {
+			//the value of the empty program
+			code.addValue(0.0);
+		}
+		if (!code.end()) {
+			//the error the elements would throw when they get to it;
+			//the calculator is not created - it doesn't own them
+			for (auto it = input.begin(); it != input.end(); ++it) {
+				delete (*it);
+			}
+			input.clear();
+			status.setStatementError(code.getErrorSymbolNo());
+			return false;
+		}
+		return true;
+	}
+
+	void Calculator::reassemble(int first, int removed, int added) {
+		Bytecode part;
+		for (int i = first; i < first + added; i++) {
+			input[i]->assemble(part);
+		}
+		//the pools are compacted by assembling the whole program, once
+		//they keep more unused entries than the stream has operations
+		if (!code.replace(first, removed, part) || code.getUnusedCount() > code.size()) {
+			assemble();
+		}
+	}
+
+	/*
+	Technological note:
+	the program was verified when created - the stack never overflows
+	nor underflows, nothing is checked. A program of common depth
+	runs on the native stack; only a deeper one allocates its stack,
+	unless the caller gives it*/
+	double Calculator::calculate(double varValue) const {
+		size_t size = getStackSize();
+		if (size <= CALCULATE_STACK_SIZE) {
+			double stack[CALCULATE_STACK_SIZE];
+			return calculate(varValue, stack);
+		}
+		vector<double> stack(size);
+		return calculate(varValue, stack.data());
+	}
+
+	double Calculator::calculate(double varValue, double* stack) const {
+		return code.run(varValue, stack, stack + code.getMaxDepth());
+	}
+
+	void Calculator::calculate(const double* xs, double* ys, size_t n) const {
+		//the columns of the stack and the slots of a block
+		vector<double> columns((code.getMaxDepth() + slotCount) * CALCULATE_BLOCK_SIZE);
+		double* slots = columns.data() + code.getMaxDepth() * CALCULATE_BLOCK_SIZE;
+		for (size_t first = 0; first < n; first += CALCULATE_BLOCK_SIZE) {
+			size_t count = min(CALCULATE_BLOCK_SIZE, n - first);
+			code.runBlock(xs + first, ys + first, count, columns.data(), slots);
+		}
+	}
+
+	void Calculator::calculate(double x0, double dx, double* ys, size_t n) const {
+		double xs[CALCULATE_BLOCK_SIZE];
+		vector<double> columns((code.getMaxDepth() + slotCount) * CALCULATE_BLOCK_SIZE);
+		double* slots = columns.data() + code.getMaxDepth() * CALCULATE_BLOCK_SIZE;
+		for (size_t first = 0; first < n; first += CALCULATE_BLOCK_SIZE) {
+			size_t count = min(CALCULATE_BLOCK_SIZE, n - first);
+			for (size_t i = 0; i < count; i++) {
+				xs[i] = x0 + dx * (double)(first + i);
+			}
+			code.runBlock(xs, ys + first, count, columns.data(), slots);
+		}
+	}
+
+	double Calculator::calculateByElements(double varValue) const {
+		if (input.empty()) {
+			return 0.0;
+		}
+		EvaluationContext ctx(varValue, slotCount);
+		/* for each symbol, call evaluation method, which is polymorphically
+		executed on each RPN-element (symbol) in a different manner*/
+		for (auto it = input.begin(); it != input.end(); ++it) {
+			(*it)->evaluate(ctx);
+			ctx.inc();
+		}
+		return ctx.getResult();
+	}
+
+
+	/*** RPNPushReader ***/
+
+	RPNPushReader::RPNPushReader(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable)
+		:
+	variableName(variableName),
+		functionLookupTable(functionLookupTable),
+		constantLookupTable(constantLookupTable),
+		symbolNo(1) {
+
+			translator = new Lexem2SymbolTranslator(
+				internSymbol(variableName),
+				functionLookupTable,
+				constantLookupTable);
+	}
+
+	RPNPushReader::~RPNPushReader() {
+		if (translator != NULL) {
+			//the calculator was not created - delete the elements
+			vector<RPNElement*> symbols = translator->getSymbols();
+			for (auto it = symbols.begin(); it != symbols.end(); ++it) {
+				delete (*it);
+			}
+			delete translator;
+		}
+	}
+
+	void RPNPushReader::push(const char* data, size_t length) {
+		lexer.push(data, length, *this);
+	}
+
+	auto_ptr<Calculator> RPNPushReader::finish() {
+		lexer.finish(*this);
+		if (translator == NULL) {
+			throw "illegal state";
+		}
+		//the calculator owns the elements, or deletes them if the
+		//program is not valid
+		vector<RPNElement*> symbols = translator->getSymbols();
+		delete translator;
+		translator = NULL;
+		return auto_ptr<Calculator>(new Calculator(variableName,
+			functionLookupTable, constantLookupTable, symbols));
+	}
+
+	void RPNPushReader::token(const Token& token, int lineNo, int charNo) {
+		if (token.kind == LK_EOF) {
+			return;
+		}
+		//same numbering of symbols as when the whole text is read
+		if (!translator->add(token)) {
+			throw StatementException(symbolNo, translator->getError());
+		}
+		symbolNo++;
+	}
+
+	/*** End of RPNPushReader ***/
+
+	/*** IncrementalCompiler ***/
+
+	IncrementalCompiler::IncrementalCompiler(
+		string variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable)
+		: parser(constantLookupTable, functionLookupTable)
+		, variableSymbol(internSymbol(variableName))
+		, calculator(new Calculator(variableName, functionLookupTable, constantLookupTable,
+			vector<RPNElement*>()))
+		, unknownCount(0)
+		, compiled(false) {
+	}
+
+	void IncrementalCompiler::compile(const string& text) {
+		compiled = false;
+		parser.parse(text.data(), text.size());
+		update();
+	}
+
+	void IncrementalCompiler::edit(size_t offset, size_t removedLength, const string& inserted) {
+		compiled = false;
+		parser.edit(offset, removedLength, inserted.data(), inserted.size());
+		update();
+	}
+
+	void IncrementalCompiler::update() {
+		const FlatAst& ast = parser.getAst();
+		int first = parser.getChangedNode();
+		int removed = parser.getRemovedNodes();
+		int added = parser.getAddedNodes();
+
+		//the elements of the new nodes - the same as compile creates
+		RPNCompiler compiler(variableSymbol);
+		compiler.reserve(added);
+		vector<unsigned char> unknown(added, 0);
+		for (int i = 0; i < added; i++) {
+			int node = first + i;
+			compiler.addNode(ast, node);
+			if (ast.getOpcode(node) == FO_VARIABLE && ast.getSymbol(node) != variableSymbol) {
+				unknown[i] = 1;
+				unknownCount++;
+			}
+		}
+		vector<RPNElement*> elements = compiler.takeSymbols();
+
+		vector<RPNElement*>& input = calculator->input;
+		for (int i = first; i < first + removed; i++) {
+			delete input[i];
+			unknownCount -= unknownVariables[i];
+		}
+		input.erase(input.begin() + first, input.begin() + first + removed);
+		input.insert(input.begin() + first, elements.begin(), elements.end());
+		calculator->reassemble(first, removed, added);
+		unknownVariables.erase(unknownVariables.begin() + first, unknownVariables.begin() + first + removed);
+		unknownVariables.insert(unknownVariables.begin() + first, unknown.begin(), unknown.end());
+
+		//as RPNCompiler::check
+		if (unknownCount > 0) {
+			throw StatementException(1, string("unknown variable name"));
+		}
+		compiled = true;
+	}
+
+	/*** End of IncrementalCompiler ***/
+	
+	/*** Some basic functions ***/
+
+	double FunctionIdentity::eval(double in) {
+		return in;
+	}
+
+	double FunctionSin::eval(double in) {
+		return sin(in);
+	}
+
+	double FunctionCos::eval(double in) {
+		return cos(in);
+	}
+
+	double FunctionExp::eval(double in) {
+		return exp(in);
+	}
+
+	double FunctionLog::eval(double in) {
+		return log(in);
+	}
+
+	/*** Standard lookup tables ***/
+
+	static FunctionSin builtinSin;
+	static FunctionCos builtinCos;
+	static FunctionExp builtinExp;
+	static FunctionLog builtinLog;
+
+	/* the standard constants and functions by their builtin symbols,
+	in the order of BuiltinSymbol; initialized by the compiler*/
+	static const BuiltinElements<double> builtinConstants = {
+		{ false, false, false, false, false, true, true, true, true, false, false },
+		{ 0.0, 0.0, 0.0, 0.0, 0.0,
+		1.0f, 0.0f, 3.1415926535897932384626433832795f, 2.7182818284590452353602874713527f,
+		0.0, 0.0 }
+	};
+
+	static const BuiltinElements<Function1Arg*> builtinFunctions = {
+		{ false, true, true, true, true, false, false, false, false, false, false },
+		{ NULL, &builtinSin, &builtinCos, &builtinExp, &builtinLog, NULL, NULL, NULL, NULL, NULL, NULL }
+	};
+
+	StdConstantLookupTable::StdConstantLookupTable() 
+	: ConstantLookupTable(&builtinConstants) {
+	}
+
+	StdFunctionLookupTable::StdFunctionLookupTable()
+		: FunctionLookupTable(&builtinFunctions) {
+	}
+
+	/*** End of Some basic functions ***/
+
+	StatementException::StatementException(string s) {
+		s = "Invalid statement: " + s; 
+	}
+
+	StatementException::StatementException(int symbolNo) {
+		stringstream sb;
+		sb << "Invalid statement at symbol no " << symbolNo; 
+		this->s = sb.str();
+	}
+
+	StatementException::StatementException(int symbolNo, string s) {
+		stringstream sb;
+		sb << "Invalid statement at symbol no " << symbolNo 
+			<< " " << s;
+		this->s = sb.str();
+	}
+
+	const char *StatementException::what() const {
+		return s.c_str();
+	}
+
+	std::string StatementException::whatStr() {
+		return s;
+	}
+}
+
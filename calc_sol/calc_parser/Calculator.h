@@ -1,106 +1,419 @@
-#ifndef CALCULATOR_H
-#define CALCULATOR_H
-
-#include "Parser.h"
-#include <istream>
-#include <ostream>
-#include <vector>
-#include <exception>
-#include <string>
-#include <exception>
-
-namespace calc {
-
-
-	/* report all calculation exceptions */
-	class StatementException : public std::exception {
-	private:
-		int symbolNo;
-		std::string s;
-	public:
-		StatementException(std::string s);
-		StatementException(int symbolNo);
-		StatementException(int symbolNo, std::string s);
-		virtual const char *what() const;
-		std::string whatStr();
-	};
-
-	/* forward declaration */
-	class RPNElement;
-
-	/* Calculator to evaluate expressions using the Reverse Polish Notation.
-	Instance of this class is either created using the RPN Notation (string)
-	or using AST tree resulting from parsing.*/
-	class Calculator {
-	private:
-			std::vector<RPNElement*> input;
-			std::string variableName;
-			parser::FunctionLookupTable* functionLookupTable;
-			parser::ConstantLookupTable* constantLookupTable;
-			void constructFromStream(std::istream& inputStream);
-	public:
-		/* create from AST*/
-		Calculator(
-			std::string variableName,
-			parser::FunctionLookupTable* functionLookupTable,
-			parser::ConstantLookupTable* constantLookupTable,
-			parser::AstNode* ast);
-		/* read the stream in the RPN notation and create*/
-		Calculator(
-			std::string variableName,
-			parser::FunctionLookupTable* functionLookupTable,
-			parser::ConstantLookupTable* constantLookupTable,
-			std::istream& inputStream);
-		virtual ~Calculator();
-		/* Save current input as RPN in the stream*/
-		void save(std::ostream& outputStream);
-		double calculate(double varValue);
-	};
-
-	/*** Some basic functions ***/
-
-	/* identity function */
-	class FunctionIdentity : public parser::Function1Arg {
-	public:
-		virtual double eval(double in);
-	};
-
-	/* sin(x) */
-	class FunctionSin : public parser::Function1Arg {
-	public:
-		virtual double eval(double in);
-	};
-
-	/* cos(x) */
-	class FunctionCos : public parser::Function1Arg {
-	public:
-		virtual double eval(double in);
-	};
-
-	/* exp(x) */
-	class FunctionExp : public parser::Function1Arg {
-	public:
-		virtual double eval(double in);
-	};
-
-	/* log(x) */
-	class FunctionLog : public parser::Function1Arg {
-	public:
-		virtual double eval(double in);
-	};
-
-	/** standard constant's lookup table**/
-	class StdConstantLookupTable : public parser::ConstantLookupTable {
-	public:
-		StdConstantLookupTable(); 
-	};
-
-	/** standard function's lookup table**/
-	class StdFunctionLookupTable : public parser::FunctionLookupTable {
-	public:
-		StdFunctionLookupTable(); 
-	};
-
-}
-
-#endif
+#ifndef CALCULATOR_H
+#define CALCULATOR_H
+
+#include "Parser.h"
+#include "FlatAst.h"
+#include "TokenArray.h"
+#include "SourceBuffer.h"
+#include "PushLexer.h"
+#include "IncrementalParser.h"
+#include "Status.h"
+#include "Bytecode.h"
+#include <memory>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <exception>
+#include <string>
+#include <exception>
+
+namespace calc {
+
+
+	/* report all calculation exceptions */
+	class StatementException : public std::exception {
+	private:
+		int symbolNo;
+		std::string s;
+	public:
+		StatementException(std::string s);
+		StatementException(int symbolNo);
+		StatementException(int symbolNo, std::string s);
+		virtual const char *what() const;
+		std::string whatStr();
+	};
+
+	/* forward declaration */
+	class RPNElement;
+
+	/* values of the stack and the slots of a program which calculate
+	keeps on the native stack; a deeper program allocates them, unless
+	the caller gives the stack (see Calculator::getStackSize)*/
+	const size_t CALCULATE_STACK_SIZE = 64;
+
+	/* Values of the variable evaluated at once by the batch calculate -
+	a column of the stack is 2 KB, the columns of a common program fit
+	in the L1 cache*/
+	const size_t CALCULATE_BLOCK_SIZE = 256;
+
+	/* forward declaration */
+	class RPNPushReader;
+
+	/* Calculator to evaluate expressions using the Reverse Polish Notation.
+	Instance of this class is either created using the RPN Notation (string)
+	or using AST tree resulting from parsing.
+
+	The RPN elements are translated into the bytecode once the program
+	is created (see Bytecode) and calculate runs it - the elements are
+	kept to save the program and as the reference evaluator
+	(calculateByElements). The stack of the program is verified then:
+	an operation without its operands, or values left beside the result,
+	is a StatementException of the constructor, the error in the status of
+	create (or of RPNPushReader::finish) - calculate checks nothing and
+	allocates nothing, but the stack of a deep program.*/
+	class Calculator {
+	private:
+			std::vector<RPNElement*> input;
+			/* the elements translated */
+			Bytecode code;
+			std::string variableName;
+			/* interned variable name */
+			int variableSymbol;
+			parser::FunctionLookupTable* functionLookupTable;
+			parser::ConstantLookupTable* constantLookupTable;
+			/* slots of the shared subexpressions */
+			int slotCount;
+			/* nodes not compiled, because they were shared */
+			size_t eliminatedCount;
+			/* read the RPN elements and assemble them; the error in the status
+			Returns: false on an error*/
+			bool constructFromStream(std::istream& inputStream, parser::Status& status);
+			bool constructFromSource(const parser::SourceBuffer& source, parser::Status& status);
+			bool constructFromTokens(const parser::TokenArray& tokens, parser::Status& status);
+			void saveElements(std::ostream& outputStream, size_t first, size_t last, int& written) const;
+			/* translate the elements into the bytecode */
+			void assemble();
+			/* Assemble; an invalid program is a statement error in the
+			status, the elements are deleted.
+			Returns: false on an error*/
+			bool assemble(parser::Status& status);
+			/* translate the elements first ... first + added - 1, which
+			replaced removed elements, into the bytecode in place of
+			theirs (see Bytecode::replace); all the elements if they are
+			not a subexpression*/
+			void reassemble(int first, int removed, int added);
+		/* create from the translated RPN elements (see RPNPushReader)*/
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const std::vector<RPNElement*>& input);
+		/* create without elements (see create) */
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable);
+		friend class RPNPushReader;
+		friend class IncrementalCompiler;
+	public:
+		/* create from AST*/
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			parser::AstNode* ast);
+		/* create from the flat AST*/
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::FlatAst& ast);
+		/* Read the stream in the RPN notation and create.
+		Throws UnknownTokenException, StatementException; see create
+		for the errors in a status*/
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			std::istream& inputStream);
+		/* read the RPN notation directly from the source text
+		(buffer or memory-mapped file) and create*/
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::SourceBuffer& source);
+		/* create from the RPN notation lexed already*/
+		Calculator(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::TokenArray& tokens);
+		/* Create from the RPN notation as the constructors do; an error
+		is set in the status instead of thrown - the unknown token or
+		the statement error of the symbol.
+		Returns: the program; NULL auto_ptr on an error*/
+		static std::auto_ptr<Calculator> create(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			std::istream& inputStream,
+			parser::Status& status);
+		/* create from the source text; errors in the status */
+		static std::auto_ptr<Calculator> create(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::SourceBuffer& source,
+			parser::Status& status);
+		/* create from the tokens; errors in the status */
+		static std::auto_ptr<Calculator> create(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::TokenArray& tokens,
+			parser::Status& status);
+		/* Compile the expression (the infix notation of parser::Parser)
+		straight into the RPN program, without the AST: the parser gives
+		the RPN elements one by one as it recognizes them (see
+		parser::PrecedenceParser). The program and the errors are the
+		same as when the AST is parsed and the calculator created from
+		it; the rest of the input not parsed is ignored as well.
+
+		With shareSubexpressions, identical subexpressions are compiled
+		once (see parser::SharedAstBuilder): the value is computed at the
+		first occurrence, kept and reused by the others. The results are
+		exactly the same, functions are taken as pure. An expression with
+		let bindings is always compiled so: the value of a binding is
+		computed once per calculation, however often its name is used.
+		So is one which calls a function defined by an expression (see
+		parser::FunctionDefinition) - its body is inlined, the argument
+		computed once.
+		Throws UnknownTokenException, SyntaxException, StatementException*/
+		static std::auto_ptr<Calculator> compile(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::SourceBuffer& source,
+			bool shareSubexpressions = false);
+		/* compile the expression lexed already */
+		static std::auto_ptr<Calculator> compile(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::TokenArray& tokens,
+			bool shareSubexpressions = false);
+		/* Compile as compile does; an error is set in the status instead
+		of thrown, with the position and text of the exception - invalid
+		input is rejected without the cost of an exception.
+		Returns: the program; NULL auto_ptr on an error*/
+		static std::auto_ptr<Calculator> compile(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::SourceBuffer& source,
+			parser::Status& status,
+			bool shareSubexpressions = false);
+		/* compile the expression lexed already; errors in the status */
+		static std::auto_ptr<Calculator> compile(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const parser::TokenArray& tokens,
+			parser::Status& status,
+			bool shareSubexpressions = false);
+		virtual ~Calculator();
+		/* Save current input as RPN in the stream; values are written
+		exactly, so the text is loaded back as the same program*/
+		void save(std::ostream& outputStream) const;
+		/* evaluate for the value of the variable; many threads may
+		evaluate the same calculator at once. The empty program is 0*/
+		double calculate(double varValue) const;
+		/* values of the stack and the slots of the program: the room
+		of the stack given to calculate(varValue, stack)*/
+		size_t getStackSize() const {
+			return code.getMaxDepth() + slotCount;
+		}
+		/* Evaluate as calculate(varValue) on the stack given - room for
+		getStackSize values: a program deeper than CALCULATE_STACK_SIZE
+		evaluated many times allocates its stack once, not per call.
+		A thread evaluating at once needs its own stack*/
+		double calculate(double varValue, double* stack) const;
+		/* Evaluate for the n values xs into ys, a block of them at once
+		(see Bytecode::runBlock) - the values are exactly those of
+		calculate for each one. xs and ys may be the same array*/
+		void calculate(const double* xs, double* ys, size_t n) const;
+		/* evaluate for the n values x0 + dx * i of a uniform grid into ys;
+		exactly calculate(x0 + dx * i)*/
+		void calculate(double x0, double dx, double* ys, size_t n) const;
+		/* Evaluate by the RPN elements one by one - a virtual call and a
+		check of the stack each, a stack allocated; the result is exactly
+		that of calculate. To compare the evaluators*/
+		double calculateByElements(double varValue) const;
+		/* Operations of the expression not compiled, because the value
+		of an identical subexpression (or of a let binding) is loaded
+		instead (see compile) - the nodes of the tree each load replaces,
+		but the leaves*/
+		size_t getEliminatedCount() const {
+			return eliminatedCount;
+		}
+		/* number of values of shared subexpressions kept at once */
+		int getSlotCount() const {
+			return slotCount;
+		}
+	};
+
+	/* forward declaration */
+	class Lexem2SymbolTranslator;
+
+	/* Read a program in the RPN notation in chunks of any size, as they
+	arrive (from a pipe, a socket ...), and create the Calculator.
+
+	Every token is translated as soon as it is lexed (see
+	parser::PushLexer), so the text is not kept; the result and the
+	errors are the same as when the whole text is read from a stream*/
+	class RPNPushReader : public parser::TokenSink {
+	private:
+		std::string variableName;
+		parser::FunctionLookupTable* functionLookupTable;
+		parser::ConstantLookupTable* constantLookupTable;
+		parser::PushLexer lexer;
+		/* the elements translated so far */
+		Lexem2SymbolTranslator* translator;
+		/* count symbols */
+		int symbolNo;
+
+		/* not copyable */
+		RPNPushReader(const RPNPushReader& other);
+		RPNPushReader& operator =(const RPNPushReader& other);
+	public:
+		RPNPushReader(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable);
+		virtual ~RPNPushReader();
+
+		/* Lex and translate the next chunk of the text. The chunk is not
+		needed after the call returns.
+		Throws UnknownTokenException, StatementException; nothing may be
+		pushed after that*/
+		void push(const char* data, size_t length);
+
+		/* End of the text: translate the rest and create the calculator.
+		Throws UnknownTokenException, StatementException*/
+		std::auto_ptr<Calculator> finish();
+
+		/* translate the next token (see parser::TokenSink) */
+		virtual void token(const parser::Token& token, int lineNo, int charNo);
+	};
+
+	/* Compile an expression being edited: after a small change of the
+	text only the changed part of the program is compiled again.
+
+	The text is parsed by parser::IncrementalParser, which replaces a
+	part of the tree. The program has an element per node, in the order
+	of the nodes (see Calculator::compile), so the elements of the part
+	are replaced the same way and the others are kept, and so are their
+	operations in the bytecode (see Bytecode::replace). A change still
+	costs time linear in the text: the arrays of the tokens, nodes,
+	elements and operations after it are moved, and the opcodes are
+	scanned for the depth of the stack - plain passes over memory,
+	without a call per element. The
+	program and the errors are those of Calculator::compile with the
+	whole text;
+	subexpressions are not shared, the value of a let binding (the
+	argument of an inlined call) is computed at each use*/
+	class IncrementalCompiler {
+	private:
+		parser::IncrementalParser parser;
+		/* interned variable name */
+		int variableSymbol;
+		/* the program of the tree of the parser */
+		std::auto_ptr<Calculator> calculator;
+		/* nodes of the tree which are variables other than the variable */
+		std::vector<unsigned char> unknownVariables;
+		size_t unknownCount;
+		bool compiled;
+
+		/* replace the elements of the nodes changed by the parser */
+		void update();
+
+		/* not copyable */
+		IncrementalCompiler(const IncrementalCompiler& other);
+		IncrementalCompiler& operator =(const IncrementalCompiler& other);
+	public:
+		IncrementalCompiler(
+			std::string variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable);
+
+		/* Compile the whole text.
+		Throws UnknownTokenException, SyntaxException, StatementException*/
+		void compile(const std::string& text);
+
+		/* Replace removedLength characters at the offset by the inserted
+		text and compile the change.
+		Throws as compile; the text is changed anyway, the next change is
+		compiled together with this one*/
+		void edit(size_t offset, size_t removedLength, const std::string& inserted);
+
+		/* the program is of the current text (the last compile or change
+		succeeded)*/
+		bool isCompiled() const {
+			return compiled;
+		}
+
+		const std::string& getText() const {
+			return parser.getText();
+		}
+
+		const parser::IncrementalParser& getParser() const {
+			return parser;
+		}
+
+		/* the program of the current text; only if isCompiled. It is
+		changed by the next change*/
+		const Calculator& getCalculator() const {
+			return *calculator;
+		}
+	};
+
+	/*** Some basic functions ***/
+
+	/* identity function */
+	class FunctionIdentity : public parser::Function1Arg {
+	public:
+		virtual double eval(double in);
+	};
+
+	/* sin(x) */
+	class FunctionSin : public parser::Function1Arg {
+	public:
+		virtual double eval(double in);
+	};
+
+	/* cos(x) */
+	class FunctionCos : public parser::Function1Arg {
+	public:
+		virtual double eval(double in);
+	};
+
+	/* exp(x) */
+	class FunctionExp : public parser::Function1Arg {
+	public:
+		virtual double eval(double in);
+	};
+
+	/* log(x) */
+	class FunctionLog : public parser::Function1Arg {
+	public:
+		virtual double eval(double in);
+	};
+
+	/** standard constant's lookup table; the constants are builtin
+	(see parser::BuiltinElements) - nothing is allocated**/
+	class StdConstantLookupTable : public parser::ConstantLookupTable {
+	public:
+		StdConstantLookupTable(); 
+	};
+
+	/** standard function's lookup table; the functions are builtin
+	and static - nothing is allocated**/
+	class StdFunctionLookupTable : public parser::FunctionLookupTable {
+	public:
+		StdFunctionLookupTable(); 
+	};
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "CalculatorCache.h"
+#include "SourceBuffer.h"
+
+using namespace std;
+using namespace parser;
+
+namespace calc {
+
+	/*** CalculatorCache *** *** *** *** *** *** *** *** *** ***/
+
+	CalculatorCache::CalculatorCache(size_t capacity)
+		: capacity(capacity > 0 ? capacity : 1)
+		, hitCount(0)
+		, missCount(0)
+		, evictionCount(0) {
+	}
+
+	/* characters of identifiers and floats */
+	static bool isWordChar(char c) {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+			|| (c >= '0' && c <= '9') || c == '_' || c == '.';
+	}
+
+	/* append the normalized text (see normalize) */
+	static void appendNormalized(string& result, const string& text) {
+		size_t start = result.size();
+		bool space = false;
+		for (size_t i = 0; i < text.size(); i++) {
+			char c = text[i];
+			//the white spaces of the lexer
+			if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+				space = true;
+				continue;
+			}
+			if (space && result.size() > start) {
+				char previous = result[result.size() - 1];
+				bool exponent = previous == 'e' || previous == 'E';
+				//a sign of an exponent: "1e+ 2" is not "1e+2"
+				bool exponentSign = (previous == '+' || previous == '-')
+					&& result.size() - start >= 2
+					&& (result[result.size() - 2] == 'e' || result[result.size() - 2] == 'E');
+				//the other tokens are single characters; "1e -1" is not "1e-1"
+				if ((isWordChar(previous) && isWordChar(c))
+					|| (exponent && (c == '+' || c == '-'))
+					|| exponentSign) {
+						result += ' ';
+				}
+			}
+			space = false;
+			result += c;
+		}
+	}
+
+	string CalculatorCache::normalize(const string& text) {
+		string result;
+		result.reserve(text.size());
+		appendNormalized(result, text);
+		return result;
+	}
+
+	/* append the bytes of the number */
+	static void appendKey(string& key, unsigned int number) {
+		key.append((const char*)&number, sizeof(number));
+	}
+
+	shared_ptr<const Calculator> CalculatorCache::compile(
+		const string& variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		const string& text,
+		bool shareSubexpressions) {
+
+			//the versions identify the tables; the parts before the
+			//text are of known length, so no two keys are confused
+			string key;
+			key.reserve(3 * sizeof(unsigned int) + 1 + variableName.size() + text.size());
+			appendKey(key, functionLookupTable != NULL ? functionLookupTable->getVersion() : 0);
+			appendKey(key, constantLookupTable != NULL ? constantLookupTable->getVersion() : 0);
+			key += shareSubexpressions ? '1' : '0';
+			appendKey(key, (unsigned int)variableName.size());
+			key += variableName;
+			appendNormalized(key, text);
+			{
+				MutexLock lock(mutex);
+				auto found = index.find(key);
+				if (found != index.end()) {
+					hitCount++;
+					//now the most recently used
+					programs.splice(programs.begin(), programs, found->second);
+					return found->second->second;
+				}
+				missCount++;
+			}
+
+			//errors are reported in the text given
+			SourceBuffer source(text.data(), text.size());
+			shared_ptr<const Calculator> calculator(Calculator::compile(variableName,
+				functionLookupTable, constantLookupTable, source, shareSubexpressions).release());
+
+			MutexLock lock(mutex);
+			auto found = index.find(key);
+			if (found != index.end()) {
+				//compiled by another thread in the meantime
+				programs.splice(programs.begin(), programs, found->second);
+				return found->second->second;
+			}
+			programs.push_front(make_pair(key, calculator));
+			index[key] = programs.begin();
+			if (programs.size() > capacity) {
+				index.erase(programs.back().first);
+				programs.pop_back();
+				evictionCount++;
+			}
+			return calculator;
+	}
+
+	void CalculatorCache::clear() {
+		MutexLock lock(mutex);
+		index.clear();
+		programs.clear();
+	}
+
+	size_t CalculatorCache::size() const {
+		MutexLock lock(mutex);
+		return programs.size();
+	}
+
+	size_t CalculatorCache::getHitCount() const {
+		MutexLock lock(mutex);
+		return hitCount;
+	}
+
+	size_t CalculatorCache::getMissCount() const {
+		MutexLock lock(mutex);
+		return missCount;
+	}
+
+	size_t CalculatorCache::getEvictionCount() const {
+		MutexLock lock(mutex);
+		return evictionCount;
+	}
+
+	/*** End of CalculatorCache *** *** *** *** *** *** *** ***/
+
+}
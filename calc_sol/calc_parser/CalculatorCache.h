@@ -0,0 +1,83 @@
+#ifndef CALCULATOR_CACHE_H
+#define CALCULATOR_CACHE_H
+
+#include "Calculator.h"
+#include "Threads.h"
+#include <memory>
+#include <string>
+#include <list>
+#include <unordered_map>
+
+namespace calc {
+
+	/* Cache of the programs compiled by Calculator::compile, so that an
+	expression compiled again costs a hash lookup.
+
+	Programs are kept by the expression text, the variable name and
+	the versions of the lookup tables (see parser::LookupTable::getVersion):
+	a program compiled with a table is never returned once the table
+	has changed. The text is normalized first - only white space which
+	doesn't separate tokens differs between texts of the same key.
+
+	At most capacity programs are kept; the least recently used one is
+	evicted. The programs are shared and never modified: a program
+	evicted stays valid while a client holds it.
+
+	All methods are synchronized; compiling is done outside of the
+	lock, so that threads compile different expressions at once*/
+	class CalculatorCache {
+	private:
+		/* the programs, the most recently used first */
+		typedef std::list<std::pair<std::string, std::shared_ptr<const Calculator> > > Programs;
+		Programs programs;
+		/* each program by its key */
+		std::unordered_map<std::string, Programs::iterator> index;
+		size_t capacity;
+		size_t hitCount;
+		size_t missCount;
+		size_t evictionCount;
+		/* guards all members */
+		mutable parser::Mutex mutex;
+
+		/* not copyable */
+		CalculatorCache(const CalculatorCache& other);
+		CalculatorCache& operator =(const CalculatorCache& other);
+	public:
+		/* keep at most capacity programs (at least 1) */
+		CalculatorCache(size_t capacity);
+
+		/* Text of the same tokens as the text, with white space only
+		where it separates tokens or makes the text invalid, as after
+		the sign of an exponent (a single space)*/
+		static std::string normalize(const std::string& text);
+
+		/* The program of the expression: the cached one, or compiled by
+		Calculator::compile and cached. The tables must not be changed
+		while they compile.
+		Throws as Calculator::compile; errors are not cached*/
+		std::shared_ptr<const Calculator> compile(
+			const std::string& variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			const std::string& text,
+			bool shareSubexpressions = false);
+
+		/* remove all programs; the counters are kept */
+		void clear();
+
+		/* number of programs cached */
+		size_t size() const;
+
+		/* requests answered from the cache */
+		size_t getHitCount() const;
+
+		/* requests compiled */
+		size_t getMissCount() const;
+
+		/* programs removed to make room for others */
+		size_t getEvictionCount() const;
+	};
+
+}
+
+#endif
@@ -0,0 +1,305 @@
+
+#include "stdafx.h"
+#include "CharScan.h"
+#include "DfaLexer.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CHAR_SCAN_X86
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+/* AVX2 intrinsics came with VS2012 (_MSC_VER 1700); an older MSVC
+scans by SSE2 at best*/
+#if defined(CHAR_SCAN_X86) && (!defined(_MSC_VER) || _MSC_VER >= 1700)
+#define CHAR_SCAN_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+/* MSVC compiles AVX2 intrinsics in any function; GCC and clang
+only in functions compiled for the instruction set*/
+#if defined(CHAR_SCAN_HAS_AVX2) && !defined(_MSC_VER)
+#define CHAR_SCAN_AVX2 __attribute__((target("avx2")))
+#else
+#define CHAR_SCAN_AVX2
+#endif
+
+namespace parser {
+
+	namespace simd {
+
+		using namespace dfa;
+
+		/*** Scalar *** *** *** *** *** *** *** *** *** *** ***/
+
+		static const char* scalarSkipSpaces(const char* p, const char* end) {
+			while (p != end && charClass(*p) == CC_SPACE) {
+				++p;
+			}
+			return p;
+		}
+
+		static const char* scalarSkipDigits(const char* p, const char* end) {
+			while (p != end && charClass(*p) == CC_DIGIT) {
+				++p;
+			}
+			return p;
+		}
+
+		static const char* scalarSkipIdentifier(const char* p, const char* end) {
+			int cc;
+			while (p != end && ((cc = charClass(*p)) == CC_LETTER || cc == CC_EXP || cc == CC_DIGIT)) {
+				++p;
+			}
+			return p;
+		}
+
+		static const CharScanner scalarScanner = {
+			scalarSkipSpaces, scalarSkipDigits, scalarSkipIdentifier
+		};
+
+		/*** End of Scalar *** *** *** *** *** *** *** *** ***/
+
+#ifdef CHAR_SCAN_X86
+
+		/* index of the lowest set bit; mask != 0 */
+		static inline int lowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return (int)index;
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+
+		/*** SSE2 *** *** *** *** *** *** *** *** *** *** *** ***/
+
+		/* Every function returns 0xFF in the bytes which belong
+		to the class and 0 elsewhere. Bytes >= 128 are negative
+		as signed chars, so they never fall into the ranges*/
+
+		static inline __m128i sse2Spaces(__m128i v) {
+			__m128i m = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+			return _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+		}
+
+		static inline __m128i sse2Digits(__m128i v) {
+			return _mm_and_si128(
+				_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+				_mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+		}
+
+		static inline __m128i sse2Identifier(__m128i v) {
+			//lower case letters; upper case letters are mapped by the bit 0x20
+			__m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+			__m128i m = _mm_and_si128(
+				_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+				_mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+			return _mm_or_si128(m, sse2Digits(v));
+		}
+
+		/* Short runs (most tokens) are cheaper to classify one character
+		at a time: the first characters are checked by the scalar test */
+#define CHAR_SCAN_PROLOGUE(inClass) \
+			for (int i = 0; i < 4; i++, ++p) { \
+				if (p == end || !(inClass)) { \
+					return p; \
+				} \
+			}
+
+		static inline bool isSpace(char c) {
+			return charClass(c) == CC_SPACE;
+		}
+
+		static inline bool isDigit(char c) {
+			return charClass(c) == CC_DIGIT;
+		}
+
+		static inline bool isIdentifier(char c) {
+			int cc = charClass(c);
+			return cc == CC_LETTER || cc == CC_EXP || cc == CC_DIGIT;
+		}
+
+		/* 16 characters at a time, then the scalar tail */
+#define CHAR_SCAN_SSE2_LOOP(classify, scalarTail) \
+			while (end - p >= 16) { \
+				__m128i v = _mm_loadu_si128((const __m128i*)p); \
+				unsigned int outside = ~(unsigned int)_mm_movemask_epi8(classify(v)) & 0xFFFFu; \
+				if (outside != 0) { \
+					return p + lowestBit(outside); \
+				} \
+				p += 16; \
+			} \
+			return scalarTail(p, end);
+
+		static const char* sse2SkipSpaces(const char* p, const char* end) {
+			CHAR_SCAN_PROLOGUE(isSpace(*p))
+			CHAR_SCAN_SSE2_LOOP(sse2Spaces, scalarSkipSpaces)
+		}
+
+		static const char* sse2SkipDigits(const char* p, const char* end) {
+			CHAR_SCAN_PROLOGUE(isDigit(*p))
+			CHAR_SCAN_SSE2_LOOP(sse2Digits, scalarSkipDigits)
+		}
+
+		static const char* sse2SkipIdentifier(const char* p, const char* end) {
+			CHAR_SCAN_PROLOGUE(isIdentifier(*p))
+			CHAR_SCAN_SSE2_LOOP(sse2Identifier, scalarSkipIdentifier)
+		}
+
+#undef CHAR_SCAN_SSE2_LOOP
+
+		static const CharScanner sse2Scanner = {
+			sse2SkipSpaces, sse2SkipDigits, sse2SkipIdentifier
+		};
+
+		/*** End of SSE2 *** *** *** *** *** *** *** *** *** ***/
+
+#ifdef CHAR_SCAN_HAS_AVX2
+
+		/*** AVX2 *** *** *** *** *** *** *** *** *** *** *** ***/
+
+		/* the same classes as the SSE2 functions, 32 bytes */
+
+		CHAR_SCAN_AVX2 static inline __m256i avx2Digits(__m256i v) {
+			return _mm256_and_si256(
+				_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+				_mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+		}
+
+		CHAR_SCAN_AVX2 static inline __m256i avx2Spaces(__m256i v) {
+			__m256i m = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+			return _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+		}
+
+		CHAR_SCAN_AVX2 static inline __m256i avx2Identifier(__m256i v) {
+			__m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+			__m256i m = _mm256_and_si256(
+				_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+				_mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+			return _mm256_or_si256(m, avx2Digits(v));
+		}
+
+		/* 32 characters at a time, then the SSE2 loop for the tail */
+#define CHAR_SCAN_AVX2_LOOP(classify, sse2Tail) \
+			while (end - p >= 32) { \
+				__m256i v = _mm256_loadu_si256((const __m256i*)p); \
+				unsigned int outside = ~(unsigned int)_mm256_movemask_epi8(classify(v)); \
+				if (outside != 0) { \
+					return p + lowestBit(outside); \
+				} \
+				p += 32; \
+			} \
+			return sse2Tail(p, end);
+
+		CHAR_SCAN_AVX2 static const char* avx2SkipSpaces(const char* p, const char* end) {
+			CHAR_SCAN_PROLOGUE(isSpace(*p))
+			CHAR_SCAN_AVX2_LOOP(avx2Spaces, sse2SkipSpaces)
+		}
+
+		CHAR_SCAN_AVX2 static const char* avx2SkipDigits(const char* p, const char* end) {
+			CHAR_SCAN_PROLOGUE(isDigit(*p))
+			CHAR_SCAN_AVX2_LOOP(avx2Digits, sse2SkipDigits)
+		}
+
+		CHAR_SCAN_AVX2 static const char* avx2SkipIdentifier(const char* p, const char* end) {
+			CHAR_SCAN_PROLOGUE(isIdentifier(*p))
+			CHAR_SCAN_AVX2_LOOP(avx2Identifier, sse2SkipIdentifier)
+		}
+
+#undef CHAR_SCAN_AVX2_LOOP
+
+		static const CharScanner avx2Scanner = {
+			avx2SkipSpaces, avx2SkipDigits, avx2SkipIdentifier
+		};
+
+		/*** End of AVX2 *** *** *** *** *** *** *** *** *** ***/
+
+#endif
+
+#undef CHAR_SCAN_PROLOGUE
+
+#endif
+
+		/*** Selection *** *** *** *** *** *** *** *** *** *** ***/
+
+		SimdLevel detectSimdLevel() {
+#if defined(CHAR_SCAN_X86) && defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			int maxFunction = info[0];
+			__cpuid(info, 1);
+			bool sse2 = (info[3] & (1 << 26)) != 0;
+#ifndef CHAR_SCAN_HAS_AVX2
+			return sse2 ? SIMD_SSE2 : SIMD_SCALAR;
+#else
+			//the OS saves the AVX registers (OSXSAVE, AVX, XCR0 bits 1-2)
+			bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+				&& (_xgetbv(0) & 6) == 6;
+			bool avx2 = false;
+			if (avx && maxFunction >= 7) {
+				__cpuidex(info, 7, 0);
+				avx2 = (info[1] & (1 << 5)) != 0;
+			}
+			return avx2 ? SIMD_AVX2 : (sse2 ? SIMD_SSE2 : SIMD_SCALAR);
+#endif
+#elif defined(CHAR_SCAN_X86)
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) {
+				return SIMD_AVX2;
+			}
+			return __builtin_cpu_supports("sse2") ? SIMD_SSE2 : SIMD_SCALAR;
+#else
+			return SIMD_SCALAR;
+#endif
+		}
+
+		/* the selected level; the best one until setSimdLevel is called */
+		static SimdLevel selectedLevel = detectSimdLevel();
+
+		SimdLevel getSimdLevel() {
+			return selectedLevel;
+		}
+
+		SimdLevel setSimdLevel(SimdLevel level) {
+			SimdLevel supported = detectSimdLevel();
+			selectedLevel = (level <= supported) ? level : supported;
+			return selectedLevel;
+		}
+
+		const CharScanner& charScanner() {
+			return charScanner(selectedLevel);
+		}
+
+		const CharScanner& charScanner(SimdLevel level) {
+#ifdef CHAR_SCAN_X86
+			switch (level) {
+#ifdef CHAR_SCAN_HAS_AVX2
+			case SIMD_AVX2:
+				return avx2Scanner;
+#endif
+			case SIMD_SSE2:
+				return sse2Scanner;
+			default:
+				return scalarScanner;
+			}
+#else
+			return scalarScanner;
+#endif
+		}
+
+		/*** End of Selection *** *** *** *** *** *** *** *** ***/
+	}
+
+}
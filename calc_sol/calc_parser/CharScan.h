@@ -0,0 +1,56 @@
+#ifndef CHAR_SCAN_H
+#define CHAR_SCAN_H
+
+#include <cstddef>
+
+namespace parser {
+
+	namespace simd {
+
+		/* Instruction sets used to classify characters */
+		enum SimdLevel {
+			/* one character at a time */
+			SIMD_SCALAR = 0,
+			/* 16 characters at a time */
+			SIMD_SSE2,
+			/* 32 characters at a time */
+			SIMD_AVX2
+		};
+
+		/* Skip characters of one class.
+		Returns: the first character in [p, end) which doesn't belong
+		to the class, or end*/
+		typedef const char* (*ScanFunc)(const char* p, const char* end);
+
+		/* Scanners of the character classes of the "Lexer" grammar */
+		struct CharScanner {
+			/* white spaces and epsilon (0) */
+			ScanFunc skipSpaces;
+			/* [0-9] */
+			ScanFunc skipDigits;
+			/* [A-Za-z_0-9] - the rest of an Identifier */
+			ScanFunc skipIdentifier;
+		};
+
+		/* the best level supported by the processor and the compiler */
+		SimdLevel detectSimdLevel();
+
+		/* the level of the scanner returned by charScanner() */
+		SimdLevel getSimdLevel();
+
+		/* Select the level used by charScanner(); levels not supported
+		by the processor are lowered to the best supported one.
+		By default the best level is used.
+		Returns: the level selected*/
+		SimdLevel setSimdLevel(SimdLevel level);
+
+		/* scanner of the selected level */
+		const CharScanner& charScanner();
+
+		/* scanner of the given level; it must be supported */
+		const CharScanner& charScanner(SimdLevel level);
+	}
+
+}
+
+#endif
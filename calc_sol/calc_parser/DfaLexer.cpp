@@ -0,0 +1,249 @@
+
+#include "stdafx.h"
+#include "DfaLexer.h"
+#include "FloatConv.h"
+#include <istream>
+#include <cstdlib>
+
+using namespace std;
+
+namespace parser {
+
+	namespace dfa {
+
+		/*** Tables  *** *** *** *** *** *** *** *** *** *** ***/
+
+		/* Character class according to the grammar in the "Lexer" class.
+		This is a constant expression, so the compiler fills
+		the whole table below; characters >= 128 are CC_OTHER */
+#define DFA_CHAR_CLASS(c) ( \
+		((c) == 0 || (c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r') ? CC_SPACE : \
+		((c) >= '0' && (c) <= '9') ? CC_DIGIT : \
+		((c) == 'e' || (c) == 'E') ? CC_EXP : \
+		(((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') || (c) == '_') ? CC_LETTER : \
+		(c) == '.' ? CC_DOT : \
+		(c) == '+' ? CC_PLUS : \
+		(c) == '-' ? CC_MINUS : \
+		(c) == '*' ? CC_MUL : \
+		(c) == '/' ? CC_DIV : \
+		(c) == '^' ? CC_DASH : \
+		(c) == '(' ? CC_OPAREN : \
+		(c) == ')' ? CC_CPAREN : \
+		(c) == '~' ? CC_TILDE : \
+		(c) == '=' ? CC_ASSIGN : \
+		CC_OTHER)
+
+#define DFA_CHAR_CLASS_4(c) \
+		DFA_CHAR_CLASS(c), DFA_CHAR_CLASS((c) + 1), \
+		DFA_CHAR_CLASS((c) + 2), DFA_CHAR_CLASS((c) + 3)
+#define DFA_CHAR_CLASS_16(c) \
+		DFA_CHAR_CLASS_4(c), DFA_CHAR_CLASS_4((c) + 4), \
+		DFA_CHAR_CLASS_4((c) + 8), DFA_CHAR_CLASS_4((c) + 12)
+#define DFA_CHAR_CLASS_64(c) \
+		DFA_CHAR_CLASS_16(c), DFA_CHAR_CLASS_16((c) + 16), \
+		DFA_CHAR_CLASS_16((c) + 32), DFA_CHAR_CLASS_16((c) + 48)
+
+		const unsigned char charClassTable[256] = {
+			DFA_CHAR_CLASS_64(0), DFA_CHAR_CLASS_64(64),
+			DFA_CHAR_CLASS_64(128), DFA_CHAR_CLASS_64(192)
+		};
+
+#undef DFA_CHAR_CLASS_64
+#undef DFA_CHAR_CLASS_16
+#undef DFA_CHAR_CLASS_4
+#undef DFA_CHAR_CLASS
+
+		/* Transitions, one row per state and one column per character class:
+		spc    - white space
+		dig    - digit
+		let    - letter or _
+		e      - e or E
+		.+-* / ^ ( ) ~ = - single characters
+		oth    - other characters
+
+		Float      : S_START -dig-> S_INT -.-> S_DOT -dig-> S_FRAC
+		             S_INT, S_FRAC -e-> S_EXP -+-> S_EXP_SIGN -dig-> S_EXP_DIGITS
+		             S_EXP -dig-> S_EXP_DIGITS
+		Identifier : S_START -let,e-> S_IDENT
+		Single char: S_START -c->   S_<c>
+
+		S_START is the only state with T_ERROR entries; all other
+		states end the token (T_STOP) when the character doesn't match*/
+#define STP T_STOP
+#define ERR T_ERROR
+		const signed char transitionTable[STATE_COUNT][CHAR_CLASS_COUNT] = {
+			/*                 spc      dig           let      e        .      +           -           *      /      ^       (         )         ~        =         oth */
+			/* S_START      */ {S_START, S_INT,        S_IDENT, S_IDENT, ERR,   S_PLUS,     S_MINUS,    S_MUL, S_DIV, S_DASH, S_OPAREN, S_CPAREN, S_TILDE, S_ASSIGN, ERR},
+			/* S_INT        */ {STP,     S_INT,        STP,     S_EXP,   S_DOT, STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_DOT        */ {STP,     S_FRAC,       STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_FRAC       */ {STP,     S_FRAC,       STP,     S_EXP,   STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_EXP        */ {STP,     S_EXP_DIGITS, STP,     STP,     STP,   S_EXP_SIGN, S_EXP_SIGN, STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_EXP_SIGN   */ {STP,     S_EXP_DIGITS, STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_EXP_DIGITS */ {STP,     S_EXP_DIGITS, STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_IDENT      */ {STP,     S_IDENT,      S_IDENT, S_IDENT, STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_PLUS       */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_MINUS      */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_MUL        */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_DIV        */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_DASH       */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_OPAREN     */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_CPAREN     */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_TILDE      */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP},
+			/* S_ASSIGN     */ {STP,     STP,          STP,     STP,     STP,   STP,        STP,        STP,   STP,   STP,    STP,      STP,      STP,     STP,      STP}
+		};
+#undef ERR
+#undef STP
+
+		/* kind of lexem recognized in each (final) state */
+		const LexemKind stateKindTable[STATE_COUNT] = {
+			LK_EOF,			// S_START
+			LK_FLOAT,		// S_INT
+			LK_FLOAT,		// S_DOT (never final)
+			LK_FLOAT,		// S_FRAC
+			LK_FLOAT,		// S_EXP (never final)
+			LK_FLOAT,		// S_EXP_SIGN (never final)
+			LK_FLOAT,		// S_EXP_DIGITS
+			LK_IDENTIFIER,	// S_IDENT
+			LK_PLUS,		// S_PLUS
+			LK_MINUS,		// S_MINUS
+			LK_MUL,			// S_MUL
+			LK_DIV,			// S_DIV
+			LK_DASH,		// S_DASH
+			LK_OPAREN,		// S_OPAREN
+			LK_CPAREN,		// S_CPAREN
+			LK_TILDE,		// S_TILDE
+			LK_ASSIGN		// S_ASSIGN
+		};
+
+		/* errors of the incomplete floats */
+		const char* const stateErrorTable[STATE_COUNT] = {
+			NULL,								// S_START
+			NULL,								// S_INT
+			"float cannot end with dot '.'",	// S_DOT
+			NULL,								// S_FRAC
+			"float exponent has no digits",		// S_EXP
+			"float exponent has no digits",		// S_EXP_SIGN
+			NULL,								// S_EXP_DIGITS
+			NULL,								// S_IDENT
+			NULL,								// S_PLUS
+			NULL,								// S_MINUS
+			NULL,								// S_MUL
+			NULL,								// S_DIV
+			NULL,								// S_DASH
+			NULL,								// S_OPAREN
+			NULL,								// S_CPAREN
+			NULL,								// S_TILDE
+			NULL								// S_ASSIGN
+		};
+
+		/*** End of Tables *** *** *** *** *** *** *** *** *** ***/
+
+		LexemKind fillToken(int state, const char* text, size_t length, Token& token) {
+			token.kind = stateKindTable[state];
+			token.text = TextSpan(text, length);
+			if (token.kind == LK_IDENTIFIER && isFloatKeyword(text, length)) {
+				token.kind = LK_FLOAT;
+			}
+			if (token.kind == LK_FLOAT) {
+				token.value = parseFloatLexem(text, text + length);
+			}
+			token.symbol = (token.kind == LK_IDENTIFIER)
+				? findSymbol(text, length)
+				: NO_SYMBOL;
+			return token.kind;
+		}
+	}
+
+	using namespace dfa;
+
+	/*** DfaLexer  *** *** *** *** *** *** *** *** *** *** ***/
+
+	DfaLexer::DfaLexer() {
+		eof = false;
+		//magic 0 = epsilon
+		input = 0;
+
+		charCounter = 0;
+		lineCounter = 1;
+		offset = 0;
+	}
+
+	auto_ptr<Lexem> DfaLexer::next(istream& inputStream) {
+		Token token;
+		next(inputStream, token);
+		return toLexem(token);
+	}
+
+	LexemKind DfaLexer::next(istream& inputStream, Token& token) {
+		if (eof) {
+			token.kind = LK_EOF;
+			token.text = TextSpan();
+			token.offset = offset;
+			token.symbol = NO_SYMBOL;
+			return LK_EOF;
+		}
+		int state = S_START;
+		seen.clear();
+		for (;;) {
+			int cc = charClass(input);
+			int nextState = transitionTable[state][cc];
+			if (nextState == T_STOP) {
+				//the token ends before the current input
+				if (stateErrorTable[state] != NULL) {
+					throw UnknownTokenException(lineCounter, charCounter,
+						string(stateErrorTable[state]));
+				}
+				//the current input must start the next token
+				if (transitionTable[S_START][cc] == T_ERROR) {
+					throw UnknownTokenException(lineCounter, charCounter);
+				}
+				//the current input is not a part of the token
+				token.offset = offset - 1 - seen.size();
+				return getToken(state, token);
+			} else if (nextState == T_ERROR) {
+				//there is no state in which lexer can process input
+				throw UnknownTokenException(lineCounter, charCounter);
+			}
+			if (nextState != S_START) {
+				seen.push_back(input);
+			}
+			state = nextState;
+			//reading not finished yet - move forward by 1 character
+			readInputChar(inputStream);
+			if (eof) {
+				//no more characters in the stream - return token
+				if (stateErrorTable[state] != NULL) {
+					throw UnknownTokenException(string(stateErrorTable[state]));
+				}
+				token.offset = offset - seen.size();
+				return getToken(state, token);
+			}
+		}
+	}
+
+	LexemKind DfaLexer::getToken(int state, Token& token) {
+		return fillToken(state, seen.data(), seen.size(), token);
+	}
+
+	void DfaLexer::readInputChar(istream& inputStream) {
+		//read through the buffer - no sentry object per character
+		int c = inputStream.rdbuf()->sbumpc();
+		if (c == char_traits<char>::eof()) {
+			//same stream state as after istream::get()
+			inputStream.setstate(ios::eofbit | ios::failbit);
+			eof = true;
+			input = 0;
+		} else {
+			input = (char)c;
+			offset++;
+			charCounter++;
+			if (input == '\n') {
+				charCounter = 0;
+				lineCounter++;
+			}
+		}
+	}
+
+	/*** End of DfaLexer ** *** *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,184 @@
+#ifndef DFA_LEXER_H
+#define DFA_LEXER_H
+
+#include "Lexer.h"
+#include "Token.h"
+#include <memory>
+#include <istream>
+#include <string>
+
+namespace parser {
+
+	namespace dfa {
+
+		/* Character classes of the grammar described in the "Lexer" class.
+		Every input character belongs to exactly one class */
+		enum CharClass {
+			CC_SPACE = 0,	// white spaces and epsilon (0)
+			CC_DIGIT,		// [0-9]
+			CC_LETTER,		// [A-Za-z_] except e E
+			CC_EXP,			// e E - letters which start the exponent of a Float
+			CC_DOT,			// .
+			CC_PLUS,		// +
+			CC_MINUS,		// -
+			CC_MUL,			// *
+			CC_DIV,			// /
+			CC_DASH,		// ^
+			CC_OPAREN,		// (
+			CC_CPAREN,		// )
+			CC_TILDE,		// ~
+			CC_ASSIGN,		// =
+			CC_OTHER,		// not a part of any token
+			CHAR_CLASS_COUNT
+		};
+
+		/* States of the automaton.
+		The states S_INT, S_FRAC, S_EXP_DIGITS, S_IDENT and the single
+		character states are accepting; S_DOT, S_EXP and S_EXP_SIGN
+		are the incomplete floats (see stateErrorTable) */
+		enum State {
+			S_START = 0,	// between tokens
+			S_INT,			// Float: before dot
+			S_DOT,			// Float: '.' dot
+			S_FRAC,			// Float: after dot
+			S_EXP,			// Float: 'e' of the exponent
+			S_EXP_SIGN,		// Float: sign of the exponent
+			S_EXP_DIGITS,	// Float: digits of the exponent
+			S_IDENT,		// Identifier
+			S_PLUS,
+			S_MINUS,
+			S_MUL,
+			S_DIV,
+			S_DASH,
+			S_OPAREN,
+			S_CPAREN,
+			S_TILDE,
+			S_ASSIGN,
+			STATE_COUNT
+		};
+
+		/* Special entries of the transition table */
+		enum Transition {
+			/* current token ends, the character is not consumed */
+			T_STOP = -1,
+			/* the character doesn't start any token */
+			T_ERROR = -2
+		};
+
+		/* Character class for each (unsigned) character */
+		extern const unsigned char charClassTable[256];
+
+		/* next state = transitionTable[state][character class] */
+		extern const signed char transitionTable[STATE_COUNT][CHAR_CLASS_COUNT];
+
+		/* kind of lexem recognized in each (final) state */
+		extern const LexemKind stateKindTable[STATE_COUNT];
+
+		/* message of the error reported when a token ends in the state;
+		NULL for the accepting states */
+		extern const char* const stateErrorTable[STATE_COUNT];
+
+		inline int charClass(char c) {
+			return charClassTable[(unsigned char)c];
+		}
+
+		/* the identifiers which are Float lexems: inf and nan */
+		inline bool isFloatKeyword(const char* text, size_t length) {
+			return length == 3
+				&& ((text[0] == 'i' && text[1] == 'n' && text[2] == 'f')
+				|| (text[0] == 'n' && text[1] == 'a' && text[2] == 'n'));
+		}
+
+		/* Fill the token recognized in the (final) state from its text:
+		kind, value of a Float, symbol of an Identifier.
+		Returns: kind of the token; LK_EOF for the start state */
+		LexemKind fillToken(int state, const char* text, size_t length, Token& token);
+	}
+
+	/* Lexer: table-driven implementation of the grammar described
+	in the "Lexer" class.
+
+	Instead of polling every LexerState object, the next state
+	is read from the transition table indexed by the current state
+	and the class of the input character. Produces exactly the same
+	lexems and reports errors at the same line/character as "Lexer" */
+	class DfaLexer {
+	private:
+		/* End of stream occured*/
+		bool eof;
+
+		/* current input; value = 0 (not '0') is epsilon*/
+		char input;
+
+		/* count characters in current line */
+		int charCounter;
+
+		/* count lines */
+		int lineCounter;
+
+		/* count all characters read */
+		size_t offset;
+
+		/* characters of the current token; reused between tokens */
+		std::string seen;
+
+		/* Mover forward in the stream of characters by 1 character*/
+		void readInputChar(std::istream& inputStream);
+
+		/* Fill the token recognized in the (final) state.
+		Returns: kind of the token; LK_EOF for the start state */
+		LexemKind getToken(int state, Token& token);
+	public:
+		DfaLexer();
+
+		/* Read next lexem from the stream.
+		Returns: non-null auto_ptr to a Lexem represenitng symbol read from the stream.
+		The method returns NULL auto_ptr at the end of file*/
+		virtual std::auto_ptr<Lexem> next(std::istream& inputStream);
+
+		/* Read next lexem from the stream into the given token; no heap
+		allocations. The text of the token is owned by the lexer and is
+		valid until the next call.
+		Returns: kind of the lexem; LK_EOF at the end of file*/
+		LexemKind next(std::istream& inputStream, Token& token);
+
+		/* verify end of stream */
+		bool isEof() {
+			return eof;
+		}
+
+		int getCharNo() {
+			return charCounter;
+		}
+
+		int getLineNo() {
+			return lineCounter;
+		}
+	};
+
+	/* TokenSource reading the stream with DfaLexer */
+	class StreamTokenSource : public TokenSource {
+	private:
+		DfaLexer lexer;
+		std::istream& inputStream;
+	public:
+		StreamTokenSource(std::istream& inputStream)
+			: inputStream(inputStream) {
+		}
+
+		virtual LexemKind next(Token& token) {
+			return lexer.next(inputStream, token);
+		}
+
+		virtual int getLineNo() {
+			return lexer.getLineNo();
+		}
+
+		virtual int getCharNo() {
+			return lexer.getCharNo();
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,243 @@
+#include "stdafx.h"
+#include "ExpressionLibrary.h"
+#include "FunctionDefinition.h"
+#include "TokenArray.h"
+#include <algorithm>
+
+using namespace std;
+using namespace parser;
+
+namespace calc {
+
+	/*** ExpressionLibrary *** *** *** *** *** *** *** *** *** ***/
+
+	ExpressionLibrary::ExpressionLibrary(const string& variableName,
+		FunctionLookupTable* functionLookupTable,
+		ConstantLookupTable* constantLookupTable,
+		bool shareSubexpressions)
+		: variableName(variableName)
+		, functionLookupTable(functionLookupTable)
+		, constantLookupTable(constantLookupTable)
+		, shareSubexpressions(shareSubexpressions)
+		, recompiledCount(0) {
+	}
+
+	void ExpressionLibrary::findUses(const TokenArray& tokens, size_t first, vector<int>& uses) {
+		uses.clear();
+		for (size_t i = first; i < tokens.size(); i++) {
+			if (tokens.getKind(i) == LK_IDENTIFIER) {
+				//a name used before it is defined is interned: it is
+				//recompiled when the name is defined
+				int symbol = tokens.intern(i);
+				if (isKeyword(symbol)) {
+					continue;
+				}
+				uses.push_back(tokens.getKind(i + 1) == LK_OPAREN ? callNode(symbol) : nameNode(symbol));
+			}
+		}
+		sort(uses.begin(), uses.end());
+		uses.erase(unique(uses.begin(), uses.end()), uses.end());
+	}
+
+	void ExpressionLibrary::link(Dependents& dependents, int symbol, const vector<int>& uses) {
+		for (auto it = uses.begin(); it != uses.end(); ++it) {
+			dependents[*it].insert(symbol);
+		}
+	}
+
+	void ExpressionLibrary::unlink(Dependents& dependents, int symbol, const vector<int>& uses) {
+		for (auto it = uses.begin(); it != uses.end(); ++it) {
+			auto found = dependents.find(*it);
+			if (found != dependents.end()) {
+				found->second.erase(symbol);
+				if (found->second.empty()) {
+					dependents.erase(found);
+				}
+			}
+		}
+	}
+
+	/*
+	Technological note:
+	the functions affected are found by a walk of the edges from the
+	node; each of them waits for those it calls among the affected
+	(the count of them), and is ordered when the last one is (Kahn's
+	topological sort). The calls have no cycles - a function calls only
+	those defined before it, or is redefined without recursion (see
+	setFunction). Both steps visit the edges of the affected ones only*/
+	void ExpressionLibrary::findFunctionDependents(int node, vector<int>& order) const {
+		order.clear();
+		//the affected functions and the number each one waits for
+		unordered_map<int, int> waiting;
+		vector<int> work(1, node);
+		while (!work.empty()) {
+			auto found = functionDependents.find(work.back());
+			work.pop_back();
+			if (found == functionDependents.end()) {
+				continue;
+			}
+			for (auto it = found->second.begin(); it != found->second.end(); ++it) {
+				if (waiting.insert(make_pair(*it, 0)).second) {
+					work.push_back(callNode(*it));
+				}
+			}
+		}
+		for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+			const vector<int>& uses = functions.find(it->first)->second.uses;
+			for (auto use = uses.begin(); use != uses.end(); ++use) {
+				//a called node is odd
+				if ((*use & 1) != 0 && waiting.count(*use / 2) > 0) {
+					it->second++;
+				}
+			}
+		}
+		//the functions which wait for none of the others come first
+		for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+			if (it->second == 0) {
+				order.push_back(it->first);
+			}
+		}
+		for (size_t i = 0; i < order.size(); i++) {
+			auto found = functionDependents.find(callNode(order[i]));
+			if (found == functionDependents.end()) {
+				continue;
+			}
+			for (auto it = found->second.begin(); it != found->second.end(); ++it) {
+				if (--waiting[*it] == 0) {
+					order.push_back(*it);
+				}
+			}
+		}
+	}
+
+	void ExpressionLibrary::compile(Expression& expression) {
+		TokenArray tokens;
+		expression.program.reset();
+		//the names are those lexed before an error
+		bool lexed = tokens.tokenize(expression.text.data(), expression.text.size(), expression.status);
+		findUses(tokens, 0, expression.uses);
+		if (lexed) {
+			expression.program = shared_ptr<const Calculator>(Calculator::compile(variableName,
+				functionLookupTable, constantLookupTable, tokens, expression.status,
+				shareSubexpressions).release());
+		}
+	}
+
+	void ExpressionLibrary::redefine(int symbol) {
+		Function1Arg* old = functionLookupTable->remove(symbol);
+		Status status;
+		if (!FunctionDefinition::define(*functionLookupTable, constantLookupTable,
+			functions[symbol].text, status)) {
+				//should not occur: the names it uses are never removed
+				functionLookupTable->add(symbol, old);
+				throw "illegal state";
+		}
+		delete old;
+	}
+
+	void ExpressionLibrary::changed(int node) {
+		vector<int> order;
+		findFunctionDependents(node, order);
+		for (auto it = order.begin(); it != order.end(); ++it) {
+			redefine(*it);
+		}
+		//the expressions which use the node or call any of the functions
+		unordered_set<int> affected;
+		for (size_t i = 0; i <= order.size(); i++) {
+			auto found = expressionDependents.find(i < order.size() ? callNode(order[i]) : node);
+			if (found != expressionDependents.end()) {
+				affected.insert(found->second.begin(), found->second.end());
+			}
+		}
+		for (auto it = affected.begin(); it != affected.end(); ++it) {
+			compile(expressions[*it]);
+		}
+		recompiledCount += order.size() + affected.size();
+	}
+
+	bool ExpressionLibrary::setExpression(const string& name, const string& text) {
+		int symbol = internSymbol(name);
+		Expression& expression = expressions[symbol];
+		unlink(expressionDependents, symbol, expression.uses);
+		expression.text = text;
+		compile(expression);
+		link(expressionDependents, symbol, expression.uses);
+		recompiledCount = 1;
+		return expression.status.isOk();
+	}
+
+	void ExpressionLibrary::setFunction(const string& text) {
+		TokenArray tokens;
+		tokens.tokenize(text.data(), text.size());
+		int symbol = tokens.getKind(0) == LK_IDENTIFIER ? tokens.getSymbol(0) : NO_SYMBOL;
+		auto found = functions.find(symbol);
+		if (found == functions.end()) {
+			//a new one: the definition reports a name defined already
+			FunctionDefinition::define(*functionLookupTable, constantLookupTable, text);
+			//the definition interns the name
+			symbol = tokens.getSymbol(0);
+			found = functions.insert(make_pair(symbol, Function())).first;
+		} else {
+			//no recursion: it calls neither itself nor its dependents
+			vector<int> order;
+			findFunctionDependents(callNode(symbol), order);
+			unordered_set<int> callers(order.begin(), order.end());
+			callers.insert(symbol);
+			for (size_t i = 1; i < tokens.size(); i++) {
+				if (tokens.getKind(i) == LK_IDENTIFIER && tokens.getKind(i + 1) == LK_OPAREN
+					&& callers.count(tokens.getSymbol(i)) > 0) {
+
+						int lineNo, charNo;
+						tokens.position(i, lineNo, charNo);
+						throw SyntaxException(lineNo, charNo,
+							string("recursive definition " + symbolName(tokens.getSymbol(i))));
+				}
+			}
+			//the old one is not in the table while the new one is parsed
+			Function1Arg* old = functionLookupTable->remove(symbol);
+			Status status;
+			if (!FunctionDefinition::define(*functionLookupTable, constantLookupTable, text, status)) {
+				functionLookupTable->add(symbol, old);
+				status.raise();
+			}
+			delete old;
+			unlink(functionDependents, symbol, found->second.uses);
+		}
+		found->second.text = text;
+		//the name is not a use
+		findUses(tokens, 1, found->second.uses);
+		link(functionDependents, symbol, found->second.uses);
+		recompiledCount = 1;
+		changed(callNode(symbol));
+	}
+
+	bool ExpressionLibrary::setConstant(const string& name, double value) {
+		int symbol = internSymbol(name);
+		recompiledCount = 0;
+		if (constantLookupTable->isBuiltin(symbol)) {
+			return false;
+		}
+		constantLookupTable->replace(symbol, value);
+		changed(nameNode(symbol));
+		return true;
+	}
+
+	shared_ptr<const Calculator> ExpressionLibrary::getProgram(const string& name) const {
+		auto found = expressions.find(symbolTable().find(name));
+		if (found == expressions.end()) {
+			return shared_ptr<const Calculator>();
+		}
+		return found->second.program;
+	}
+
+	Status ExpressionLibrary::getStatus(const string& name) const {
+		auto found = expressions.find(symbolTable().find(name));
+		if (found == expressions.end()) {
+			return Status();
+		}
+		return found->second.status;
+	}
+
+	/*** End of ExpressionLibrary *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,162 @@
+#ifndef EXPRESSION_LIBRARY_H
+#define EXPRESSION_LIBRARY_H
+
+#include "Calculator.h"
+#include "Status.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace calc {
+
+	/* A library of models: named expressions of the variable, each
+	compiled into its program (as Calculator::compile does), with the
+	functions (parser::FunctionDefinition) and constants they use,
+	kept in the lookup tables given.
+
+	Every entry - an expression or a function - depends on the names
+	its text uses (its identifiers). A change recompiles only what
+	depends on the name changed: the functions which inline it, in the
+	order of their dependencies, then the functions and expressions
+	which use them - transitively. The others are not touched, so the
+	cost of a change grows with its dependents, not with the size of
+	the library. Constants are folded into the programs (and into the
+	bodies of functions); a new value is a change as well.
+
+	A program recompiled replaces the old one, which stays valid for
+	a client holding it. An expression which doesn't compile keeps
+	its error and is compiled again when a name it uses changes - when
+	its function is defined, for example.
+
+	The tables are changed by the library; they must not be changed
+	otherwise while the library uses them. Not synchronized*/
+	class ExpressionLibrary {
+	private:
+		/* an expression: its text, nodes used and program or error */
+		struct Expression {
+			std::string text;
+			std::vector<int> uses;
+			/* NULL on an error */
+			std::shared_ptr<const Calculator> program;
+			parser::Status status;
+		};
+
+		/* a function defined in the library */
+		struct Function {
+			std::string text;
+			std::vector<int> uses;
+		};
+
+		/* The entries which use each name - an edge of the graph from
+		the name to the symbol of the entry. A name called and the same
+		name used otherwise are different nodes (see callNode): the
+		function and the constant of the name, so that a parameter or
+		a let named as a function is not a use of the function*/
+		typedef std::unordered_map<int, std::unordered_set<int> > Dependents;
+
+		/* the node of the graph of the name called - the function */
+		static int callNode(int symbol) {
+			return 2 * symbol + 1;
+		}
+
+		/* the node of the name used otherwise - the constant */
+		static int nameNode(int symbol) {
+			return 2 * symbol;
+		}
+
+		std::string variableName;
+
+		/* a table to lookup function by name */
+		parser::FunctionLookupTable* functionLookupTable;
+
+		/* a table to lookup constant by name */
+		parser::ConstantLookupTable* constantLookupTable;
+
+		bool shareSubexpressions;
+
+		/* the entries by the symbol of the name */
+		std::unordered_map<int, Expression> expressions;
+		std::unordered_map<int, Function> functions;
+
+		/* functions and expressions which use each name */
+		Dependents functionDependents;
+		Dependents expressionDependents;
+
+		/* programs and functions compiled by the last change */
+		size_t recompiledCount;
+
+		/* the nodes of the names the tokens use, from the token first */
+		static void findUses(const parser::TokenArray& tokens, size_t first, std::vector<int>& uses);
+
+		/* set the edges from the nodes used to the entry */
+		static void link(Dependents& dependents, int symbol, const std::vector<int>& uses);
+
+		/* remove the edges from the nodes used to the entry */
+		static void unlink(Dependents& dependents, int symbol, const std::vector<int>& uses);
+
+		/* The functions which use the node, directly or through others,
+		in the order of their dependencies - each one after the functions
+		it calls*/
+		void findFunctionDependents(int node, std::vector<int>& order) const;
+
+		/* compile the expression from its text */
+		void compile(Expression& expression);
+
+		/* define the function of the library again, from its text */
+		void redefine(int symbol);
+
+		/* the node has changed: recompile its dependents */
+		void changed(int node);
+
+		/* not copyable */
+		ExpressionLibrary(const ExpressionLibrary& other);
+		ExpressionLibrary& operator =(const ExpressionLibrary& other);
+	public:
+		/* The expressions are of the variable; the tables must outlive
+		the library*/
+		ExpressionLibrary(const std::string& variableName,
+			parser::FunctionLookupTable* functionLookupTable,
+			parser::ConstantLookupTable* constantLookupTable,
+			bool shareSubexpressions = false);
+
+		/* Add the expression of the name, or change it, and compile it.
+		Its error is kept (see getStatus), not thrown.
+		Returns: false on an error*/
+		bool setExpression(const std::string& name, const std::string& text);
+
+		/* Define the function "name(parameter) = expr" (see
+		parser::FunctionDefinition), or define again the function of
+		the library; its dependents are recompiled. The function must
+		not call itself, nor a function which calls it (no recursion).
+		Throws UnknownTokenException, SyntaxException; nothing is changed*/
+		void setFunction(const std::string& text);
+
+		/* Add the constant or change its value; its dependents are
+		recompiled. A builtin constant (as PI) can't be changed.
+		Returns: false if the constant is builtin - nothing is changed*/
+		bool setConstant(const std::string& name, double value);
+
+		/* the program of the expression; NULL if it has an error or
+		there is no such expression*/
+		std::shared_ptr<const Calculator> getProgram(const std::string& name) const;
+
+		/* the error of the expression; ok if compiled (or no such
+		expression)*/
+		parser::Status getStatus(const std::string& name) const;
+
+		/* number of expressions */
+		size_t size() const {
+			return expressions.size();
+		}
+
+		/* programs and functions compiled by the last change - its cost */
+		size_t getRecompiledCount() const {
+			return recompiledCount;
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,267 @@
+
+#include "stdafx.h"
+#include "FlatAst.h"
+
+using namespace std;
+
+namespace parser {
+
+	/*** FlatAst *** *** *** *** *** *** *** *** *** *** *** ***/
+
+	/* Adds the nodes of an AstNode tree: visited in post-order, so the
+	arguments of a node are on the top of the stack when it is visited*/
+	class FlattenVisitor : public AstVisitor {
+	private:
+		FlatAst& ast;
+		/* numbers of the nodes without a parent yet */
+		vector<int> stack;
+
+		void binary(FlatOpcode opcode) {
+			int right = stack.back();
+			stack.pop_back();
+			stack.back() = ast.addBinary(opcode, stack.back(), right);
+		}
+	public:
+		FlattenVisitor(FlatAst& ast) : ast(ast) {
+		}
+
+		int getRoot() {
+			return stack.back();
+		}
+
+		virtual void visit(FloatLiteralAstNode& floatLiteralNode) {
+			stack.push_back(ast.addFloat(floatLiteralNode.getLiteralValue()));
+		}
+
+		virtual void visit(VariableAstNode& variableNode) {
+			stack.push_back(ast.addVariable(variableNode.getSymbol()));
+		}
+
+		virtual void visit(UnaryNegationAstNode& unaryNegationNode) {
+			stack.back() = ast.addNegation(stack.back());
+		}
+
+		virtual void visit(AddOperatorAstNode& addOperatorNode) {
+			binary(FO_ADD);
+		}
+
+		virtual void visit(SubOperatorAstNode& subOperatorNode) {
+			binary(FO_SUB);
+		}
+
+		virtual void visit(MulOperatorAstNode& mulOperatorNode) {
+			binary(FO_MUL);
+		}
+
+		virtual void visit(DivOperatorAstNode& divOperatorNode) {
+			binary(FO_DIV);
+		}
+
+		virtual void visit(PowerOperatorAstNode& powerOperatorNode) {
+			binary(FO_POWER);
+		}
+
+		virtual void visit(FunctionCall1ArgAstNode& funcCallNode) {
+			stack.back() = ast.addCall(funcCallNode.getSymbol(), funcCallNode.getFunction(), stack.back());
+		}
+
+		virtual void visit(ConstantAstNode& constantNode) {
+			stack.push_back(ast.addConstant(constantNode.getSymbol(), constantNode.getValue()));
+		}
+	};
+
+	int FlatAst::add(FlatOpcode opcode, int left, int right, double value) {
+		opcodes.push_back((unsigned char)opcode);
+		lefts.push_back(left);
+		rights.push_back(right);
+		values.push_back(value);
+		return (int)opcodes.size() - 1;
+	}
+
+	int FlatAst::addCall(int symbol, Function1Arg* function, int arg) {
+		//a symbol names the same function in the whole tree
+		if ((size_t)symbol >= functions.size()) {
+			functions.resize(symbol + 1, NULL);
+		}
+		functions[symbol] = function;
+		return add(FO_CALL, arg, symbol, 0.0);
+	}
+
+	int FlatAst::addReference(int node) {
+		if (isTooLarge()) {
+			return addFloat(0.0);
+		}
+		int first = getFirst(node);
+		copiedCount += node + 1 - first;
+		int shift = (int)opcodes.size() - first;
+		for (int i = first; i <= node; i++) {
+			FlatOpcode opcode = getOpcode(i);
+			int left = lefts[i];
+			int right = rights[i];
+			//the arguments are copied before - shifted as well
+			if (opcode >= FO_NEGATION) {
+				left += shift;
+			}
+			if (opcode >= FO_ADD && opcode <= FO_POWER) {
+				right += shift;
+			}
+			add(opcode, left, right, values[i]);
+		}
+		return (int)opcodes.size() - 1;
+	}
+
+	int FlatAst::endScope(int value, int body) {
+		int first = getFirst(value);
+		//no node uses the value - it is removed as a subtree replaced by nothing
+		replaceSubtree(first, value + 1, FlatAst());
+		return body - (value + 1 - first);
+	}
+
+	void FlatAst::replaceSubtree(int first, int end, const FlatAst& part) {
+		int count = (int)part.size();
+		int shift = count - (end - first);
+		opcodes.erase(opcodes.begin() + first, opcodes.begin() + end);
+		opcodes.insert(opcodes.begin() + first, part.opcodes.begin(), part.opcodes.end());
+		lefts.erase(lefts.begin() + first, lefts.begin() + end);
+		lefts.insert(lefts.begin() + first, part.lefts.begin(), part.lefts.end());
+		rights.erase(rights.begin() + first, rights.begin() + end);
+		rights.insert(rights.begin() + first, part.rights.begin(), part.rights.end());
+		values.erase(values.begin() + first, values.begin() + end);
+		values.insert(values.begin() + first, part.values.begin(), part.values.end());
+		for (size_t symbol = 0; symbol < part.functions.size(); symbol++) {
+			if (part.functions[symbol] != NULL) {
+				if (symbol >= functions.size()) {
+					functions.resize(symbol + 1, NULL);
+				}
+				functions[symbol] = part.functions[symbol];
+			}
+		}
+
+		//the part is numbered from 0
+		for (int i = first; i < first + count; i++) {
+			if (opcodes[i] >= FO_NEGATION) {
+				lefts[i] += first;
+			}
+			if (opcodes[i] >= FO_ADD && opcodes[i] <= FO_POWER) {
+				rights[i] += first;
+			}
+		}
+		//the root of the subtree and the nodes after it are moved
+		if (shift != 0) {
+			int size = (int)opcodes.size();
+			for (int i = first + count; i < size; i++) {
+				if (opcodes[i] >= FO_NEGATION && lefts[i] >= end - 1) {
+					lefts[i] += shift;
+				}
+				if (opcodes[i] >= FO_ADD && opcodes[i] <= FO_POWER && rights[i] >= end - 1) {
+					rights[i] += shift;
+				}
+			}
+		}
+	}
+
+	void FlatAst::clear() {
+		copiedCount = 0;
+		opcodes.clear();
+		lefts.clear();
+		rights.clear();
+		values.clear();
+		functions.clear();
+	}
+
+	void FlatAst::reserve(size_t nodeCount) {
+		opcodes.reserve(nodeCount);
+		lefts.reserve(nodeCount);
+		rights.reserve(nodeCount);
+		values.reserve(nodeCount);
+	}
+
+	int FlatAst::addTree(AstNode* ast) {
+		FlattenVisitor visitor(*this);
+		ast->visitPostOrder(visitor);
+		return visitor.getRoot();
+	}
+
+	size_t FlatAst::memorySize() const {
+		return opcodes.capacity() * sizeof(unsigned char)
+			+ lefts.capacity() * sizeof(int)
+			+ rights.capacity() * sizeof(int)
+			+ values.capacity() * sizeof(double)
+			+ functions.capacity() * sizeof(Function1Arg*);
+	}
+
+	void FlatAst::visitPostOrder(AstVisitor& visitor) const {
+		size_t count = opcodes.size();
+		for (size_t i = 0; i < count; i++) {
+			//the temporary node has no arguments, nothing is deleted with it
+			switch (opcodes[i]) {
+			case FO_FLOAT:
+				{
+					FloatLiteralAstNode node(values[i]);
+					visitor.visit(node);
+				}
+				break;
+			case FO_VARIABLE:
+				{
+					VariableAstNode node(rights[i]);
+					visitor.visit(node);
+				}
+				break;
+			case FO_CONSTANT:
+				{
+					ConstantAstNode node(rights[i], values[i]);
+					visitor.visit(node);
+				}
+				break;
+			case FO_NEGATION:
+				{
+					UnaryNegationAstNode node(NULL);
+					visitor.visit(node);
+				}
+				break;
+			case FO_ADD:
+				{
+					AddOperatorAstNode node(NULL, NULL);
+					visitor.visit(node);
+				}
+				break;
+			case FO_SUB:
+				{
+					SubOperatorAstNode node(NULL, NULL);
+					visitor.visit(node);
+				}
+				break;
+			case FO_MUL:
+				{
+					MulOperatorAstNode node(NULL, NULL);
+					visitor.visit(node);
+				}
+				break;
+			case FO_DIV:
+				{
+					DivOperatorAstNode node(NULL, NULL);
+					visitor.visit(node);
+				}
+				break;
+			case FO_POWER:
+				{
+					PowerOperatorAstNode node(NULL, NULL);
+					visitor.visit(node);
+				}
+				break;
+			case FO_CALL:
+				{
+					FunctionCall1ArgAstNode node(rights[i], functions[rights[i]], NULL);
+					visitor.visit(node);
+				}
+				break;
+			default:
+				//should not occur
+				throw "illegal state";
+			}
+		}
+	}
+
+	/*** End of FlatAst *** *** *** *** *** *** *** *** *** ***/
+
+}
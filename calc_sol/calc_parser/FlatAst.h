@@ -0,0 +1,297 @@
+#ifndef FLAT_AST_H
+#define FLAT_AST_H
+
+#include "Parser.h"
+#include <vector>
+
+namespace parser {
+
+	/* operation of a node of FlatAst */
+	enum FlatOpcode {
+		FO_FLOAT = 0,
+		FO_VARIABLE,
+		FO_CONSTANT,
+		FO_NEGATION,
+		FO_ADD,
+		FO_SUB,
+		FO_MUL,
+		FO_DIV,
+		FO_POWER,
+		FO_CALL
+	};
+
+	/* Abstract syntax tree stored flat, without pointers and objects.
+
+	Nodes are numbered 0, 1, 2 ... and kept in parallel arrays indexed
+	by the number: opcode, operands (numbers of the argument nodes or
+	the symbol of a name) and value of a literal or constant - 17 bytes
+	per node. Nodes are
+	stored in post-order - the arguments of a node come before it and
+	the root is the last node - so traversing the tree is a linear scan
+	of the arrays.
+
+	The tree is built by Parser::expr(FlatAst&) or from an AstNode tree.
+	Visitors of AstNode trees visit it as well (see visitPostOrder)*/
+	class FlatAst {
+	private:
+		/* FlatOpcode of each node */
+		std::vector<unsigned char> opcodes;
+		/* the argument of an unary node, the left argument of a binary one */
+		std::vector<int> lefts;
+		/* the right argument of a binary node; the symbol of a variable,
+		constant or function */
+		std::vector<int> rights;
+		/* value of a float literal or a constant */
+		std::vector<double> values;
+		/* function of each symbol called */
+		std::vector<Function1Arg*> functions;
+		/* nodes added by addReference (see MAX_COPIED_NODES) */
+		size_t copiedCount;
+
+		int add(FlatOpcode opcode, int left, int right, double value);
+	public:
+		/* number of the node used as "no argument" */
+		static const int NO_NODE = -1;
+
+		FlatAst() : copiedCount(0) {
+		}
+
+		/* the node type of the parser's builder (see Parser) */
+		typedef int Node;
+
+		/* remove all nodes; the memory is reused */
+		void clear();
+
+		/* allocate memory for the nodes at once */
+		void reserve(size_t nodeCount);
+
+		/* flatten the tree; its nodes are added after the existing ones.
+		Returns: number of its root*/
+		int addTree(AstNode* ast);
+
+		size_t size() const {
+			return opcodes.size();
+		}
+
+		/* Replace the nodes first ... end - 1 - a whole subtree, whose
+		root end - 1 is an argument of a following node only - by the
+		nodes of the tree part. The following nodes are moved and their
+		arguments renumbered (see IncrementalParser)*/
+		void replaceSubtree(int first, int end, const FlatAst& part);
+
+		/* the last node; NO_NODE if empty */
+		int getRoot() const {
+			return (int)opcodes.size() - 1;
+		}
+
+		/* The first node of the subtree of the node - its leftmost leaf;
+		the subtree is the nodes first ... node*/
+		int getFirst(int node) const {
+			while (opcodes[node] >= FO_NEGATION) {
+				node = lefts[node];
+			}
+			return node;
+		}
+
+		FlatOpcode getOpcode(int node) const {
+			return (FlatOpcode)opcodes[node];
+		}
+
+		int getLeft(int node) const {
+			return lefts[node];
+		}
+
+		int getRight(int node) const {
+			return rights[node];
+		}
+
+		double getValue(int node) const {
+			return values[node];
+		}
+
+		int getSymbol(int node) const {
+			return rights[node];
+		}
+
+		Function1Arg* getFunction(int node) const {
+			return functions[rights[node]];
+		}
+
+		/* bytes allocated for the nodes */
+		size_t memorySize() const;
+
+		/* Building: every method adds a node after its arguments.
+		Returns: number of the node*/
+		int addFloat(double value) {
+			return add(FO_FLOAT, NO_NODE, NO_SYMBOL, value);
+		}
+
+		int addVariable(int symbol) {
+			return add(FO_VARIABLE, NO_NODE, symbol, 0.0);
+		}
+
+		int addConstant(int symbol, double value) {
+			return add(FO_CONSTANT, NO_NODE, symbol, value);
+		}
+
+		int addNegation(int arg) {
+			return add(FO_NEGATION, arg, NO_NODE, 0.0);
+		}
+
+		/* FO_ADD ... FO_POWER */
+		int addBinary(FlatOpcode opcode, int left, int right) {
+			return add(opcode, left, right, 0.0);
+		}
+
+		int addCall(int symbol, Function1Arg* function, int arg);
+
+		/* A copy of the subtree of the node - the value of a let binding
+		at its use (see Parser). Past MAX_COPIED_NODES nodes copied, a
+		float 0 instead - the tree is too large (see isTooLarge)*/
+		int addReference(int node);
+
+		/* more nodes were copied than MAX_COPIED_NODES: the tree is
+		not the expression, the parser fails*/
+		bool isTooLarge() const {
+			return copiedCount > MAX_COPIED_NODES;
+		}
+
+		/* The let binding of the value is out of scope: the subtree of
+		the value is removed - it was copied where used.
+		Returns: number of the node body after the removal*/
+		int endScope(int value, int body);
+
+		/* Visit every node in post-order, as AstNode::visitPostOrder
+		does. The visitor is given a temporary AstNode of the node -
+		a view valid during the call; its arguments are not set (they
+		were visited before)*/
+		void visitPostOrder(AstVisitor& visitor) const;
+	};
+
+	/* Builder of the AstNode tree for the parsers (see Parser): the
+	same building methods as FlatAst, which builds the flat tree*/
+	class AstTreeBuilder {
+	private:
+		/* memory of the nodes; NULL is the heap */
+		MemoryResource* resource;
+		/* nodes added by addReference */
+		size_t copiedCount;
+	public:
+		typedef AstNode* Node;
+
+		AstTreeBuilder(MemoryResource* resource) : resource(resource), copiedCount(0) {
+		}
+
+		AstNode* addFloat(double value) {
+			return new (resource) FloatLiteralAstNode(value);
+		}
+
+		AstNode* addVariable(int symbol) {
+			return new (resource) VariableAstNode(symbol);
+		}
+
+		AstNode* addConstant(int symbol, double value) {
+			return new (resource) ConstantAstNode(symbol, value);
+		}
+
+		AstNode* addNegation(AstNode* arg) {
+			return new (resource) UnaryNegationAstNode(arg);
+		}
+
+		AstNode* addBinary(FlatOpcode opcode, AstNode* left, AstNode* right) {
+			switch (opcode) {
+			case FO_ADD:
+				return new (resource) AddOperatorAstNode(left, right);
+			case FO_SUB:
+				return new (resource) SubOperatorAstNode(left, right);
+			case FO_MUL:
+				return new (resource) MulOperatorAstNode(left, right);
+			case FO_DIV:
+				return new (resource) DivOperatorAstNode(left, right);
+			case FO_POWER:
+				return new (resource) PowerOperatorAstNode(left, right);
+			default:
+				//should not occur
+				throw "illegal state";
+			}
+		}
+
+		AstNode* addCall(int symbol, Function1Arg* function, AstNode* arg) {
+			return new (resource) FunctionCall1ArgAstNode(symbol, function, arg);
+		}
+
+		/* a copy of the value of a let binding at its use; past the
+		limit a float 0, as FlatAst::addReference*/
+		AstNode* addReference(AstNode* value) {
+			if (isTooLarge()) {
+				return addFloat(0.0);
+			}
+			size_t count;
+			AstNode* copy = copyAst(value, resource, count);
+			copiedCount += count;
+			return copy;
+		}
+
+		bool isTooLarge() const {
+			return copiedCount > MAX_COPIED_NODES;
+		}
+
+		/* the binding is out of scope - the value was copied where used */
+		AstNode* endScope(AstNode* value, AstNode* body) {
+			//a tree in a resource is freed with the resource
+			if (resource == NULL) {
+				delete value;
+			}
+			return body;
+		}
+	};
+
+	/* Builder given the nodes as the parser recognizes them, without
+	any tree: the arguments of a node are always given before it, so
+	the calls come in post-order - the order of the Reverse Polish
+	Notation (see PrecedenceParser::expr(PostOrderBuilder&)).
+	The node numbers are chosen by the builder, the parser only passes
+	them back as arguments*/
+	class PostOrderBuilder {
+	public:
+		typedef int Node;
+
+		virtual ~PostOrderBuilder() {
+		}
+
+		virtual int addFloat(double value) = 0;
+
+		virtual int addVariable(int symbol) = 0;
+
+		virtual int addConstant(int symbol, double value) = 0;
+
+		virtual int addNegation(int arg) = 0;
+
+		/* FO_ADD ... FO_POWER */
+		virtual int addBinary(FlatOpcode opcode, int left, int right) = 0;
+
+		virtual int addCall(int symbol, Function1Arg* function, int arg) = 0;
+
+		/* The value of a let binding used: by default the node is an
+		argument once more - the nodes are a DAG, the value is built
+		once however often it is used*/
+		virtual int addReference(int value) {
+			return value;
+		}
+
+		/* the let binding of the value is out of scope; the number of
+		the body is returned*/
+		virtual int endScope(int value, int body) {
+			return body;
+		}
+
+		/* the copies of the values were too many (see FlatAst): the
+		parser fails. Never by default - no copy*/
+		virtual bool isTooLarge() const {
+			return false;
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef FLOAT_CONV_H
+#define FLOAT_CONV_H
+
+#include <cstddef>
+#include <string>
+
+namespace parser {
+
+	/* size of a buffer which holds any text written by formatFloat,
+	including the terminating 0 */
+	const size_t FLOAT_TEXT_SIZE = 32;
+
+	/* Convert decimal text to the nearest double (ties to even), as
+	strtod in the "C" locale does, without reading past end.
+
+	Text ::= -?([0-9]+(\.[0-9]+)?([eE][+-]?[0-9]+)? | inf | nan)
+
+	Most texts are converted exactly in a few integer operations
+	(Clinger's fast path, then the Eisel-Lemire algorithm with
+	a table of 128-bit powers of 5); the rare texts the table cannot
+	decide are passed to strtod in the "C" locale, so these are
+	correctly rounded only where the C library is (the CRT of
+	Visual Studio 2010 is not). Values too large are infinite,
+	values too small are (signed) zero.
+	Returns: false if the text has another syntax; value is not set*/
+	bool parseFloat(const char* begin, const char* end, double& value);
+
+	/* convert the text of a Float lexem (see the "Lexer" class)
+	to double; the text must be valid*/
+	double parseFloatLexem(const char* begin, const char* end);
+
+	/* Write the shortest decimal text which parseFloat reads back
+	as exactly the same value: "0.1", "1e+300", "-2.5", "inf", "nan".
+	The exponent has at least 2 digits, as in C99 printf: "1e+20",
+	"1e-05", on every C library.
+	The buffer must hold FLOAT_TEXT_SIZE characters.
+	Returns: length of the text; the text is 0-terminated*/
+	size_t formatFloat(double value, char* buffer);
+
+	/* see formatFloat(double, char*) */
+	std::string formatFloat(double value);
+
+}
+
+#endif
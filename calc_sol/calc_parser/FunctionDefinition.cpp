@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "FunctionDefinition.h"
+#include "PrecedenceParser.h"
+#include <cmath>
+
+using namespace std;
+
+namespace parser {
+
+	/*** FunctionDefinition *** *** *** *** *** *** *** *** *** ***/
+
+	FunctionDefinition::FunctionDefinition()
+		: symbol(NO_SYMBOL)
+		, parameter(NO_SYMBOL) {
+	}
+
+	void FunctionDefinition::define(FunctionLookupTable& functionLookupTable,
+		ConstantLookupTable* constantLookupTable, const string& text) {
+
+			Status status;
+			if (!define(functionLookupTable, constantLookupTable, text, status)) {
+				status.raise();
+			}
+	}
+
+	bool FunctionDefinition::define(FunctionLookupTable& functionLookupTable,
+		ConstantLookupTable* constantLookupTable, const string& text, Status& status) {
+
+			SourceBuffer source(text.data(), text.size());
+			PrecedenceParser parser(source, constantLookupTable, &functionLookupTable);
+			if (!parser.begin(status)) {
+				return false;
+			}
+			auto_ptr<FunctionDefinition> definition(new FunctionDefinition());
+			if (!parser.definition(definition->symbol, definition->parameter, definition->body, status)) {
+				return false;
+			}
+			definition->findShared();
+			functionLookupTable.add(definition->symbol, definition.get());
+			definition.release();
+			return true;
+	}
+
+	void FunctionDefinition::findShared() {
+		vector<int> uses(body.size(), 0);
+		for (int node = 0; node < (int)body.size(); node++) {
+			FlatOpcode opcode = body.getOpcode(node);
+			if (opcode >= FO_NEGATION) {
+				uses[body.getLeft(node)]++;
+			}
+			if (opcode >= FO_ADD && opcode <= FO_POWER) {
+				uses[body.getRight(node)]++;
+			}
+		}
+		//a leaf is built again at every use - as cheap as a reference
+		shared.assign(body.size(), false);
+		for (int node = 0; node < (int)body.size(); node++) {
+			shared[node] = uses[node] > 1 && body.getOpcode(node) >= FO_NEGATION;
+		}
+	}
+
+	double FunctionDefinition::eval(double in) {
+		//the value of each node, in post-order
+		vector<double> values(body.size());
+		for (int node = 0; node < (int)body.size(); node++) {
+			switch (body.getOpcode(node)) {
+			case FO_FLOAT:
+			case FO_CONSTANT:
+				values[node] = body.getValue(node);
+				break;
+			case FO_VARIABLE:
+				values[node] = in;
+				break;
+			case FO_NEGATION:
+				values[node] = -values[body.getLeft(node)];
+				break;
+			case FO_ADD:
+				values[node] = values[body.getLeft(node)] + values[body.getRight(node)];
+				break;
+			case FO_SUB:
+				values[node] = values[body.getLeft(node)] - values[body.getRight(node)];
+				break;
+			case FO_MUL:
+				values[node] = values[body.getLeft(node)] * values[body.getRight(node)];
+				break;
+			case FO_DIV:
+				values[node] = values[body.getLeft(node)] / values[body.getRight(node)];
+				break;
+			case FO_POWER:
+				values[node] = pow(values[body.getLeft(node)], values[body.getRight(node)]);
+				break;
+			case FO_CALL:
+				values[node] = body.getFunction(node)->eval(values[body.getLeft(node)]);
+				break;
+			}
+		}
+		return values[body.getRoot()];
+	}
+
+	/*** End of FunctionDefinition *** *** *** *** *** *** *** ***/
+
+}
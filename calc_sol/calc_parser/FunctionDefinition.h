@@ -0,0 +1,179 @@
+#ifndef FUNCTION_DEFINITION_H
+#define FUNCTION_DEFINITION_H
+
+#include "Parser.h"
+#include "FlatAst.h"
+#include "Status.h"
+#include <string>
+#include <vector>
+
+namespace parser {
+
+	/* A function defined by an expression of its parameter, as
+	"g(t) = t^2 + 1", kept in a FunctionLookupTable with the native
+	functions - the table is the library of the calculators compiled
+	with it, and is shared as it is.
+
+	The definition is parsed once, when it is added, into the DAG of
+	its body (see PrecedenceParser::definition): its constants and
+	functions are looked up then, the calls of the functions defined
+	before are inlined already. The parameter is a single node, used
+	by all its uses, and so is the argument of a call inlined - a call
+	adds the nodes of the body once, whatever the size of the argument.
+	The parsers inline every call as well (see inlineCall): the body
+	is built in place of the call, the parameter bound to the argument
+	as the name of a let binding. The program of the caller is the
+	formula written out by hand - no call is left in it. eval serves
+	the programs not parsed from an expression (RPN input).
+
+	A function calls only those defined before it - no recursion*/
+	class FunctionDefinition : public Function1Arg {
+	private:
+		/* the name and the parameter */
+		int symbol;
+		int parameter;
+
+		/* the body: a DAG in post-order (see SharedAstBuilder); the
+		parameter is its only variable*/
+		FlatAst body;
+		/* the operations of the body used by several nodes */
+		std::vector<bool> shared;
+
+		FunctionDefinition();
+
+		/* find the shared operations of the body */
+		void findShared();
+
+		/* Build the node of the body: the parameter and the shared
+		operations below it are references to their bindings, the
+		other nodes are used once and built in place, the arguments
+		first (an explicit stack - any depth).
+		Returns: the node built*/
+		template <class Builder>
+		typename Builder::Node inlineNode(Builder& builder, int root,
+			const std::vector<typename Builder::Node>& nodes) const {
+
+				//nodes to build; ~node - its arguments are built already
+				std::vector<int> pending(1, root);
+				//the nodes built, not an argument yet
+				std::vector<typename Builder::Node> built;
+				while (!pending.empty()) {
+					int node = pending.back();
+					pending.pop_back();
+					if (node < 0) {
+						node = ~node;
+						FlatOpcode opcode = body.getOpcode(node);
+						if (opcode == FO_NEGATION) {
+							built.back() = builder.addNegation(built.back());
+						} else if (opcode == FO_CALL) {
+							built.back() = builder.addCall(body.getSymbol(node),
+								body.getFunction(node), built.back());
+						} else {
+							typename Builder::Node right = built.back();
+							built.pop_back();
+							built.back() = builder.addBinary(opcode, built.back(), right);
+						}
+						continue;
+					}
+					FlatOpcode opcode = body.getOpcode(node);
+					switch (opcode) {
+					case FO_FLOAT:
+						built.push_back(builder.addFloat(body.getValue(node)));
+						break;
+					case FO_VARIABLE:
+						//the parameter
+						built.push_back(builder.addReference(nodes[node]));
+						break;
+					case FO_CONSTANT:
+						built.push_back(builder.addConstant(body.getSymbol(node), body.getValue(node)));
+						break;
+					default:
+						if (shared[node] && node != root) {
+							built.push_back(builder.addReference(nodes[node]));
+							break;
+						}
+						//the left argument is built first
+						pending.push_back(~node);
+						if (opcode >= FO_ADD && opcode <= FO_POWER) {
+							pending.push_back(body.getRight(node));
+						}
+						pending.push_back(body.getLeft(node));
+						break;
+					}
+				}
+				return built.back();
+		}
+
+		/* not copyable */
+		FunctionDefinition(const FunctionDefinition& other);
+		FunctionDefinition& operator =(const FunctionDefinition& other);
+	public:
+		/* Parse the definition "name(parameter) = expr" and add the
+		function to the table, which owns it. The name must be new
+		in the table; the expression uses the constants of the table
+		given, no variable but the parameter. The body has at most
+		MAX_COPIED_NODES nodes ("function too large").
+		Throws UnknownTokenException, SyntaxException*/
+		static void define(FunctionLookupTable& functionLookupTable,
+			ConstantLookupTable* constantLookupTable, const std::string& text);
+
+		/* As define above; an error is set in the status instead of
+		thrown.
+		Returns: false on an error - nothing is added*/
+		static bool define(FunctionLookupTable& functionLookupTable,
+			ConstantLookupTable* constantLookupTable, const std::string& text,
+			Status& status);
+
+		int getSymbol() const {
+			return symbol;
+		}
+
+		int getParameter() const {
+			return parameter;
+		}
+
+		const FlatAst& getBody() const {
+			return body;
+		}
+
+		virtual FunctionDefinition* getDefinition() {
+			return this;
+		}
+
+		/* the body evaluated for the parameter */
+		virtual double eval(double in);
+
+		/* Build the body in place of a call for the builder of a parser
+		(see Parser). The argument and the shared operations of the body
+		are bound as the values of let bindings, the innermost last:
+		each use is a reference to the binding, which is out of scope
+		after the body. A builder of a DAG builds every node of the body
+		once; a builder of a tree copies the binding at every use - the
+		tree is the formula written out, the parser fails past
+		MAX_COPIED_NODES nodes copied (see isTooLarge of the builders).
+		Returns: the node of the body*/
+		template <class Builder>
+		typename Builder::Node inlineCall(Builder& builder, typename Builder::Node arg) const {
+			//the binding of each node, in the order of the body - the
+			//arguments are bound before the operations using them
+			std::vector<typename Builder::Node> nodes(body.size());
+			for (int node = 0; node < (int)body.size(); node++) {
+				if (body.getOpcode(node) == FO_VARIABLE) {
+					nodes[node] = arg;
+				} else if (shared[node]) {
+					nodes[node] = inlineNode(builder, node, nodes);
+				}
+			}
+			typename Builder::Node result = inlineNode(builder, body.getRoot(), nodes);
+			for (int node = body.getRoot(); node >= 0; node--) {
+				if (shared[node]) {
+					result = builder.endScope(nodes[node], result);
+				}
+			}
+			return builder.endScope(arg, result);
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,293 @@
+#include "stdafx.h"
+#include "IncrementalParser.h"
+#include "PrecedenceParser.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace parser {
+
+	/*** IncrementalParser *** *** *** *** *** *** *** *** *** ***/
+
+	/* Builds the flat tree and keeps the token read by the parser
+	when it built each node*/
+	class SpanBuilder : public PostOrderBuilder {
+	private:
+		FlatAst& ast;
+		vector<size_t>& nodeTokens;
+		PrecedenceParser& parser;
+
+		int added(int node) {
+			nodeTokens.push_back(parser.getTokenIndex());
+			return node;
+		}
+	public:
+		SpanBuilder(FlatAst& ast, vector<size_t>& nodeTokens, PrecedenceParser& parser)
+			: ast(ast), nodeTokens(nodeTokens), parser(parser) {
+		}
+
+		virtual int addFloat(double value) {
+			return added(ast.addFloat(value));
+		}
+
+		virtual int addVariable(int symbol) {
+			return added(ast.addVariable(symbol));
+		}
+
+		virtual int addConstant(int symbol, double value) {
+			return added(ast.addConstant(symbol, value));
+		}
+
+		virtual int addNegation(int arg) {
+			return added(ast.addNegation(arg));
+		}
+
+		virtual int addBinary(FlatOpcode opcode, int left, int right) {
+			return added(ast.addBinary(opcode, left, right));
+		}
+
+		virtual int addCall(int symbol, Function1Arg* function, int arg) {
+			return added(ast.addCall(symbol, function, arg));
+		}
+
+		virtual int addReference(int value) {
+			//the nodes of the copy are built at the use
+			int node = ast.addReference(value);
+			nodeTokens.resize(ast.size(), parser.getTokenIndex());
+			return node;
+		}
+
+		virtual int endScope(int value, int body) {
+			int first = ast.getFirst(value);
+			nodeTokens.erase(nodeTokens.begin() + first, nodeTokens.begin() + value + 1);
+			return ast.endScope(value, body);
+		}
+
+		virtual bool isTooLarge() const {
+			return ast.isTooLarge();
+		}
+	};
+
+	/* Some of the tokens first ... end - 1 is Assign - of a let binding,
+	or the name of a function defined by an expression - its call is
+	inlined (see FunctionDefinition)*/
+	static bool hasCopies(const TokenArray& tokens, size_t first, size_t end,
+		FunctionLookupTable* functionLookupTable) {
+
+			Function1Arg* function;
+			for (size_t i = first; i < end; i++) {
+				LexemKind kind = tokens.getKind(i);
+				if (kind == LK_ASSIGN) {
+					return true;
+				}
+				if (kind == LK_IDENTIFIER && functionLookupTable != NULL
+					&& functionLookupTable->find(tokens.getSymbol(i), function)
+					&& function->getDefinition() != NULL) {
+						return true;
+				}
+			}
+			return false;
+	}
+
+	IncrementalParser::IncrementalParser(ConstantLookupTable* constantLookupTable,
+		FunctionLookupTable* functionLookupTable)
+		: constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, tokens(new TokenArray())
+		, nextTokens(new TokenArray())
+		, parsedEnd(0)
+		, hasTree(false)
+		, hasBindings(false)
+		, parsed(false)
+		, changeOffset(0)
+		, changeRemoved(0)
+		, changeInserted(0)
+		, changedNode(0)
+		, removedNodes(0)
+		, addedNodes(0)
+		, lexedTokens(0)
+		, parsedTokens(0) {
+	}
+
+	IncrementalParser::~IncrementalParser() {
+		delete tokens;
+		delete nextTokens;
+	}
+
+	void IncrementalParser::parse(const char* data, size_t length) {
+		text.assign(data, length);
+		//nothing to be reused
+		hasTree = false;
+		parsed = false;
+		parseAll();
+	}
+
+	void IncrementalParser::edit(size_t offset, size_t removedLength, const char* inserted, size_t insertedLength) {
+		text.replace(offset, removedLength, inserted, insertedLength);
+		if (!hasTree) {
+			parseAll();
+			return;
+		}
+		if (parsed) {
+			changeOffset = offset;
+			changeRemoved = removedLength;
+			changeInserted = insertedLength;
+		} else {
+			//one change from the text parsed, over both changes and the text between them
+			size_t start = min(changeOffset, offset);
+			size_t end = max(changeOffset + changeInserted, offset + removedLength);
+			changeRemoved = end - changeInserted + changeRemoved - start;
+			changeInserted = end - removedLength + insertedLength - start;
+			changeOffset = start;
+		}
+		parsed = false;
+		parseChange();
+	}
+
+	size_t IncrementalParser::parsePart(size_t first) {
+		part.clear();
+		partTokens.clear();
+		PrecedenceParser parser(*nextTokens, constantLookupTable, functionLookupTable);
+		parser.begin(first);
+		SpanBuilder builder(part, partTokens, parser);
+		parser.expr(builder);
+		return parser.getTokenIndex();
+	}
+
+	void IncrementalParser::parseAll() {
+		nextTokens->tokenize(text.data(), text.size());
+		lexedTokens = nextTokens->size();
+		parseTokens();
+	}
+
+	void IncrementalParser::parseTokens() {
+		size_t end = parsePart(0);
+		removedNodes = (int)ast.size();
+		ast = part;
+		nodeTokens.swap(partTokens);
+		parsedEnd = end;
+		hasBindings = hasCopies(*nextTokens, 0, end, functionLookupTable);
+		swap(tokens, nextTokens);
+		hasTree = true;
+		parsed = true;
+		changedNode = 0;
+		addedNodes = (int)ast.size();
+		parsedTokens = end;
+	}
+
+	/*
+	Technological note:
+	the nodes built while the parser reads the tokens of an expression
+	in parentheses and its closing parenthesis are the nodes of the
+	expression - nothing outside of the parentheses is built then: the
+	operators before the parenthesis wait on the stack, its minus or
+	call is built after the closing parenthesis is read. The tokens of
+	the nodes never decrease, so the nodes of the expression are found
+	by binary search.
+
+	The expression parsed alone, from its first token on, stops at its
+	closing parenthesis. The parser of the whole text would have built
+	the same nodes, and the tokens before and after are the same - the
+	rest of the tree is the same too*/
+	void IncrementalParser::parseChange() {
+		size_t first, previousEnd, end;
+		nextTokens->relex(*tokens, text.data(), text.size(),
+			changeOffset, changeRemoved, changeInserted, first, previousEnd, end);
+		lexedTokens = end - first;
+		//tokens from previousEnd on move by shift (modulo size_t)
+		size_t shift = end - previousEnd;
+		if (first > parsedEnd) {
+			//only the rest not parsed has changed
+			swap(tokens, nextTokens);
+			parsed = true;
+			changedNode = (int)ast.size();
+			removedNodes = 0;
+			addedNodes = 0;
+			parsedTokens = 0;
+			return;
+		}
+		if (hasBindings || hasCopies(*nextTokens, first, end, functionLookupTable)) {
+			//the values of the bindings are copied where used
+			parseTokens();
+			return;
+		}
+
+		//the parentheses around the changed tokens, from the innermost
+		//one; open and close are tokens of the text parsed
+		size_t open = first;
+		size_t close = first;
+		bool reparsed = false;
+		while (!reparsed) {
+			int depth = 0;
+			bool found = false;
+			while (open > 0) {
+				open--;
+				LexemKind kind = tokens->getKind(open);
+				if (kind == LK_CPAREN) {
+					depth++;
+				} else if (kind == LK_OPAREN) {
+					if (depth == 0) {
+						found = true;
+						break;
+					}
+					depth--;
+				}
+			}
+			if (!found) {
+				break;
+			}
+			depth = 0;
+			found = false;
+			for (; close < parsedEnd; close++) {
+				LexemKind kind = tokens->getKind(close);
+				if (kind == LK_OPAREN) {
+					depth++;
+				} else if (kind == LK_CPAREN) {
+					if (depth == 0) {
+						found = true;
+						break;
+					}
+					depth--;
+				}
+			}
+			if (!found) {
+				//not parsed, nor the parentheses around
+				break;
+			}
+			if (close >= previousEnd) {
+				try {
+					reparsed = (parsePart(open + 1) == close + shift);
+				} catch (SyntaxException&) {
+					//not an expression any more - try the parentheses around
+				}
+			}
+			if (!reparsed) {
+				close++;
+			}
+		}
+		if (!reparsed) {
+			parseTokens();
+			return;
+		}
+
+		//the nodes of the expression in parentheses
+		int firstNode = (int)(lower_bound(nodeTokens.begin(), nodeTokens.end(), open + 1) - nodeTokens.begin());
+		int endNode = (int)(upper_bound(nodeTokens.begin(), nodeTokens.end(), close) - nodeTokens.begin());
+		ast.replaceSubtree(firstNode, endNode, part);
+		nodeTokens.erase(nodeTokens.begin() + firstNode, nodeTokens.begin() + endNode);
+		nodeTokens.insert(nodeTokens.begin() + firstNode, partTokens.begin(), partTokens.end());
+		for (size_t i = firstNode + partTokens.size(); i < nodeTokens.size(); i++) {
+			nodeTokens[i] += shift;
+		}
+		parsedEnd += shift;
+		swap(tokens, nextTokens);
+		parsed = true;
+		changedNode = firstNode;
+		removedNodes = endNode - firstNode;
+		addedNodes = (int)part.size();
+		parsedTokens = close + shift - open;
+	}
+
+	/*** End of IncrementalParser *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,179 @@
+#ifndef INCREMENTAL_PARSER_H
+#define INCREMENTAL_PARSER_H
+
+#include "Parser.h"
+#include "FlatAst.h"
+#include "TokenArray.h"
+#include <string>
+#include <vector>
+
+namespace parser {
+
+	/* Parser of a text being edited (in an editor, a formula field ...):
+	after a small change the tokens and the tree are brought up to date
+	in time of the change, not of the whole text.
+
+	Only the tokens which read the changed characters are lexed again
+	(see TokenArray::relex). Then only the innermost expression in
+	parentheses (or the argument of a call) around the changed tokens
+	is parsed again: the tokens outside of it are the same, so is the
+	rest of the tree - its nodes are kept, moved to make room for the
+	new nodes of the expression (see FlatAst::replaceSubtree). If the
+	expression is not parsed up to its closing parenthesis any more,
+	the parenthesis around it is tried, finally the whole text.
+
+	Each node keeps the token read when it was built (its span): the
+	nodes of an expression in parentheses are exactly the nodes built
+	while its tokens and its closing parenthesis were read, a range of
+	the post-order found by binary search.
+
+	The tokens and the tree are always those of PrecedenceParser with
+	the whole text; so are the errors. After an error the text is
+	changed anyway, the tree stays the one of the last text parsed and
+	the next change is parsed together with the ones since. The lookup
+	tables must not change between the changes (parse the text again).
+
+	The tree has the value of a let binding at each use of its name
+	(see Parser), so a change of the value changes nodes elsewhere: a
+	text with let bindings is parsed whole after every change. So is
+	a text calling a function defined by an expression, whose argument
+	is at each use of the parameter*/
+	class IncrementalParser {
+	private:
+		/* a table to lookup constant by name */
+		ConstantLookupTable* constantLookupTable;
+
+		/* a table to lookup function by name */
+		FunctionLookupTable* functionLookupTable;
+
+		/* the current text */
+		std::string text;
+
+		/* tokens of the last text parsed */
+		TokenArray* tokens;
+		/* tokens of the text being parsed; swapped with tokens */
+		TokenArray* nextTokens;
+
+		/* the tree of the last text parsed */
+		FlatAst ast;
+		/* token read by the parser when it built each node */
+		std::vector<size_t> nodeTokens;
+		/* the first token not parsed */
+		size_t parsedEnd;
+		/* the tree of a part parsed again; reused */
+		FlatAst part;
+		std::vector<size_t> partTokens;
+
+		/* the tree exists (the text was parsed once) */
+		bool hasTree;
+		/* the text parsed has let bindings or inlined calls */
+		bool hasBindings;
+		/* the tree is of the current text */
+		bool parsed;
+		/* changes since the text parsed: the removedLength characters
+		at offset were replaced by insertedLength characters */
+		size_t changeOffset;
+		size_t changeRemoved;
+		size_t changeInserted;
+
+		/* the last change of the tree */
+		int changedNode;
+		int removedNodes;
+		int addedNodes;
+		/* tokens lexed and parsed by the last parse */
+		size_t lexedTokens;
+		size_t parsedTokens;
+
+		/* parse the whole current text */
+		void parseAll();
+
+		/* parse the changes since the text parsed */
+		void parseChange();
+
+		/* parse all of nextTokens, the tokens of the current text */
+		void parseTokens();
+
+		/* Parse the expression from the token first of nextTokens on
+		into part.
+		Returns: the first token not parsed*/
+		size_t parsePart(size_t first);
+
+		/* not copyable */
+		IncrementalParser(const IncrementalParser& other);
+		IncrementalParser& operator =(const IncrementalParser& other);
+	public:
+		IncrementalParser(ConstantLookupTable* constantLookupTable,
+			FunctionLookupTable* functionLookupTable);
+
+		~IncrementalParser();
+
+		/* Parse the whole text; it is copied.
+		Throws UnknownTokenException, SyntaxException*/
+		void parse(const char* data, size_t length);
+
+		/* Replace removedLength characters at the offset by the inserted
+		characters and parse the change. The offset and the length must
+		be in the current text.
+		Throws UnknownTokenException, SyntaxException*/
+		void edit(size_t offset, size_t removedLength, const char* inserted, size_t insertedLength);
+
+		/* the tree and the tokens are of the current text (the last
+		parse or change succeeded)*/
+		bool isParsed() const {
+			return parsed;
+		}
+
+		const std::string& getText() const {
+			return text;
+		}
+
+		/* tokens of the current text; only if isParsed */
+		const TokenArray& getTokens() const {
+			return *tokens;
+		}
+
+		/* tree of the text parsed last */
+		const FlatAst& getAst() const {
+			return ast;
+		}
+
+		/* the token read by the parser when it built the node */
+		size_t getNodeToken(int node) const {
+			return nodeTokens[node];
+		}
+
+		/* the first token not parsed (the rest is ignored as by Parser) */
+		size_t getParsedEnd() const {
+			return parsedEnd;
+		}
+
+		/* The last change of the tree: removedNodes nodes from
+		changedNode on were replaced by addedNodes nodes; the nodes
+		after them were moved (see FlatAst::replaceSubtree)*/
+		int getChangedNode() const {
+			return changedNode;
+		}
+
+		int getRemovedNodes() const {
+			return removedNodes;
+		}
+
+		int getAddedNodes() const {
+			return addedNodes;
+		}
+
+		/* tokens lexed by the last parse; tokens lexed and changed by
+		the last change*/
+		size_t getLexedTokens() const {
+			return lexedTokens;
+		}
+
+		/* tokens parsed by the last parse or change */
+		size_t getParsedTokens() const {
+			return parsedTokens;
+		}
+	};
+
+}
+
+#endif
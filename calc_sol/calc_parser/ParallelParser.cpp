@@ -0,0 +1,291 @@
+
+#include "stdafx.h"
+#include "ParallelParser.h"
+#include "DfaLexer.h"
+#include "Threads.h"
+#include <vector>
+
+using namespace std;
+
+namespace parser {
+
+	using namespace dfa;
+
+	/*** Tasks *** *** *** *** *** *** *** *** *** *** *** ***/
+
+	/* a part of the source, lexed separately (passes 1 and 3) */
+	class LexPartTask : public Task {
+	public:
+		/* the text of the part */
+		const char* begin;
+		size_t offset;
+		size_t length;
+		/* tokens of the part */
+		TokenArray tokens;
+		/* change of the parenthesis depth over the part */
+		int depthChange;
+		/* the part cannot be lexed */
+		bool failed;
+
+		/* filled in pass 2: index of the first token in the joined
+		tokens, depth at the start, kind of the token before the part */
+		size_t firstToken;
+		int depth;
+		LexemKind previousKind;
+
+		/* pass 3: the splitting Plus/Minus tokens */
+		vector<size_t> splits;
+
+		LexPartTask(const char* begin, size_t offset, size_t length)
+			: begin(begin), offset(offset), length(length), depthChange(0), failed(false),
+			firstToken(0), depth(0), previousKind(LK_EOF) {
+		}
+
+		/* pass 1 */
+		virtual void run() {
+			try {
+				tokens.tokenize(begin, length);
+			} catch (UnknownTokenException&) {
+				failed = true;
+				return;
+			}
+			size_t count = tokens.size() - 1;
+			for (size_t i = 0; i < count; i++) {
+				LexemKind kind = tokens.getKind(i);
+				if (kind == LK_OPAREN) {
+					depthChange++;
+				} else if (kind == LK_CPAREN) {
+					depthChange--;
+				}
+			}
+		}
+
+		/* last token of the part; LK_EOF if it has no tokens */
+		LexemKind lastKind() const {
+			return tokens.size() > 1 ? tokens.getKind(tokens.size() - 2) : LK_EOF;
+		}
+
+		/* pass 3 */
+		void join(TokenArray& joined) {
+			joined.joinPart(firstToken, tokens, offset);
+			size_t count = tokens.size() - 1;
+			LexemKind previous = previousKind;
+			int d = depth;
+			for (size_t i = 0; i < count; i++) {
+				LexemKind kind = tokens.getKind(i);
+				if (kind == LK_OPAREN) {
+					d++;
+				} else if (kind == LK_CPAREN) {
+					d--;
+				} else if (d == 0 && (kind == LK_PLUS || kind == LK_MINUS)
+					&& (previous == LK_FLOAT || previous == LK_IDENTIFIER || previous == LK_CPAREN)) {
+						//binary operator of the add_expr; a Minus after
+						//anything else is the unary minus of a factor
+						splits.push_back(firstToken + i);
+				}
+				previous = kind;
+			}
+		}
+	};
+
+	/* pass 3 of a part */
+	class JoinPartTask : public Task {
+	private:
+		LexPartTask& part;
+		TokenArray& joined;
+	public:
+		JoinPartTask(LexPartTask& part, TokenArray& joined)
+			: part(part), joined(joined) {
+		}
+
+		virtual void run() {
+			part.join(joined);
+		}
+	};
+
+	/* consecutive mul_expr terms of the add_expr (pass 4) */
+	class ParseTermsTask : public Task {
+	private:
+		const TokenArray& tokens;
+		ConstantLookupTable* constantLookupTable;
+		FunctionLookupTable* functionLookupTable;
+		/* token after each term, the next term starts after it */
+		const vector<size_t>& termEnds;
+		size_t firstTerm;
+		size_t lastTerm;
+		/* AST of each term */
+		vector<AstNode*>& terms;
+	public:
+		/* a term cannot be parsed or is parsed differently by Parser::expr */
+		bool failed;
+
+		ParseTermsTask(const TokenArray& tokens,
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			const vector<size_t>& termEnds, size_t firstTerm, size_t lastTerm, vector<AstNode*>& terms)
+			: tokens(tokens), constantLookupTable(constantLookupTable), functionLookupTable(functionLookupTable),
+			termEnds(termEnds), firstTerm(firstTerm), lastTerm(lastTerm), terms(terms), failed(false) {
+		}
+
+		virtual void run() {
+			Parser parser(tokens, constantLookupTable, functionLookupTable);
+			for (size_t t = firstTerm; t < lastTerm; t++) {
+				size_t first = (t == 0) ? 0 : termEnds[t - 1] + 1;
+				try {
+					terms[t] = parser.begin(first).mulExpr();
+				} catch (SyntaxException&) {
+					failed = true;
+					return;
+				}
+				//the term must end just before the splitting operator
+				if (parser.getTokenIndex() != termEnds[t]) {
+					failed = true;
+					return;
+				}
+			}
+		}
+	};
+
+	/*** End of Tasks *** *** *** *** *** *** *** *** *** ***/
+
+	/*** ParallelParser *** *** *** *** *** *** *** *** *** ***/
+
+	ParallelParser::ParallelParser(const SourceBuffer& source,
+		ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+		unsigned int threadCount)
+		: source(source)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, threadCount(threadCount > 0 ? threadCount : hardwareThreads())
+		, minParallelLength(MIN_PARALLEL_LENGTH) {
+	}
+
+	AstNode* ParallelParser::expr() {
+		AstNode* ast = NULL;
+		if (threadCount > 1 && source.getLength() >= minParallelLength) {
+			ast = parseParts();
+		}
+		if (ast == NULL) {
+			//a small source or an error: the same result as Parser
+			Parser parser(source, constantLookupTable, functionLookupTable);
+			ast = parser.begin().expr();
+		}
+		return ast;
+	}
+
+	/* the character never belongs to a token - a part may start here */
+	static bool isPartBoundary(char c) {
+		int cc = charClass(c);
+		return cc == CC_SPACE || cc == CC_MUL || cc == CC_DIV || cc == CC_DASH
+			|| cc == CC_OPAREN || cc == CC_CPAREN || cc == CC_TILDE
+			|| cc == CC_ASSIGN;
+	}
+
+	AstNode* ParallelParser::parseParts() {
+		const char* data = source.getData();
+		size_t length = source.getLength();
+
+		//pass 1: lex the parts
+		size_t partCount = threadCount;
+		vector<LexPartTask*> parts;
+		vector<Task*> tasks;
+		size_t begin = 0;
+		for (size_t i = 0; i < partCount; i++) {
+			size_t end = (i + 1 == partCount) ? length : length / partCount * (i + 1);
+			if (end < begin) {
+				end = begin;
+			}
+			while (end < length && !isPartBoundary(data[end])) {
+				end++;
+			}
+			parts.push_back(new LexPartTask(data + begin, begin, end - begin));
+			tasks.push_back(parts.back());
+			begin = end;
+		}
+		runTasks(tasks, threadCount);
+
+		//pass 2: prefix sums
+		bool failed = false;
+		size_t tokenCount = 0;
+		int depth = 0;
+		LexemKind previousKind = LK_EOF;
+		for (size_t i = 0; i < partCount; i++) {
+			LexPartTask* part = parts[i];
+			failed = failed || part->failed;
+			if (failed) {
+				break;
+			}
+			part->firstToken = tokenCount;
+			part->depth = depth;
+			part->previousKind = previousKind;
+			tokenCount += part->tokens.size() - 1;
+			depth += part->depthChange;
+			if (part->lastKind() != LK_EOF) {
+				previousKind = part->lastKind();
+			}
+		}
+
+		vector<size_t> termEnds;
+		if (!failed) {
+			//pass 3: join the tokens, find the terms
+			tokens.prepareJoin(data, length, tokenCount);
+			tasks.clear();
+			for (size_t i = 0; i < partCount; i++) {
+				tasks.push_back(new JoinPartTask(*parts[i], tokens));
+			}
+			runTasks(tasks, threadCount);
+			for (size_t i = 0; i < partCount; i++) {
+				delete tasks[i];
+				termEnds.insert(termEnds.end(), parts[i]->splits.begin(), parts[i]->splits.end());
+			}
+			//the last term ends at LK_EOF
+			termEnds.push_back(tokenCount);
+		}
+		for (size_t i = 0; i < partCount; i++) {
+			delete parts[i];
+		}
+		if (failed) {
+			return NULL;
+		}
+
+		//pass 4: parse the terms, a few groups per thread
+		size_t termCount = termEnds.size();
+		vector<AstNode*> terms(termCount, (AstNode*)NULL);
+		size_t groupCount = threadCount * 4;
+		vector<ParseTermsTask*> groups;
+		tasks.clear();
+		for (size_t i = 0; i < groupCount; i++) {
+			size_t firstTerm = termCount * i / groupCount;
+			size_t lastTerm = termCount * (i + 1) / groupCount;
+			if (firstTerm < lastTerm) {
+				groups.push_back(new ParseTermsTask(tokens, constantLookupTable, functionLookupTable,
+					termEnds, firstTerm, lastTerm, terms));
+				tasks.push_back(groups.back());
+			}
+		}
+		runTasks(tasks, threadCount);
+		for (size_t i = 0; i < groups.size(); i++) {
+			failed = failed || groups[i]->failed;
+			delete groups[i];
+		}
+		if (failed) {
+			for (size_t t = 0; t < termCount; t++) {
+				delete terms[t];
+			}
+			return NULL;
+		}
+
+		//pass 5: join the terms from the left, as Parser::addExpr does
+		AstNode* left = terms[0];
+		for (size_t t = 1; t < termCount; t++) {
+			if (tokens.getKind(termEnds[t - 1]) == LK_PLUS) {
+				left = new AddOperatorAstNode(left, terms[t]);
+			} else {
+				left = new SubOperatorAstNode(left, terms[t]);
+			}
+		}
+		return left;
+	}
+
+	/*** End of ParallelParser *** *** *** *** *** *** *** *** ***/
+
+}
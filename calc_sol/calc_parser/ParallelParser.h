@@ -0,0 +1,80 @@
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include "Parser.h"
+#include "SourceBuffer.h"
+#include "TokenArray.h"
+
+namespace parser {
+
+	/* Parser of a very large expression on many threads.
+
+	The grammar is parsed as by the "Parser" class and the AST is
+	identical to the one built by Parser::expr. The source is parsed
+	in the following passes (the passes marked * run on all threads):
+	1* the text is cut into parts at characters which never belong
+	   to a token (white spaces, * / ^ ( ) ~ =) and the parts are lexed;
+	   each part counts its change of the parenthesis depth
+	2  prefix sums give the first token and the depth at the start
+	   of each part
+	3* the tokens are joined into one TokenArray and the binary
+	   Plus/Minus tokens outside parentheses (after a Float, an
+	   Identifier or CParen) are found: they split the add_expr into
+	   its mul_expr terms
+	4* the terms are parsed by Parser::mulExpr
+	5  the terms are joined by the Add/Sub operators, from the left
+
+	Errors are rare, so when a part cannot be lexed or a term
+	cannot be parsed, the source is parsed again by Parser: the
+	same exception is thrown, with the same position.
+	Small sources are parsed by Parser right away*/
+	class ParallelParser {
+	private:
+		const SourceBuffer& source;
+
+		/* a table to lookup constant by name */
+		ConstantLookupTable* constantLookupTable;
+
+		/* a table to lookup function by name */
+		FunctionLookupTable* functionLookupTable;
+
+		unsigned int threadCount;
+
+		/* sources smaller than this are parsed by Parser */
+		size_t minParallelLength;
+
+		/* tokens of all parts */
+		TokenArray tokens;
+
+		/* passes 1-5; Returns: NULL on any error */
+		AstNode* parseParts();
+
+		/* not copyable */
+		ParallelParser(const ParallelParser& other);
+		ParallelParser& operator =(const ParallelParser& other);
+	public:
+		/* default of setMinParallelLength */
+		static const size_t MIN_PARALLEL_LENGTH = 64 * 1024;
+
+		/* Parse the source on at most threadCount threads (including
+		the calling one); the source must outlive the parser.
+		threadCount 0 is the number of processors*/
+		ParallelParser(const SourceBuffer& source,
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			unsigned int threadCount);
+
+		/* parse sources of the length and longer on many threads
+		(MIN_PARALLEL_LENGTH by default); the rest by Parser*/
+		void setMinParallelLength(size_t length) {
+			minParallelLength = length;
+		}
+
+		/* Parse the expression, as Parser::begin().expr() does.
+		Returns: AST; it must be deallocated by the client.
+		Throws UnknownTokenException, SyntaxException*/
+		AstNode* expr();
+	};
+
+}
+
+#endif
@@ -1,387 +1,609 @@
-
-#include "stdafx.h"
-#include "Lexer.h"
-#include "Parser.h"
-#include <memory>
-
-namespace parser {
-
-	using namespace std;
-
-	/*** Parser ************************************/
-
-	Parser& Parser::begin() {
-		readNextSymbol();
-		return *this;
-	}
-
-	void Parser::readNextSymbol() {
-		currentLexem = lexer.next(inputStream);
-	}
-
-
-	/*
-	Technological note: 
-	I could have similar methods per each
-	lexem type, but they would look exactly the same.
-	To resolve that problem more polymorphic - not really
-	usefull, because Lexems would all have a method to check their
-	type and this is exactly the role of dynamic_cast*/
-	template <class LexemType>
-	auto_ptr<LexemType> Parser::accept() {
-		if (currentLexem.get() != NULL 
-			&& dynamic_cast<LexemType*>(currentLexem.get()) != NULL) {
-				//downcast is save here, because condition
-				//verified the right type
-				//auto_ptr is required to handle ownership transfer properly
-				LexemType* lexemPtr = dynamic_cast<LexemType*>(currentLexem.release());
-				auto_ptr<LexemType> result = auto_ptr<LexemType>(lexemPtr);
-				//advance automata state
-				readNextSymbol();
-				return result;
-
-		} else {
-			return auto_ptr<LexemType>();
-		}
-	}
-
-	template <class LexemType>
-	auto_ptr<LexemType> Parser::expect() {
-		auto_ptr<LexemType> l = accept<LexemType>();
-		if (l.get() != NULL) {
-			return l;
-		} else {
-			throw SyntaxException(lexer.getLineNo(), lexer.getCharNo());
-		}
-	}
-
-	template <class LexemType>
-	bool Parser::symbol() {
-		return currentLexem.get() != NULL 
-			&& dynamic_cast<LexemType*>(currentLexem.get()) != NULL;
-	}
-
-
-	/* parse expression */
-	AstNode* Parser::expr() {
-		return addExpr();
-	}
-
-	/* parse additive expression '+' or '-' */
-	AstNode* Parser::addExpr() {
-		bool add = false;
-		bool sub = false;
-		//non-terminal
-		AstNode* addExpressionSymbol = NULL;
-		//left argument of the operator
-		AstNode* left = mulExpr();
-		while ((add = symbol<PlusLexem>()) || (sub = symbol<MinusLexem>())) {
-			//advance automata
-			readNextSymbol();
-			//right argument of the operator
-			AstNode* right = mulExpr();
-			if (add) {
-				addExpressionSymbol = new AddOperatorAstNode(left, right);
-			} else if (sub) {
-				addExpressionSymbol = new SubOperatorAstNode(left, right);
-			} else {
-				//should not occur
-				throw "illegal state";
-			}
-			left = addExpressionSymbol;
-		}
-		if (addExpressionSymbol != NULL) {
-			//additive symbol
-			return addExpressionSymbol;
-		} else {
-			//not an additive symbol - recursive expansion
-			return left;
-		}
-	}
-
-	/* parse multiplicative expression '*' or '/'*/
-	AstNode* Parser::mulExpr() {
-		bool mul = false;
-		bool div = false;
-		//left argument of the operator
-		AstNode* left = powExpr();
-		//non-terminal
-		AstNode* mulExpressionSymbol = NULL;
-		while ((mul=symbol<MulLexem>()) || (div=symbol<DivLexem>())) {
-			//advance automata
-			readNextSymbol();
-			//right argument of the operator
-			AstNode* right = powExpr();
-			if (mul) {
-				mulExpressionSymbol = new MulOperatorAstNode(left, right);
-			} else if (div) {
-				mulExpressionSymbol = new DivOperatorAstNode(left, right);
-			} else {
-				//should not occur
-				throw "illegal state";
-			}
-			left = mulExpressionSymbol;
-		}
-		if (mulExpressionSymbol != NULL) {
-			//multiplicative expression
-			return mulExpressionSymbol;
-		} else {
-			//not a multiplicative symbol - recursive expansion
-			return left;
-		}
-	}
-
-	/* parse power expression */
-	AstNode* Parser::powExpr() {
-		//left argument of 'power'
-		AstNode* left = factor();
-		AstNode* powerExprSymbol = NULL; //non-terminal
-		//read next dash '^'
-		while (symbol<DashLexem>()) {
-			//advance automata
-			readNextSymbol();
-			//read right argument of 'power'
-			AstNode* right = factor();
-			//the power expressions becomes the left
-			//side of the next power (if any)
-			powerExprSymbol = new PowerOperatorAstNode(left, right);
-			left = powerExprSymbol;
-		}
-		if (powerExprSymbol != NULL) {
-			//power expression
-			//one or more '^'
-			return powerExprSymbol;
-		} else {
-			//not a power-expr - recursive expansion
-			return left;
-		}
-	}
-
-	/* parse basic factor */
-	AstNode* Parser::factor() {
-		AstNode* result = NULL;
-
-		//optional: consume '-'
-		auto_ptr<MinusLexem> minusLexem = accept<MinusLexem>();
-		auto_ptr<FloatLexem> floatLexem;
-		auto_ptr<OParenLexem> oParenLexem;
-		if ((floatLexem = accept<FloatLexem>()).get() != NULL) {
-			//consume Float
-			double d = floatLexem.get()->getValue();
-			result = new FloatLiteralAstNode(d);
-		} else if (symbol<IdentifierLexem>()) {
-			result = funcCall();
-		} else if ((oParenLexem = accept<OParenLexem>()).get()) {
-			//opening parenthesis - this is expression enclosed in parenthesis
-			result = expr();
-			//closing parenthesis is mandatory now
-			auto_ptr<CParenLexem> cParenLexem = expect<CParenLexem>();
-		} else {
-			//No viable alternative form of the factor rule
-			throw SyntaxException(lexer.getLineNo(), lexer.getCharNo());
-		}
-
-		if (minusLexem.get() != NULL) {
-			//unary negation
-			result = new UnaryNegationAstNode(result);
-		}
-
-		return result;
-	}
-
-	AstNode* Parser::funcCall() {
-		//required function identifier
-		VariableAstNode* var = variable();
-		//non-terminal
-		FunctionCall1ArgAstNode* funcCallSymbol = NULL;
-		auto_ptr<OParenLexem> oParenLexem;
-		if ( (oParenLexem = accept<OParenLexem>()).get() != NULL) {
-			//only 1-arg functions allowed - argument is compulsory
-			AstNode* arg1 = expr();
-			//closing parenthesis is mandatory
-			expect<CParenLexem>();
-
-			std:string id = var->getVarIdentifier();
-			//lookup function in the lookup table
-			if (functionLookupTable != NULL 
-				&& functionLookupTable->exists(id)) {
-
-					Function1Arg* function = functionLookupTable->lookup(id);
-					funcCallSymbol = new FunctionCall1ArgAstNode(
-						id,
-						function,
-						arg1);
-			} else {
-				throw SyntaxException(lexer.getLineNo(), lexer.getCharNo(), 
-					string("unknown function " + id));
-			}
-
-		}
-		if (funcCallSymbol != NULL) {
-			//function expression
-			return funcCallSymbol;
-		} else {
-			//not a function-expr - recursive expansion
-			return var;
-		}
-	}
-
-	VariableAstNode* Parser::variable() {
-		//required identifier
-		auto_ptr<IdentifierLexem> identifierLexem = expect<IdentifierLexem>();
-		string id = identifierLexem->getIdentifier();
-		if (constantLookupTable != NULL 
-			&& constantLookupTable->exists(id)) {
-
-			//constant
-			return new ConstantAstNode(
-				id,	constantLookupTable->lookup(id));
-		} else {
-			return new VariableAstNode(identifierLexem->getIdentifier());
-		}
-	}
-
-	/*** End of parser *****************************/
-
-
-	/*** AST Node implementations ******************/
-	void FloatLiteralAstNode::visitPostOrder(AstVisitor& visitor) {
-		visitor.visit(*this);
-	}
-
-	void VariableAstNode::visitPostOrder(AstVisitor& visitor) {
-		visitor.visit(*this);
-	}
-
-	void UnaryNegationAstNode::visitPostOrder(AstVisitor& visitor) {
-		getArgument()->visitPostOrder(visitor);
-		visitor.visit(*this);
-	}
-
-	void AddOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
-		getLeft()->visitPostOrder(visitor);
-		getRight()->visitPostOrder(visitor);
-		visitor.visit(*this);
-	}
-
-	void SubOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
-		getLeft()->visitPostOrder(visitor);
-		getRight()->visitPostOrder(visitor);
-		visitor.visit(*this);
-	}
-
-	void MulOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
-		getLeft()->visitPostOrder(visitor);
-		getRight()->visitPostOrder(visitor);
-		visitor.visit(*this);
-
-	}
-
-	void DivOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
-		getLeft()->visitPostOrder(visitor);
-		getRight()->visitPostOrder(visitor);
-		visitor.visit(*this);
-	}
-
-	void PowerOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
-		getLeft()->visitPostOrder(visitor);
-		getRight()->visitPostOrder(visitor);
-		visitor.visit(*this);
-	}
-
-	void FunctionCall1ArgAstNode::visitPostOrder(AstVisitor& visitor) {
-		arg1->visitPostOrder(visitor);
-		visitor.visit(*this);
-	}
-
-	void ConstantAstNode::visitPostOrder(AstVisitor& visitor) {
-		visitor.visit(*this);
-	}
-
-	/*** End of AST Node implementations *************/
-
-	/*** Exceptions ********************************/
-	SyntaxException::SyntaxException(int lineNo, int charNo) 
-		: lineNo(lineNo), charNo(charNo) {
-			stringstream sb;
-			sb << "Syntax error at " << lineNo << ":" << charNo;
-			this->s = sb.str();
-	}
-
-	SyntaxException::SyntaxException(int lineNo, int charNo, string text) 
-	: lineNo(lineNo), charNo(charNo){
-			stringstream sb;
-			sb << "Syntax error at " << lineNo << ":" << charNo
-				<< " " << text;
-			this->s = sb.str();
-	}
-
-	const char *SyntaxException::what() const {
-		return s.c_str();
-	}
-
-	/*** End of Exceptions *************************/
-
-	/*** RPNTextVisitor ****************************/
-	string RPNTextVisitor::getRPNText() {
-		return b.str();
-	}
-
-	void RPNTextVisitor::space() {
-		if (tokens > 0) {
-			b << " ";
-		}
-		tokens++;
-	}
-
-	void RPNTextVisitor::visit(FloatLiteralAstNode& floatLiteralNode) {
-		space();
-		b << floatLiteralNode.getLiteralValue();
-	}
-
-	void RPNTextVisitor::visit(VariableAstNode& variableNode){
-		space();
-		b << variableNode.getVarIdentifier();
-	}
-
-	void RPNTextVisitor::visit(UnaryNegationAstNode& unaryNegationNode){
-		space();
-		b << unaryNegationNode.getSymbol();
-	}
-
-	void RPNTextVisitor::visit(AddOperatorAstNode& addOperatorNode){
-		space();
-		b << addOperatorNode.getSymbol();
-	}
-
-	void RPNTextVisitor::visit(SubOperatorAstNode& subOperatorNode){
-		space();
-		b << subOperatorNode.getSymbol();
-	}
-
-	void RPNTextVisitor::visit(MulOperatorAstNode& mulOperatorNode){
-		space();
-		b << mulOperatorNode.getSymbol();
-	}
-
-	void RPNTextVisitor::visit(DivOperatorAstNode& divOperatorNode){
-		space();
-		b << divOperatorNode.getSymbol();
-	}
-
-	void RPNTextVisitor::visit(PowerOperatorAstNode& powerOperatorNode){
-		space();
-		b << powerOperatorNode.getSymbol();
-	}
-
-	void RPNTextVisitor::visit(FunctionCall1ArgAstNode& funcCallNode) {
-		space();
-		b << funcCallNode.getFunctionName();
-	}
-
-	void RPNTextVisitor::visit(ConstantAstNode& constantNode){ 
-		space();
-		b << constantNode.getVarIdentifier();
-	}
-	/*** End of RPNTextVisitor *********************/
+
+#include "stdafx.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "FlatAst.h"
+#include "FunctionDefinition.h"
+#include "FloatConv.h"
+#include "Threads.h"
+#include <memory>
+
+namespace parser {
+
+	using namespace std;
+
+	/*** Parser ************************************/
+
+	Parser::Parser(istream& inputStream)
+		: inputStream(&inputStream)
+		, source(NULL)
+		, tokens(&ownedTokens)
+		, current(0)
+		, constantLookupTable(NULL)
+		, functionLookupTable(NULL)
+		, resource(NULL) {
+	}
+
+	Parser::Parser(istream& inputStream, 
+		ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+		MemoryResource* resource)
+		: inputStream(&inputStream)
+		, source(NULL)
+		, tokens(&ownedTokens)
+		, current(0)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, resource(resource) {
+	}
+
+	Parser::Parser(const SourceBuffer& source, 
+		ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+		MemoryResource* resource)
+		: inputStream(NULL)
+		, source(&source)
+		, tokens(&ownedTokens)
+		, current(0)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, resource(resource) {
+	}
+
+	Parser::Parser(const TokenArray& tokens, 
+		ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+		MemoryResource* resource)
+		: inputStream(NULL)
+		, source(NULL)
+		, tokens(&tokens)
+		, current(0)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, resource(resource) {
+	}
+
+	Parser& Parser::begin() {
+		if (inputStream != NULL) {
+			ownedTokens.tokenize(*inputStream);
+		} else if (source != NULL) {
+			ownedTokens.tokenize(*source);
+		}
+		current = 0;
+		bindings.clear();
+		return *this;
+	}
+
+	Parser& Parser::begin(size_t first) {
+		begin();
+		current = first;
+		return *this;
+	}
+
+	/*
+	Technological note: 
+	tokens are plain values identified by their kind, so
+	checking the type of the current symbol is a comparison;
+	no Lexem objects are allocated and no dynamic_cast is needed*/
+	bool Parser::accept(LexemKind kind) {
+		if (symbol(kind)) {
+			//advance automata state
+			readNextSymbol();
+			return true;
+		} else {
+			return false;
+		}
+	}
+
+	void Parser::expect(LexemKind kind) {
+		if (!accept(kind)) {
+			syntaxError();
+		}
+	}
+
+	void Parser::syntaxError() {
+		int lineNo, charNo;
+		tokens->position(current, lineNo, charNo);
+		throw SyntaxException(lineNo, charNo);
+	}
+
+	void Parser::syntaxError(string text) {
+		int lineNo, charNo;
+		tokens->position(current, lineNo, charNo);
+		throw SyntaxException(lineNo, charNo, text);
+	}
+
+
+	/* parse expression */
+	AstNode* Parser::expr() {
+		AstTreeBuilder builder(resource);
+		return letExpr(builder);
+	}
+
+	void Parser::expr(FlatAst& ast) {
+		ast.clear();
+		//never more nodes than tokens
+		ast.reserve(tokens->size() - current);
+		letExpr(ast);
+	}
+
+	AstNode* Parser::addExpr() {
+		AstTreeBuilder builder(resource);
+		return addExpr(builder);
+	}
+
+	AstNode* Parser::mulExpr() {
+		AstTreeBuilder builder(resource);
+		return mulExpr(builder);
+	}
+
+	AstNode* Parser::powExpr() {
+		AstTreeBuilder builder(resource);
+		return powExpr(builder);
+	}
+
+	AstNode* Parser::factor() {
+		AstTreeBuilder builder(resource);
+		return factor(builder);
+	}
+
+	AstNode* Parser::funcCall() {
+		AstTreeBuilder builder(resource);
+		return funcCall(builder);
+	}
+
+	VariableAstNode* Parser::variable() {
+		AstTreeBuilder builder(resource);
+		//a variable or a constant
+		return static_cast<VariableAstNode*>(variable(builder));
+	}
+
+	/* parse expression: let or additive */
+	template <class Builder>
+	typename Builder::Node Parser::letExpr(Builder& builder) {
+		if (!symbol(LK_IDENTIFIER) || tokens->getSymbol(current) != SYMBOL_LET) {
+			return addExpr(builder);
+		}
+		readNextSymbol();
+		//the name - any identifier but a keyword
+		if (!symbol(LK_IDENTIFIER) || isKeyword(tokens->getSymbol(current))) {
+			syntaxError();
+		}
+		//the name is defined - interned
+		int name = tokens->intern(current);
+		readNextSymbol();
+		expect(LK_ASSIGN);
+		//the name is not bound in its own value
+		typename Builder::Node value = letExpr(builder);
+		if (!symbol(LK_IDENTIFIER) || tokens->getSymbol(current) != SYMBOL_IN) {
+			syntaxError();
+		}
+		readNextSymbol();
+		bindings.push(name, value);
+		typename Builder::Node body = letExpr(builder);
+		bindings.pop();
+		//the value is not needed any more (it is in the body where used)
+		return builder.endScope(value, body);
+	}
+
+	/* parse additive expression '+' or '-' */
+	template <class Builder>
+	typename Builder::Node Parser::addExpr(Builder& builder) {
+		//left argument of the operator
+		typename Builder::Node left = mulExpr(builder);
+		bool add;
+		while ((add = symbol(LK_PLUS)) || symbol(LK_MINUS)) {
+			//advance automata
+			readNextSymbol();
+			//right argument of the operator
+			typename Builder::Node right = mulExpr(builder);
+			//the additive expression becomes the left
+			//argument of the next operator (if any)
+			left = builder.addBinary(add ? FO_ADD : FO_SUB, left, right);
+		}
+		return left;
+	}
+
+	/* parse multiplicative expression '*' or '/'*/
+	template <class Builder>
+	typename Builder::Node Parser::mulExpr(Builder& builder) {
+		//left argument of the operator
+		typename Builder::Node left = powExpr(builder);
+		bool mul;
+		while ((mul = symbol(LK_MUL)) || symbol(LK_DIV)) {
+			//advance automata
+			readNextSymbol();
+			//right argument of the operator
+			typename Builder::Node right = powExpr(builder);
+			left = builder.addBinary(mul ? FO_MUL : FO_DIV, left, right);
+		}
+		return left;
+	}
+
+	/* parse power expression */
+	template <class Builder>
+	typename Builder::Node Parser::powExpr(Builder& builder) {
+		//left argument of 'power'
+		typename Builder::Node left = factor(builder);
+		//read next dash '^'
+		while (symbol(LK_DASH)) {
+			//advance automata
+			readNextSymbol();
+			//read right argument of 'power'
+			typename Builder::Node right = factor(builder);
+			//the power expressions becomes the left
+			//side of the next power (if any)
+			left = builder.addBinary(FO_POWER, left, right);
+		}
+		return left;
+	}
+
+	/* parse basic factor */
+	template <class Builder>
+	typename Builder::Node Parser::factor(Builder& builder) {
+		typename Builder::Node result = typename Builder::Node();
+
+		//optional: consume '-'
+		bool minus = accept(LK_MINUS);
+		if (symbol(LK_FLOAT)) {
+			//consume Float
+			double d = tokens->getValue(current);
+			readNextSymbol();
+			result = builder.addFloat(d);
+		} else if (symbol(LK_IDENTIFIER)) {
+			result = funcCall(builder);
+		} else if (accept(LK_OPAREN)) {
+			//opening parenthesis - this is expression enclosed in parenthesis
+			result = letExpr(builder);
+			//closing parenthesis is mandatory now
+			expect(LK_CPAREN);
+		} else {
+			//No viable alternative form of the factor rule
+			syntaxError();
+		}
+
+		if (minus) {
+			//unary negation
+			result = builder.addNegation(result);
+		}
+
+		return result;
+	}
+
+	template <class Builder>
+	typename Builder::Node Parser::funcCall(Builder& builder) {
+		//required function identifier
+		if (!symbol(LK_IDENTIFIER) || isKeyword(tokens->getSymbol(current))) {
+			syntaxError();
+		}
+		if (tokens->getKind(current + 1) != LK_OPAREN) {
+			//not a function-expr - recursive expansion
+			return variable(builder);
+		}
+		//the name is not a variable - no node is created for it
+		size_t name = current;
+		int symbol = tokens->getSymbol(current);
+		readNextSymbol();
+		readNextSymbol();
+		//only 1-arg functions allowed - argument is compulsory
+		typename Builder::Node arg1 = letExpr(builder);
+		//closing parenthesis is mandatory
+		expect(LK_CPAREN);
+
+		//lookup function in the lookup table
+		Function1Arg* function = NULL;
+		if (functionLookupTable == NULL 
+			|| !functionLookupTable->find(symbol, function)) {
+
+				syntaxError(string("unknown function " + tokens->getText(name).str()));
+		}
+		FunctionDefinition* definition = function->getDefinition();
+		if (definition != NULL) {
+			//the body in place of the call
+			typename Builder::Node body = definition->inlineCall(builder, arg1);
+			if (builder.isTooLarge()) {
+				syntaxError("expression too large");
+			}
+			return body;
+		}
+		//function expression
+		return builder.addCall(symbol, function, arg1);
+	}
+
+	template <class Builder>
+	typename Builder::Node Parser::variable(Builder& builder) {
+		//required identifier
+		if (!symbol(LK_IDENTIFIER) || isKeyword(tokens->getSymbol(current))) {
+			syntaxError();
+		}
+		//a name not interned is neither bound nor a constant
+		size_t name = current;
+		int symbol = tokens->getSymbol(current);
+		readNextSymbol();
+		typename Builder::Node bound;
+		double value;
+		if (bindings.find(symbol, bound)) {
+			//the value of the binding
+			typename Builder::Node copy = builder.addReference(bound);
+			if (builder.isTooLarge()) {
+				syntaxError("expression too large");
+			}
+			return copy;
+		} else if (constantLookupTable != NULL 
+			&& constantLookupTable->find(symbol, value)) {
+
+			//constant
+			return builder.addConstant(symbol, value);
+		} else {
+			//the tree names the variable
+			return builder.addVariable(tokens->intern(name));
+		}
+	}
+
+	/*** End of parser *****************************/
+
+
+	/*** Bindings ********************************/
+
+	bool Bindings::find(int symbol, AstNode*& tree) const {
+		for (size_t i = symbols.size(); i > 0; i--) {
+			if (symbols[i - 1] == symbol) {
+				tree = trees[i - 1];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Bindings::find(int symbol, int& node) const {
+		for (size_t i = symbols.size(); i > 0; i--) {
+			if (symbols[i - 1] == symbol) {
+				node = nodes[i - 1];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*** End of Bindings ***************************/
+
+	/*** AST Node implementations ******************/
+	void FloatLiteralAstNode::visitPostOrder(AstVisitor& visitor) {
+		visitor.visit(*this);
+	}
+
+	void VariableAstNode::visitPostOrder(AstVisitor& visitor) {
+		visitor.visit(*this);
+	}
+
+	void UnaryNegationAstNode::visitPostOrder(AstVisitor& visitor) {
+		getArgument()->visitPostOrder(visitor);
+		visitor.visit(*this);
+	}
+
+	void AddOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
+		getLeft()->visitPostOrder(visitor);
+		getRight()->visitPostOrder(visitor);
+		visitor.visit(*this);
+	}
+
+	void SubOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
+		getLeft()->visitPostOrder(visitor);
+		getRight()->visitPostOrder(visitor);
+		visitor.visit(*this);
+	}
+
+	void MulOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
+		getLeft()->visitPostOrder(visitor);
+		getRight()->visitPostOrder(visitor);
+		visitor.visit(*this);
+
+	}
+
+	void DivOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
+		getLeft()->visitPostOrder(visitor);
+		getRight()->visitPostOrder(visitor);
+		visitor.visit(*this);
+	}
+
+	void PowerOperatorAstNode::visitPostOrder(AstVisitor& visitor) {
+		getLeft()->visitPostOrder(visitor);
+		getRight()->visitPostOrder(visitor);
+		visitor.visit(*this);
+	}
+
+	void FunctionCall1ArgAstNode::visitPostOrder(AstVisitor& visitor) {
+		arg1->visitPostOrder(visitor);
+		visitor.visit(*this);
+	}
+
+	void ConstantAstNode::visitPostOrder(AstVisitor& visitor) {
+		visitor.visit(*this);
+	}
+
+	/* Builds the copy of the nodes visited: the copies of the arguments
+	of a node are on the stack when it is visited*/
+	class AstCopyVisitor : public AstVisitor {
+	private:
+		AstTreeBuilder builder;
+		vector<AstNode*> copies;
+		/* nodes copied */
+		size_t count;
+
+		void binary(FlatOpcode opcode) {
+			AstNode* right = copies.back();
+			copies.pop_back();
+			count++;
+			copies.back() = builder.addBinary(opcode, copies.back(), right);
+		}
+	public:
+		AstCopyVisitor(MemoryResource* resource) : builder(resource), count(0) {
+		}
+
+		AstNode* getCopy() {
+			return copies.back();
+		}
+
+		size_t getCount() {
+			return count;
+		}
+
+		virtual void visit(FloatLiteralAstNode& floatLiteralNode) {
+			count++;
+			copies.push_back(builder.addFloat(floatLiteralNode.getLiteralValue()));
+		}
+
+		virtual void visit(VariableAstNode& variableNode) {
+			count++;
+			copies.push_back(builder.addVariable(variableNode.getSymbol()));
+		}
+
+		virtual void visit(UnaryNegationAstNode& unaryNegationNode) {
+			count++;
+			copies.back() = builder.addNegation(copies.back());
+		}
+
+		virtual void visit(AddOperatorAstNode& addOperatorNode) {
+			binary(FO_ADD);
+		}
+
+		virtual void visit(SubOperatorAstNode& subOperatorNode) {
+			binary(FO_SUB);
+		}
+
+		virtual void visit(MulOperatorAstNode& mulOperatorNode) {
+			binary(FO_MUL);
+		}
+
+		virtual void visit(DivOperatorAstNode& divOperatorNode) {
+			binary(FO_DIV);
+		}
+
+		virtual void visit(PowerOperatorAstNode& powerOperatorNode) {
+			binary(FO_POWER);
+		}
+
+		virtual void visit(FunctionCall1ArgAstNode& funcCallNode) {
+			count++;
+			copies.back() = builder.addCall(funcCallNode.getSymbol(),
+				funcCallNode.getFunction(), copies.back());
+		}
+
+		virtual void visit(ConstantAstNode& constantNode) {
+			count++;
+			copies.push_back(builder.addConstant(constantNode.getSymbol(), constantNode.getValue()));
+		}
+	};
+
+	AstNode* copyAst(AstNode* ast, MemoryResource* resource) {
+		AstCopyVisitor visitor(resource);
+		ast->visitPostOrder(visitor);
+		return visitor.getCopy();
+	}
+
+	AstNode* copyAst(AstNode* ast, MemoryResource* resource, size_t& nodeCount) {
+		AstCopyVisitor visitor(resource);
+		ast->visitPostOrder(visitor);
+		nodeCount = visitor.getCount();
+		return visitor.getCopy();
+	}
+
+	/*** End of AST Node implementations *************/
+
+	/*** Exceptions ********************************/
+	SyntaxException::SyntaxException(int lineNo, int charNo) 
+		: lineNo(lineNo), charNo(charNo) {
+			stringstream sb;
+			sb << "Syntax error at " << lineNo << ":" << charNo;
+			this->s = sb.str();
+	}
+
+	SyntaxException::SyntaxException(int lineNo, int charNo, string text) 
+	: lineNo(lineNo), charNo(charNo){
+			stringstream sb;
+			sb << "Syntax error at " << lineNo << ":" << charNo
+				<< " " << text;
+			this->s = sb.str();
+	}
+
+	const char *SyntaxException::what() const {
+		return s.c_str();
+	}
+
+	/*** End of Exceptions *************************/
+
+	/*** Lookup tables *****************************/
+
+	/* The last version given to a lookup table; initialized statically
+	(no constructor), so a table may be created by the initializer of a
+	static object of any file*/
+	static volatile unsigned int lookupTableVersion = 0;
+
+	unsigned int newLookupTableVersion() {
+		return atomicIncrement(lookupTableVersion);
+	}
+
+	/*** End of Lookup tables **********************/
+
+	/*** RPNTextVisitor ****************************/
+	string RPNTextVisitor::getRPNText() {
+		return b.str();
+	}
+
+	void RPNTextVisitor::space() {
+		if (tokens > 0) {
+			b << " ";
+		}
+		tokens++;
+	}
+
+	void RPNTextVisitor::visit(FloatLiteralAstNode& floatLiteralNode) {
+		space();
+		//shortest text which is read back as the same value
+		char text[FLOAT_TEXT_SIZE];
+		b.write(text, formatFloat(floatLiteralNode.getLiteralValue(), text));
+	}
+
+	void RPNTextVisitor::visit(VariableAstNode& variableNode){
+		space();
+		b << symbolName(variableNode.getSymbol());
+	}
+
+	void RPNTextVisitor::visit(UnaryNegationAstNode& unaryNegationNode){
+		space();
+		b << unaryNegationNode.getSymbol();
+	}
+
+	void RPNTextVisitor::visit(AddOperatorAstNode& addOperatorNode){
+		space();
+		b << addOperatorNode.getSymbol();
+	}
+
+	void RPNTextVisitor::visit(SubOperatorAstNode& subOperatorNode){
+		space();
+		b << subOperatorNode.getSymbol();
+	}
+
+	void RPNTextVisitor::visit(MulOperatorAstNode& mulOperatorNode){
+		space();
+		b << mulOperatorNode.getSymbol();
+	}
+
+	void RPNTextVisitor::visit(DivOperatorAstNode& divOperatorNode){
+		space();
+		b << divOperatorNode.getSymbol();
+	}
+
+	void RPNTextVisitor::visit(PowerOperatorAstNode& powerOperatorNode){
+		space();
+		b << powerOperatorNode.getSymbol();
+	}
+
+	void RPNTextVisitor::visit(FunctionCall1ArgAstNode& funcCallNode) {
+		space();
+		b << symbolName(funcCallNode.getSymbol());
+	}
+
+	void RPNTextVisitor::visit(ConstantAstNode& constantNode){ 
+		space();
+		b << symbolName(constantNode.getSymbol());
+	}
+	/*** End of RPNTextVisitor *********************/
 }
\ No newline at end of file
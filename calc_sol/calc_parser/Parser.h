@@ -1,506 +1,896 @@
-#ifndef PARSER_H
-#define PARSER_H
-
-#include "Lexer.h"
-#include <string>
-#include <memory>
-#include <vector>
-#include <map>
-
-
-namespace parser {
-
-	using namespace parser;
-
-	/* forward declaration */
-	class AstNode;
-
-	/* forward declaration */
-	class VariableAstNode;
-
-	/* forward declaration */
-	class ConstantLookupTable;
-
-	/* forward declaration */
-	class FunctionLookupTable;
-
-	/* Exception class used by parser
-	to report syntax errors */
-	class SyntaxException : public std::exception {
-	private:
-		int lineNo;
-		int charNo;
-		std::string s;
-	public:
-		SyntaxException(int lineNo, int charNo);
-		SyntaxException(int lineNo, int charNo, std::string text);
-		virtual const char *what() const;
-	};
-
-	/* Parser to parse texts according to the grammar
-
-	expr                      ::= add_expr
-	add_expr                  ::= mul_expr { ( Plus | Minus ) mul_expr }
-	mul_expr                  ::= pow_expr { ( Mul | Div ) pow_expr }
-	pow_expr                  ::= factor { Dash factor }
-	factor                    ::= [ Minus ] (
-	Float
-	| func_call_expr
-	| OParen expr CParen )
-	//only 1-arg functions allowed
-	func_call_expr            ::= variable [ OParen expr CParen ] 
-	variable				  ::= Identifier
-
-	See the "Lexer" class for tokens.
-
-	Every method of this class represents one grammar rule. Such
-	method i parsing according to that rule (and dependent rules).
-
-	Methods are creating abstract syntax tree. The tree must be 
-	deallocated by the client. Deallocation occurs recursively
-	automatically
-	*/
-	class Parser {
-
-	private:
-		/* underlying lexer to tokenize input stream*/
-		Lexer lexer;
-
-		/* the stream - source of program */
-		std::istream& inputStream;
-
-		/* currently read lexem (token)*/
-		std::auto_ptr<Lexem> currentLexem;
-
-		/* advance automata by 1 token */
-		void readNextSymbol();
-
-		/* Accept optional symbol.
-		Accept lexem of type indicated by LexemType (one of Lexem subclasses).
-		If current state of automata doesn't allow to accept that symbol,
-		return NULL auto_ptr, otherwise return auto_ptr for accepted symbol*/
-		template <class LexemType>
-		std::auto_ptr<LexemType> accept();
-
-		/* Accept mandatory symbol.
-		Accept lexem of type indicated by LexemType (one of Lexem subclasses).
-		If current state of automata doesn't allow to accept that symbol,
-		throw SyntaxException auto_ptr, otherwise return auto_ptr for accepted symbol*/
-		template <class LexemType>
-		std::auto_ptr<LexemType> expect();
-
-		/* Check current symbol.
-		Check if automata is in state indicated by LexemType (one of Lexem subclasses).
-		Returns: true if current state is in Lexem indicated by LexemType, otherwise return false*/
-		template <class LexemType>
-		bool symbol();
-
-		/* a table to lookup constant by name */
-		ConstantLookupTable* constantLookupTable;
-
-		/* a table to lookup function by name */
-		FunctionLookupTable* functionLookupTable;
-
-	public:
-
-		Parser(std::istream& inputStream)
-			: inputStream(inputStream), constantLookupTable(NULL), functionLookupTable(NULL) {
-		}
-
-		Parser(std::istream& inputStream, 
-			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable)
-			: inputStream(inputStream)
-			, constantLookupTable(constantLookupTable)
-			, functionLookupTable(functionLookupTable) {
-		}
-
-		Parser& begin();
-
-		/* parse expression */
-		AstNode* expr();
-
-		/* parse additive expression */
-		AstNode* addExpr();
-
-		/* parse multiplicative expression */
-		AstNode* mulExpr();
-
-		/* parse power expression */
-		AstNode* powExpr();
-
-		/* parse basic factor */
-		AstNode* factor();
-
-		/* parse function call*/
-		AstNode* funcCall();
-
-		/* parse variable */
-		VariableAstNode* variable();
-
-	};
-
-	/* forward declaration */
-	class AstVisitor;
-
-	/* Abstract Syntaxt Tree - base class
-	Used to represent parsed program.
-	Structures of this type implement GoF composite
-	design pattern. The visitor pattern is applied
-	to traverse the composite*/
-	class AstNode {
-	public:
-		/* Traverse sub-tree rooted in this node.
-		Traversal is 'post-order': 
-		1. Visit all sub-trees 
-		2. Visit this node
-		*/
-		virtual void visitPostOrder(AstVisitor& visitor) = 0;
-	};
-
-	/* Abstract representation of literal */
-	template <class T>
-	class LiteralAstNode : public AstNode {
-	private:
-		//literal value
-		T value;
-	protected:
-		LiteralAstNode(T t) : value(t) {}
-	public:
-		T getLiteralValue() {
-			return value;
-		}
-	};
-
-	/* floating-point literals */
-	class FloatLiteralAstNode : public LiteralAstNode<double> {
-	public: 
-		FloatLiteralAstNode(double d) 
-			: LiteralAstNode(d) {
-		}
-		virtual void visitPostOrder(AstVisitor& visitor);	
-	};
-
-	/* Node representing variable in calculation*/
-	class VariableAstNode : public AstNode {
-	private:
-		//variable name
-		std::string varName;
-	public:
-		VariableAstNode(std::string varName) : varName(varName) {}
-
-		std::string getVarIdentifier() {
-			return varName;
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* Abstraction for unary operators */
-	class UnaryOperatorAstNode : public AstNode {
-	private:
-		//operator's symbol
-		std::string symbol;
-		//argument of the operator - expression
-		AstNode* exprAst;
-	protected:
-		UnaryOperatorAstNode(std::string symbol, AstNode* exprAst)
-			:symbol(symbol), exprAst(exprAst) {
-		}
-
-		virtual ~UnaryOperatorAstNode() {
-			delete exprAst;
-		}
-
-		AstNode* getArgument() {
-			return exprAst;
-		}
-	public:
-		std::string getSymbol() {
-			return symbol;
-		}
-	};
-
-	/* unary negation '- expr '*/
-	class UnaryNegationAstNode : public UnaryOperatorAstNode {
-	public:
-		UnaryNegationAstNode(AstNode* exprAst)
-			: UnaryOperatorAstNode(std::string("-"), exprAst) {
-				;
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* abstraction of binary operators */
-	class BinaryOperatorAstNode : public AstNode {
-	private:
-		//operator's symbol
-		std::string symbol;
-		//left argument of the operator - expression
-		AstNode* leftAst;
-		//right argument of the operator - expression
-		AstNode* rightAst;
-	public:
-		BinaryOperatorAstNode(
-			std::string symbol,
-			AstNode* leftAst,
-			AstNode* rightAst) 
-			: symbol(symbol), leftAst(leftAst), rightAst(rightAst) {
-		}
-
-		virtual ~BinaryOperatorAstNode() {
-			delete leftAst;
-			delete rightAst;
-		}
-
-		std::string getSymbol() {
-			return symbol;
-		}
-
-		AstNode* getLeft() {
-			return leftAst;
-		}
-
-		AstNode* getRight() {
-			return rightAst;
-		}
-	};
-
-	/* binary operator: addition */
-	class AddOperatorAstNode : public BinaryOperatorAstNode {
-	public:
-		AddOperatorAstNode(
-			AstNode* leftAst,
-			AstNode* rightAst) 
-			: BinaryOperatorAstNode(std::string("+"), leftAst, rightAst) {
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* binary operator: subtraction */
-	class SubOperatorAstNode : public BinaryOperatorAstNode {
-	public:
-		SubOperatorAstNode(
-			AstNode* leftAst,
-			AstNode* rightAst) 
-			: BinaryOperatorAstNode(std::string("-"), leftAst, rightAst) {
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* binary operator: multiplication */
-	class MulOperatorAstNode : public BinaryOperatorAstNode {
-	public:
-		MulOperatorAstNode(
-			AstNode* leftAst,
-			AstNode* rightAst) 
-			: BinaryOperatorAstNode(std::string("*"), leftAst, rightAst) {
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* binary operator: division */
-	class DivOperatorAstNode : public BinaryOperatorAstNode {
-	public:
-		DivOperatorAstNode(
-			AstNode* leftAst,
-			AstNode* rightAst) 
-			: BinaryOperatorAstNode(std::string("/"), leftAst, rightAst) {
-		}
-
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* binary operator: power */
-	class PowerOperatorAstNode : public BinaryOperatorAstNode {
-	public:
-		PowerOperatorAstNode(
-			AstNode* leftAst,
-			AstNode* rightAst) 
-			: BinaryOperatorAstNode(std::string("^"), leftAst, rightAst) {
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-
-	};
-
-	/* function evaluator for 1-arg functions*/
-	class Function1Arg {
-	public:
-		/* evaluate function's value */
-		virtual double eval(double in) = 0;
-	};
-
-	/* function call - 1 arg */
-	class FunctionCall1ArgAstNode : public AstNode {
-	private:
-		/* function name*/
-		std::string funcName;
-		/* argument of the function*/
-		AstNode* arg1;
-		/* function value evaluator - result of function lookup */
-		Function1Arg* func;
-	public:
-		FunctionCall1ArgAstNode(std::string funcName, Function1Arg* func, AstNode* arg1) 
-			: funcName(funcName), arg1(arg1), func(func) {
-				;
-		}
-		virtual ~FunctionCall1ArgAstNode() {
-			//function is not deleted - it belongs to the lookup table
-			delete arg1;
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-
-		AstNode* getArg1() {
-			return arg1;
-		}
-
-		std::string getFunctionName() {
-			return funcName;
-		}
-	};
-
-	/* constant value */
-	class ConstantAstNode : public VariableAstNode {
-	private:
-		/* constant's value - result of lookup*/
-		double value;
-	public:
-		ConstantAstNode(std::string constName, double value)
-			: VariableAstNode(constName), value(value) {
-				;
-		}
-
-		double getValue() {
-			return value;
-		}
-
-		virtual void visitPostOrder(AstVisitor& visitor);
-	};
-
-	/* Generic implementation of symbol lookup table.
-	Used for constant and funcion identifier lookup*/
-	template <class T>
-	class LookupTable {
-	protected:
-		std::map<std::string, T> table;
-	protected:
-		LookupTable() {
-			;
-		}
-
-	public:
-		void add(std::string key, T element) {
-			if (exists(key)) {
-				throw "illegal state";
-			}
-			table[key] = element;
-		}
-
-		bool exists(std::string key) {
-			return table.count(key) == 1;
-		}
-
-		T lookup(std::string key) {
-			if (exists(key)) {
-				return table[key];
-			} else {
-				throw "illegal state";
-			}
-		}
-	};
-
-	/* lookup table for constants */
-	class ConstantLookupTable : public LookupTable<double> {
-	public:
-		ConstantLookupTable() : LookupTable() {
-			;
-		}
-	};
-
-	/* Lookup table for functions 
-	This table takes ownership of contained elements.
-	It dealocates all functions at destruction time*/
-	class FunctionLookupTable : public LookupTable<Function1Arg*> {
-	public:
-		FunctionLookupTable() : LookupTable() {
-			;
-		}
-		~FunctionLookupTable() {
-			for (std::map<std::string,Function1Arg*>::iterator it = table.begin(); it != table.end(); ++it) {
-				delete it->second;
-			}
-		}
-
-	};
-
-	/* GoF Visitor Design pattern:
-	The visitor class - a callback when traversing
-	tree of NodeAst (and subclasses)*/
-	class AstVisitor {
-	public:
-		virtual void visit(FloatLiteralAstNode& floatLiteralNode) = 0;
-
-		virtual void visit(VariableAstNode& variableNode) = 0;
-
-		virtual void visit(UnaryNegationAstNode& unaryNegationNode) = 0;
-
-		virtual void visit(AddOperatorAstNode& addOperatorNode) = 0;
-
-		virtual void visit(SubOperatorAstNode& subOperatorNode) = 0;
-
-		virtual void visit(MulOperatorAstNode& mulOperatorNode) = 0;
-
-		virtual void visit(DivOperatorAstNode& divOperatorNode) = 0;
-
-		virtual void visit(PowerOperatorAstNode& powerOperatorNode) = 0;
-
-		virtual void visit(FunctionCall1ArgAstNode& funcCallNode) = 0;
-
-		virtual void visit(ConstantAstNode& constantNode) = 0;
-	};
-
-	/* helper visitor to transform AST into textual representation
-	if reverse polish notation */
-	class RPNTextVisitor : public AstVisitor {
-	private:
-		int tokens;
-		std::stringstream b;
-		/* add space between tokens */
-		void space();
-	public:
-		RPNTextVisitor() : tokens(0) {
-			;
-		}
-		/* return result - AST tree in reverse polish notation*/
-		std::string getRPNText();
-
-		virtual void visit(FloatLiteralAstNode& floatLiteralNode);
-
-		virtual void visit(VariableAstNode& variableNode);
-
-		virtual void visit(UnaryNegationAstNode& unaryNegationNode);
-
-		virtual void visit(AddOperatorAstNode& addOperatorNode);
-
-		virtual void visit(SubOperatorAstNode& subOperatorNode);
-
-		virtual void visit(MulOperatorAstNode& mulOperatorNode);
-
-		virtual void visit(DivOperatorAstNode& divOperatorNode);
-
-		virtual void visit(PowerOperatorAstNode& powerOperatorNode);
-
-		virtual void visit(FunctionCall1ArgAstNode& funcCallNode);
-
-		virtual void visit(ConstantAstNode& constantNode);
-	};
-
-}
-
-#endif
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "Lexer.h"
+#include "Token.h"
+#include "TokenArray.h"
+#include "SourceBuffer.h"
+#include "SymbolTable.h"
+#include "Arena.h"
+#include <string>
+#include <memory>
+#include <vector>
+
+
+namespace parser {
+
+	using namespace parser;
+
+	/* forward declaration */
+	class AstNode;
+
+	/* forward declaration */
+	class VariableAstNode;
+
+	/* forward declaration */
+	class ConstantLookupTable;
+
+	/* forward declaration */
+	class FunctionLookupTable;
+
+	/* forward declaration */
+	class FlatAst;
+
+	/* forward declaration */
+	class FunctionDefinition;
+
+	/* Exception class used by parser
+	to report syntax errors */
+	class SyntaxException : public std::exception {
+	private:
+		int lineNo;
+		int charNo;
+		std::string s;
+	public:
+		SyntaxException(int lineNo, int charNo);
+		SyntaxException(int lineNo, int charNo, std::string text);
+		virtual const char *what() const;
+	};
+
+	/* The most nodes a parser building a tree adds as the copies of
+	the values of let bindings and of the arguments of the functions
+	inlined (see FunctionDefinition): each use of a name is a copy of
+	its value, so nested lets of a few hundred bytes stand for a tree
+	of billions of nodes. Past the limit the parse fails with the error
+	"expression too large". The DAG of calc::Calculator::compile uses
+	a value without a copy - there is no limit. The body of a function
+	has at most as many nodes*/
+	const size_t MAX_COPIED_NODES = 1 << 20;
+
+	/* The let bindings in scope while an expression is parsed: the
+	name and the value of each, the innermost last. The value is a
+	node of either kind the builders of the parsers build (see Parser)
+	- a tree or a node number*/
+	class Bindings {
+	private:
+		std::vector<int> symbols;
+		std::vector<AstNode*> trees;
+		std::vector<int> nodes;
+	public:
+		void clear() {
+			symbols.clear();
+			trees.clear();
+			nodes.clear();
+		}
+
+		void push(int symbol, AstNode* tree) {
+			symbols.push_back(symbol);
+			trees.push_back(tree);
+			nodes.push_back(-1);
+		}
+
+		void push(int symbol, int node) {
+			symbols.push_back(symbol);
+			trees.push_back(NULL);
+			nodes.push_back(node);
+		}
+
+		/* the innermost binding goes out of scope; its value is returned */
+		void pop(AstNode*& tree) {
+			tree = trees.back();
+			pop();
+		}
+
+		void pop(int& node) {
+			node = nodes.back();
+			pop();
+		}
+
+		void pop() {
+			symbols.pop_back();
+			trees.pop_back();
+			nodes.pop_back();
+		}
+
+		/* Value of the innermost binding of the symbol.
+		Returns: false if the symbol is not bound*/
+		bool find(int symbol, AstNode*& tree) const;
+
+		bool find(int symbol, int& node) const;
+	};
+
+	/* Parser to parse texts according to the grammar
+
+	expr                      ::= let_expr | add_expr
+	let_expr                  ::= Let variable Assign expr In expr
+	add_expr                  ::= mul_expr { ( Plus | Minus ) mul_expr }
+	mul_expr                  ::= pow_expr { ( Mul | Div ) pow_expr }
+	pow_expr                  ::= factor { Dash factor }
+	factor                    ::= [ Minus ] (
+	Float
+	| func_call_expr
+	| OParen expr CParen )
+	//only 1-arg functions allowed
+	func_call_expr            ::= variable [ OParen expr CParen ] 
+	variable				  ::= Identifier
+
+	See the "Lexer" class for tokens. Let and In are the identifiers
+	"let" and "in" - keywords, which are not variables (see isKeyword).
+
+	The let expression names the value of an expression: the name
+	is bound to the value in the expression after In, where it stands
+	for the value - before the variable and constants of the name.
+	"let a = exp(-x^2) in a*(1-a)" is exp(-x^2)*(1-exp(-x^2)). The tree
+	has the value at each use of the name (the AstNode tree and the
+	FlatAst are trees); a compiled program computes the value once
+	(see calc::Calculator::compile).
+
+	The call of a function defined by an expression (FunctionDefinition)
+	is its body with the parameter bound to the argument, as by a let:
+	the tree has no call node for it.
+
+	Every method of this class represents one grammar rule. Such
+	method i parsing according to that rule (and dependent rules).
+
+	Methods are creating abstract syntax tree. The tree must be 
+	deallocated by the client. Deallocation occurs recursively
+	automatically.
+
+	When the parser is given a memory resource (an Arena), the nodes
+	are allocated there instead: the tree is never deleted, it is
+	freed with the arena (see AstNode)
+
+	The errors are only thrown: UnknownTokenException by begin,
+	SyntaxException by the rules. PrecedenceParser parses the same
+	grammar into the same trees with the errors set in a Status
+	instead (see PrecedenceParser::begin(status), expr(ast, status));
+	a stream is lexed for it by TokenArray::tokenize(inputStream, status)
+	*/
+	class Parser {
+
+	private:
+		/* input to tokenize when parsing begins (one of them or none)*/
+		std::istream* inputStream;
+		const SourceBuffer* source;
+
+		/* tokens of the input, lexed before parsing */
+		TokenArray ownedTokens;
+		const TokenArray* tokens;
+
+		/* index of currently read lexem (token)*/
+		size_t current;
+
+		/* advance automata by 1 token */
+		void readNextSymbol() {
+			if (tokens->getKind(current) != LK_EOF) {
+				current++;
+			}
+		}
+
+		/* throw SyntaxException at the current token */
+		void syntaxError();
+
+		/* throw SyntaxException with the text at the current token */
+		void syntaxError(std::string text);
+
+		/* Accept optional symbol.
+		If current state of automata doesn't allow to accept symbol of the kind,
+		return false, otherwise advance automata and return true*/
+		bool accept(LexemKind kind);
+
+		/* Accept mandatory symbol.
+		If current state of automata doesn't allow to accept symbol of the kind,
+		throw SyntaxException, otherwise advance automata*/
+		void expect(LexemKind kind);
+
+		/* Check current symbol.
+		Returns: true if current symbol is of the kind, otherwise return false*/
+		bool symbol(LexemKind kind) {
+			return tokens->getKind(current) == kind;
+		}
+
+		/* a table to lookup constant by name */
+		ConstantLookupTable* constantLookupTable;
+
+		/* a table to lookup function by name */
+		FunctionLookupTable* functionLookupTable;
+
+		/* memory of the nodes; NULL is the heap */
+		MemoryResource* resource;
+
+		/* the let bindings of the expression being parsed */
+		Bindings bindings;
+
+		/* The grammar rules, one code for both trees: the builder creates
+		the nodes of the AstNode tree (AstTreeBuilder) or of the FlatAst.
+		The public rule methods call these*/
+		template <class Builder>
+		typename Builder::Node letExpr(Builder& builder);
+
+		template <class Builder>
+		typename Builder::Node addExpr(Builder& builder);
+
+		template <class Builder>
+		typename Builder::Node mulExpr(Builder& builder);
+
+		template <class Builder>
+		typename Builder::Node powExpr(Builder& builder);
+
+		template <class Builder>
+		typename Builder::Node factor(Builder& builder);
+
+		template <class Builder>
+		typename Builder::Node funcCall(Builder& builder);
+
+		template <class Builder>
+		typename Builder::Node variable(Builder& builder);
+
+	public:
+
+		Parser(std::istream& inputStream);
+
+		/* the nodes are allocated in the resource (heap if NULL) */
+		Parser(std::istream& inputStream, 
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			MemoryResource* resource = NULL);
+
+		/* parse the source text in place (buffer or memory-mapped file);
+		the source must outlive the parser*/
+		Parser(const SourceBuffer& source, 
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			MemoryResource* resource = NULL);
+
+		/* parse tokens lexed already; the tokens must outlive the parser.
+		The same tokens may be parsed many times*/
+		Parser(const TokenArray& tokens, 
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			MemoryResource* resource = NULL);
+
+		/* Lex the whole input (unless tokens were given) and
+		start parsing at the first token.
+		Throws UnknownTokenException*/
+		Parser& begin();
+
+		/* Start parsing the tokens given at the token first; parsing
+		a rule then reads only the tokens of that rule (see getTokenIndex)*/
+		Parser& begin(size_t first);
+
+		/* index of the current token - the first one not parsed yet */
+		size_t getTokenIndex() {
+			return current;
+		}
+
+		/* parse expression */
+		AstNode* expr();
+
+		/* parse expression into the flat tree (cleared first) */
+		void expr(FlatAst& ast);
+
+		/* parse additive expression */
+		AstNode* addExpr();
+
+		/* parse multiplicative expression */
+		AstNode* mulExpr();
+
+		/* parse power expression */
+		AstNode* powExpr();
+
+		/* parse basic factor */
+		AstNode* factor();
+
+		/* parse function call*/
+		AstNode* funcCall();
+
+		/* parse variable */
+		VariableAstNode* variable();
+
+	};
+
+	/* forward declaration */
+	class AstVisitor;
+
+	/* Abstract Syntaxt Tree - base class
+	Used to represent parsed program.
+	Structures of this type implement GoF composite
+	design pattern. The visitor pattern is applied
+	to traverse the composite*/
+	class AstNode {
+	public:
+		/* sub-trees are deleted with the node */
+		virtual ~AstNode() {
+		}
+
+		/* nodes allocated by "new" are deleted */
+		static void* operator new(size_t size) {
+			return ::operator new(size);
+		}
+
+		static void operator delete(void* p) {
+			::operator delete(p);
+		}
+
+		/* Node allocated in the resource (on the heap if NULL).
+		The nodes hold no resources but their sub-trees, so a tree in
+		an Arena is not deleted - releasing the arena frees it*/
+		static void* operator new(size_t size, MemoryResource* resource) {
+			if (resource == NULL) {
+				return ::operator new(size);
+			}
+			return resource->allocate(size, sizeof(double));
+		}
+
+		/* only when the constructor throws */
+		static void operator delete(void* p, MemoryResource* resource) {
+			if (resource == NULL) {
+				::operator delete(p);
+			}
+		}
+
+		/* Traverse sub-tree rooted in this node.
+		Traversal is 'post-order': 
+		1. Visit all sub-trees 
+		2. Visit this node
+		*/
+		virtual void visitPostOrder(AstVisitor& visitor) = 0;
+	};
+
+	/* Copy of the whole tree; the nodes are allocated in the resource
+	(heap if NULL)*/
+	AstNode* copyAst(AstNode* ast, MemoryResource* resource = NULL);
+
+	/* as copyAst; nodeCount is set to the number of the nodes copied */
+	AstNode* copyAst(AstNode* ast, MemoryResource* resource, size_t& nodeCount);
+
+	/* Abstract representation of literal */
+	template <class T>
+	class LiteralAstNode : public AstNode {
+	private:
+		//literal value
+		T value;
+	protected:
+		LiteralAstNode(T t) : value(t) {}
+	public:
+		T getLiteralValue() {
+			return value;
+		}
+	};
+
+	/* floating-point literals */
+	class FloatLiteralAstNode : public LiteralAstNode<double> {
+	public: 
+		FloatLiteralAstNode(double d) 
+			: LiteralAstNode(d) {
+		}
+		virtual void visitPostOrder(AstVisitor& visitor);	
+	};
+
+	/* Node representing variable in calculation*/
+	class VariableAstNode : public AstNode {
+	private:
+		//variable name - interned (see SymbolTable)
+		int symbol;
+	public:
+		VariableAstNode(int symbol) : symbol(symbol) {}
+
+		int getSymbol() {
+			return symbol;
+		}
+
+		std::string getVarIdentifier() {
+			return symbolName(symbol);
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* Abstraction for unary operators */
+	class UnaryOperatorAstNode : public AstNode {
+	private:
+		//operator's symbol - a literal, nothing to free
+		const char* symbol;
+		//argument of the operator - expression
+		AstNode* exprAst;
+	protected:
+		UnaryOperatorAstNode(const char* symbol, AstNode* exprAst)
+			:symbol(symbol), exprAst(exprAst) {
+		}
+
+		virtual ~UnaryOperatorAstNode() {
+			delete exprAst;
+		}
+
+		AstNode* getArgument() {
+			return exprAst;
+		}
+	public:
+		std::string getSymbol() {
+			return std::string(symbol);
+		}
+	};
+
+	/* unary negation '- expr '*/
+	class UnaryNegationAstNode : public UnaryOperatorAstNode {
+	public:
+		UnaryNegationAstNode(AstNode* exprAst)
+			: UnaryOperatorAstNode("-", exprAst) {
+				;
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* abstraction of binary operators */
+	class BinaryOperatorAstNode : public AstNode {
+	private:
+		//operator's symbol - a literal, nothing to free
+		const char* symbol;
+		//left argument of the operator - expression
+		AstNode* leftAst;
+		//right argument of the operator - expression
+		AstNode* rightAst;
+	public:
+		BinaryOperatorAstNode(
+			const char* symbol,
+			AstNode* leftAst,
+			AstNode* rightAst) 
+			: symbol(symbol), leftAst(leftAst), rightAst(rightAst) {
+		}
+
+		virtual ~BinaryOperatorAstNode() {
+			//a long sum is a long chain of left arguments:
+			//delete it in a loop, the recursion would overflow the stack
+			AstNode* left = leftAst;
+			BinaryOperatorAstNode* binary;
+			while ((binary = dynamic_cast<BinaryOperatorAstNode*>(left)) != NULL) {
+				left = binary->leftAst;
+				binary->leftAst = NULL;
+				delete binary;
+			}
+			delete left;
+			delete rightAst;
+		}
+
+		std::string getSymbol() {
+			return std::string(symbol);
+		}
+
+		AstNode* getLeft() {
+			return leftAst;
+		}
+
+		AstNode* getRight() {
+			return rightAst;
+		}
+	};
+
+	/* binary operator: addition */
+	class AddOperatorAstNode : public BinaryOperatorAstNode {
+	public:
+		AddOperatorAstNode(
+			AstNode* leftAst,
+			AstNode* rightAst) 
+			: BinaryOperatorAstNode("+", leftAst, rightAst) {
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* binary operator: subtraction */
+	class SubOperatorAstNode : public BinaryOperatorAstNode {
+	public:
+		SubOperatorAstNode(
+			AstNode* leftAst,
+			AstNode* rightAst) 
+			: BinaryOperatorAstNode("-", leftAst, rightAst) {
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* binary operator: multiplication */
+	class MulOperatorAstNode : public BinaryOperatorAstNode {
+	public:
+		MulOperatorAstNode(
+			AstNode* leftAst,
+			AstNode* rightAst) 
+			: BinaryOperatorAstNode("*", leftAst, rightAst) {
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* binary operator: division */
+	class DivOperatorAstNode : public BinaryOperatorAstNode {
+	public:
+		DivOperatorAstNode(
+			AstNode* leftAst,
+			AstNode* rightAst) 
+			: BinaryOperatorAstNode("/", leftAst, rightAst) {
+		}
+
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* binary operator: power */
+	class PowerOperatorAstNode : public BinaryOperatorAstNode {
+	public:
+		PowerOperatorAstNode(
+			AstNode* leftAst,
+			AstNode* rightAst) 
+			: BinaryOperatorAstNode("^", leftAst, rightAst) {
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+
+	};
+
+	/* function evaluator for 1-arg functions*/
+	class Function1Arg {
+	public:
+		virtual ~Function1Arg() {
+		}
+
+		/* evaluate function's value */
+		virtual double eval(double in) = 0;
+
+		/* the definition of a function defined by an expression - its
+		calls are inlined by the parsers; NULL for a native function*/
+		virtual FunctionDefinition* getDefinition() {
+			return NULL;
+		}
+	};
+
+	/* function call - 1 arg */
+	class FunctionCall1ArgAstNode : public AstNode {
+	private:
+		/* function name - interned (see SymbolTable)*/
+		int symbol;
+		/* argument of the function*/
+		AstNode* arg1;
+		/* function value evaluator - result of function lookup */
+		Function1Arg* func;
+	public:
+		FunctionCall1ArgAstNode(int symbol, Function1Arg* func, AstNode* arg1) 
+			: symbol(symbol), arg1(arg1), func(func) {
+				;
+		}
+		virtual ~FunctionCall1ArgAstNode() {
+			//function is not deleted - it belongs to the lookup table
+			delete arg1;
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+
+		AstNode* getArg1() {
+			return arg1;
+		}
+
+		int getSymbol() {
+			return symbol;
+		}
+
+		std::string getFunctionName() {
+			return symbolName(symbol);
+		}
+
+		Function1Arg* getFunction() {
+			return func;
+		}
+	};
+
+	/* constant value */
+	class ConstantAstNode : public VariableAstNode {
+	private:
+		/* constant's value - result of lookup*/
+		double value;
+	public:
+		ConstantAstNode(int symbol, double value)
+			: VariableAstNode(symbol), value(value) {
+				;
+		}
+
+		double getValue() {
+			return value;
+		}
+
+		virtual void visitPostOrder(AstVisitor& visitor);
+	};
+
+	/* A new version number of a lookup table; never the same twice.
+	Thread-safe, and safe before main (see atomicIncrement)*/
+	unsigned int newLookupTableVersion();
+
+	/* Elements of the builtin symbols (see BuiltinSymbol), indexed by
+	the symbol: a static table, initialized by the compiler, which lookup
+	tables find below the elements added to them*/
+	template <class T>
+	struct BuiltinElements {
+		bool defined[BUILTIN_SYMBOL_COUNT];
+		T elements[BUILTIN_SYMBOL_COUNT];
+	};
+
+	/* Generic implementation of symbol lookup table.
+	Used for constant and funcion identifier lookup.
+	Elements are kept in an open addressing hash table keyed by the
+	symbol of the name (see SymbolTable): a lookup is usually a single
+	probe, and a table is as large as the names added to it - not as
+	the largest symbol of the process*/
+	template <class T>
+	class LookupTable {
+	protected:
+		/* symbol of each slot; NO_SYMBOL - empty. The size is 0 or
+		a power of 2, at most half of the slots have a symbol. A slot
+		keeps its symbol when the element is removed, until the table
+		grows, so that the probes never stop early*/
+		std::vector<int> keys;
+		/* element of each slot; valid where defined */
+		std::vector<T> elements;
+		std::vector<bool> defined;
+		/* number of the slots with a symbol */
+		size_t used;
+		/* the builtin elements below those added; NULL if none */
+		const BuiltinElements<T>* builtins;
+		/* version of the contents */
+		unsigned int version;
+	protected:
+		LookupTable(const BuiltinElements<T>* builtins = NULL)
+			: used(0), builtins(builtins), version(newLookupTableVersion()) {
+			;
+		}
+
+		/* slot of the symbol, or the empty slot where it is added;
+		the table must have slots*/
+		size_t findSlot(int symbol) const {
+			//symbols are small consecutive numbers - no hash is needed
+			size_t mask = keys.size() - 1;
+			size_t slot = (size_t)symbol & mask;
+			while (keys[slot] != symbol && keys[slot] != NO_SYMBOL) {
+				slot = (slot + 1) & mask;
+			}
+			return slot;
+		}
+
+		/* Returns: slot of the element added for the symbol; -1 if none */
+		int findDefined(int symbol) const {
+			if (symbol < 0 || keys.empty()) {
+				return -1;
+			}
+			size_t slot = findSlot(symbol);
+			//an empty slot is not defined
+			return defined[slot] ? (int)slot : -1;
+		}
+
+		/* twice as many slots; the slots of the elements removed are
+		emptied*/
+		void grow() {
+			std::vector<int> oldKeys;
+			std::vector<T> oldElements;
+			std::vector<bool> oldDefined;
+			oldKeys.swap(keys);
+			oldElements.swap(elements);
+			oldDefined.swap(defined);
+			size_t size = oldKeys.empty() ? 8 : oldKeys.size() * 2;
+			keys.assign(size, NO_SYMBOL);
+			elements.assign(size, T());
+			defined.assign(size, false);
+			used = 0;
+			for (size_t i = 0; i < oldKeys.size(); i++) {
+				if (oldDefined[i]) {
+					size_t slot = findSlot(oldKeys[i]);
+					keys[slot] = oldKeys[i];
+					elements[slot] = oldElements[i];
+					defined[slot] = true;
+					used++;
+				}
+			}
+		}
+
+	public:
+		/* the element of the symbol is builtin: it is not replaced nor
+		removed*/
+		bool isBuiltin(int symbol) const {
+			return builtins != NULL && symbol >= 0 && symbol < BUILTIN_SYMBOL_COUNT
+				&& builtins->defined[symbol];
+		}
+
+		void add(int symbol, T element) {
+			if (symbol < 0 || exists(symbol)) {
+				throw "illegal state";
+			}
+			if ((used + 1) * 2 > keys.size()) {
+				grow();
+			}
+			size_t slot = findSlot(symbol);
+			if (keys[slot] == NO_SYMBOL) {
+				keys[slot] = symbol;
+				used++;
+			}
+			elements[slot] = element;
+			defined[slot] = true;
+			version = newLookupTableVersion();
+		}
+
+		void add(const std::string& key, T element) {
+			add(internSymbol(key), element);
+		}
+
+		/* Put the element in place of the one added for the symbol, or
+		add it. A builtin element is not replaced; the element replaced
+		is the caller's (see FunctionLookupTable)*/
+		void replace(int symbol, T element) {
+			if (isBuiltin(symbol)) {
+				throw "illegal state";
+			}
+			int slot = findDefined(symbol);
+			if (slot < 0) {
+				add(symbol, element);
+				return;
+			}
+			elements[slot] = element;
+			version = newLookupTableVersion();
+		}
+
+		/* Remove the element added for the symbol (not a builtin one).
+		Returns: the element - the caller's now*/
+		T remove(int symbol) {
+			int slot = findDefined(symbol);
+			if (isBuiltin(symbol) || slot < 0) {
+				throw "illegal state";
+			}
+			defined[slot] = false;
+			version = newLookupTableVersion();
+			return elements[slot];
+		}
+
+		/* Version of the contents: a new number whenever an element is
+		added, replaced or removed. No two tables have the same version - not even a table
+		created at the address of a deleted one - so the version
+		identifies the table and its contents (see calc::CalculatorCache)*/
+		unsigned int getVersion() const {
+			return version;
+		}
+
+		bool exists(int symbol) const {
+			return isBuiltin(symbol) || findDefined(symbol) >= 0;
+		}
+
+		bool exists(const std::string& key) const {
+			return exists(symbolTable().find(key));
+		}
+
+		/* Look the symbol up once.
+		Returns: false if the symbol is not defined; element is not set*/
+		bool find(int symbol, T& element) const {
+			if (isBuiltin(symbol)) {
+				element = builtins->elements[symbol];
+				return true;
+			}
+			int slot = findDefined(symbol);
+			if (slot < 0) {
+				return false;
+			}
+			element = elements[slot];
+			return true;
+		}
+
+		T lookup(int symbol) const {
+			T element;
+			if (find(symbol, element)) {
+				return element;
+			} else {
+				throw "illegal state";
+			}
+		}
+
+		T lookup(const std::string& key) const {
+			return lookup(symbolTable().find(key));
+		}
+	};
+
+	/* lookup table for constants */
+	class ConstantLookupTable : public LookupTable<double> {
+	public:
+		/* the builtin constants (if any) are found as added */
+		ConstantLookupTable(const BuiltinElements<double>* builtins = NULL)
+			: LookupTable(builtins) {
+			;
+		}
+	};
+
+	/* Lookup table for functions 
+	This table takes ownership of contained elements.
+	It dealocates all functions at destruction time; the builtin
+	functions are static and not owned*/
+	class FunctionLookupTable : public LookupTable<Function1Arg*> {
+	public:
+		/* the builtin functions (if any) are found as added */
+		FunctionLookupTable(const BuiltinElements<Function1Arg*>* builtins = NULL)
+			: LookupTable(builtins) {
+			;
+		}
+		~FunctionLookupTable() {
+			for (size_t slot = 0; slot < elements.size(); slot++) {
+				if (defined[slot]) {
+					delete elements[slot];
+				}
+			}
+		}
+
+	};
+
+	/* GoF Visitor Design pattern:
+	The visitor class - a callback when traversing
+	tree of NodeAst (and subclasses)*/
+	class AstVisitor {
+	public:
+		virtual void visit(FloatLiteralAstNode& floatLiteralNode) = 0;
+
+		virtual void visit(VariableAstNode& variableNode) = 0;
+
+		virtual void visit(UnaryNegationAstNode& unaryNegationNode) = 0;
+
+		virtual void visit(AddOperatorAstNode& addOperatorNode) = 0;
+
+		virtual void visit(SubOperatorAstNode& subOperatorNode) = 0;
+
+		virtual void visit(MulOperatorAstNode& mulOperatorNode) = 0;
+
+		virtual void visit(DivOperatorAstNode& divOperatorNode) = 0;
+
+		virtual void visit(PowerOperatorAstNode& powerOperatorNode) = 0;
+
+		virtual void visit(FunctionCall1ArgAstNode& funcCallNode) = 0;
+
+		virtual void visit(ConstantAstNode& constantNode) = 0;
+	};
+
+	/* helper visitor to transform AST into textual representation
+	if reverse polish notation */
+	class RPNTextVisitor : public AstVisitor {
+	private:
+		int tokens;
+		std::stringstream b;
+		/* add space between tokens */
+		void space();
+	public:
+		RPNTextVisitor() : tokens(0) {
+			;
+		}
+		/* return result - AST tree in reverse polish notation*/
+		std::string getRPNText();
+
+		virtual void visit(FloatLiteralAstNode& floatLiteralNode);
+
+		virtual void visit(VariableAstNode& variableNode);
+
+		virtual void visit(UnaryNegationAstNode& unaryNegationNode);
+
+		virtual void visit(AddOperatorAstNode& addOperatorNode);
+
+		virtual void visit(SubOperatorAstNode& subOperatorNode);
+
+		virtual void visit(MulOperatorAstNode& mulOperatorNode);
+
+		virtual void visit(DivOperatorAstNode& divOperatorNode);
+
+		virtual void visit(PowerOperatorAstNode& powerOperatorNode);
+
+		virtual void visit(FunctionCall1ArgAstNode& funcCallNode);
+
+		virtual void visit(ConstantAstNode& constantNode);
+	};
+
+}
+
+#endif
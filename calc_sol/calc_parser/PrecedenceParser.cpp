@@ -0,0 +1,448 @@
+
+#include "stdafx.h"
+#include "PrecedenceParser.h"
+#include "FunctionDefinition.h"
+#include "SharedAst.h"
+
+using namespace std;
+
+namespace parser {
+
+	/*** PrecedenceParser *** *** *** *** *** *** *** *** *** ***/
+
+	/* the binary operators by their token: precedence (0 - the token
+	is not a binary operator) and operation. All of them are left
+	associative*/
+	struct BinaryOperatorInfo {
+		int precedence;
+		FlatOpcode opcode;
+	};
+
+	static const BinaryOperatorInfo binaryOperators[] = {
+		{ 0, FO_FLOAT },  //LK_EOF
+		{ 0, FO_FLOAT },  //LK_FLOAT
+		{ 0, FO_FLOAT },  //LK_IDENTIFIER
+		{ 1, FO_ADD },    //LK_PLUS
+		{ 1, FO_SUB },    //LK_MINUS
+		{ 2, FO_MUL },    //LK_MUL
+		{ 2, FO_DIV },    //LK_DIV
+		{ 3, FO_POWER },  //LK_DASH
+		{ 0, FO_FLOAT },  //LK_OPAREN
+		{ 0, FO_FLOAT },  //LK_CPAREN
+		{ 0, FO_FLOAT },  //LK_TILDE
+		{ 0, FO_FLOAT }   //LK_ASSIGN
+	};
+
+	PrecedenceParser::PrecedenceParser(const SourceBuffer& source,
+		ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+		MemoryResource* resource)
+		: source(&source)
+		, tokens(&ownedTokens)
+		, current(0)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, resource(resource) {
+	}
+
+	PrecedenceParser::PrecedenceParser(const TokenArray& tokens,
+		ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+		MemoryResource* resource)
+		: source(NULL)
+		, tokens(&tokens)
+		, current(0)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable)
+		, resource(resource) {
+	}
+
+	PrecedenceParser& PrecedenceParser::begin() {
+		if (source != NULL) {
+			ownedTokens.tokenize(*source);
+		}
+		current = 0;
+		bindings.clear();
+		return *this;
+	}
+
+	bool PrecedenceParser::begin(Status& status) {
+		current = 0;
+		bindings.clear();
+		if (source != NULL) {
+			return ownedTokens.tokenize(*source, status);
+		}
+		status.clear();
+		return true;
+	}
+
+	PrecedenceParser& PrecedenceParser::begin(size_t first) {
+		begin();
+		current = first;
+		return *this;
+	}
+
+	bool PrecedenceParser::syntaxError(Status& status, const char* text, int symbol) {
+		int lineNo, charNo;
+		tokens->position(current, lineNo, charNo);
+		status.setSyntaxError(lineNo, charNo, text, symbol);
+		return false;
+	}
+
+	bool PrecedenceParser::syntaxError(Status& status, const char* text, size_t token) {
+		int lineNo, charNo;
+		tokens->position(current, lineNo, charNo);
+		status.setSyntaxError(lineNo, charNo, text, tokens->getText(token));
+		return false;
+	}
+
+	AstNode* PrecedenceParser::expr() {
+		AstTreeBuilder builder(resource);
+		AstNode* root = NULL;
+		Status status;
+		if (!parse(builder, root, status)) {
+			status.raise();
+		}
+		return root;
+	}
+
+	void PrecedenceParser::expr(FlatAst& ast) {
+		Status status;
+		if (!expr(ast, status)) {
+			status.raise();
+		}
+	}
+
+	void PrecedenceParser::expr(PostOrderBuilder& builder) {
+		Status status;
+		if (!expr(builder, status)) {
+			status.raise();
+		}
+	}
+
+	bool PrecedenceParser::expr(FlatAst& ast, Status& status) {
+		ast.clear();
+		//never more nodes than tokens
+		ast.reserve(tokens->size() - current);
+		int root;
+		return parse(ast, root, status);
+	}
+
+	bool PrecedenceParser::expr(PostOrderBuilder& builder, Status& status) {
+		int root;
+		return parse(builder, root, status);
+	}
+
+	bool PrecedenceParser::expr(PostOrderBuilder& builder, int& root, Status& status) {
+		return parse(builder, root, status);
+	}
+
+	template <class Builder>
+	bool PrecedenceParser::reduce(Builder& builder, vector<typename Builder::Node>& operands) {
+		int kind = operators.back().kind;
+		if (kind == OP_LET) {
+			return false;
+		}
+		operators.pop_back();
+		if (kind == OP_IN) {
+			//the binding is out of scope
+			typename Builder::Node value;
+			bindings.pop(value);
+			operands.back() = builder.endScope(value, operands.back());
+			return true;
+		}
+		typename Builder::Node right = operands.back();
+		operands.pop_back();
+		operands.back() = builder.addBinary((FlatOpcode)kind, operands.back(), right);
+		return true;
+	}
+
+	bool PrecedenceParser::isBindingOpen() const {
+		for (size_t i = operators.size(); i > 0; i--) {
+			int kind = operators[i - 1].kind;
+			if (kind == OP_LET) {
+				return true;
+			}
+			if (kind == OP_PAREN || kind == OP_CALL) {
+				return false;
+			}
+		}
+		return false;
+	}
+
+	/*
+	Technological note:
+	the parser is an automaton of two states. Before an operand, a
+	factor is read: its minus, a function call or an open parenthesis
+	are pushed, a float or a variable becomes an argument. After an
+	operand, a binary operator first applies the operators of the
+	same or higher precedence from the stack (left associativity),
+	then it is pushed; a closing parenthesis applies the operators
+	down to its open parenthesis. The end of a factor applies its
+	minus.
+
+	A let may begin where an expression begins: at the start, after
+	an open parenthesis, Assign or In. Its value ends at In, which
+	applies the operators down to the Let; the expression after In
+	ends where the expression around it ends, and so is completed by
+	the closing parenthesis, the In or the end of the expression
+	around. A Let still on the stack there is the error of a missing
+	In, at the same token as Parser reports it.
+
+	Wherever Parser::expr would stop or fail, this parser stops or
+	fails at the same token*/
+	template <class Builder>
+	bool PrecedenceParser::parse(Builder& builder, typename Builder::Node& root, Status& status) {
+		status.clear();
+		vector<typename Builder::Node> operands;
+		operators.clear();
+		//number of open parentheses and calls on the stack
+		size_t open = 0;
+		//an expression begins - it may be a let expression
+		bool exprBegins = true;
+		for (;;) {
+			LexemKind kind = tokens->getKind(current);
+			if (exprBegins && kind == LK_IDENTIFIER && tokens->getSymbol(current) == SYMBOL_LET) {
+				//let_expr ::= Let variable Assign expr In expr
+				current++;
+				if (tokens->getKind(current) != LK_IDENTIFIER || isKeyword(tokens->getSymbol(current))) {
+					return syntaxError(status);
+				}
+				//the name is defined - interned
+				int name = tokens->intern(current);
+				current++;
+				if (tokens->getKind(current) != LK_ASSIGN) {
+					return syntaxError(status);
+				}
+				current++;
+				operators.push_back(Operator(OP_LET, 0, name));
+				continue;
+			}
+			exprBegins = false;
+			//before an operand: factor ::= [ Minus ] ( Float | func_call_expr | OParen expr CParen )
+			if (kind == LK_MINUS) {
+				operators.push_back(Operator(OP_NEGATION, 0, NO_SYMBOL));
+				current++;
+				kind = tokens->getKind(current);
+			}
+			if (kind == LK_FLOAT) {
+				operands.push_back(builder.addFloat(tokens->getValue(current)));
+				current++;
+			} else if (kind == LK_IDENTIFIER) {
+				//a name not interned is neither bound nor a constant
+				size_t name = current;
+				int symbol = tokens->getSymbol(current);
+				if (isKeyword(symbol)) {
+					return syntaxError(status);
+				}
+				current++;
+				if (tokens->getKind(current) == LK_OPAREN) {
+					//only 1-arg functions allowed - argument is compulsory
+					operators.push_back(Operator(OP_CALL, 0, symbol, name));
+					open++;
+					current++;
+					exprBegins = true;
+					continue;
+				}
+				typename Builder::Node bound;
+				double value;
+				if (bindings.find(symbol, bound)) {
+					//the value of the binding
+					operands.push_back(builder.addReference(bound));
+					if (builder.isTooLarge()) {
+						return syntaxError(status, "expression too large");
+					}
+				} else if (constantLookupTable != NULL
+					&& constantLookupTable->find(symbol, value)) {
+						operands.push_back(builder.addConstant(symbol, value));
+				} else {
+					//the tree names the variable
+					operands.push_back(builder.addVariable(tokens->intern(name)));
+				}
+			} else if (kind == LK_OPAREN) {
+				operators.push_back(Operator(OP_PAREN, 0, NO_SYMBOL));
+				open++;
+				current++;
+				exprBegins = true;
+				continue;
+			} else {
+				//No viable alternative form of the factor rule
+				return syntaxError(status);
+			}
+
+			//after an operand
+			for (;;) {
+				//the factor is complete
+				if (!operators.empty() && operators.back().kind == OP_NEGATION) {
+					operands.back() = builder.addNegation(operands.back());
+					operators.pop_back();
+				}
+				kind = tokens->getKind(current);
+				if (kind != LK_CPAREN || open == 0) {
+					break;
+				}
+				//closing parenthesis - the expression in parenthesis is complete
+				while (operators.back().kind != OP_PAREN && operators.back().kind != OP_CALL) {
+					if (!reduce(builder, operands)) {
+						//In is mandatory
+						return syntaxError(status);
+					}
+				}
+				Operator paren = operators.back();
+				operators.pop_back();
+				open--;
+				current++;
+				if (paren.kind == OP_CALL) {
+					//lookup function in the lookup table
+					Function1Arg* function = NULL;
+					if (functionLookupTable == NULL
+						|| !functionLookupTable->find(paren.symbol, function)) {
+							return syntaxError(status, "unknown function ", paren.token);
+					}
+					FunctionDefinition* definition = function->getDefinition();
+					if (definition != NULL) {
+						//the body in place of the call
+						operands.back() = definition->inlineCall(builder, operands.back());
+						if (builder.isTooLarge()) {
+							return syntaxError(status, "expression too large");
+						}
+					} else {
+						operands.back() = builder.addCall(paren.symbol, function, operands.back());
+					}
+				}
+			}
+
+			if (kind == LK_IDENTIFIER && tokens->getSymbol(current) == SYMBOL_IN && isBindingOpen()) {
+				//the value of the binding is complete
+				while (operators.back().kind != OP_LET) {
+					reduce(builder, operands);
+				}
+				bindings.push(operators.back().symbol, operands.back());
+				operands.pop_back();
+				operators.back().kind = OP_IN;
+				current++;
+				exprBegins = true;
+				continue;
+			}
+			const BinaryOperatorInfo& info = binaryOperators[kind];
+			if (info.precedence == 0) {
+				if (open > 0) {
+					//closing parenthesis is mandatory
+					return syntaxError(status);
+				}
+				//the end of the expression - the rest is not parsed
+				break;
+			}
+			while (!operators.empty() && operators.back().precedence >= info.precedence) {
+				reduce(builder, operands);
+			}
+			operators.push_back(Operator(info.opcode, info.precedence, NO_SYMBOL));
+			current++;
+		}
+		while (!operators.empty()) {
+			if (!reduce(builder, operands)) {
+				//In is mandatory
+				return syntaxError(status);
+			}
+		}
+		root = operands.back();
+		return true;
+	}
+
+	bool PrecedenceParser::definition(int& name, int& parameter, FlatAst& body, Status& status) {
+		status.clear();
+		if (tokens->getKind(current) != LK_IDENTIFIER || isKeyword(tokens->getSymbol(current))) {
+			return syntaxError(status);
+		}
+		size_t nameToken = current;
+		name = tokens->getSymbol(current);
+		if (functionLookupTable != NULL && functionLookupTable->exists(name)) {
+			return syntaxError(status, "function already defined ", name);
+		}
+		current++;
+		if (tokens->getKind(current) != LK_OPAREN) {
+			return syntaxError(status);
+		}
+		current++;
+		if (tokens->getKind(current) != LK_IDENTIFIER || isKeyword(tokens->getSymbol(current))) {
+			return syntaxError(status);
+		}
+		//the parameter is bound in the body - interned
+		parameter = tokens->intern(current);
+		current++;
+		if (tokens->getKind(current) != LK_CPAREN) {
+			return syntaxError(status);
+		}
+		current++;
+		if (tokens->getKind(current) != LK_ASSIGN) {
+			return syntaxError(status);
+		}
+		current++;
+		size_t first = current;
+		//the body is built as a DAG: the parameter is bound as the name
+		//of a let - every use of it is its node, as every use of a let
+		//binding or of the argument of a function inlined
+		FlatAst dag;
+		SharedAstBuilder builder(dag);
+		int variable = builder.addVariable(parameter);
+		bindings.push(parameter, variable);
+		int root;
+		if (!parse(builder, root, status)) {
+			return false;
+		}
+		bindings.pop();
+		if (tokens->getKind(current) != LK_EOF) {
+			//the rest is not a part of the body
+			return syntaxError(status);
+		}
+		if (dag.size() > MAX_COPIED_NODES) {
+			//the bodies inlined double at each level of nesting
+			return syntaxError(status, "function too large");
+		}
+		//only the nodes of the root are kept, not the values of the
+		//let bindings not used; they are numbered again
+		vector<int> uses;
+		builder.countUses(root, uses);
+		vector<int> numbers(root + 1);
+		body.clear();
+		for (int node = 0; node <= root; node++) {
+			if (uses[node] == 0 && node != root) {
+				continue;
+			}
+			switch (dag.getOpcode(node)) {
+			case FO_FLOAT:
+				numbers[node] = body.addFloat(dag.getValue(node));
+				break;
+			case FO_VARIABLE:
+				if (dag.getSymbol(node) != parameter) {
+					//the error is at the first use of the variable
+					int symbol = dag.getSymbol(node);
+					for (current = first; tokens->getKind(current) != LK_IDENTIFIER
+						|| tokens->getSymbol(current) != symbol; current++) {
+					}
+					return syntaxError(status, "unknown variable ", symbol);
+				}
+				numbers[node] = body.addVariable(parameter);
+				break;
+			case FO_CONSTANT:
+				numbers[node] = body.addConstant(dag.getSymbol(node), dag.getValue(node));
+				break;
+			case FO_NEGATION:
+				numbers[node] = body.addNegation(numbers[dag.getLeft(node)]);
+				break;
+			case FO_CALL:
+				numbers[node] = body.addCall(dag.getSymbol(node), dag.getFunction(node),
+					numbers[dag.getLeft(node)]);
+				break;
+			default:
+				numbers[node] = body.addBinary(dag.getOpcode(node),
+					numbers[dag.getLeft(node)], numbers[dag.getRight(node)]);
+				break;
+			}
+		}
+		//the function is defined - its name is interned
+		name = tokens->intern(nameToken);
+		return true;
+	}
+
+	/*** End of PrecedenceParser *** *** *** *** *** *** *** ***/
+
+}
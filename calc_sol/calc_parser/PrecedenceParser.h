@@ -0,0 +1,186 @@
+#ifndef PRECEDENCE_PARSER_H
+#define PRECEDENCE_PARSER_H
+
+#include "Parser.h"
+#include "FlatAst.h"
+#include "TokenArray.h"
+#include "SourceBuffer.h"
+#include "Status.h"
+#include <vector>
+
+namespace parser {
+
+	/* Parser of the grammar of the "Parser" class without recursion.
+
+	The operators are parsed by their precedence (operator precedence,
+	"shunting-yard"): the binary operators waiting for their right
+	argument, the open parentheses, function calls and unary minuses
+	are kept on an explicit stack, the arguments on another one.
+	Each token is read once and the stacks grow with the nesting of
+	the input, not the native stack - any nesting depth is parsed.
+	A let expression is a marker too: Let opens the value of the
+	binding, In closes it and opens the expression after it, which
+	ends with the expression around.
+
+	The trees, the rest of the input not parsed and the errors (text
+	and position) are the same as those of Parser::expr. A deeply
+	nested AstNode tree is still deleted and visited by recursion;
+	parse such input into a FlatAst, which has no recursion at all.
+
+	The calls of the functions defined by an expression are inlined
+	(see FunctionDefinition)*/
+	class PrecedenceParser {
+	private:
+		/* input to tokenize when parsing begins (or none) */
+		const SourceBuffer* source;
+
+		/* tokens of the input, lexed before parsing */
+		TokenArray ownedTokens;
+		const TokenArray* tokens;
+
+		/* index of currently read lexem (token)*/
+		size_t current;
+
+		/* a table to lookup constant by name */
+		ConstantLookupTable* constantLookupTable;
+
+		/* a table to lookup function by name */
+		FunctionLookupTable* functionLookupTable;
+
+		/* memory of the nodes; NULL is the heap */
+		MemoryResource* resource;
+
+		/* Entry of the operator stack: a binary operator (FlatOpcode),
+		or one of the markers below */
+		struct Operator {
+			int kind;
+			/* precedence of a binary operator; 0 - a marker, never
+			applied by another operator*/
+			int precedence;
+			/* symbol of a function call or of a let name */
+			int symbol;
+			/* token of the name of a function call */
+			size_t token;
+
+			Operator(int kind, int precedence, int symbol, size_t token = 0)
+				: kind(kind), precedence(precedence), symbol(symbol), token(token) {
+			}
+		};
+
+		/* markers of the operator stack */
+		enum {
+			/* unary minus of the factor being parsed */
+			OP_NEGATION = 100,
+			/* open parenthesis */
+			OP_PAREN,
+			/* open parenthesis of a function call */
+			OP_CALL,
+			/* the value of a let binding is parsed; symbol is the name */
+			OP_LET,
+			/* the expression after In is parsed - the name is bound */
+			OP_IN
+		};
+
+		/* the operator stack; reused by the next parse */
+		std::vector<Operator> operators;
+
+		/* the let bindings in scope */
+		Bindings bindings;
+
+		/* Set the syntax error at the current token in the status; the
+		symbol is named after the text.
+		Returns: false*/
+		bool syntaxError(Status& status, const char* text = NULL, int symbol = NO_SYMBOL);
+
+		/* Set the syntax error at the current token; the text of the
+		token given (a name not interned) is named after the text.
+		Returns: false*/
+		bool syntaxError(Status& status, const char* text, size_t token);
+
+		/* The whole expression; the builder creates the nodes.
+		Returns: false on an error, set in the status; nothing is thrown*/
+		template <class Builder>
+		bool parse(Builder& builder, typename Builder::Node& root, Status& status);
+
+		/* The operator on the top is applied to the arguments, the let
+		expression on the top is complete.
+		Returns: false if the top is the value of a let binding - the
+		expression ends before In*/
+		template <class Builder>
+		bool reduce(Builder& builder, std::vector<typename Builder::Node>& operands);
+
+		/* the value of a let binding is parsed in the innermost
+		parentheses - In is the keyword of the binding*/
+		bool isBindingOpen() const;
+
+		/* not copyable */
+		PrecedenceParser(const PrecedenceParser& other);
+		PrecedenceParser& operator =(const PrecedenceParser& other);
+	public:
+		/* parse the source text in place; the source must outlive the
+		parser. The nodes are allocated in the resource (heap if NULL)*/
+		PrecedenceParser(const SourceBuffer& source,
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			MemoryResource* resource = NULL);
+
+		/* parse tokens lexed already; the tokens must outlive the parser */
+		PrecedenceParser(const TokenArray& tokens,
+			ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable,
+			MemoryResource* resource = NULL);
+
+		/* Lex the source (unless tokens were given) and start parsing
+		at the first token.
+		Throws UnknownTokenException*/
+		PrecedenceParser& begin();
+
+		/* Lex the source (unless tokens were given) and start parsing;
+		a lexer error is set in the status instead of thrown.
+		Returns: false on an error*/
+		bool begin(Status& status);
+
+		/* Start parsing at the token first of the tokens given - an
+		expression inside of the text (see IncrementalParser)*/
+		PrecedenceParser& begin(size_t first);
+
+		/* index of the current token - the first one not parsed yet */
+		size_t getTokenIndex() {
+			return current;
+		}
+
+		/* Parse expression, as Parser::expr does.
+		Returns: AST; it must be deallocated by the client (see Parser).
+		Throws SyntaxException*/
+		AstNode* expr();
+
+		/* parse expression into the flat tree (cleared first) */
+		void expr(FlatAst& ast);
+
+		/* parse expression; the nodes are given to the builder as they
+		are recognized and no tree is built*/
+		void expr(PostOrderBuilder& builder);
+
+		/* Parse expression into the flat tree; a syntax error is set in
+		the status instead of thrown.
+		Returns: false on an error*/
+		bool expr(FlatAst& ast, Status& status);
+
+		/* parse expression for the builder; errors as expr(ast, status) */
+		bool expr(PostOrderBuilder& builder, Status& status);
+
+		/* as expr(builder, status); the root is the node of the expression
+		given by the builder - not the last node if it shares the nodes*/
+		bool expr(PostOrderBuilder& builder, int& root, Status& status);
+
+		/* Parse the definition of a function (see FunctionDefinition):
+		definition ::= Identifier OParen Identifier CParen Assign expr
+		The name must not be in the function table; the body is built
+		into the flat tree (cleared first) as a DAG, hash-consed (see
+		SharedAstBuilder): the parameter, its only variable, is a single
+		node. The body must end the input.
+		Returns: false on an error, set in the status*/
+		bool definition(int& name, int& parameter, FlatAst& body, Status& status);
+	};
+
+}
+
+#endif
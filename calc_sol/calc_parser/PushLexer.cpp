@@ -0,0 +1,101 @@
+
+#include "stdafx.h"
+#include "PushLexer.h"
+#include "DfaLexer.h"
+
+using namespace std;
+
+namespace parser {
+
+	using namespace dfa;
+
+	/*** PushLexer *** *** *** *** *** *** *** *** *** *** ***/
+
+	PushLexer::PushLexer()
+		: state(S_START)
+		, charCounter(0)
+		, lineCounter(1)
+		, offset(0)
+		, tokenOffset(0)
+		, finished(false) {
+	}
+
+	void PushLexer::push(const char* data, size_t length, TokenSink& sink) {
+		const char* end = data + length;
+		//beginning of the current token in this chunk; a token
+		//continued from the previous chunks starts at data
+		const char* tokenBegin = data;
+		for (const char* p = data; p != end; ++p) {
+			char input = *p;
+			//the character is read - same counting as DfaLexer
+			offset++;
+			charCounter++;
+			if (input == '\n') {
+				charCounter = 0;
+				lineCounter++;
+			}
+			int cc = charClass(input);
+			int nextState = transitionTable[state][cc];
+			if (nextState == T_STOP) {
+				//the token ends before the current input
+				if (stateErrorTable[state] != NULL) {
+					throw UnknownTokenException(lineCounter, charCounter,
+						string(stateErrorTable[state]));
+				}
+				//the current input must start the next token
+				if (transitionTable[S_START][cc] == T_ERROR) {
+					throw UnknownTokenException(lineCounter, charCounter);
+				}
+				emit(tokenBegin, p, sink);
+				nextState = transitionTable[S_START][cc];
+			} else if (nextState == T_ERROR) {
+				//there is no state in which lexer can process input
+				throw UnknownTokenException(lineCounter, charCounter);
+			}
+			if (state == S_START && nextState != S_START) {
+				//a new token starts here
+				tokenBegin = p;
+				tokenOffset = offset - 1;
+			}
+			state = nextState;
+		}
+		if (state != S_START) {
+			//the token continues in the next chunk
+			pending.append(tokenBegin, end);
+		}
+	}
+
+	void PushLexer::finish(TokenSink& sink) {
+		if (finished) {
+			return;
+		}
+		finished = true;
+		if (state != S_START) {
+			//no more characters - the token ends here
+			if (stateErrorTable[state] != NULL) {
+				throw UnknownTokenException(string(stateErrorTable[state]));
+			}
+			emit(pending.data(), pending.data(), sink);
+		}
+		current = Token();
+		current.offset = offset;
+		sink.token(current, lineCounter, charCounter);
+	}
+
+	void PushLexer::emit(const char* chunkText, const char* chunkEnd, TokenSink& sink) {
+		if (pending.empty()) {
+			fillToken(state, chunkText, chunkEnd - chunkText, current);
+		} else {
+			//the token is split between chunks
+			pending.append(chunkText, chunkEnd);
+			fillToken(state, pending.data(), pending.size(), current);
+		}
+		current.offset = tokenOffset;
+		state = S_START;
+		sink.token(current, lineCounter, charCounter);
+		pending.clear();
+	}
+
+	/*** End of PushLexer *** *** *** *** *** *** *** *** *** ***/
+
+}
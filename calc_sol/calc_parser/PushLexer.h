@@ -0,0 +1,90 @@
+#ifndef PUSH_LEXER_H
+#define PUSH_LEXER_H
+
+#include "Lexer.h"
+#include "Token.h"
+#include <string>
+
+namespace parser {
+
+	/* Receiver of the tokens recognized by PushLexer */
+	class TokenSink {
+	public:
+		virtual ~TokenSink() {
+		}
+
+		/* Called for every token, the last one is LK_EOF.
+		lineNo/charNo is the position of the input after the token,
+		as reported by the "Lexer" class which has just read it (for
+		error messages). The text of the token is valid until the call
+		returns*/
+		virtual void token(const Token& token, int lineNo, int charNo) = 0;
+	};
+
+	/* Lexer driven by the input: the text is pushed in chunks of any
+	size, as they arrive (from a pipe, a socket ...).
+
+	Recognizes the grammar of the "Lexer" class with the tables of
+	DfaLexer and reports the same errors at the same line/character.
+	A token may be split between chunks: the automaton stops at the end
+	of the chunk and resumes with the next one. Only the beginning of
+	a split token is copied; all other texts are views into the chunk*/
+	class PushLexer {
+	private:
+		/* state of the automaton (dfa::State) at the end of the last chunk */
+		int state;
+
+		/* beginning of the current token, read with the previous chunks */
+		std::string pending;
+
+		/* count characters in current line */
+		int charCounter;
+
+		/* count lines */
+		int lineCounter;
+
+		/* count all characters pushed */
+		size_t offset;
+
+		/* offset of the first character of the current token */
+		size_t tokenOffset;
+
+		/* finish has been called */
+		bool finished;
+
+		/* the token passed to the sink */
+		Token current;
+
+		/* Send the token recognized in the (final) state; the token
+		ends before chunkEnd, its text after pending starts at chunkText */
+		void emit(const char* chunkText, const char* chunkEnd, TokenSink& sink);
+	public:
+		PushLexer();
+
+		/* Lex the next chunk of the text; the tokens which end in the
+		chunk are sent to the sink. The chunk is not needed after
+		the call returns.
+		Throws UnknownTokenException; nothing may be pushed after that*/
+		void push(const char* data, size_t length, TokenSink& sink);
+
+		/* End of the text: send the last token and LK_EOF.
+		Throws UnknownTokenException*/
+		void finish(TokenSink& sink);
+
+		/* verify end of text */
+		bool isEof() {
+			return finished;
+		}
+
+		int getCharNo() {
+			return charCounter;
+		}
+
+		int getLineNo() {
+			return lineCounter;
+		}
+	};
+
+}
+
+#endif
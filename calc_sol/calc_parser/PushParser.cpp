@@ -0,0 +1,279 @@
+
+#include "stdafx.h"
+#include "PushParser.h"
+#include "FlatAst.h"
+#include "FunctionDefinition.h"
+
+using namespace std;
+
+namespace parser {
+
+	/*** PushParser *** *** *** *** *** *** *** *** *** *** ***/
+
+	PushParser::PushParser(ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable)
+		: result(NULL)
+		, builder(NULL)
+		, constantLookupTable(constantLookupTable)
+		, functionLookupTable(functionLookupTable) {
+		frames.push_back(Frame(R_EXPR));
+	}
+
+	PushParser::~PushParser() {
+		for (size_t i = 0; i < frames.size(); i++) {
+			delete frames[i].node;
+		}
+		delete result;
+	}
+
+	void PushParser::push(const char* data, size_t length) {
+		lexer.push(data, length, *this);
+	}
+
+	AstNode* PushParser::finish() {
+		lexer.finish(*this);
+		AstNode* ast = result;
+		result = NULL;
+		return ast;
+	}
+
+	void PushParser::token(const Token& token, int lineNo, int charNo) {
+		LexemKind kind = token.kind;
+		//every iteration either consumes the token (return) or
+		//completes the innermost rule, which doesn't accept it
+		while (!frames.empty()) {
+			Frame& frame = frames.back();
+			switch (frame.rule) {
+			case R_EXPR:
+				switch (frame.step) {
+				case STEP_BEGIN:
+					if (kind == LK_IDENTIFIER && token.symbol == SYMBOL_LET) {
+						frame.step = STEP_LET_NAME;
+						return;
+					}
+					//expr ::= add_expr
+					frame.rule = R_ADD_EXPR;
+					break;
+				case STEP_LET_NAME:
+					//the name - any identifier but a keyword
+					if (kind != LK_IDENTIFIER || isKeyword(token.symbol)) {
+						throw SyntaxException(lineNo, charNo);
+					}
+					//the name is defined - interned
+					frame.symbol = token.symbol != NO_SYMBOL
+						? token.symbol : internSymbol(token.text.begin, token.text.length);
+					frame.step = STEP_LET_ASSIGN;
+					return;
+				case STEP_LET_ASSIGN:
+					if (kind != LK_ASSIGN) {
+						throw SyntaxException(lineNo, charNo);
+					}
+					//the name is not bound in its own value
+					frame.step = STEP_LET_VALUE;
+					frames.push_back(Frame(R_EXPR));
+					return;
+				case STEP_LET_VALUE:
+					if (kind != LK_IDENTIFIER || token.symbol != SYMBOL_IN) {
+						throw SyntaxException(lineNo, charNo);
+					}
+					bindings.push(frame.symbol, frame.node);
+					frame.step = STEP_LET_BODY;
+					frames.push_back(Frame(R_EXPR));
+					return;
+				default:
+					throw "illegal state";
+				}
+				break;
+			case R_ADD_EXPR:
+			case R_MUL_EXPR:
+			case R_POW_EXPR:
+				if (frame.step == STEP_BEGIN) {
+					//left argument of the operator
+					frame.step = STEP_OPERAND;
+					frames.push_back(Frame((Rule)(frame.rule + 1)));
+					break;
+				}
+				if ((frame.rule == R_ADD_EXPR && (kind == LK_PLUS || kind == LK_MINUS))
+					|| (frame.rule == R_MUL_EXPR && (kind == LK_MUL || kind == LK_DIV))
+					|| (frame.rule == R_POW_EXPR && kind == LK_DASH)) {
+						//right argument of the operator
+						frame.op = kind;
+						frames.push_back(Frame((Rule)(frame.rule + 1)));
+						return;
+				}
+				complete(frame.node);
+				break;
+			case R_FACTOR:
+				switch (frame.step) {
+				case STEP_BEGIN:
+					//optional: consume '-'
+					frame.step = STEP_OPERAND;
+					if (kind == LK_MINUS) {
+						frame.minus = true;
+						return;
+					}
+					break;
+				case STEP_OPERAND:
+					if (kind == LK_FLOAT) {
+						completeFactor(frame, new FloatLiteralAstNode(token.value));
+					} else if (kind == LK_IDENTIFIER) {
+						if (isKeyword(token.symbol)) {
+							throw SyntaxException(lineNo, charNo);
+						}
+						frame.symbol = token.symbol;
+						if (frame.symbol == NO_SYMBOL) {
+							frame.name.assign(token.text.begin, token.text.length);
+						}
+						frame.step = STEP_IDENTIFIER;
+					} else if (kind == LK_OPAREN) {
+						//opening parenthesis - this is expression enclosed in parenthesis
+						frame.step = STEP_PAREN_EXPR;
+						frames.push_back(Frame(R_EXPR));
+					} else {
+						//No viable alternative form of the factor rule
+						throw SyntaxException(lineNo, charNo);
+					}
+					return;
+				case STEP_IDENTIFIER:
+					if (kind == LK_OPAREN) {
+						//only 1-arg functions allowed - argument is compulsory
+						frame.step = STEP_CALL_ARG;
+						frames.push_back(Frame(R_EXPR));
+						return;
+					}
+					if (frame.symbol == NO_SYMBOL) {
+						//neither bound nor a constant; the tree names the variable
+						frame.symbol = internSymbol(frame.name);
+					}
+					completeFactor(frame, variable(frame.symbol));
+					if (builder.isTooLarge()) {
+						//the frames own the tree
+						throw SyntaxException(lineNo, charNo, "expression too large");
+					}
+					break;
+				case STEP_PAREN_EXPR:
+				case STEP_CALL_ARG:
+					//closing parenthesis is mandatory
+					if (kind != LK_CPAREN) {
+						throw SyntaxException(lineNo, charNo);
+					}
+					if (frame.step == STEP_PAREN_EXPR) {
+						AstNode* expr = frame.node;
+						frame.node = NULL;
+						completeFactor(frame, expr);
+					} else {
+						//the function is looked up at the next token, so
+						//that an error is reported where Parser reports it
+						frame.step = STEP_CALL_END;
+					}
+					return;
+				case STEP_CALL_END:
+					{
+						Function1Arg* function = NULL;
+						if (functionLookupTable == NULL
+							|| !functionLookupTable->find(frame.symbol, function)) {
+								throw SyntaxException(lineNo, charNo,
+									string("unknown function " + (frame.symbol != NO_SYMBOL
+										? symbolName(frame.symbol) : frame.name)));
+						}
+						AstNode* arg1 = frame.node;
+						frame.node = NULL;
+						FunctionDefinition* definition = function->getDefinition();
+						if (definition != NULL) {
+							//the body in place of the call
+							completeFactor(frame, definition->inlineCall(builder, arg1));
+							if (builder.isTooLarge()) {
+								throw SyntaxException(lineNo, charNo, "expression too large");
+							}
+						} else {
+							completeFactor(frame, new FunctionCall1ArgAstNode(frame.symbol, function, arg1));
+						}
+					}
+					break;
+				default:
+					throw "illegal state";
+				}
+				break;
+			default:
+				throw "illegal state";
+			}
+		}
+		//the expression is complete - the rest is not parsed
+	}
+
+	void PushParser::completeFactor(Frame& frame, AstNode* node) {
+		if (frame.minus) {
+			//unary negation
+			node = new UnaryNegationAstNode(node);
+		}
+		complete(node);
+	}
+
+	void PushParser::complete(AstNode* node) {
+		frames.pop_back();
+		if (frames.empty()) {
+			result = node;
+			return;
+		}
+		Frame& frame = frames.back();
+		if (frame.rule == R_EXPR) {
+			if (frame.step == STEP_LET_VALUE) {
+				//the value of the binding
+				frame.node = node;
+				return;
+			}
+			//the expression after In - the let expression is complete;
+			//the value was copied where used
+			delete frame.node;
+			frame.node = NULL;
+			bindings.pop();
+			complete(node);
+		} else if (frame.rule == R_FACTOR) {
+			//the expression in parenthesis
+			frame.node = node;
+		} else if (frame.node == NULL) {
+			//left argument of the operator
+			frame.node = node;
+		} else {
+			//the operator expression becomes the left
+			//argument of the next operator (if any)
+			switch (frame.op) {
+			case LK_PLUS:
+				frame.node = new AddOperatorAstNode(frame.node, node);
+				break;
+			case LK_MINUS:
+				frame.node = new SubOperatorAstNode(frame.node, node);
+				break;
+			case LK_MUL:
+				frame.node = new MulOperatorAstNode(frame.node, node);
+				break;
+			case LK_DIV:
+				frame.node = new DivOperatorAstNode(frame.node, node);
+				break;
+			case LK_DASH:
+				frame.node = new PowerOperatorAstNode(frame.node, node);
+				break;
+			default:
+				//should not occur
+				throw "illegal state";
+			}
+		}
+	}
+
+	AstNode* PushParser::variable(int symbol) {
+		AstNode* bound;
+		double value;
+		if (bindings.find(symbol, bound)) {
+			return builder.addReference(bound);
+		} else if (constantLookupTable != NULL
+			&& constantLookupTable->find(symbol, value)) {
+
+			//constant
+			return new ConstantAstNode(symbol, value);
+		} else {
+			return new VariableAstNode(symbol);
+		}
+	}
+
+	/*** End of PushParser *** *** *** *** *** *** *** *** *** ***/
+
+}
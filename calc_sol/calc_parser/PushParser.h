@@ -0,0 +1,143 @@
+#ifndef PUSH_PARSER_H
+#define PUSH_PARSER_H
+
+#include "Parser.h"
+#include "FlatAst.h"
+#include "PushLexer.h"
+#include <string>
+#include <vector>
+
+namespace parser {
+
+	/* Parser driven by the input: the text is pushed in chunks of any
+	size, as they arrive, and parsed while the rest is still on its way.
+
+	Parses the grammar of the "Parser" class into the same AST and
+	reports the same syntax errors at the same line/character. Instead
+	of one method per grammar rule calling each other, the rules being
+	parsed are kept on an explicit stack (one frame per rule with the
+	position in the rule and the sub-tree parsed so far), so parsing can
+	stop after any token and resume when the next chunk arrives.
+
+	Like Parser::expr, parsing stops after the expression; the tokens
+	after it are lexed but not parsed*/
+	class PushParser : public TokenSink {
+	private:
+		/* grammar rule of a frame */
+		enum Rule {
+			R_EXPR,
+			R_ADD_EXPR,
+			R_MUL_EXPR,
+			R_POW_EXPR,
+			R_FACTOR
+		};
+
+		/* position in the rule of a frame */
+		enum Step {
+			/* nothing parsed yet */
+			STEP_BEGIN,
+			/* add/mul/pow: an operand parsed; factor: optional minus parsed */
+			STEP_OPERAND,
+			/* factor: an identifier parsed */
+			STEP_IDENTIFIER,
+			/* factor: OParen expr parsed */
+			STEP_PAREN_EXPR,
+			/* factor: Identifier OParen expr parsed */
+			STEP_CALL_ARG,
+			/* factor: Identifier OParen expr CParen parsed */
+			STEP_CALL_END,
+			/* expr: Let parsed */
+			STEP_LET_NAME,
+			/* expr: Let variable parsed */
+			STEP_LET_ASSIGN,
+			/* expr: Let variable Assign parsed, the value is parsed */
+			STEP_LET_VALUE,
+			/* expr: Let variable Assign expr In parsed */
+			STEP_LET_BODY
+		};
+
+		/* a grammar rule being parsed */
+		struct Frame {
+			Rule rule;
+			Step step;
+			/* add/mul/pow: operator before the operand being parsed */
+			LexemKind op;
+			/* factor: unary minus */
+			bool minus;
+			/* factor: symbol of the identifier; expr: the name bound */
+			int symbol;
+			/* factor: the identifier when it is not interned - the text
+			of the token is gone when the next one is read*/
+			std::string name;
+			/* sub-tree parsed so far; owned by the frame */
+			AstNode* node;
+
+			Frame(Rule rule)
+				: rule(rule), step(STEP_BEGIN), op(LK_EOF), minus(false),
+				symbol(NO_SYMBOL), node(NULL) {
+			}
+		};
+
+		PushLexer lexer;
+
+		/* rules being parsed, the innermost last */
+		std::vector<Frame> frames;
+
+		/* the parsed expression */
+		AstNode* result;
+
+		/* the let bindings in scope; the values are owned by the frames */
+		Bindings bindings;
+
+		/* builds the copies of the values and of the arguments of the
+		functions inlined (see MAX_COPIED_NODES)*/
+		AstTreeBuilder builder;
+
+		/* a table to lookup constant by name */
+		ConstantLookupTable* constantLookupTable;
+
+		/* a table to lookup function by name */
+		FunctionLookupTable* functionLookupTable;
+
+		/* The innermost rule is parsed: pop its frame and pass the
+		sub-tree to the enclosing rule*/
+		void complete(AstNode* node);
+
+		/* the factor is parsed; apply the unary minus */
+		void completeFactor(Frame& frame, AstNode* node);
+
+		/* variable or constant, or the value of a let binding */
+		AstNode* variable(int symbol);
+
+		/* not copyable */
+		PushParser(const PushParser& other);
+		PushParser& operator =(const PushParser& other);
+	public:
+		PushParser(ConstantLookupTable* constantLookupTable, FunctionLookupTable* functionLookupTable);
+
+		/* deletes the AST parsed so far, unless finish returned it */
+		virtual ~PushParser();
+
+		/* Lex and parse the next chunk of the text. The chunk is not
+		needed after the call returns.
+		Throws UnknownTokenException, SyntaxException; nothing may be
+		pushed after that*/
+		void push(const char* data, size_t length);
+
+		/* End of the text: parse the rest.
+		Returns: AST of the expression; it must be deallocated by the client.
+		Throws UnknownTokenException, SyntaxException*/
+		AstNode* finish();
+
+		/* the whole expression is parsed (before the end of the text) */
+		bool isComplete() {
+			return frames.empty();
+		}
+
+		/* parse the next token (see TokenSink) */
+		virtual void token(const Token& token, int lineNo, int charNo);
+	};
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+
+#include "stdafx.h"
+#include "SharedAst.h"
+#include <cstring>
+
+using namespace std;
+
+namespace parser {
+
+	/*** SharedAstBuilder *** *** *** *** *** *** *** *** *** ***/
+
+	static const int NO_NODE = FlatAst::NO_NODE;
+
+	SharedAstBuilder::SharedAstBuilder(FlatAst& ast)
+		: ast(ast)
+		, slots(64, NO_NODE)
+		, addedCount(0)
+		, eliminatedCount(0) {
+		ast.clear();
+	}
+
+	unsigned int SharedAstBuilder::hash(FlatOpcode opcode, int left, int right, double value) {
+		//FNV-1a of the words of the node
+		unsigned int words[5];
+		words[0] = (unsigned int)opcode;
+		words[1] = (unsigned int)left;
+		words[2] = (unsigned int)right;
+		memcpy(&words[3], &value, sizeof(value));
+		unsigned int h = 2166136261u;
+		for (size_t i = 0; i < 5; i++) {
+			h = (h ^ words[i]) * 16777619u;
+		}
+		return h;
+	}
+
+	void SharedAstBuilder::grow() {
+		//rehash all nodes into a table twice as large
+		slots.assign(slots.size() * 2, NO_NODE);
+		size_t mask = slots.size() - 1;
+		for (int node = 0; node < (int)hashes.size(); node++) {
+			size_t i = hashes[node] & mask;
+			while (slots[i] != NO_NODE) {
+				i = (i + 1) & mask;
+			}
+			slots[i] = node;
+		}
+	}
+
+	int SharedAstBuilder::share(FlatOpcode opcode, int left, int right, double value, Function1Arg* function) {
+		addedCount++;
+		unsigned int h = hash(opcode, left, right, value);
+		size_t mask = slots.size() - 1;
+		//linear probing; the table is never full
+		size_t i = h & mask;
+		for (; slots[i] != NO_NODE; i = (i + 1) & mask) {
+			int node = slots[i];
+			double nodeValue = ast.getValue(node);
+			//values compared bit by bit: 0 and -0 differ
+			if (hashes[node] == h && ast.getOpcode(node) == opcode
+				&& ast.getLeft(node) == left && ast.getRight(node) == right
+				&& memcmp(&nodeValue, &value, sizeof(value)) == 0) {
+					if (opcode != FO_FLOAT && opcode != FO_VARIABLE && opcode != FO_CONSTANT) {
+						eliminatedCount++;
+					}
+					return node;
+			}
+		}
+		int node;
+		switch (opcode) {
+		case FO_FLOAT:
+			node = ast.addFloat(value);
+			break;
+		case FO_VARIABLE:
+			node = ast.addVariable(right);
+			break;
+		case FO_CONSTANT:
+			node = ast.addConstant(right, value);
+			break;
+		case FO_NEGATION:
+			node = ast.addNegation(left);
+			break;
+		case FO_CALL:
+			node = ast.addCall(right, function, left);
+			break;
+		default:
+			node = ast.addBinary(opcode, left, right);
+			break;
+		}
+		hashes.push_back(h);
+		slots[i] = node;
+		//keep the load factor at most 1/2
+		if (hashes.size() * 2 > slots.size()) {
+			grow();
+		}
+		return node;
+	}
+
+	void SharedAstBuilder::countUses(int root, vector<int>& uses) const {
+		uses.assign(ast.size(), 0);
+		if (ast.size() == 0) {
+			return;
+		}
+		//only the nodes of the root count: the value of a let binding
+		//not used is built, but not a part of the expression. The
+		//arguments of a node come before it, so the nodes are found
+		//from the root down in one pass
+		vector<bool> used(ast.size(), false);
+		used[root] = true;
+		for (int node = root; node >= 0; node--) {
+			if (!used[node]) {
+				continue;
+			}
+			switch (ast.getOpcode(node)) {
+			case FO_FLOAT:
+			case FO_VARIABLE:
+			case FO_CONSTANT:
+				break;
+			case FO_NEGATION:
+			case FO_CALL:
+				uses[ast.getLeft(node)]++;
+				used[ast.getLeft(node)] = true;
+				break;
+			default:
+				uses[ast.getLeft(node)]++;
+				uses[ast.getRight(node)]++;
+				used[ast.getLeft(node)] = true;
+				used[ast.getRight(node)] = true;
+				break;
+			}
+		}
+	}
+
+	int SharedAstBuilder::addFloat(double value) {
+		return share(FO_FLOAT, NO_NODE, NO_SYMBOL, value, NULL);
+	}
+
+	int SharedAstBuilder::addVariable(int symbol) {
+		return share(FO_VARIABLE, NO_NODE, symbol, 0.0, NULL);
+	}
+
+	int SharedAstBuilder::addConstant(int symbol, double value) {
+		return share(FO_CONSTANT, NO_NODE, symbol, value, NULL);
+	}
+
+	int SharedAstBuilder::addNegation(int arg) {
+		return share(FO_NEGATION, arg, NO_NODE, 0.0, NULL);
+	}
+
+	int SharedAstBuilder::addBinary(FlatOpcode opcode, int left, int right) {
+		return share(opcode, left, right, 0.0, NULL);
+	}
+
+	int SharedAstBuilder::addCall(int symbol, Function1Arg* function, int arg) {
+		return share(FO_CALL, arg, symbol, 0.0, function);
+	}
+
+	/*** End of SharedAstBuilder *** *** *** *** *** *** *** ***/
+
+}
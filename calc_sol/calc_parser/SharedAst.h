@@ -0,0 +1,85 @@
+#ifndef SHARED_AST_H
+#define SHARED_AST_H
+
+#include "FlatAst.h"
+#include <vector>
+
+namespace parser {
+
+	/* Builder of the expression as a DAG (directed acyclic graph): a
+	node equal to one built before - the same operation, value or
+	symbol and the same argument nodes - is not added again, the node
+	built before is returned (hash-consing). Every distinct
+	subexpression is then a single node, shared by all its occurrences:
+	"sin(x)*sin(x)" has 3 nodes, not 5.
+
+	The nodes are kept in a FlatAst in post-order as usual, but a node
+	may be the argument of several nodes. They are looked up in an open
+	addressing hash table, so building stays linear.
+
+	Functions are taken as pure: calls of the same function with the
+	same argument are the same node. The value of a let binding is
+	a node as any other, each use of the name is that node*/
+	class SharedAstBuilder : public PostOrderBuilder {
+	private:
+		/* the nodes */
+		FlatAst& ast;
+		/* hash of each node */
+		std::vector<unsigned int> hashes;
+		/* open addressing: a node or NO_NODE; size is a power of 2 */
+		std::vector<int> slots;
+		/* nodes given by the parser */
+		size_t addedCount;
+		/* operations given by the parser and shared */
+		size_t eliminatedCount;
+
+		static unsigned int hash(FlatOpcode opcode, int left, int right, double value);
+
+		/* the equal node, or add it */
+		int share(FlatOpcode opcode, int left, int right, double value, Function1Arg* function);
+
+		void grow();
+
+		/* not copyable */
+		SharedAstBuilder(const SharedAstBuilder& other);
+		SharedAstBuilder& operator =(const SharedAstBuilder& other);
+	public:
+		/* build into the flat tree; it is cleared */
+		SharedAstBuilder(FlatAst& ast);
+
+		/* nodes given by the parser - the nodes of the tree */
+		size_t getAddedCount() const {
+			return addedCount;
+		}
+
+		/* Operations of the tree not added, because they were shared.
+		Leaves (variables, constants, floats) shared are not counted -
+		they are compiled again at every use*/
+		size_t getEliminatedCount() const {
+			return eliminatedCount;
+		}
+
+		/* Count uses of every node as an argument of other nodes of the
+		expression (the root and the nodes below it), an argument twice
+		in the same node is counted twice; the root has no uses.
+		The root is the node given to the parser (see PrecedenceParser::expr)
+		- the body of a let binding may be a node shared before its value*/
+		void countUses(int root, std::vector<int>& uses) const;
+
+		virtual int addFloat(double value);
+
+		virtual int addVariable(int symbol);
+
+		virtual int addConstant(int symbol, double value);
+
+		virtual int addNegation(int arg);
+
+		/* FO_ADD ... FO_POWER */
+		virtual int addBinary(FlatOpcode opcode, int left, int right);
+
+		virtual int addCall(int symbol, Function1Arg* function, int arg);
+	};
+
+}
+
+#endif
@@ -0,0 +1,124 @@
+
+#include "stdafx.h"
+#include "SourceBuffer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace parser {
+
+	/*** SourceBuffer  *** *** *** *** *** *** *** *** *** ***/
+
+	SourceBuffer::SourceBuffer(const char* data, size_t length)
+		: data(data), length(length), mapped(false) {
+#ifdef _WIN32
+		fileHandle = NULL;
+		mappingHandle = NULL;
+#endif
+	}
+
+#ifdef _WIN32
+
+	SourceBuffer::SourceBuffer(const string& fileName)
+		: data(""), length(0), mapped(false), fileHandle(NULL), mappingHandle(NULL) {
+
+		HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+			NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw SourceException("cannot open " + fileName);
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			throw SourceException("cannot read size of " + fileName);
+		}
+		if (size.QuadPart == 0) {
+			//empty files cannot be mapped
+			CloseHandle(file);
+			return;
+		}
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL) {
+			CloseHandle(file);
+			throw SourceException("cannot map " + fileName);
+		}
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == NULL) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			throw SourceException("cannot map " + fileName);
+		}
+		fileHandle = file;
+		mappingHandle = mapping;
+		data = (const char*)view;
+		length = (size_t)size.QuadPart;
+		mapped = true;
+	}
+
+	SourceBuffer::~SourceBuffer() {
+		if (mapped) {
+			UnmapViewOfFile(data);
+			CloseHandle(mappingHandle);
+			CloseHandle(fileHandle);
+		}
+	}
+
+#else
+
+	SourceBuffer::SourceBuffer(const string& fileName)
+		: data(""), length(0), mapped(false) {
+
+		int fd = open(fileName.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw SourceException("cannot open " + fileName);
+		}
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close(fd);
+			throw SourceException("cannot read size of " + fileName);
+		}
+		if (st.st_size == 0) {
+			//empty files cannot be mapped
+			close(fd);
+			return;
+		}
+		void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		//the mapping stays valid after the descriptor is closed
+		close(fd);
+		if (view == MAP_FAILED) {
+			throw SourceException("cannot map " + fileName);
+		}
+		madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+		data = (const char*)view;
+		length = (size_t)st.st_size;
+		mapped = true;
+	}
+
+	SourceBuffer::~SourceBuffer() {
+		if (mapped) {
+			munmap((void*)data, length);
+		}
+	}
+
+#endif
+
+	/*** End of SourceBuffer *** *** *** *** *** *** *** *** ***/
+
+	/*** Exceptions      *** *** *** *** *** *** *** *** ***/
+	SourceException::SourceException(string s)
+		: s(s) {
+	}
+
+	const char *SourceException::what() const {
+		return s.c_str();
+	}
+
+}
@@ -0,0 +1,91 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <string>
+#include <exception>
+#include <cstring>
+
+namespace parser {
+
+	/* Exception class used to report problems
+	with opening or mapping source files */
+	class SourceException : public std::exception {
+	private:
+		std::string s;
+	public:
+		SourceException(std::string s);
+		virtual const char *what() const;
+	};
+
+	/* View into a part of the source text (not owned, not 0-terminated).
+	Valid as long as the source text exists */
+	struct TextSpan {
+		const char* begin;
+		size_t length;
+
+		TextSpan() : begin(NULL), length(0) {
+		}
+
+		TextSpan(const char* begin, size_t length)
+			: begin(begin), length(length) {
+		}
+
+		const char* end() const {
+			return begin + length;
+		}
+
+		bool equals(const char* s) const {
+			return strncmp(begin, s, length) == 0 && s[length] == 0;
+		}
+
+		/* copy of the text */
+		std::string str() const {
+			return std::string(begin, length);
+		}
+	};
+
+	/* Read-only, contiguous source text.
+	The text is either a memory-mapped file or a buffer owned
+	by the client (borrowed); the text is never copied*/
+	class SourceBuffer {
+	private:
+		/* first character */
+		const char* data;
+		/* number of characters */
+		size_t length;
+		/* the text is a mapped view of a file */
+		bool mapped;
+#ifdef _WIN32
+		/* file and file mapping handles */
+		void* fileHandle;
+		void* mappingHandle;
+#endif
+
+		/* not copyable - owns the mapping */
+		SourceBuffer(const SourceBuffer& other);
+		SourceBuffer& operator =(const SourceBuffer& other);
+	public:
+		/* borrow the text; it must outlive this object */
+		SourceBuffer(const char* data, size_t length);
+
+		/* map the file for reading; throws SourceException */
+		SourceBuffer(const std::string& fileName);
+
+		~SourceBuffer();
+
+		const char* getData() const {
+			return data;
+		}
+
+		size_t getLength() const {
+			return length;
+		}
+
+		bool isMapped() const {
+			return mapped;
+		}
+	};
+
+}
+
+#endif
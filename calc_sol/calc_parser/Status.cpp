@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "Status.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <sstream>
+
+using namespace std;
+
+namespace parser {
+
+	/*** Status *** *** *** *** *** *** *** *** *** *** *** *** ***/
+
+	Status::Status() {
+		clear();
+	}
+
+	void Status::clear() {
+		kind = ST_OK;
+		lineNo = -1;
+		charNo = -1;
+		symbolNo = -1;
+		text = NULL;
+		symbol = NO_SYMBOL;
+		name.clear();
+	}
+
+	void Status::setUnknownToken(int lineNo, int charNo, const char* text) {
+		clear();
+		kind = ST_UNKNOWN_TOKEN;
+		this->lineNo = lineNo;
+		this->charNo = charNo;
+		this->text = text;
+	}
+
+	void Status::setSyntaxError(int lineNo, int charNo, const char* text, int symbol) {
+		clear();
+		kind = ST_SYNTAX_ERROR;
+		this->lineNo = lineNo;
+		this->charNo = charNo;
+		this->text = text;
+		this->symbol = symbol;
+	}
+
+	void Status::setSyntaxError(int lineNo, int charNo, const char* text, const TextSpan& name) {
+		setSyntaxError(lineNo, charNo, text);
+		this->name.assign(name.begin, name.length);
+	}
+
+	void Status::setStatementError(int symbolNo, const char* text) {
+		clear();
+		kind = ST_STATEMENT_ERROR;
+		this->symbolNo = symbolNo;
+		this->text = text;
+	}
+
+	string Status::getText() const {
+		string result;
+		if (text != NULL) {
+			result = text;
+		}
+		if (symbol != NO_SYMBOL) {
+			result += symbolName(symbol);
+		}
+		result += name;
+		return result;
+	}
+
+	//the same texts as the constructors of the exceptions
+	string Status::what() const {
+		stringstream sb;
+		switch (kind) {
+		case ST_OK:
+			return string();
+		case ST_UNKNOWN_TOKEN:
+			if (lineNo < 0) {
+				return getText();
+			}
+			sb << "Unknown token " << lineNo << ":" << charNo;
+			break;
+		case ST_SYNTAX_ERROR:
+			sb << "Syntax error at " << lineNo << ":" << charNo;
+			break;
+		case ST_STATEMENT_ERROR:
+			sb << "Invalid statement at symbol no " << symbolNo;
+			break;
+		}
+		if (text != NULL) {
+			sb << " " << getText();
+		}
+		return sb.str();
+	}
+
+	void Status::raise() const {
+		switch (kind) {
+		case ST_UNKNOWN_TOKEN:
+			if (lineNo < 0) {
+				throw UnknownTokenException(getText());
+			}
+			if (text != NULL) {
+				throw UnknownTokenException(lineNo, charNo, getText());
+			}
+			throw UnknownTokenException(lineNo, charNo);
+		case ST_SYNTAX_ERROR:
+			if (text != NULL) {
+				throw SyntaxException(lineNo, charNo, getText());
+			}
+			throw SyntaxException(lineNo, charNo);
+		default:
+			break;
+		}
+	}
+
+	/*** End of Status *** *** *** *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,102 @@
+#ifndef STATUS_H
+#define STATUS_H
+
+#include "SymbolTable.h"
+#include "SourceBuffer.h"
+#include <string>
+
+namespace parser {
+
+	/* Result of the methods which report errors without exceptions
+	(those with a Status argument): success, or the error the other
+	methods throw - its kind, position and text.
+
+	Setting an error costs as much as a return: the text is a literal,
+	the message is formatted only when requested (see what), so bad
+	input is rejected as fast as good input is accepted. Only the name
+	of an unknown function, which has no symbol, is copied*/
+	class Status {
+	public:
+		enum Kind {
+			/* no error */
+			ST_OK = 0,
+			/* UnknownTokenException */
+			ST_UNKNOWN_TOKEN,
+			/* SyntaxException */
+			ST_SYNTAX_ERROR,
+			/* calc::StatementException */
+			ST_STATEMENT_ERROR
+		};
+	private:
+		Kind kind;
+
+		/* position of the error; -1 if none */
+		int lineNo;
+		int charNo;
+
+		/* number of the symbol of a statement error */
+		int symbolNo;
+
+		/* text after the position; NULL if none */
+		const char* text;
+
+		/* symbol named after the text; NO_SYMBOL if none */
+		int symbol;
+
+		/* name after the text when it is not interned (see SymbolTable);
+		copied, as the error may outlive the source text*/
+		std::string name;
+	public:
+		Status();
+
+		bool isOk() const {
+			return kind == ST_OK;
+		}
+
+		Kind getKind() const {
+			return kind;
+		}
+
+		int getLineNo() const {
+			return lineNo;
+		}
+
+		int getCharNo() const {
+			return charNo;
+		}
+
+		int getSymbolNo() const {
+			return symbolNo;
+		}
+
+		/* the text after the position, with the symbol; empty if none */
+		std::string getText() const;
+
+		/* the message of the exception the other methods throw;
+		empty if ok*/
+		std::string what() const;
+
+		/* no error */
+		void clear();
+
+		/* UnknownTokenException at the position; lineNo -1 - no position */
+		void setUnknownToken(int lineNo, int charNo, const char* text = NULL);
+
+		/* SyntaxException at the position; the symbol is named after the text */
+		void setSyntaxError(int lineNo, int charNo, const char* text = NULL, int symbol = NO_SYMBOL);
+
+		/* SyntaxException at the position; the name, which is not
+		interned, is named after the text*/
+		void setSyntaxError(int lineNo, int charNo, const char* text, const TextSpan& name);
+
+		/* StatementException at the symbol */
+		void setStatementError(int symbolNo, const char* text = NULL);
+
+		/* Throw the exception of a lexer or parser error; nothing if ok.
+		Statement errors are thrown by their callers (see calc::Calculator)*/
+		void raise() const;
+	};
+
+}
+
+#endif
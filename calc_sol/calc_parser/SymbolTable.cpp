@@ -0,0 +1,151 @@
+
+#include "stdafx.h"
+#include "SymbolTable.h"
+#include <cstring>
+
+using namespace std;
+
+namespace parser {
+
+	/*** SymbolTable *** *** *** *** *** *** *** *** *** *** ***/
+
+	/* names of the builtin symbols, in the order of BuiltinSymbol */
+	static const char* builtinNames[BUILTIN_SYMBOL_COUNT] = {
+		"x", "sin", "cos", "exp", "log", "ONE", "ZERO", "PI", "E", "let", "in"
+	};
+
+	static const unsigned char builtinLengths[BUILTIN_SYMBOL_COUNT] = {
+		1, 3, 3, 3, 3, 3, 4, 2, 1, 3, 2
+	};
+
+	/* the builtin symbol in the slot of its name; the slot is
+	(first character + last character) & 31, different for each
+	builtin name*/
+	static const signed char builtinSlots[32] = {
+		SYMBOL_LET, SYMBOL_SIN, NO_SYMBOL, NO_SYMBOL,
+		NO_SYMBOL, NO_SYMBOL, NO_SYMBOL, NO_SYMBOL,
+		NO_SYMBOL, SYMBOL_ZERO, SYMBOL_E, NO_SYMBOL,
+		NO_SYMBOL, NO_SYMBOL, NO_SYMBOL, NO_SYMBOL,
+		SYMBOL_X, NO_SYMBOL, NO_SYMBOL, SYMBOL_LOG,
+		SYMBOL_ONE, SYMBOL_EXP, SYMBOL_COS, SYMBOL_IN,
+		NO_SYMBOL, SYMBOL_PI, NO_SYMBOL, NO_SYMBOL,
+		NO_SYMBOL, NO_SYMBOL, NO_SYMBOL, NO_SYMBOL
+	};
+
+	int findBuiltinSymbol(const char* text, size_t length) {
+		if (length == 0 || length > 4) {
+			return NO_SYMBOL;
+		}
+		size_t slot = ((unsigned char)text[0] + (unsigned char)text[length - 1]) & 31;
+		int symbol = builtinSlots[slot];
+		if (symbol == NO_SYMBOL || builtinLengths[symbol] != length
+			|| memcmp(builtinNames[symbol], text, length) != 0) {
+				return NO_SYMBOL;
+		}
+		return symbol;
+	}
+
+	SymbolTable::SymbolTable()
+		: slots(64, NO_SYMBOL) {
+		//intern finds the builtin names without the hash table; they
+		//are added to it all the same, so that it has every name
+		for (int symbol = 0; symbol < BUILTIN_SYMBOL_COUNT; symbol++) {
+			const char* name = builtinNames[symbol];
+			unsigned int h = hash(name, builtinLengths[symbol]);
+			slots[findSlot(name, builtinLengths[symbol], h)] = symbol;
+			names.push_back(string(name, builtinLengths[symbol]));
+			hashes.push_back(h);
+		}
+	}
+
+	unsigned int SymbolTable::hash(const char* text, size_t length) {
+		//FNV-1a
+		unsigned int h = 2166136261u;
+		for (size_t i = 0; i < length; i++) {
+			h = (h ^ (unsigned char)text[i]) * 16777619u;
+		}
+		return h;
+	}
+
+	size_t SymbolTable::findSlot(const char* text, size_t length, unsigned int h) const {
+		size_t mask = slots.size() - 1;
+		//linear probing; the table is never full
+		for (size_t i = h & mask; ; i = (i + 1) & mask) {
+			int symbol = slots[i];
+			if (symbol == NO_SYMBOL) {
+				return i;
+			}
+			const string& name = names[symbol];
+			if (hashes[symbol] == h && name.size() == length
+				&& memcmp(name.data(), text, length) == 0) {
+					return i;
+			}
+		}
+	}
+
+	void SymbolTable::grow() {
+		//rehash all symbols into a table twice as large
+		slots.assign(slots.size() * 2, NO_SYMBOL);
+		size_t mask = slots.size() - 1;
+		for (int symbol = 0; symbol < (int)names.size(); symbol++) {
+			size_t i = hashes[symbol] & mask;
+			while (slots[i] != NO_SYMBOL) {
+				i = (i + 1) & mask;
+			}
+			slots[i] = symbol;
+		}
+	}
+
+	int SymbolTable::intern(const char* text, size_t length) {
+		int builtin = findBuiltinSymbol(text, length);
+		if (builtin != NO_SYMBOL) {
+			return builtin;
+		}
+		unsigned int h = hash(text, length);
+		{
+			//most names are known already
+			ReadLock lock(rwLock);
+			int symbol = slots[findSlot(text, length, h)];
+			if (symbol != NO_SYMBOL) {
+				return symbol;
+			}
+		}
+		WriteLock lock(rwLock);
+		//another thread may have added the name in the meantime
+		size_t slot = findSlot(text, length, h);
+		if (slots[slot] != NO_SYMBOL) {
+			return slots[slot];
+		}
+		int symbol = (int)names.size();
+		names.push_back(string(text, length));
+		hashes.push_back(h);
+		slots[slot] = symbol;
+		//keep the load factor at most 1/2
+		if (names.size() * 2 > slots.size()) {
+			grow();
+		}
+		return symbol;
+	}
+
+	int SymbolTable::find(const char* text, size_t length) const {
+		int builtin = findBuiltinSymbol(text, length);
+		if (builtin != NO_SYMBOL) {
+			return builtin;
+		}
+		unsigned int h = hash(text, length);
+		ReadLock lock(rwLock);
+		return slots[findSlot(text, length, h)];
+	}
+
+	/*** End of SymbolTable *** *** *** *** *** *** *** *** ***/
+
+	SymbolTable& symbolTable() {
+		static SymbolTable table;
+		return table;
+	}
+
+	/* create the table before main - initialization of a local
+	static is not synchronized by all compilers (Visual Studio 2010)*/
+	static SymbolTable& initialSymbolTable = symbolTable();
+
+}
@@ -0,0 +1,143 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include "Threads.h"
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace parser {
+
+	/* no symbol - the token is not an identifier */
+	const int NO_SYMBOL = -1;
+
+	/* Symbols with pre-assigned numbers: the default variable, the
+	names of the standard functions and constants and the keywords.
+	Every symbol table starts with them, in this order*/
+	enum BuiltinSymbol {
+		SYMBOL_X = 0,
+		SYMBOL_SIN,
+		SYMBOL_COS,
+		SYMBOL_EXP,
+		SYMBOL_LOG,
+		SYMBOL_ONE,
+		SYMBOL_ZERO,
+		SYMBOL_PI,
+		SYMBOL_E,
+		/* keywords of the let expression (see Parser) */
+		SYMBOL_LET,
+		SYMBOL_IN,
+		BUILTIN_SYMBOL_COUNT
+	};
+
+	/* the identifier is a keyword - never a name of a variable,
+	constant or function*/
+	inline bool isKeyword(int symbol) {
+		return symbol == SYMBOL_LET || symbol == SYMBOL_IN;
+	}
+
+	/* Builtin symbol of the name, by a perfect hash into a static table:
+	no lock, no allocation, nothing initialized at run time.
+	Returns: NO_SYMBOL if the name is not builtin*/
+	int findBuiltinSymbol(const char* text, size_t length);
+
+	/* Interner: maps the text of an identifier to a small number
+	(symbol), so that identifiers are compared and looked up by number.
+
+	Symbols are numbered 0, 1, 2 ... in the order of interning and are
+	never removed. Names are kept in an open addressing hash table;
+	interning a known name allocates nothing.
+
+	As names are never removed, only the names the program keeps are
+	interned: those defined (variables of calculators, let names,
+	functions and their parameters, constants, expressions of a
+	library) and the variables of the trees parsed. The lexers only
+	find the names (see findSymbol), so an identifier which is just
+	read - a misspelt name, a call of an unknown function - leaves
+	nothing behind.
+
+	All methods are synchronized, so that many threads may lex at
+	once (see ParallelParser): known names are found under a shared
+	lock, only new names lock the table for writing. Names never move,
+	so the name of a symbol stays valid while the table exists*/
+	class SymbolTable {
+	private:
+		/* name of each symbol; a deque - growing doesn't move names */
+		std::deque<std::string> names;
+		/* hash of each name */
+		std::vector<unsigned int> hashes;
+		/* open addressing: a symbol or NO_SYMBOL; size is a power of 2 */
+		std::vector<int> slots;
+
+		static unsigned int hash(const char* text, size_t length);
+
+		/* slot of the name - the symbol or an empty slot */
+		size_t findSlot(const char* text, size_t length, unsigned int h) const;
+
+		void grow();
+
+		/* guards all members */
+		mutable ReadWriteLock rwLock;
+
+		/* not copyable */
+		SymbolTable(const SymbolTable& other);
+		SymbolTable& operator =(const SymbolTable& other);
+	public:
+		/* a table with the builtin symbols */
+		SymbolTable();
+
+		/* symbol of the name; a new symbol if the name is not known.
+		Builtin names are found without locking (see findBuiltinSymbol)*/
+		int intern(const char* text, size_t length);
+
+		int intern(const std::string& name) {
+			return intern(name.data(), name.size());
+		}
+
+		/* Returns: symbol of the name, NO_SYMBOL if not interned */
+		int find(const char* text, size_t length) const;
+
+		int find(const std::string& name) const {
+			return find(name.data(), name.size());
+		}
+
+		/* name of the symbol */
+		const std::string& getName(int symbol) const {
+			ReadLock lock(rwLock);
+			return names[symbol];
+		}
+
+		/* number of symbols; all symbols are less than this */
+		size_t size() const {
+			ReadLock lock(rwLock);
+			return names.size();
+		}
+	};
+
+	/* The symbol table shared by lexers, parsers and lookup tables,
+	so that a symbol means the same name everywhere*/
+	SymbolTable& symbolTable();
+
+	/* see SymbolTable::intern */
+	inline int internSymbol(const char* text, size_t length) {
+		return symbolTable().intern(text, length);
+	}
+
+	inline int internSymbol(const std::string& name) {
+		return symbolTable().intern(name);
+	}
+
+	/* see SymbolTable::find */
+	inline int findSymbol(const char* text, size_t length) {
+		return symbolTable().find(text, length);
+	}
+
+	/* see SymbolTable::getName */
+	inline const std::string& symbolName(int symbol) {
+		return symbolTable().getName(symbol);
+	}
+
+}
+
+#endif
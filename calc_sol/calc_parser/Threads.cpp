@@ -0,0 +1,220 @@
+
+#include "stdafx.h"
+#include "Threads.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace parser {
+
+	/*** Atomic operations *** *** *** *** *** *** *** *** ***/
+
+	unsigned int atomicIncrement(volatile unsigned int& value) {
+#ifdef _WIN32
+		return (unsigned int)InterlockedIncrement((volatile LONG*)&value);
+#else
+		return __sync_add_and_fetch(&value, 1u);
+#endif
+	}
+
+	/*** Mutex *** *** *** *** *** *** *** *** *** *** *** ***/
+
+#ifdef _WIN32
+	Mutex::Mutex() {
+		CRITICAL_SECTION* section = new CRITICAL_SECTION;
+		InitializeCriticalSection(section);
+		handle = section;
+	}
+
+	Mutex::~Mutex() {
+		CRITICAL_SECTION* section = (CRITICAL_SECTION*)handle;
+		DeleteCriticalSection(section);
+		delete section;
+	}
+
+	void Mutex::lock() {
+		EnterCriticalSection((CRITICAL_SECTION*)handle);
+	}
+
+	void Mutex::unlock() {
+		LeaveCriticalSection((CRITICAL_SECTION*)handle);
+	}
+#else
+	Mutex::Mutex() {
+		pthread_mutex_t* mutex = new pthread_mutex_t;
+		pthread_mutex_init(mutex, NULL);
+		handle = mutex;
+	}
+
+	Mutex::~Mutex() {
+		pthread_mutex_t* mutex = (pthread_mutex_t*)handle;
+		pthread_mutex_destroy(mutex);
+		delete mutex;
+	}
+
+	void Mutex::lock() {
+		pthread_mutex_lock((pthread_mutex_t*)handle);
+	}
+
+	void Mutex::unlock() {
+		pthread_mutex_unlock((pthread_mutex_t*)handle);
+	}
+#endif
+
+	/*** End of Mutex *** *** *** *** *** *** *** *** *** ***/
+
+	/*** ReadWriteLock *** *** *** *** *** *** *** *** *** ***/
+
+#ifdef _WIN32
+	ReadWriteLock::ReadWriteLock() {
+		SRWLOCK* lock = new SRWLOCK;
+		InitializeSRWLock(lock);
+		handle = lock;
+	}
+
+	ReadWriteLock::~ReadWriteLock() {
+		//a slim lock needs no clean up
+		delete (SRWLOCK*)handle;
+	}
+
+	void ReadWriteLock::lockRead() {
+		AcquireSRWLockShared((SRWLOCK*)handle);
+	}
+
+	void ReadWriteLock::unlockRead() {
+		ReleaseSRWLockShared((SRWLOCK*)handle);
+	}
+
+	void ReadWriteLock::lockWrite() {
+		AcquireSRWLockExclusive((SRWLOCK*)handle);
+	}
+
+	void ReadWriteLock::unlockWrite() {
+		ReleaseSRWLockExclusive((SRWLOCK*)handle);
+	}
+#else
+	ReadWriteLock::ReadWriteLock() {
+		pthread_rwlock_t* lock = new pthread_rwlock_t;
+		pthread_rwlock_init(lock, NULL);
+		handle = lock;
+	}
+
+	ReadWriteLock::~ReadWriteLock() {
+		pthread_rwlock_t* lock = (pthread_rwlock_t*)handle;
+		pthread_rwlock_destroy(lock);
+		delete lock;
+	}
+
+	void ReadWriteLock::lockRead() {
+		pthread_rwlock_rdlock((pthread_rwlock_t*)handle);
+	}
+
+	void ReadWriteLock::unlockRead() {
+		pthread_rwlock_unlock((pthread_rwlock_t*)handle);
+	}
+
+	void ReadWriteLock::lockWrite() {
+		pthread_rwlock_wrlock((pthread_rwlock_t*)handle);
+	}
+
+	void ReadWriteLock::unlockWrite() {
+		pthread_rwlock_unlock((pthread_rwlock_t*)handle);
+	}
+#endif
+
+	/*** End of ReadWriteLock *** *** *** *** *** *** *** *** ***/
+
+	/*** Tasks *** *** *** *** *** *** *** *** *** *** *** ***/
+
+	/* tasks shared by the threads of one runTasks call */
+	class TaskQueue {
+	private:
+		const vector<Task*>& tasks;
+		size_t next;
+		Mutex mutex;
+	public:
+		TaskQueue(const vector<Task*>& tasks) : tasks(tasks), next(0) {
+		}
+
+		/* run tasks until none is left */
+		void runAll() {
+			for (;;) {
+				Task* task;
+				{
+					MutexLock lock(mutex);
+					if (next == tasks.size()) {
+						return;
+					}
+					task = tasks[next++];
+				}
+				task->run();
+			}
+		}
+	};
+
+#ifdef _WIN32
+	static unsigned int __stdcall taskThread(void* queue) {
+		((TaskQueue*)queue)->runAll();
+		return 0;
+	}
+#else
+	static void* taskThread(void* queue) {
+		((TaskQueue*)queue)->runAll();
+		return NULL;
+	}
+#endif
+
+	unsigned int hardwareThreads() {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		long count = (long)info.dwNumberOfProcessors;
+#else
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		return count > 0 ? (unsigned int)count : 1;
+	}
+
+	void runTasks(const vector<Task*>& tasks, unsigned int threadCount) {
+		TaskQueue queue(tasks);
+		//the calling thread is one of the threads
+		size_t started = threadCount < tasks.size() ? threadCount : tasks.size();
+		started = started > 0 ? started - 1 : 0;
+#ifdef _WIN32
+		vector<HANDLE> threads;
+		for (size_t i = 0; i < started; i++) {
+			uintptr_t thread = _beginthreadex(NULL, 0, taskThread, &queue, 0, NULL);
+			if (thread != 0) {
+				threads.push_back((HANDLE)thread);
+			}
+		}
+		queue.runAll();
+		for (size_t i = 0; i < threads.size(); i++) {
+			WaitForSingleObject(threads[i], INFINITE);
+			CloseHandle(threads[i]);
+		}
+#else
+		vector<pthread_t> threads;
+		for (size_t i = 0; i < started; i++) {
+			pthread_t thread;
+			if (pthread_create(&thread, NULL, taskThread, &queue) == 0) {
+				threads.push_back(thread);
+			}
+		}
+		queue.runAll();
+		for (size_t i = 0; i < threads.size(); i++) {
+			pthread_join(threads[i], NULL);
+		}
+#endif
+	}
+
+	/*** End of Tasks *** *** *** *** *** *** *** *** *** ***/
+
+}
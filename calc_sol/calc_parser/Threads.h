@@ -0,0 +1,130 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <vector>
+
+namespace parser {
+
+	/* Mutual exclusion between threads: a critical section on Windows,
+	a pthread mutex elsewhere (Visual Studio 2010 has no std::mutex)*/
+	class Mutex {
+	private:
+		/* the system object */
+		void* handle;
+
+		/* not copyable */
+		Mutex(const Mutex& other);
+		Mutex& operator =(const Mutex& other);
+	public:
+		Mutex();
+		~Mutex();
+
+		void lock();
+
+		void unlock();
+	};
+
+	/* Holds the mutex locked while the object exists */
+	class MutexLock {
+	private:
+		Mutex& mutex;
+
+		/* not copyable */
+		MutexLock(const MutexLock& other);
+		MutexLock& operator =(const MutexLock& other);
+	public:
+		MutexLock(Mutex& mutex) : mutex(mutex) {
+			mutex.lock();
+		}
+
+		~MutexLock() {
+			mutex.unlock();
+		}
+	};
+
+	/* Lock shared by readers and exclusive for a writer: a slim
+	reader/writer lock on Windows, a pthread rwlock elsewhere*/
+	class ReadWriteLock {
+	private:
+		/* the system object */
+		void* handle;
+
+		/* not copyable */
+		ReadWriteLock(const ReadWriteLock& other);
+		ReadWriteLock& operator =(const ReadWriteLock& other);
+	public:
+		ReadWriteLock();
+		~ReadWriteLock();
+
+		void lockRead();
+
+		void unlockRead();
+
+		void lockWrite();
+
+		void unlockWrite();
+	};
+
+	/* Holds the lock for reading while the object exists */
+	class ReadLock {
+	private:
+		ReadWriteLock& rwLock;
+
+		/* not copyable */
+		ReadLock(const ReadLock& other);
+		ReadLock& operator =(const ReadLock& other);
+	public:
+		ReadLock(ReadWriteLock& rwLock) : rwLock(rwLock) {
+			rwLock.lockRead();
+		}
+
+		~ReadLock() {
+			rwLock.unlockRead();
+		}
+	};
+
+	/* Holds the lock for writing while the object exists */
+	class WriteLock {
+	private:
+		ReadWriteLock& rwLock;
+
+		/* not copyable */
+		WriteLock(const WriteLock& other);
+		WriteLock& operator =(const WriteLock& other);
+	public:
+		WriteLock(ReadWriteLock& rwLock) : rwLock(rwLock) {
+			rwLock.lockWrite();
+		}
+
+		~WriteLock() {
+			rwLock.unlockWrite();
+		}
+	};
+
+	/* Add 1 to the value as one atomic operation (an interlocked
+	increment); no lock, nothing to initialize - usable by static
+	initializers before main.
+	Returns: the value incremented*/
+	unsigned int atomicIncrement(volatile unsigned int& value);
+
+	/* Work done by runTasks */
+	class Task {
+	public:
+		virtual ~Task() {
+		}
+
+		/* Do the work; must not throw - errors are kept in the task */
+		virtual void run() = 0;
+	};
+
+	/* number of processors (at least 1) */
+	unsigned int hardwareThreads();
+
+	/* Run every task once on at most threadCount threads and wait
+	until all of them are finished. The calling thread is one of the
+	threads; tasks are started in their order*/
+	void runTasks(const std::vector<Task*>& tasks, unsigned int threadCount);
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+
+#include "stdafx.h"
+#include "Token.h"
+
+using namespace std;
+
+namespace parser {
+
+	auto_ptr<Lexem> toLexem(const Token& token) {
+		switch (token.kind) {
+		case LK_EOF:
+			return auto_ptr<Lexem>();
+		case LK_FLOAT:
+			return auto_ptr<Lexem>(new FloatLexem(token.value));
+		case LK_IDENTIFIER:
+			return auto_ptr<Lexem>(new IdentifierLexem(token.text.str()));
+		case LK_PLUS:
+			return auto_ptr<Lexem>(new PlusLexem());
+		case LK_MINUS:
+			return auto_ptr<Lexem>(new MinusLexem());
+		case LK_MUL:
+			return auto_ptr<Lexem>(new MulLexem());
+		case LK_DIV:
+			return auto_ptr<Lexem>(new DivLexem());
+		case LK_DASH:
+			return auto_ptr<Lexem>(new DashLexem());
+		case LK_OPAREN:
+			return auto_ptr<Lexem>(new OParenLexem());
+		case LK_CPAREN:
+			return auto_ptr<Lexem>(new CParenLexem());
+		case LK_TILDE:
+			return auto_ptr<Lexem>(new TildeLexem());
+		case LK_ASSIGN:
+			return auto_ptr<Lexem>(new AssignLexem());
+		default:
+			throw "illegal state";
+		}
+	}
+
+}
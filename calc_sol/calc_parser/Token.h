@@ -0,0 +1,74 @@
+#ifndef TOKEN_H
+#define TOKEN_H
+
+#include "Lexer.h"
+#include "SourceBuffer.h"
+#include "SymbolTable.h"
+#include <memory>
+
+namespace parser {
+
+	/* Kinds of lexems (tokens) - see the grammar in the "Lexer" class */
+	enum LexemKind {
+		/* end of the source */
+		LK_EOF = 0,
+		LK_FLOAT,
+		LK_IDENTIFIER,
+		LK_PLUS,
+		LK_MINUS,
+		LK_MUL,
+		LK_DIV,
+		LK_DASH,
+		LK_OPAREN,
+		LK_CPAREN,
+		LK_TILDE,
+		LK_ASSIGN
+	};
+
+	/* Single lexem (token) as a plain value.
+
+	Unlike the Lexem classes, a Token is not allocated on the heap
+	and its type is checked by comparing the kind - the lexers fill
+	the same Token object for every lexem they read*/
+	struct Token {
+		LexemKind kind;
+		/* value of a LK_FLOAT token */
+		double value;
+		/* text of the token; a view into the source, valid until
+		the lexer reads the next token (see the lexer) */
+		TextSpan text;
+		/* position of the first character in the source (0-indexed) */
+		size_t offset;
+		/* symbol of the text of a LK_IDENTIFIER token if the name
+		was interned when the token was read (see SymbolTable); NO_SYMBOL
+		for a name not interned and for other tokens */
+		int symbol;
+
+		Token() : kind(LK_EOF), value(0.0), offset(0), symbol(NO_SYMBOL) {
+		}
+	};
+
+	/* Source of tokens for the Parser */
+	class TokenSource {
+	public:
+		virtual ~TokenSource() {
+		}
+
+		/* Read next token into the given object.
+		Returns: kind of the token; LK_EOF at the end of the source.
+		Throws UnknownTokenException*/
+		virtual LexemKind next(Token& token) = 0;
+
+		/* position of the current input, for error messages */
+		virtual int getLineNo() = 0;
+
+		virtual int getCharNo() = 0;
+	};
+
+	/* Lexem object for the token (compatibility with the Lexem API)
+	Returns: NULL auto_ptr for LK_EOF*/
+	std::auto_ptr<Lexem> toLexem(const Token& token);
+
+}
+
+#endif
@@ -0,0 +1,205 @@
+
+#include "stdafx.h"
+#include "TokenArray.h"
+#include "BufferLexer.h"
+#include <iterator>
+#include <algorithm>
+
+using namespace std;
+
+namespace parser {
+
+	/*** TokenArray *** *** *** *** *** *** *** *** *** *** ***/
+
+	TokenArray::TokenArray()
+		: source(""), length(0) {
+	}
+
+	void TokenArray::tokenize(const char* data, size_t length) {
+		Status status;
+		if (!tokenize(data, length, status)) {
+			status.raise();
+		}
+	}
+
+	void TokenArray::tokenize(const SourceBuffer& source) {
+		tokenize(source.getData(), source.getLength());
+	}
+
+	bool TokenArray::tokenize(const char* data, size_t length, Status& status) {
+		this->source = data;
+		this->length = length;
+		status.clear();
+		lexAll(status);
+		return status.isOk();
+	}
+
+	bool TokenArray::tokenize(const SourceBuffer& source, Status& status) {
+		return tokenize(source.getData(), source.getLength(), status);
+	}
+
+	void TokenArray::tokenize(istream& inputStream) {
+		Status status;
+		if (!tokenize(inputStream, status)) {
+			status.raise();
+		}
+	}
+
+	bool TokenArray::tokenize(istream& inputStream, Status& status) {
+		ownedText.assign(istreambuf_iterator<char>(inputStream), istreambuf_iterator<char>());
+		//same stream state as after lexing the stream to its end
+		inputStream.setstate(ios::eofbit | ios::failbit);
+		return tokenize(ownedText.data(), ownedText.size(), status);
+	}
+
+	void TokenArray::lexAll(Status& status) {
+		kinds.clear();
+		values.clear();
+		starts.clear();
+		ends.clear();
+		symbols.clear();
+
+		BufferLexer lexer(source, length);
+		LexemKind kind;
+		do {
+			kind = lexer.next(status);
+			const Token& token = lexer.getToken();
+			kinds.push_back((unsigned char)kind);
+			values.push_back(kind == LK_FLOAT ? token.value : 0.0);
+			starts.push_back(token.offset);
+			ends.push_back(token.offset + token.text.length);
+			symbols.push_back(token.symbol);
+		} while (kind != LK_EOF);
+	}
+
+	void TokenArray::prepareJoin(const char* data, size_t length, size_t count) {
+		this->source = data;
+		this->length = length;
+		kinds.assign(count + 1, (unsigned char)LK_EOF);
+		values.assign(count + 1, 0.0);
+		starts.assign(count + 1, length);
+		ends.assign(count + 1, length);
+		symbols.assign(count + 1, NO_SYMBOL);
+	}
+
+	void TokenArray::joinPart(size_t first, const TokenArray& part, size_t offset) {
+		size_t count = part.size() - 1;
+		for (size_t i = 0; i < count; i++) {
+			kinds[first + i] = part.kinds[i];
+			values[first + i] = part.values[i];
+			starts[first + i] = part.starts[i] + offset;
+			ends[first + i] = part.ends[i] + offset;
+			symbols[first + i] = part.symbols[i];
+		}
+	}
+
+	void TokenArray::relex(const TokenArray& previous, const char* data, size_t length,
+		size_t offset, size_t removedLength, size_t insertedLength,
+		size_t& first, size_t& previousEnd, size_t& end) {
+
+			this->source = data;
+			this->length = length;
+			//the tokens which read only characters before the change
+			first = lower_bound(previous.ends.begin(), previous.ends.end(), offset) - previous.ends.begin();
+			kinds.assign(previous.kinds.begin(), previous.kinds.begin() + first);
+			values.assign(previous.values.begin(), previous.values.begin() + first);
+			starts.assign(previous.starts.begin(), previous.starts.begin() + first);
+			ends.assign(previous.ends.begin(), previous.ends.begin() + first);
+			symbols.assign(previous.symbols.begin(), previous.symbols.begin() + first);
+
+			//the first token of previous after the change
+			size_t changeEnd = offset + removedLength;
+			previousEnd = lower_bound(previous.starts.begin() + first, previous.starts.end(), changeEnd)
+				- previous.starts.begin();
+			BufferLexer lexer(data, length, first > 0 ? previous.ends[first - 1] : 0);
+			for (;;) {
+				LexemKind kind = lexer.next();
+				const Token& token = lexer.getToken();
+				//where the token would be in the previous text
+				size_t start = token.offset + removedLength;
+				while (previous.starts[previousEnd] + insertedLength < start) {
+					previousEnd++;
+				}
+				if (previous.starts[previousEnd] + insertedLength == start) {
+					//the same text follows - the same tokens
+					break;
+				}
+				kinds.push_back((unsigned char)kind);
+				values.push_back(kind == LK_FLOAT ? token.value : 0.0);
+				starts.push_back(token.offset);
+				ends.push_back(token.offset + token.text.length);
+				symbols.push_back(token.symbol);
+			}
+			end = kinds.size();
+			//the tokens lexed the same at the same place are not changed
+			while (first < end && first < previousEnd
+				&& kinds[first] == previous.kinds[first]
+				&& values[first] == previous.values[first]
+				&& starts[first] == previous.starts[first]
+				&& ends[first] == previous.ends[first]
+				&& symbols[first] == previous.symbols[first]
+				//a name not interned has no symbol to compare: it
+				//is the same if it doesn't end in the change
+				&& (symbols[first] != NO_SYMBOL || kinds[first] != LK_IDENTIFIER
+					|| ends[first] <= offset)) {
+					first++;
+			}
+
+			size_t count = previous.size() - previousEnd;
+			kinds.insert(kinds.end(), previous.kinds.begin() + previousEnd, previous.kinds.end());
+			values.insert(values.end(), previous.values.begin() + previousEnd, previous.values.end());
+			symbols.insert(symbols.end(), previous.symbols.begin() + previousEnd, previous.symbols.end());
+			starts.resize(end + count);
+			ends.resize(end + count);
+			for (size_t i = 0; i < count; i++) {
+				starts[end + i] = previous.starts[previousEnd + i] + insertedLength - removedLength;
+				ends[end + i] = previous.ends[previousEnd + i] + insertedLength - removedLength;
+			}
+	}
+
+	Token TokenArray::getToken(size_t i) const {
+		Token token;
+		token.kind = getKind(i);
+		token.value = values[i];
+		token.text = getText(i);
+		token.offset = starts[i];
+		token.symbol = getSymbol(i);
+		return token;
+	}
+
+	void TokenArray::position(size_t i, int& lineNo, int& charNo) const {
+		if (length == 0) {
+			//nothing read
+			lineNo = 1;
+			charNo = 0;
+			return;
+		}
+		//the lexer stops at the first character after the token
+		//or at the last character of the source
+		size_t offset = ends[i] < length ? ends[i] : length - 1;
+		lineNo = 1;
+		size_t lineStart = 0;
+		for (size_t p = 0; p <= offset; p++) {
+			if (source[p] == '\n') {
+				lineNo++;
+				lineStart = p + 1;
+			}
+		}
+		charNo = (int)(offset - lineStart + 1);
+	}
+
+	int TokenArray::getLineNo(size_t i) const {
+		int lineNo, charNo;
+		position(i, lineNo, charNo);
+		return lineNo;
+	}
+
+	int TokenArray::getCharNo(size_t i) const {
+		int lineNo, charNo;
+		position(i, lineNo, charNo);
+		return charNo;
+	}
+
+	/*** End of TokenArray *** *** *** *** *** *** *** *** ***/
+
+}
@@ -0,0 +1,164 @@
+#ifndef TOKEN_ARRAY_H
+#define TOKEN_ARRAY_H
+
+#include "Token.h"
+#include "SourceBuffer.h"
+#include "Status.h"
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace parser {
+
+	/* All tokens of a source text, lexed in one pass.
+
+	Tokens are stored in parallel arrays (kinds, values, start and
+	end offsets, symbols of identifiers), indexed by the token number. The last token is always
+	LK_EOF, so that any token can be followed without checking the size.
+
+	The text is either borrowed (buffer, SourceBuffer) and must outlive
+	this object, or copied from a stream into the array. Tokenizing again
+	reuses the allocated arrays*/
+	class TokenArray {
+	private:
+		/* the source text */
+		const char* source;
+		size_t length;
+		/* text read from a stream; source points here */
+		std::string ownedText;
+
+		/* the tokens - parallel arrays */
+		std::vector<unsigned char> kinds;
+		std::vector<double> values;
+		std::vector<size_t> starts;
+		std::vector<size_t> ends;
+		std::vector<int> symbols;
+
+		/* not copyable - may point into ownedText */
+		TokenArray(const TokenArray& other);
+		TokenArray& operator =(const TokenArray& other);
+
+		void lexAll(Status& status);
+	public:
+		TokenArray();
+
+		/* Lex the whole text; the text is not copied.
+		Throws UnknownTokenException*/
+		void tokenize(const char* data, size_t length);
+
+		/* Lex the whole source; the source must outlive this object.
+		Throws UnknownTokenException*/
+		void tokenize(const SourceBuffer& source);
+
+		/* Lex the whole text; an error is set in the status instead of
+		thrown, and the tokens end with LK_EOF there.
+		Returns: false on an error*/
+		bool tokenize(const char* data, size_t length, Status& status);
+
+		/* lex the whole source as tokenize(data, length, status) */
+		bool tokenize(const SourceBuffer& source, Status& status);
+
+		/* Read the stream to its end and lex the text.
+		Throws UnknownTokenException*/
+		void tokenize(std::istream& inputStream);
+
+		/* read and lex the stream as tokenize(inputStream); the error
+		in the status as tokenize(data, length, status)*/
+		bool tokenize(std::istream& inputStream, Status& status);
+
+		/* Prepare to join the tokens of consecutive parts of the text,
+		lexed separately (see ParallelParser): count tokens followed by
+		LK_EOF, to be set by joinPart. The text is not copied*/
+		void prepareJoin(const char* data, size_t length, size_t count);
+
+		/* Copy the tokens of the part, except its LK_EOF, to the tokens
+		from first on; the text of the part starts at offset in the text*/
+		void joinPart(size_t first, const TokenArray& part, size_t offset);
+
+		/* Lex the text after a change of the text of the tokens previous:
+		removedLength characters at offset were replaced by insertedLength
+		characters, the text is now data (length). Lexing starts at the
+		first token which read a changed character (a token reads the
+		character after it as well) and stops at the first token which
+		starts where a token of previous after the change started - the
+		text from there on is the same, so are the tokens. The other
+		tokens are copied from previous, moved by the change.
+		The tokens first ... end - 1 replace the tokens first ...
+		previousEnd - 1 of previous; the tokens before first are the
+		same (lexed again the same, if any). The text is not copied.
+		Throws UnknownTokenException as tokenize(data, length) would*/
+		void relex(const TokenArray& previous, const char* data, size_t length,
+			size_t offset, size_t removedLength, size_t insertedLength,
+			size_t& first, size_t& previousEnd, size_t& end);
+
+		/* number of tokens, including the final LK_EOF */
+		size_t size() const {
+			return kinds.size();
+		}
+
+		LexemKind getKind(size_t i) const {
+			return (LexemKind)kinds[i];
+		}
+
+		/* value of a LK_FLOAT token */
+		double getValue(size_t i) const {
+			return values[i];
+		}
+
+		/* Symbol of a LK_IDENTIFIER token; NO_SYMBOL for others and for
+		a name not interned. A name interned after the tokens were lexed
+		(a let name, a parameter) is found by its text*/
+		int getSymbol(size_t i) const {
+			int symbol = symbols[i];
+			if (symbol == NO_SYMBOL && kinds[i] == LK_IDENTIFIER) {
+				TextSpan text = getText(i);
+				return findSymbol(text.begin, text.length);
+			}
+			return symbol;
+		}
+
+		/* symbol of a LK_IDENTIFIER token; the name is interned if it
+		is not (see SymbolTable) - the token names what is defined*/
+		int intern(size_t i) const {
+			int symbol = getSymbol(i);
+			if (symbol == NO_SYMBOL) {
+				TextSpan text = getText(i);
+				return internSymbol(text.begin, text.length);
+			}
+			return symbol;
+		}
+
+		/* offset of the first character of the token */
+		size_t getStart(size_t i) const {
+			return starts[i];
+		}
+
+		/* offset of the first character after the token */
+		size_t getEnd(size_t i) const {
+			return ends[i];
+		}
+
+		/* text of the token; a view into the source */
+		TextSpan getText(size_t i) const {
+			return TextSpan(source + starts[i], ends[i] - starts[i]);
+		}
+
+		Token getToken(size_t i) const;
+
+		/* the whole source text */
+		TextSpan getSource() const {
+			return TextSpan(source, length);
+		}
+
+		/* Line and character number of the input after the token i,
+		as reported by the lexer which has just read the token*/
+		void position(size_t i, int& lineNo, int& charNo) const;
+
+		int getLineNo(size_t i) const;
+
+		int getCharNo(size_t i) const;
+	};
+
+}
+
+#endif
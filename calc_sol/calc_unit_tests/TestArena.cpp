@@ -0,0 +1,133 @@
+#include "stdafx.h"
+
+#include "TestArena.h"
+
+#include "..\calc_parser\Arena.h"
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <cstring>
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	Arena* ar_arena = NULL;
+	FunctionLookupTable* ar_flookup = NULL;
+	ConstantLookupTable* ar_clookup = NULL;
+
+	class ar_DummyFunction : public Function1Arg {
+	public:
+		virtual double eval(double in) {
+			return in;
+		}
+	};
+
+	void ar_setup() {
+		ar_arena = new Arena();
+		ar_flookup = new FunctionLookupTable();
+		ar_clookup = new ConstantLookupTable();
+		ar_flookup->add(string("a"), new ar_DummyFunction());
+		ar_clookup->add(string("c"), 1.0);
+	}
+
+	void ar_cleanup() {
+		delete ar_arena;
+		delete ar_flookup;
+		delete ar_clookup;
+		ar_arena = NULL;
+		ar_flookup = NULL;
+		ar_clookup = NULL;
+	}
+
+	void ar_testAllocate() {
+		CAssert::assertEquals(0, (int)ar_arena->getChunkCount());
+		char* a = (char*)ar_arena->allocate(3, 1);
+		double* b = (double*)ar_arena->allocate(sizeof(double), sizeof(double));
+		char* c = (char*)ar_arena->allocate(5, 4);
+		CAssert::assertEquals(0, (int)((size_t)b % sizeof(double)));
+		CAssert::assertEquals(0, (int)((size_t)c % 4));
+		//the objects don't overlap
+		memset(a, 1, 3);
+		*b = 2.5;
+		memset(c, 3, 5);
+		CAssert::assertEquals(1, (int)a[2]);
+		CAssert::assertEquals(2.5, *b);
+		CAssert::assertEquals(1, (int)ar_arena->getChunkCount());
+		CAssert::assertEquals(3 + (int)sizeof(double) + 5, (int)ar_arena->getAllocatedSize());
+		//a large object gets a chunk of its own
+		char* large = (char*)ar_arena->allocate(Arena::MAX_CHUNK_SIZE * 2, 16);
+		CAssert::assertEquals(0, (int)((size_t)large % 16));
+		memset(large, 4, Arena::MAX_CHUNK_SIZE * 2);
+		CAssert::assertEquals(2, (int)ar_arena->getChunkCount());
+		ar_arena->deallocate(large, Arena::MAX_CHUNK_SIZE * 2, 16);
+	}
+
+	void ar_testRelease() {
+		//enough for a chunk of MAX_CHUNK_SIZE
+		for (int i = 0; i < 30000; i++) {
+			ar_arena->allocate(100, 8);
+		}
+		CAssert::assertTrue(ar_arena->getChunkCount() > 1);
+		ar_arena->release();
+		CAssert::assertEquals(1, (int)ar_arena->getChunkCount());
+		CAssert::assertEquals(0, (int)ar_arena->getAllocatedSize());
+		//the kept chunk is the largest one - it has room again
+		for (size_t i = 0; i < Arena::MAX_CHUNK_SIZE / 200; i++) {
+			ar_arena->allocate(100, 8);
+		}
+		CAssert::assertEquals(1, (int)ar_arena->getChunkCount());
+		ar_arena->release();
+		ar_arena->release();
+		CAssert::assertEquals(1, (int)ar_arena->getChunkCount());
+	}
+
+	/* RPN text of the AST or the error; the nodes are in the arena if given */
+	string ar_parse(const string& text, Arena* arena) {
+		SourceBuffer source(text.data(), text.size());
+		Parser sourceParser(source, ar_clookup, ar_flookup, arena);
+		RPNTextVisitor visitor;
+		try {
+			sourceParser.begin();
+			AstNode* ast = sourceParser.expr();
+			ast->visitPostOrder(visitor);
+			if (arena == NULL) {
+				delete ast;
+			}
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	void ar_testParser() {
+		const char* texts[] = {
+			"1+2*3", "a(b+1) - c", "-(x^2.5)/\n(y-c)", "2^3^-4 * -a(-c) / 1e-3 - ((x))", "1 2",
+			"", "1+", "b(1)+2", "a(1", "x $"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			CAssert::assertEquals(ar_parse(texts[i], NULL), ar_parse(texts[i], ar_arena));
+		}
+		CAssert::assertEquals(string("b 1 + a c -"), ar_parse("a(b+1) - c", ar_arena));
+		CAssert::assertTrue(ar_arena->getAllocatedSize() > 0);
+		//the trees are freed at once, even the parts of the failed ones
+		ar_arena->release();
+		CAssert::assertEquals(0, (int)ar_arena->getAllocatedSize());
+		CAssert::assertEquals(string("1 x +"), ar_parse("1+x", ar_arena));
+	}
+
+	auto_ptr<TestCase> arenaTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("ArenaTestCase"),
+			ar_setup, ar_cleanup));
+		tc->addTest("ar_testAllocate", ar_testAllocate);
+		tc->addTest("ar_testRelease", ar_testRelease);
+		tc->addTest("ar_testParser", ar_testParser);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_ARENA_H
+#define TEST_ARENA_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> arenaTestCase();
+
+}
+
+#endif
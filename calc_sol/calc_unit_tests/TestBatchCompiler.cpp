@@ -0,0 +1,130 @@
+#include "stdafx.h"
+
+#include "TestBatchCompiler.h"
+
+#include "..\calc_parser\BatchCompiler.h"
+#include "..\calc_parser\Calculator.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* bch_flookup = NULL;
+	StdConstantLookupTable* bch_clookup = NULL;
+
+	void bch_setup() {
+		bch_flookup = new StdFunctionLookupTable();
+		bch_clookup = new StdConstantLookupTable();
+	}
+
+	void bch_cleanup() {
+		delete bch_flookup;
+		delete bch_clookup;
+		bch_flookup = NULL;
+		bch_clookup = NULL;
+	}
+
+	/* expressions of a model library; every 5th is invalid */
+	vector<string> bch_library(int count) {
+		vector<string> texts;
+		for (int i = 0; i < count; i++) {
+			stringstream text;
+			switch (i % 5) {
+			case 0:
+				text << "x*" << i << "+sin(x)";
+				break;
+			case 1:
+				text << "(x-" << i << ")^2/PI";
+				break;
+			case 2:
+				text << "exp(-x/" << i << ")*cos(x)";
+				break;
+			case 3:
+				text << "log(x+" << i << ")-E";
+				break;
+			default:
+				text << "x*(" << i << "+";
+				break;
+			}
+			texts.push_back(text.str());
+		}
+		return texts;
+	}
+
+	void bch_testResults() {
+		vector<string> texts;
+		texts.push_back(string("x+1"));
+		texts.push_back(string("1+"));
+		texts.push_back(string("sin(x)*PI"));
+		texts.push_back(string("y"));
+		texts.push_back(string("$"));
+		texts.push_back(string("foo(x)"));
+		BatchCompiler compiler(string("x"), bch_flookup, bch_clookup, 2);
+		compiler.setChunkSize(1);
+		vector<BatchResult> results;
+		CAssert::assertEquals(4, (int)compiler.compile(texts, results));
+		CAssert::assertEquals((int)texts.size(), (int)results.size());
+		for (size_t i = 0; i < texts.size(); i++) {
+			SourceBuffer source(texts[i].data(), texts[i].size());
+			string thrown;
+			double expected = 0.0;
+			try {
+				expected = Calculator::compile(string("x"), bch_flookup, bch_clookup, source)->calculate(2.0);
+			} catch (exception& e) {
+				thrown = e.what();
+			}
+			CAssert::assertEquals(thrown, results[i].status.what());
+			CAssert::assertEquals(thrown.empty(), results[i].program.get() != NULL);
+			if (thrown.empty()) {
+				CAssert::assertEquals(expected, results[i].program->calculate(2.0));
+			}
+		}
+		CAssert::assertEquals((int)Status::ST_STATEMENT_ERROR, (int)results[3].status.getKind());
+
+		//nothing to compile
+		texts.clear();
+		CAssert::assertEquals(0, (int)compiler.compile(texts, results));
+		CAssert::assertEquals(0, (int)results.size());
+	}
+
+	void bch_testThreads() {
+		vector<string> texts = bch_library(3000);
+		BatchCompiler sequential(string("x"), bch_flookup, bch_clookup, 1);
+		vector<BatchResult> expected;
+		CAssert::assertEquals(600, (int)sequential.compile(texts, expected));
+		//the same results in the same order on any number of threads
+		unsigned int threadCounts[] = { 2, 4, 8 };
+		for (int t = 0; t < 3; t++) {
+			BatchCompiler compiler(string("x"), bch_flookup, bch_clookup, threadCounts[t], t == 2);
+			compiler.setChunkSize(7 * (t + 1));
+			vector<BatchResult> results;
+			CAssert::assertEquals(600, (int)compiler.compile(texts, results));
+			CAssert::assertEquals((int)texts.size(), (int)results.size());
+			for (size_t i = 0; i < texts.size(); i++) {
+				CAssert::assertEquals(expected[i].status.what(), results[i].status.what());
+				if (results[i].program.get() != NULL) {
+					CAssert::assertEquals(expected[i].program->calculate(1.5), results[i].program->calculate(1.5));
+				} else {
+					CAssert::assertTrue(expected[i].program.get() == NULL);
+				}
+			}
+		}
+	}
+
+	auto_ptr<TestCase> batchCompilerTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("BatchCompilerTestCase"),
+			bch_setup, bch_cleanup));
+		tc->addTest("bch_testResults", bch_testResults);
+		tc->addTest("bch_testThreads", bch_testThreads);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_BATCH_COMPILER_H
+#define TEST_BATCH_COMPILER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> batchCompilerTestCase();
+
+}
+
+#endif
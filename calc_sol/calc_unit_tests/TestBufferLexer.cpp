@@ -0,0 +1,199 @@
+
+#include "stdafx.h"
+
+#include "TestBufferLexer.h"
+
+#include "..\calc_parser\DfaLexer.h"
+#include "..\calc_parser\BufferLexer.h"
+#include "..\calc_parser\FloatConv.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	string* bt_text = NULL;
+	BufferLexer* bufferLexer = NULL;
+
+	void bt_setup() {
+		bt_text = new string();
+		bufferLexer = NULL;
+	}
+
+	void bt_cleanup() {
+		delete bufferLexer;
+		delete bt_text;
+		bufferLexer = NULL;
+		bt_text = NULL;
+	}
+
+	/* lexer over the text; the text is not copied*/
+	BufferLexer* bt_lexer(string text) {
+		*bt_text = text;
+		delete bufferLexer;
+		bufferLexer = new BufferLexer(bt_text->data(), bt_text->size());
+		return bufferLexer;
+	}
+
+	/* Lex the whole text with DfaLexer.
+	Returns: lexems separated with spaces, or the error message */
+	string bt_lexAllDfa(string text) {
+		DfaLexer lexer;
+		stringstream in(text);
+		stringstream out;
+		try {
+			auto_ptr<Lexem> lexem;
+			while ((lexem = lexer.next(in)).get() != NULL) {
+				out << lexem->toString() << " ";
+			}
+		} catch (UnknownTokenException& e) {
+			out << "error: " << e.what();
+		}
+		out << "eof=" << lexer.isEof()
+			<< " line=" << lexer.getLineNo()
+			<< " char=" << lexer.getCharNo();
+		return out.str();
+	}
+
+	/* the same as bt_lexAllDfa, with BufferLexer*/
+	string bt_lexAllBuffer(string text) {
+		BufferLexer lexer(text.data(), text.size());
+		stringstream out;
+		try {
+			while (lexer.next() != LK_EOF) {
+				out << lexer.getLexem()->toString() << " ";
+			}
+		} catch (UnknownTokenException& e) {
+			out << "error: " << e.what();
+		}
+		out << "eof=" << lexer.isEof()
+			<< " line=" << lexer.getLineNo()
+			<< " char=" << lexer.getCharNo();
+		return out.str();
+	}
+
+	void bt_assertSameAsDfaLexer(string text) {
+		CAssert::assertEquals(bt_lexAllDfa(text), bt_lexAllBuffer(text));
+	}
+
+	void bt_testNextEmpty() {
+		BufferLexer* lexer = bt_lexer(" \r\t\n");
+		CAssert::assertTrue(lexer->next() == LK_EOF);
+		CAssert::assertTrue(lexer->isEof());
+	}
+
+	void bt_testNextStateChangeTwice() {
+		BufferLexer* lexer = bt_lexer(" 1 2 ");
+		CAssert::assertTrue(lexer->next() == LK_FLOAT);
+		CAssert::assertEquals(1.0, lexer->getValue());
+		CAssert::assertFalse(lexer->isEof());
+
+		CAssert::assertTrue(lexer->next() == LK_FLOAT);
+		CAssert::assertEquals(2.0, lexer->getValue());
+		CAssert::assertFalse(lexer->isEof());
+
+		CAssert::assertTrue(lexer->next() == LK_EOF);
+		CAssert::assertTrue(lexer->isEof());
+	}
+
+	void bt_testIdentifierIsView() {
+		BufferLexer* lexer = bt_lexer("sin(abc_1)");
+		CAssert::assertTrue(lexer->next() == LK_IDENTIFIER);
+		CAssert::assertTrue(lexer->getText().begin == bt_text->data());
+		CAssert::assertTrue(lexer->getText().equals("sin"));
+		CAssert::assertTrue(lexer->next() == LK_OPAREN);
+		CAssert::assertTrue(lexer->next() == LK_IDENTIFIER);
+		CAssert::assertTrue(lexer->getText().begin == bt_text->data() + 4);
+		CAssert::assertEquals(string("abc_1"), lexer->getText().str());
+		CAssert::assertTrue(lexer->next() == LK_CPAREN);
+		CAssert::assertTrue(lexer->next() == LK_EOF);
+	}
+
+	void bt_testSameTokens() {
+		bt_assertSameAsDfaLexer("1+2");
+		bt_assertSameAsDfaLexer("((1))");
+		bt_assertSameAsDfaLexer(" sin(x) * 2.5 ^ -y / (3-4) ~ ");
+		bt_assertSameAsDfaLexer("12 2 3 4 * 10 5 / + * +");
+		bt_assertSameAsDfaLexer("a1b2_c3+_\n\t1.25\r\n2");
+		bt_assertSameAsDfaLexer("1 2\n3 4\n");
+		bt_assertSameAsDfaLexer("");
+	}
+
+	void bt_testSameErrors() {
+		bt_assertSameAsDfaLexer("1 $");
+		bt_assertSameAsDfaLexer("1$");
+		bt_assertSameAsDfaLexer("ab\n 2 # 3");
+		bt_assertSameAsDfaLexer("\n\n.5");
+		bt_assertSameAsDfaLexer("1.+2");
+		bt_assertSameAsDfaLexer("2\n1.");
+	}
+
+	void bt_testFloatConversion() {
+		//the same value as the conversion in the standard library
+		const char* literals[] = {
+			"0", "7", "0.1", "0.3", "3.1415926535897932384626433832795",
+			"123456789012345678901234567890", "9007199254740993",
+			"0.000000000000000000000000000123", "2.2250738585072014",
+			"17976931348623157000000000000000000.5", "1.5", "000.0001"
+		};
+		for (size_t i = 0; i < sizeof(literals) / sizeof(literals[0]); i++) {
+			string s(literals[i]);
+			CAssert::assertEquals(strtod(s.c_str(), NULL),
+				parseFloatLexem(s.data(), s.data() + s.size()));
+		}
+	}
+
+	void bt_testMappedFile() {
+		const char* fileName = "bt_testMappedFile.tmp";
+		{
+			ofstream out(fileName, ofstream::out | ofstream::trunc | ofstream::binary);
+			out << "x 2.5 *";
+		}
+		{
+			SourceBuffer source((string(fileName)));
+			CAssert::assertTrue(source.isMapped());
+			CAssert::assertEquals(7, (int)source.getLength());
+			BufferLexer lexer(source);
+			CAssert::assertTrue(lexer.next() == LK_IDENTIFIER);
+			CAssert::assertTrue(lexer.next() == LK_FLOAT);
+			CAssert::assertEquals(2.5, lexer.getValue());
+			CAssert::assertTrue(lexer.next() == LK_MUL);
+			CAssert::assertTrue(lexer.next() == LK_EOF);
+		}
+		remove(fileName);
+	}
+
+	void bt_testMissingFile() {
+		bool thrown = false;
+		try {
+			SourceBuffer source(string("bt_testMissingFile.tmp"));
+		} catch (SourceException&) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+	}
+
+	auto_ptr<TestCase> bufferLexerTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("BufferLexerTestCase"),
+			bt_setup, bt_cleanup));
+		tc->addTest("bt_testNextEmpty", bt_testNextEmpty);
+		tc->addTest("bt_testNextStateChangeTwice", bt_testNextStateChangeTwice);
+		tc->addTest("bt_testIdentifierIsView", bt_testIdentifierIsView);
+		tc->addTest("bt_testSameTokens", bt_testSameTokens);
+		tc->addTest("bt_testSameErrors", bt_testSameErrors);
+		tc->addTest("bt_testFloatConversion", bt_testFloatConversion);
+		tc->addTest("bt_testMappedFile", bt_testMappedFile);
+		tc->addTest("bt_testMissingFile", bt_testMissingFile);
+		return tc;
+	}
+
+}
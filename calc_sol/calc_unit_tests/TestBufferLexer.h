@@ -0,0 +1,12 @@
+#ifndef TEST_BUFFER_LEXER_H
+#define TEST_BUFFER_LEXER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> bufferLexerTestCase();
+
+}
+
+#endif
@@ -0,0 +1,272 @@
+#include "stdafx.h"
+
+#include "TestBytecode.h"
+
+#include "..\calc_parser\Bytecode.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* bc_flookup = NULL;
+	StdConstantLookupTable* bc_clookup = NULL;
+
+	void bc_setup() {
+		bc_flookup = new StdFunctionLookupTable();
+		bc_clookup = new StdConstantLookupTable();
+	}
+
+	void bc_cleanup() {
+		delete bc_flookup;
+		delete bc_clookup;
+		bc_flookup = NULL;
+		bc_clookup = NULL;
+	}
+
+	/* the same bits - NaN included */
+	bool bc_same(double a, double b) {
+		return memcmp(&a, &b, sizeof(double)) == 0;
+	}
+
+	/* the message of the StatementException of creating the calculator
+	from the RPN text; empty if none*/
+	string bc_error(const string& text) {
+		try {
+			stringstream rpn(text);
+			Calculator calculator(string("x"), bc_flookup, bc_clookup, rpn);
+		} catch (StatementException& e) {
+			return e.whatStr();
+		}
+		return string();
+	}
+
+	void bc_testRun() {
+		//(x*2 stored) - sin(loaded) ^ 2
+		Function1Arg* sinFunction = NULL;
+		CAssert::assertTrue(bc_flookup->find(internSymbol(string("sin")), sinFunction));
+		Bytecode code;
+		code.addVariable();
+		code.addValue(2.0);
+		code.addBinary(BC_MUL);
+		code.addStore(0);
+		code.addLoad(0);
+		code.addCall(sinFunction);
+		code.addValue(2.0);
+		code.addBinary(BC_POWER);
+		code.addBinary(BC_SUB);
+		code.addNegation();
+		CAssert::assertTrue(code.end());
+		CAssert::assertEquals(3, code.getMaxDepth());
+		double stack[3];
+		double slots[1];
+		double a = 0.3 * 2.0;
+		CAssert::assertTrue(bc_same(-(a - pow(sin(a), 2.0)), code.run(0.3, stack, slots)));
+
+		code.clear();
+		code.addValue(1.5);
+		CAssert::assertTrue(code.end());
+		CAssert::assertEquals(1, code.getMaxDepth());
+		CAssert::assertEquals(1.5, code.run(0.0, stack, slots));
+	}
+
+	void bc_testInvalid() {
+		Bytecode code;
+		code.addValue(1.0);
+		code.addBinary(BC_ADD);
+		code.addValue(1.0);
+		CAssert::assertFalse(code.end());
+		CAssert::assertEquals(2, code.getErrorSymbolNo());
+		//too many values left
+		code.clear();
+		code.addValue(1.0);
+		code.addValue(2.0);
+		CAssert::assertFalse(code.end());
+		CAssert::assertEquals(3, code.getErrorSymbolNo());
+		code.clear();
+		code.addStore(0);
+		CAssert::assertFalse(code.end());
+		CAssert::assertEquals(1, code.getErrorSymbolNo());
+		code.clear();
+		CAssert::assertFalse(code.end());
+
+		//the program is rejected when created
+		CAssert::assertEquals(string(StatementException(2).what()), bc_error(string("1 +")));
+		CAssert::assertEquals(string(StatementException(3).what()), bc_error(string("x 2")));
+		CAssert::assertEquals(string(StatementException(4).what()), bc_error(string("1 2 + * 3")));
+		CAssert::assertEquals(string(StatementException(1).what()), bc_error(string("~")));
+		CAssert::assertEquals(string(), bc_error(string("x 2 +")));
+		RPNPushReader reader(string("x"), bc_flookup, bc_clookup);
+		reader.push("1 x", 3);
+		string message;
+		try {
+			reader.finish();
+		} catch (StatementException& e) {
+			message = e.whatStr();
+		}
+		CAssert::assertEquals(string(StatementException(3).what()), message);
+	}
+
+	void bc_testStack() {
+		//the empty program
+		stringstream empty("");
+		Calculator calculator(string("x"), bc_flookup, bc_clookup, empty);
+		CAssert::assertEquals(0.0, calculator.calculate(1.0));
+		//deeper than the stack of calculate: 1 + (1 + (1 + ... x))
+		string text;
+		for (int i = 0; i < 200; i++) {
+			text += "1+(";
+		}
+		text += "x";
+		text.append(200, ')');
+		SourceBuffer source(text.data(), text.size());
+		auto_ptr<Calculator> deep = Calculator::compile(string("x"), bc_flookup, bc_clookup, source);
+		CAssert::assertEquals(200.5, deep->calculate(0.5));
+		CAssert::assertEquals(200.5, deep->calculateByElements(0.5));
+		//the stack given by the caller, allocated once
+		CAssert::assertTrue(deep->getStackSize() > CALCULATE_STACK_SIZE);
+		vector<double> stack(deep->getStackSize());
+		CAssert::assertEquals(200.5, deep->calculate(0.5, &stack[0]));
+		CAssert::assertEquals(201.0, deep->calculate(1.0, &stack[0]));
+	}
+
+	void bc_testCalculator() {
+		const char* texts[] = {
+			"x",
+			"-x^2 + 3*x - 1/x",
+			"exp(-log(x)^2) * ((1+x)*(1-x))",
+			"sin(x)*sin(x) + cos(x)*cos(x) - PI/E",
+			"let a = exp(-x*x) in let b = a*a in a*(1-a) + b/a",
+			"(x - 1) ^ (x + 1) / (x*x - 1)"
+		};
+		double xs[] = { 0.0, -0.0, 0.5, -1.0, 1.0, 3.25, 1e300, -1e-300 };
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			string text(texts[i]);
+			SourceBuffer source(text.data(), text.size());
+			for (int shared = 0; shared < 2; shared++) {
+				auto_ptr<Calculator> calculator = Calculator::compile(string("x"),
+					bc_flookup, bc_clookup, source, shared != 0);
+				for (size_t j = 0; j < sizeof(xs) / sizeof(xs[0]); j++) {
+					CAssert::assertTrue(bc_same(calculator->calculateByElements(xs[j]),
+						calculator->calculate(xs[j])));
+				}
+			}
+		}
+		stringstream rpn("x 2 ^ ~ 1 x / + sin");
+		Calculator calculator(string("x"), bc_flookup, bc_clookup, rpn);
+		CAssert::assertTrue(bc_same(sin(-pow(0.75, 2.0) + 1 / 0.75), calculator.calculate(0.75)));
+	}
+
+	void bc_testBlock() {
+		const char* texts[] = {
+			"x",
+			"2.5",
+			"-x^2 + 3*x - 1/x",
+			"exp(-log(x)^2) * ((1+x)*(1-x))",
+			"let a = exp(-x*x) in let b = a*a in a*(1-a) + b/a"
+		};
+		//more than a block, not a multiple of it
+		const size_t n = CALCULATE_BLOCK_SIZE * 3 + 17;
+		vector<double> xs(n);
+		for (size_t i = 0; i < n; i++) {
+			xs[i] = (i % 7 == 0 ? -1.0 : 1.0) * i / 64.0;
+		}
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			string text(texts[i]);
+			SourceBuffer source(text.data(), text.size());
+			for (int shared = 0; shared < 2; shared++) {
+				auto_ptr<Calculator> calculator = Calculator::compile(string("x"),
+					bc_flookup, bc_clookup, source, shared != 0);
+				vector<double> ys(n);
+				calculator->calculate(&xs[0], &ys[0], n);
+				vector<double> grid(n);
+				calculator->calculate(-2.0, 0.01, &grid[0], n);
+				for (size_t j = 0; j < n; j++) {
+					CAssert::assertTrue(bc_same(calculator->calculate(xs[j]), ys[j]));
+					CAssert::assertTrue(bc_same(calculator->calculate(-2.0 + 0.01 * j), grid[j]));
+				}
+				//in place
+				vector<double> values(xs);
+				calculator->calculate(&values[0], &values[0], n);
+				CAssert::assertTrue(memcmp(&values[0], &ys[0], n * sizeof(double)) == 0);
+			}
+		}
+		//nothing to evaluate
+		stringstream rpn("x 1 +");
+		Calculator calculator(string("x"), bc_flookup, bc_clookup, rpn);
+		calculator.calculate(&xs[0], NULL, 0);
+		calculator.calculate(0.0, 1.0, NULL, 0);
+	}
+
+	void bc_testReplace() {
+		//(1 + 2) * 3
+		Bytecode code;
+		code.addValue(1.0);
+		code.addValue(2.0);
+		code.addBinary(BC_ADD);
+		code.addValue(3.0);
+		code.addBinary(BC_MUL);
+		CAssert::assertTrue(code.end());
+		double stack[4];
+		double slots[1];
+		//not a subexpression: the program is not changed
+		Bytecode part;
+		part.addVariable();
+		CAssert::assertFalse(code.replace(1, 2, part));
+		CAssert::assertEquals(9.0, code.run(0.5, stack, slots));
+		CAssert::assertEquals(0, (int) code.getUnusedCount());
+		//1 + 2 -> x
+		CAssert::assertTrue(code.replace(0, 3, part));
+		CAssert::assertEquals(1.5, code.run(0.5, stack, slots));
+		CAssert::assertEquals(2, code.getMaxDepth());
+		CAssert::assertEquals(2, (int) code.getUnusedCount());
+		//3 -> x - (x * 4)
+		part.clear();
+		part.addVariable();
+		part.addVariable();
+		part.addValue(4.0);
+		part.addBinary(BC_MUL);
+		part.addBinary(BC_SUB);
+		CAssert::assertTrue(code.replace(1, 1, part));
+		CAssert::assertEquals(0.5 * (0.5 - 0.5 * 4.0), code.run(0.5, stack, slots));
+		CAssert::assertEquals(4, code.getMaxDepth());
+		CAssert::assertEquals(3, (int) code.getUnusedCount());
+		//the deepest part removed: x - (x * 4) -> 2
+		part.clear();
+		part.addValue(2.0);
+		CAssert::assertTrue(code.replace(1, 5, part));
+		CAssert::assertEquals(1.0, code.run(0.5, stack, slots));
+		CAssert::assertEquals(2, code.getMaxDepth());
+		CAssert::assertEquals(4, (int) code.getUnusedCount());
+		//the part is not one value
+		part.addValue(1.0);
+		CAssert::assertFalse(code.replace(0, 1, part));
+		CAssert::assertEquals(1.0, code.run(0.5, stack, slots));
+	}
+
+	std::auto_ptr<cunit::TestCase> bytecodeTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(
+			new TestCase(string("BytecodeTestCase"),
+			bc_setup, bc_cleanup));
+
+		tc->addTest(string("bc_testRun"), bc_testRun);
+		tc->addTest(string("bc_testInvalid"), bc_testInvalid);
+		tc->addTest(string("bc_testStack"), bc_testStack);
+		tc->addTest(string("bc_testBlock"), bc_testBlock);
+		tc->addTest(string("bc_testCalculator"), bc_testCalculator);
+		tc->addTest(string("bc_testReplace"), bc_testReplace);
+		return tc;
+	}
+
+}
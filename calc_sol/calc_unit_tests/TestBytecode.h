@@ -0,0 +1,12 @@
+#ifndef TEST_BYTECODE_H
+#define TEST_BYTECODE_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> bytecodeTestCase();
+
+}
+
+#endif
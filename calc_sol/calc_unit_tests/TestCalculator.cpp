@@ -1,291 +1,560 @@
-#include "stdafx.h"
-
-#include "TestCalculator.h"
-#include "..\calc_parser\Calculator.h"
-
-#include "CAssert.h"
-#include "CUnit.h"
-#include <vector>
-#include <string>
-
-using namespace std;
-using namespace cunit;
-using namespace parser;
-using namespace calc;
-
-namespace parser_tests {
-
-	Calculator* calc;
-	stringstream* ct_s = NULL;
-	FunctionLookupTable* ct_ftl;
-	ConstantLookupTable* ct_clt;
-	Parser* ct_parser;
-	AstNode* ct_ast = NULL;
-
-	void ct_setup() {
-		ct_ftl = new StdFunctionLookupTable();
-		ct_clt = new StdConstantLookupTable();
-		ct_s = new stringstream();
-		ct_parser = new Parser(*ct_s, ct_clt, ct_ftl);
-		ct_ast = NULL;
-	}
-
-	void ct_cleanup() {
-		delete calc;
-		delete ct_s;
-		delete ct_ftl;
-		delete ct_clt;
-		delete ct_parser;
-		if (ct_ast != NULL) {
-			delete ct_ast;
-		}
-		calc = NULL;
-		ct_s = NULL;
-		ct_ftl = NULL;
-		ct_clt = NULL;
-		ct_parser = NULL;
-		ct_ast = NULL;
-	}
-
-	void ct_testRPNPlus() {
-		*ct_s << "1 2 +";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(3.0f, result);
-	}
-
-	void ct_testASTPlus() {
-		*ct_s << "1+2";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(3.0f, result);
-	}
-
-	void ct_testRPNMinus() {
-		*ct_s << "1 2 -";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(-1.0f, result);
-	}
-
-	void ct_testASTMinus() {
-		*ct_s << "1-2";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(-1.0f, result);
-	}
-
-	void ct_testRPNUnaryNeg() {
-		*ct_s << "1 ~";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(-1.0f, result);
-	}
-
-	void ct_testASTUnaryNeg() {
-		*ct_s << "-1";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(-1.0f, result);
-	}
-
-	void ct_testRPNMul() {
-		*ct_s << "2 3 *";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(6.0f, result);
-	}
-
-	void ct_testASTMul() {
-		*ct_s << "2*3";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(6.0f, result);
-	}
-
-	void ct_testRPNDiv() {
-		*ct_s << "6 3 /";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(2.0f, result);
-	}
-
-	void ct_testASTDiv() {
-		*ct_s << "6/3";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(2.0f, result);
-	}
-
-	void ct_testRPNPow() {
-		*ct_s << "2 3 ^";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(8.0f, result);
-	}
-
-	void ct_testASTPow() {
-		*ct_s << "2^3";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(8.0f, result);
-	}
-
-	void ct_testRPNVariable() {
-		*ct_s << "x";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(1.0f);
-		CAssert::assertEquals(1.0f, result);
-	}
-
-	void ct_testASTVariable() {
-		*ct_s << "x";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(1.0f);
-		CAssert::assertEquals(1.0f, result);
-	}
-
-	void ct_testRPNConst() {
-		ct_clt->add(string("c"), 1.0);
-		*ct_s << "c";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(1.0f, result);
-	}
-
-	void ct_testASTConst() {
-		ct_clt->add(string("c"), 1.0);
-		*ct_s << "c";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(1.0f, result);
-	}
-
-	void ct_testRPNFunc() {
-		ct_ftl->add(string("f"), new FunctionIdentity());
-		*ct_s << "2.0 f";
-
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(1.0f);
-		CAssert::assertEquals(2.0f, result);
-	}
-
-	void ct_testASTFunc() {
-
-		ct_ftl->add(string("f"), new FunctionIdentity());
-		*ct_s << "f(2.0)";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(2.0f, result);
-	}
-
-	void ct_testRPNWiki() {
-		*ct_s << "12 2 3 4 * 10 5 / + * +";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		double result = calc->calculate(1.0f);
-		CAssert::assertEquals(40.0f, result);
-	}
-
-	void ct_testASTWiki() {
-		*ct_s << "((2+7)/3+(14-3)*4)/2";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(23.5f, result);
-	}
-
-	void ct_testSaveLoad1() {
-		stringstream s2;
-		*ct_s << "1~ 2 +";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		calc->save(s2);
-		s2.flush();
-		Calculator calc2(string("x"), ct_ftl, ct_clt, s2);
-		double result = calc2.calculate(0.0f);
-		CAssert::assertEquals(1.0f, result);
-	}
-
-	void ct_testSaveLoad2() {
-		stringstream s2;
-		*ct_s << "12 2 3 4 * 10 5 / + * +";
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
-		calc->save(s2);
-		s2.flush();
-		Calculator calc2(string("x"), ct_ftl, ct_clt, s2);
-		double result = calc2.calculate(0.0f);
-		CAssert::assertEquals(40.0f, result);
-	}
-
-	void ct_testASTSin() {
-		*ct_s << "sin(x)";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(0.0f, result);
-	}
-
-	/*void ct_test() {
-		*ct_s << "y";
-		ct_parser->begin();
-		ct_ast = ct_parser->expr();
-		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
-		double result = calc->calculate(0.0f);
-		CAssert::assertEquals(0.0f, result);
-	}
-	*/
-
-	std::auto_ptr<cunit::TestCase> calculatorTestCase() {
-		auto_ptr<TestCase> tc = auto_ptr<TestCase>(
-			new TestCase(string("CalculatorTestCase"), 
-			ct_setup, ct_cleanup));
-
-		tc->addTest(string("ct_testRPNPlus"), ct_testRPNPlus);
-		tc->addTest(string("ct_testASTPlus"), ct_testASTPlus);
-		tc->addTest(string("ct_testRPNMinus"), ct_testRPNMinus);
-		tc->addTest(string("ct_testASTMinus"), ct_testASTMinus);
-		tc->addTest(string("ct_testRPNUnaryNeg"), ct_testRPNUnaryNeg);
-		tc->addTest(string("ct_testASTUnaryNeg"), ct_testASTUnaryNeg);
-		tc->addTest(string("ct_testRPNMul"), ct_testRPNMul);
-		tc->addTest(string("ct_testASTMul"), ct_testASTMul);
-		tc->addTest(string("ct_testRPNDiv"), ct_testRPNDiv);
-		tc->addTest(string("ct_testASTDiv"), ct_testASTDiv);
-		tc->addTest(string("ct_testRPNPow"), ct_testRPNPow);
-		tc->addTest(string("ct_testASTPow"), ct_testASTPow);
-		tc->addTest(string("ct_testRPNVariable"), ct_testRPNVariable);
-		tc->addTest(string("ct_testASTVariable"), ct_testASTVariable);
-		tc->addTest(string("ct_testRPNConst"), ct_testRPNConst);
-		tc->addTest(string("ct_testASTConst"), ct_testASTConst);
-		tc->addTest(string("ct_testRPNFunc"), ct_testRPNFunc);
-		tc->addTest(string("ct_testASTFunc"), ct_testASTFunc);
-		tc->addTest(string("ct_testRPNWiki"), ct_testRPNWiki);
-		tc->addTest(string("ct_testASTWiki"), ct_testASTWiki);
-		tc->addTest(string("ct_testSaveLoad1"), ct_testSaveLoad1);
-		tc->addTest(string("ct_testSaveLoad2"), ct_testSaveLoad2);
-		tc->addTest(string("ct_testASTSin"), ct_testASTSin);
-		//tc->addTest(string("ct_test"), ct_test);
-		return tc;
-	}
-}
-
-
-
+#include "stdafx.h"
+
+#include "TestCalculator.h"
+#include "..\calc_parser\Calculator.h"
+
+#include "CAssert.h"
+#include "CUnit.h"
+#include <vector>
+#include <cmath>
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	Calculator* calc;
+	stringstream* ct_s = NULL;
+	FunctionLookupTable* ct_ftl;
+	ConstantLookupTable* ct_clt;
+	Parser* ct_parser;
+	AstNode* ct_ast = NULL;
+
+	void ct_setup() {
+		ct_ftl = new StdFunctionLookupTable();
+		ct_clt = new StdConstantLookupTable();
+		ct_s = new stringstream();
+		ct_parser = new Parser(*ct_s, ct_clt, ct_ftl);
+		ct_ast = NULL;
+	}
+
+	void ct_cleanup() {
+		delete calc;
+		delete ct_s;
+		delete ct_ftl;
+		delete ct_clt;
+		delete ct_parser;
+		if (ct_ast != NULL) {
+			delete ct_ast;
+		}
+		calc = NULL;
+		ct_s = NULL;
+		ct_ftl = NULL;
+		ct_clt = NULL;
+		ct_parser = NULL;
+		ct_ast = NULL;
+	}
+
+	void ct_testRPNPlus() {
+		*ct_s << "1 2 +";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(3.0f, result);
+	}
+
+	void ct_testASTPlus() {
+		*ct_s << "1+2";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(3.0f, result);
+	}
+
+	void ct_testRPNMinus() {
+		*ct_s << "1 2 -";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(-1.0f, result);
+	}
+
+	void ct_testASTMinus() {
+		*ct_s << "1-2";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(-1.0f, result);
+	}
+
+	void ct_testRPNUnaryNeg() {
+		*ct_s << "1 ~";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(-1.0f, result);
+	}
+
+	void ct_testASTUnaryNeg() {
+		*ct_s << "-1";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(-1.0f, result);
+	}
+
+	void ct_testRPNMul() {
+		*ct_s << "2 3 *";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(6.0f, result);
+	}
+
+	void ct_testASTMul() {
+		*ct_s << "2*3";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(6.0f, result);
+	}
+
+	void ct_testRPNDiv() {
+		*ct_s << "6 3 /";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(2.0f, result);
+	}
+
+	void ct_testASTDiv() {
+		*ct_s << "6/3";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(2.0f, result);
+	}
+
+	void ct_testRPNPow() {
+		*ct_s << "2 3 ^";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(8.0f, result);
+	}
+
+	void ct_testASTPow() {
+		*ct_s << "2^3";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(8.0f, result);
+	}
+
+	void ct_testRPNVariable() {
+		*ct_s << "x";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(1.0f);
+		CAssert::assertEquals(1.0f, result);
+	}
+
+	void ct_testASTVariable() {
+		*ct_s << "x";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(1.0f);
+		CAssert::assertEquals(1.0f, result);
+	}
+
+	void ct_testRPNConst() {
+		ct_clt->add(string("c"), 1.0);
+		*ct_s << "c";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(1.0f, result);
+	}
+
+	void ct_testASTConst() {
+		ct_clt->add(string("c"), 1.0);
+		*ct_s << "c";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(1.0f, result);
+	}
+
+	void ct_testRPNFunc() {
+		ct_ftl->add(string("f"), new FunctionIdentity());
+		*ct_s << "2.0 f";
+
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(1.0f);
+		CAssert::assertEquals(2.0f, result);
+	}
+
+	void ct_testASTFunc() {
+
+		ct_ftl->add(string("f"), new FunctionIdentity());
+		*ct_s << "f(2.0)";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(2.0f, result);
+	}
+
+	void ct_testRPNWiki() {
+		*ct_s << "12 2 3 4 * 10 5 / + * +";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		double result = calc->calculate(1.0f);
+		CAssert::assertEquals(40.0f, result);
+	}
+
+	void ct_testASTWiki() {
+		*ct_s << "((2+7)/3+(14-3)*4)/2";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(23.5f, result);
+	}
+
+	void ct_testSaveLoad1() {
+		stringstream s2;
+		*ct_s << "1~ 2 +";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		calc->save(s2);
+		s2.flush();
+		Calculator calc2(string("x"), ct_ftl, ct_clt, s2);
+		double result = calc2.calculate(0.0f);
+		CAssert::assertEquals(1.0f, result);
+	}
+
+	void ct_testSaveLoad2() {
+		stringstream s2;
+		*ct_s << "12 2 3 4 * 10 5 / + * +";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		calc->save(s2);
+		s2.flush();
+		Calculator calc2(string("x"), ct_ftl, ct_clt, s2);
+		double result = calc2.calculate(0.0f);
+		CAssert::assertEquals(40.0f, result);
+	}
+
+	void ct_testASTSin() {
+		*ct_s << "sin(x)";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(0.0f, result);
+	}
+
+	void ct_testSourceWiki() {
+		string text("12 2 3 4 * 10 5 / + * +");
+		SourceBuffer source(text.data(), text.size());
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, source);
+		double result = calc->calculate(1.0f);
+		CAssert::assertEquals(40.0f, result);
+	}
+
+	void ct_testSourceSaveLoad() {
+		stringstream s2;
+		*ct_s << "x sin 2 ^ x cos 2 ^ + PI *";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		calc->save(s2);
+		string text = s2.str();
+		//the same program loaded from the stream and from the buffer
+		SourceBuffer source(text.data(), text.size());
+		Calculator calc2(string("x"), ct_ftl, ct_clt, source);
+		Calculator calc3(string("x"), ct_ftl, ct_clt, s2);
+		CAssert::assertEquals(calc3.calculate(0.5), calc2.calculate(0.5));
+	}
+
+	void ct_testTokenArray() {
+		string text("12 2 3 4 * 10 5 / + * +");
+		TokenArray tokens;
+		tokens.tokenize(text.data(), text.size());
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, tokens);
+		Calculator calc2(string("x"), ct_ftl, ct_clt, tokens);
+		CAssert::assertEquals(40.0f, calc->calculate(1.0f));
+		CAssert::assertEquals(40.0f, calc2.calculate(1.0f));
+	}
+
+	void ct_testSaveLoadExact() {
+		stringstream s2;
+		ct_clt->add(string("NEG"), -0.1);
+		*ct_s << "x 0.1 * 1e-300 + 1.7976931348623157e308 / 3.0000000000000004 ^ NEG +";
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, *ct_s);
+		calc->save(s2);
+		//shortest texts; the negative constant is negated
+		CAssert::assertEquals(
+			string("x 0.1 * 1e-300 + 1.7976931348623157e+308 / 3.0000000000000004 ^ 0.1 ~ +"),
+			s2.str());
+		Calculator calc2(string("x"), ct_ftl, ct_clt, s2);
+		double x = 1e300;
+		for (int i = 0; i < 10; i++) {
+			CAssert::assertTrue(calc->calculate(x) == calc2.calculate(x));
+			x /= 7.0;
+		}
+	}
+
+	void ct_testPushReader() {
+		string text("x 0.1 * sin 12.5e-1 ~ + PI / 2 ^");
+		*ct_s << text;
+		Calculator whole(string("x"), ct_ftl, ct_clt, *ct_s);
+		stringstream expected;
+		whole.save(expected);
+		//every chunk size; tokens are split between chunks
+		for (size_t chunk = 1; chunk <= text.size(); chunk++) {
+			RPNPushReader reader(string("x"), ct_ftl, ct_clt);
+			for (size_t p = 0; p < text.size(); p += chunk) {
+				string part = text.substr(p, chunk);
+				reader.push(part.data(), part.size());
+			}
+			auto_ptr<Calculator> pushed = reader.finish();
+			stringstream saved;
+			pushed->save(saved);
+			CAssert::assertEquals(expected.str(), saved.str());
+			CAssert::assertTrue(whole.calculate(0.7) == pushed->calculate(0.7));
+		}
+	}
+
+	void ct_testPushReaderError() {
+		*ct_s << "1 2 + y *";
+		string expected;
+		try {
+			Calculator whole(string("x"), ct_ftl, ct_clt, *ct_s);
+		} catch (StatementException& e) {
+			expected = e.whatStr();
+		}
+		CAssert::assertFalse(expected.empty());
+		RPNPushReader reader(string("x"), ct_ftl, ct_clt);
+		string message;
+		try {
+			reader.push("1 2 + ", 6);
+			reader.push("y", 1);
+			reader.push(" *", 2);
+		} catch (StatementException& e) {
+			message = e.whatStr();
+		}
+		CAssert::assertEquals(expected, message);
+	}
+
+	/* the program saved, or the error of creating it, through the AST */
+	string ct_viaAst(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser parser(source, ct_clt, ct_ftl);
+		stringstream saved;
+		AstNode* ast = NULL;
+		try {
+			ast = parser.begin().expr();
+			Calculator calculator(string("x"), ct_ftl, ct_clt, ast);
+			calculator.save(saved);
+		} catch (std::exception& e) {
+			saved << "error: " << e.what();
+		}
+		delete ast;
+		return saved.str();
+	}
+
+	/* the program saved, or the error of compiling it, without the AST */
+	string ct_compiled(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		stringstream saved;
+		try {
+			auto_ptr<Calculator> calculator = Calculator::compile(string("x"), ct_ftl, ct_clt, source);
+			calculator->save(saved);
+		} catch (std::exception& e) {
+			saved << "error: " << e.what();
+		}
+		return saved.str();
+	}
+
+	void ct_testCompile() {
+		CAssert::assertEquals(string("1 2 3 * +"), ct_compiled("1+2*3"));
+		const char* texts[] = {
+			"x",
+			"sin(x)^2 + cos(x)^2",
+			"-(x^2.5)/\n(x-E) * PI",
+			"2^3^-4 * -cos(-E) / 1e-3 - ((x))",
+			"exp(-log(x)^2) * ((1+x)*(1-x))",
+			//the rest is not compiled
+			"x*2 3 4"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			CAssert::assertEquals(ct_viaAst(texts[i]), ct_compiled(texts[i]));
+		}
+		string text("exp(-log(x)^2) * ((1+x)*(1-x))");
+		SourceBuffer source(text.data(), text.size());
+		calc = Calculator::compile(string("x"), ct_ftl, ct_clt, source).release();
+		Parser parser(source, ct_clt, ct_ftl);
+		ct_ast = parser.begin().expr();
+		Calculator viaAst(string("x"), ct_ftl, ct_clt, ct_ast);
+		CAssert::assertTrue(viaAst.calculate(0.3) == calc->calculate(0.3));
+	}
+
+	void ct_testCompileErrors() {
+		const char* texts[] = {
+			"",
+			"1+",
+			"(x",
+			"x+ ?",
+			"foo(x)",
+			"y+1",
+			//syntax errors are reported before the unknown variable
+			"y+(1"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			string expected = ct_viaAst(texts[i]);
+			CAssert::assertEquals(string("error: "), expected.substr(0, 7));
+			CAssert::assertEquals(expected, ct_compiled(texts[i]));
+		}
+	}
+
+	/* the program saved, or the error, compiled by the change */
+	string ct_edited(IncrementalCompiler& compiler, size_t offset, size_t removedLength, const string& inserted) {
+		stringstream saved;
+		try {
+			compiler.edit(offset, removedLength, inserted);
+			compiler.getCalculator().save(saved);
+		} catch (std::exception& e) {
+			CAssert::assertFalse(compiler.isCompiled());
+			saved << "error: " << e.what();
+		}
+		return saved.str();
+	}
+
+	void ct_testIncremental() {
+		IncrementalCompiler compiler(string("x"), ct_ftl, ct_clt);
+		string text("exp(-log(x)^2) * ((1+x)*(1-x))");
+		compiler.compile(text);
+		CAssert::assertEquals(ct_compiled(text), ct_viaAst(text));
+		struct {
+			size_t offset;
+			size_t removed;
+			const char* inserted;
+		} edits[] = {
+			{ 21, 1, "2*x" },
+			{ 4, 1, "" },
+			{ 0, 3, "sin" },
+			//errors - the next changes are compiled with them
+			{ 22, 0, "y" },
+			{ 22, 1, "" },
+			{ 10, 0, "(" },
+			{ 10, 1, "" },
+			{ 10, 0, "?" },
+			{ 0, 0, "foo" },
+			{ 0, 3, "" },
+			{ 10, 1, "" },
+			{ 25, 0, "E - " }
+		};
+		for (size_t i = 0; i < sizeof(edits) / sizeof(edits[0]); i++) {
+			text.replace(edits[i].offset, edits[i].removed, edits[i].inserted);
+			CAssert::assertEquals(ct_compiled(text),
+				ct_edited(compiler, edits[i].offset, edits[i].removed, edits[i].inserted));
+			CAssert::assertEquals(text, compiler.getText());
+		}
+		CAssert::assertTrue(compiler.isCompiled());
+		SourceBuffer source(text.data(), text.size());
+		calc = Calculator::compile(string("x"), ct_ftl, ct_clt, source).release();
+		CAssert::assertTrue(calc->calculate(0.3) == compiler.getCalculator().calculate(0.3));
+	}
+
+	void ct_testLet() {
+		const char* texts[] = {
+			"let a = exp(-x*x) in a*(1-a)",
+			"let a = sin(x) in let b = a*a in b + b*a",
+			"let a = sin(x)*2 in sin(x)",
+			"let E = x in E",
+			"let a = 1", "let a = y in 1"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			CAssert::assertEquals(ct_viaAst(texts[i]), ct_compiled(texts[i]));
+		}
+		//the value is computed once and kept
+		string text("let a = exp(-x*x) in a*(1-a)");
+		SourceBuffer source(text.data(), text.size());
+		calc = Calculator::compile(string("x"), ct_ftl, ct_clt, source).release();
+		CAssert::assertEquals(1, calc->getSlotCount());
+		double a = exp(-0.25);
+		CAssert::assertEquals(a * (1 - a), calc->calculate(0.5));
+		//a binding not used is not compiled
+		string unused("let a = sin(x)*2 in sin(x)");
+		SourceBuffer unusedSource(unused.data(), unused.size());
+		auto_ptr<Calculator> unusedCalc = Calculator::compile(string("x"), ct_ftl, ct_clt, unusedSource);
+		CAssert::assertEquals(0, unusedCalc->getSlotCount());
+
+		IncrementalCompiler compiler(string("x"), ct_ftl, ct_clt);
+		compiler.compile(text);
+		text.replace(text.find("x*x"), 1, "2*x");
+		CAssert::assertEquals(ct_compiled(text), ct_edited(compiler, 13, 1, "2*x"));
+
+		//the values are not copied: no limit (see parser::MAX_COPIED_NODES)
+		stringstream nested;
+		nested << "let a0 = x in ";
+		for (int i = 1; i <= 30; i++) {
+			nested << "let a" << i << " = a" << (i - 1) << "*a" << (i - 1) << "+a" << (i - 1) << " in ";
+		}
+		nested << "a30";
+		string nestedText = nested.str();
+		SourceBuffer nestedSource(nestedText.data(), nestedText.size());
+		auto_ptr<Calculator> nestedCalc = Calculator::compile(string("x"), ct_ftl, ct_clt, nestedSource);
+		double expected = -0.5;
+		for (int i = 1; i <= 30; i++) {
+			expected = expected * expected + expected;
+		}
+		CAssert::assertEquals(expected, nestedCalc->calculate(-0.5));
+	}
+
+	/*void ct_test() {
+		*ct_s << "y";
+		ct_parser->begin();
+		ct_ast = ct_parser->expr();
+		calc = new Calculator(string("x"), ct_ftl, ct_clt, ct_ast);
+		double result = calc->calculate(0.0f);
+		CAssert::assertEquals(0.0f, result);
+	}
+	*/
+
+	std::auto_ptr<cunit::TestCase> calculatorTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(
+			new TestCase(string("CalculatorTestCase"), 
+			ct_setup, ct_cleanup));
+
+		tc->addTest(string("ct_testRPNPlus"), ct_testRPNPlus);
+		tc->addTest(string("ct_testASTPlus"), ct_testASTPlus);
+		tc->addTest(string("ct_testRPNMinus"), ct_testRPNMinus);
+		tc->addTest(string("ct_testASTMinus"), ct_testASTMinus);
+		tc->addTest(string("ct_testRPNUnaryNeg"), ct_testRPNUnaryNeg);
+		tc->addTest(string("ct_testASTUnaryNeg"), ct_testASTUnaryNeg);
+		tc->addTest(string("ct_testRPNMul"), ct_testRPNMul);
+		tc->addTest(string("ct_testASTMul"), ct_testASTMul);
+		tc->addTest(string("ct_testRPNDiv"), ct_testRPNDiv);
+		tc->addTest(string("ct_testASTDiv"), ct_testASTDiv);
+		tc->addTest(string("ct_testRPNPow"), ct_testRPNPow);
+		tc->addTest(string("ct_testASTPow"), ct_testASTPow);
+		tc->addTest(string("ct_testRPNVariable"), ct_testRPNVariable);
+		tc->addTest(string("ct_testASTVariable"), ct_testASTVariable);
+		tc->addTest(string("ct_testRPNConst"), ct_testRPNConst);
+		tc->addTest(string("ct_testASTConst"), ct_testASTConst);
+		tc->addTest(string("ct_testRPNFunc"), ct_testRPNFunc);
+		tc->addTest(string("ct_testASTFunc"), ct_testASTFunc);
+		tc->addTest(string("ct_testRPNWiki"), ct_testRPNWiki);
+		tc->addTest(string("ct_testASTWiki"), ct_testASTWiki);
+		tc->addTest(string("ct_testSaveLoad1"), ct_testSaveLoad1);
+		tc->addTest(string("ct_testSaveLoad2"), ct_testSaveLoad2);
+		tc->addTest(string("ct_testASTSin"), ct_testASTSin);
+		tc->addTest(string("ct_testSourceWiki"), ct_testSourceWiki);
+		tc->addTest(string("ct_testSourceSaveLoad"), ct_testSourceSaveLoad);
+		tc->addTest(string("ct_testTokenArray"), ct_testTokenArray);
+		tc->addTest(string("ct_testSaveLoadExact"), ct_testSaveLoadExact);
+		tc->addTest(string("ct_testPushReader"), ct_testPushReader);
+		tc->addTest(string("ct_testPushReaderError"), ct_testPushReaderError);
+		tc->addTest(string("ct_testCompile"), ct_testCompile);
+		tc->addTest(string("ct_testCompileErrors"), ct_testCompileErrors);
+		tc->addTest(string("ct_testIncremental"), ct_testIncremental);
+		tc->addTest(string("ct_testLet"), ct_testLet);
+		//tc->addTest(string("ct_test"), ct_test);
+		return tc;
+	}
+}
+
+
+
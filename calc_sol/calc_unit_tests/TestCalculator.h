@@ -1,13 +1,13 @@
-#ifndef TEST_CALCULATOR_H
-#define TEST_CALCULATOR_H
-
-#include "CUnit.h"
-#include <memory>
-
-namespace parser_tests {
-
-	std::auto_ptr<cunit::TestCase> calculatorTestCase();
-
-}
-
-#endif
+#ifndef TEST_CALCULATOR_H
+#define TEST_CALCULATOR_H
+
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> calculatorTestCase();
+
+}
+
+#endif
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+
+#include "TestCalculatorCache.h"
+
+#include "..\calc_parser\CalculatorCache.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\Threads.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* cc_flookup = NULL;
+	StdConstantLookupTable* cc_clookup = NULL;
+
+	void cc_setup() {
+		cc_flookup = new StdFunctionLookupTable();
+		cc_clookup = new StdConstantLookupTable();
+	}
+
+	void cc_cleanup() {
+		delete cc_flookup;
+		delete cc_clookup;
+		cc_flookup = NULL;
+		cc_clookup = NULL;
+	}
+
+	void cc_testNormalize() {
+		CAssert::assertEquals(string("x+1"), CalculatorCache::normalize(string("  x +\t1 ")));
+		CAssert::assertEquals(string("sin(x)*-2"), CalculatorCache::normalize(string("sin( x ) * - 2")));
+		//white space between tokens of words is kept
+		CAssert::assertEquals(string("x 1"), CalculatorCache::normalize(string("x\r\n\n1")));
+		CAssert::assertEquals(string("1e -3"), CalculatorCache::normalize(string("1e -3")));
+		CAssert::assertEquals(string("1e-3"), CalculatorCache::normalize(string("1e-3")));
+		//a space after the sign of an exponent is a lexical error
+		CAssert::assertEquals(string("1e+ 2"), CalculatorCache::normalize(string("1e+  2")));
+		CAssert::assertEquals(string("2E- x"), CalculatorCache::normalize(string("2E-\tx")));
+		CAssert::assertEquals(string(""), CalculatorCache::normalize(string(" \n ")));
+	}
+
+	void cc_testHit() {
+		CalculatorCache cache(10);
+		shared_ptr<const Calculator> first = cache.compile(string("x"), cc_flookup, cc_clookup, string("x + 1"));
+		shared_ptr<const Calculator> second = cache.compile(string("x"), cc_flookup, cc_clookup, string("x+1"));
+		CAssert::assertTrue(first == second);
+		CAssert::assertEquals(3.0, second->calculate(2.0));
+		CAssert::assertEquals(1, (int)cache.getHitCount());
+		CAssert::assertEquals(1, (int)cache.getMissCount());
+		//another variable or compile mode - another program
+		shared_ptr<const Calculator> y = cache.compile(string("y"), cc_flookup, cc_clookup, string("y+1"));
+		shared_ptr<const Calculator> shared = cache.compile(string("x"), cc_flookup, cc_clookup, string("x+1"), true);
+		CAssert::assertTrue(first != shared);
+		CAssert::assertEquals(3, (int)cache.getMissCount());
+		CAssert::assertEquals(3, (int)cache.size());
+		cache.clear();
+		CAssert::assertEquals(0, (int)cache.size());
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+1"));
+		CAssert::assertEquals(4, (int)cache.getMissCount());
+	}
+
+	void cc_testTableVersion() {
+		CalculatorCache cache(10);
+		//TWO is a variable - unknown
+		bool thrown = false;
+		try {
+			cache.compile(string("x"), cc_flookup, cc_clookup, string("x*TWO"));
+		} catch (StatementException&) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+
+		shared_ptr<const Calculator> sum = cache.compile(string("x"), cc_flookup, cc_clookup, string("x+ONE"));
+		cc_clookup->add(string("TWO"), 2.0);
+		shared_ptr<const Calculator> after = cache.compile(string("x"), cc_flookup, cc_clookup, string("x*TWO"));
+		CAssert::assertEquals(6.0, after->calculate(3.0));
+		//the table has changed - compiled again
+		CAssert::assertTrue(sum != cache.compile(string("x"), cc_flookup, cc_clookup, string("x+ONE")));
+		CAssert::assertEquals(0, (int)cache.getHitCount());
+		//a new table never has the version of another one
+		StdConstantLookupTable other;
+		CAssert::assertTrue(other.getVersion() != cc_clookup->getVersion());
+	}
+
+	void cc_testErrors() {
+		CalculatorCache cache(10);
+		for (int i = 0; i < 2; i++) {
+			string message;
+			try {
+				cache.compile(string("x"), cc_flookup, cc_clookup, string("x +\n (1"));
+			} catch (SyntaxException& e) {
+				message = e.what();
+			}
+			//reported in the text given
+			CAssert::assertFalse(message.empty());
+		}
+		CAssert::assertEquals(2, (int)cache.getMissCount());
+		CAssert::assertEquals(0, (int)cache.size());
+
+		//not the program of the valid text
+		CAssert::assertEquals(100.0, cache.compile(string("x"), cc_flookup, cc_clookup, string("1e+2"))->calculate(0.0));
+		bool thrown = false;
+		try {
+			cache.compile(string("x"), cc_flookup, cc_clookup, string("1e+ 2"));
+		} catch (std::exception&) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+	}
+
+	void cc_testEviction() {
+		CalculatorCache cache(2);
+		shared_ptr<const Calculator> a = cache.compile(string("x"), cc_flookup, cc_clookup, string("x+1"));
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+2"));
+		//x+1 is used - x+2 is the least recently used
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+1"));
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+3"));
+		CAssert::assertEquals(1, (int)cache.getEvictionCount());
+		CAssert::assertEquals(2, (int)cache.size());
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+1"));
+		CAssert::assertEquals(2, (int)cache.getHitCount());
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+2"));
+		CAssert::assertEquals(4, (int)cache.getMissCount());
+		CAssert::assertEquals(2, (int)cache.getEvictionCount());
+		//an evicted program stays valid while held
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+4"));
+		cache.compile(string("x"), cc_flookup, cc_clookup, string("x+5"));
+		CAssert::assertEquals(11.0, a->calculate(10.0));
+	}
+
+	/* compiles the expressions x+0 ... x+n-1 many times */
+	class cc_CompileTask : public Task {
+	public:
+		CalculatorCache* cache;
+		int expressionCount;
+		int wrong;
+
+		virtual void run() {
+			for (int i = 0; i < 100; i++) {
+				stringstream text;
+				int n = i % expressionCount;
+				text << "x + " << n;
+				shared_ptr<const Calculator> calculator = cache->compile(string("x"),
+					cc_flookup, cc_clookup, text.str());
+				if (calculator->calculate(1.0) != 1.0 + n) {
+					wrong++;
+				}
+			}
+		}
+	};
+
+	void cc_testThreads() {
+		CalculatorCache cache(8);
+		vector<cc_CompileTask> compiles(16);
+		vector<Task*> tasks;
+		for (size_t i = 0; i < compiles.size(); i++) {
+			compiles[i].cache = &cache;
+			//some of them evict the programs of the others
+			compiles[i].expressionCount = i % 2 == 0 ? 8 : 12;
+			compiles[i].wrong = 0;
+			tasks.push_back(&compiles[i]);
+		}
+		runTasks(tasks, 4);
+		for (size_t i = 0; i < compiles.size(); i++) {
+			CAssert::assertEquals(0, compiles[i].wrong);
+		}
+		CAssert::assertEquals(1600, (int)(cache.getHitCount() + cache.getMissCount()));
+		CAssert::assertTrue(cache.getMissCount() >= 12);
+		CAssert::assertTrue(cache.size() <= 8);
+		CAssert::assertTrue(cache.getEvictionCount() > 0);
+	}
+
+	auto_ptr<TestCase> calculatorCacheTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("CalculatorCacheTestCase"),
+			cc_setup, cc_cleanup));
+		tc->addTest("cc_testNormalize", cc_testNormalize);
+		tc->addTest("cc_testHit", cc_testHit);
+		tc->addTest("cc_testTableVersion", cc_testTableVersion);
+		tc->addTest("cc_testErrors", cc_testErrors);
+		tc->addTest("cc_testEviction", cc_testEviction);
+		tc->addTest("cc_testThreads", cc_testThreads);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_CALCULATOR_CACHE_H
+#define TEST_CALCULATOR_CACHE_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> calculatorCacheTestCase();
+
+}
+
+#endif
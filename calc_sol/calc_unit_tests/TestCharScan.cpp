@@ -0,0 +1,152 @@
+#include "stdafx.h"
+
+#include "TestCharScan.h"
+
+#include "..\calc_parser\CharScan.h"
+#include "..\calc_parser\BufferLexer.h"
+#include "..\calc_parser\DfaLexer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace parser::simd;
+
+namespace parser_tests {
+
+	SimdLevel cs_savedLevel = SIMD_SCALAR;
+
+	void cs_setup() {
+		cs_savedLevel = getSimdLevel();
+	}
+
+	void cs_cleanup() {
+		setSimdLevel(cs_savedLevel);
+	}
+
+	/* Text with runs of every character class of various lengths,
+	and characters outside of ASCII */
+	string cs_text() {
+		static const char* pieces[] = {
+			" ", "\t\t", "0", "123", "abc", "_Z9", "\n", "\r\n", ".", "+",
+			"\x80", "\xff", "@", "[", "`", "{", "/", ":", "\0"
+		};
+		string text;
+		unsigned int state = 17;
+		for (int i = 0; i < 2000; i++) {
+			state = state * 1103515245u + 12345u;
+			unsigned int piece = (state >> 16) % 19;
+			unsigned int repeat = ((state >> 8) % 5 == 0) ? 40 : 1;
+			for (unsigned int r = 0; r < repeat; r++) {
+				if (piece == 18) {
+					text.push_back('\0');
+				} else {
+					text.append(pieces[piece]);
+				}
+			}
+		}
+		return text;
+	}
+
+	/* the scanner finds the same boundaries as the scalar one,
+	starting at every character and ending at every length */
+	void cs_assertSameAsScalar(SimdLevel level) {
+		string text = cs_text();
+		const CharScanner& scalar = charScanner(SIMD_SCALAR);
+		const CharScanner& scanner = charScanner(level);
+		const char* data = text.data();
+		const char* end = data + text.size();
+		for (const char* p = data; p != end; ++p) {
+			CAssert::assertTrue(scalar.skipSpaces(p, end) == scanner.skipSpaces(p, end));
+			CAssert::assertTrue(scalar.skipDigits(p, end) == scanner.skipDigits(p, end));
+			CAssert::assertTrue(scalar.skipIdentifier(p, end) == scanner.skipIdentifier(p, end));
+		}
+		for (size_t length = 0; length < 100; length++) {
+			const char* shortEnd = data + length;
+			CAssert::assertTrue(scalar.skipSpaces(data, shortEnd) == scanner.skipSpaces(data, shortEnd));
+			CAssert::assertTrue(scalar.skipIdentifier(data, shortEnd) == scanner.skipIdentifier(data, shortEnd));
+		}
+	}
+
+	void cs_testScalar() {
+		string text("  \t\n12ab_9 x");
+		const CharScanner& scalar = charScanner(SIMD_SCALAR);
+		const char* data = text.data();
+		const char* end = data + text.size();
+		CAssert::assertTrue(scalar.skipSpaces(data, end) == data + 4);
+		CAssert::assertTrue(scalar.skipDigits(data + 4, end) == data + 6);
+		CAssert::assertTrue(scalar.skipIdentifier(data + 4, end) == data + 10);
+		CAssert::assertTrue(scalar.skipSpaces(end, end) == end);
+	}
+
+	void cs_testSse2() {
+		if (detectSimdLevel() >= SIMD_SSE2) {
+			cs_assertSameAsScalar(SIMD_SSE2);
+		}
+	}
+
+	void cs_testAvx2() {
+		if (detectSimdLevel() >= SIMD_AVX2) {
+			cs_assertSameAsScalar(SIMD_AVX2);
+		}
+	}
+
+	void cs_testSetLevel() {
+		CAssert::assertTrue(setSimdLevel(SIMD_SCALAR) == SIMD_SCALAR);
+		CAssert::assertTrue(getSimdLevel() == SIMD_SCALAR);
+		CAssert::assertTrue(setSimdLevel(SIMD_AVX2) == detectSimdLevel());
+	}
+
+	/* BufferLexer at every level gives the tokens of DfaLexer */
+	void cs_testBufferLexer() {
+		string text;
+		for (int i = 0; i < 50; i++) {
+			text += "x 1234567890123456789012345678901234567890.0987654321098765432109876543210 +";
+			text += "                                                      ";
+			text += "a_very_long_identifier_with_digits_0123456789_and_more_letters ~\n";
+		}
+		text += "1.$";
+		for (int level = SIMD_SCALAR; level <= SIMD_AVX2; level++) {
+			setSimdLevel((SimdLevel)level);
+			BufferLexer bufferLexer(text.data(), text.size());
+			DfaLexer dfaLexer;
+			stringstream in(text);
+			string bufferError;
+			string dfaError;
+			try {
+				LexemKind kind;
+				do {
+					kind = bufferLexer.next();
+					auto_ptr<Lexem> lexem = dfaLexer.next(in);
+					CAssert::assertEquals(lexem.get() != NULL ? lexem->toString() : string("eof"),
+						kind != LK_EOF ? bufferLexer.getLexem()->toString() : string("eof"));
+				} while (kind != LK_EOF);
+			} catch (UnknownTokenException& e) {
+				bufferError = e.what();
+			}
+			try {
+				while (dfaLexer.next(in).get() != NULL) {
+				}
+			} catch (UnknownTokenException& e) {
+				dfaError = e.what();
+			}
+			CAssert::assertFalse(bufferError.empty());
+			CAssert::assertEquals(dfaError, bufferError);
+		}
+	}
+
+	auto_ptr<TestCase> charScanTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("CharScanTestCase"),
+			cs_setup, cs_cleanup));
+		tc->addTest("cs_testScalar", cs_testScalar);
+		tc->addTest("cs_testSse2", cs_testSse2);
+		tc->addTest("cs_testAvx2", cs_testAvx2);
+		tc->addTest("cs_testSetLevel", cs_testSetLevel);
+		tc->addTest("cs_testBufferLexer", cs_testBufferLexer);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_CHAR_SCAN_H
+#define TEST_CHAR_SCAN_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> charScanTestCase();
+
+}
+
+#endif
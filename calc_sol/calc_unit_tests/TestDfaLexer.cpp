@@ -0,0 +1,138 @@
+
+#include "stdafx.h"
+
+#include "TestDfaLexer.h"
+
+#include "..\calc_parser\Lexer.h"
+#include "..\calc_parser\DfaLexer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <vector>
+#include <string>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	DfaLexer* dfaLexer = NULL;
+	stringstream* dt_s = NULL;
+
+	void dt_setup() {
+		dfaLexer = new DfaLexer();
+		dt_s = new stringstream();
+	}
+
+	void dt_cleanup() {
+		delete dfaLexer;
+		delete dt_s;
+		dfaLexer = NULL;
+		dt_s = NULL;
+	}
+
+	/* Lex the whole text with the given lexer.
+	Returns: lexems separated with spaces, or the error message */
+	template <class LexerType>
+	string dt_lexAll(string text) {
+		LexerType lexer;
+		stringstream in(text);
+		stringstream out;
+		try {
+			auto_ptr<Lexem> lexem;
+			while ((lexem = lexer.next(in)).get() != NULL) {
+				out << lexem->toString() << " ";
+			}
+		} catch (UnknownTokenException& e) {
+			out << "error: " << e.what();
+		}
+		out << "eof=" << lexer.isEof()
+			<< " line=" << lexer.getLineNo()
+			<< " char=" << lexer.getCharNo();
+		return out.str();
+	}
+
+	/* both lexers must give the same lexems, errors and positions */
+	void dt_assertSameAsLexer(string text) {
+		CAssert::assertEquals(dt_lexAll<Lexer>(text), dt_lexAll<DfaLexer>(text));
+	}
+
+	void dt_testNextEmpty() {
+		*dt_s << " \r\t\n";
+		auto_ptr<Lexem> lexem = dfaLexer->next(*dt_s);
+		CAssert::assertNull(lexem.get());
+		CAssert::assertTrue(dfaLexer->isEof());
+	}
+
+	void dt_testNextStateChangeTwice() {
+		*dt_s << " 1 2 ";
+		auto_ptr<Lexem> lexem1 = dfaLexer->next(*dt_s);
+		CAssert::assertTrue(FloatLexem(1.0) == *(lexem1.get()));
+		CAssert::assertFalse(dfaLexer->isEof());
+
+		auto_ptr<Lexem> lexem2 = dfaLexer->next(*dt_s);
+		CAssert::assertTrue(FloatLexem(2.0) == *(lexem2.get()));
+		CAssert::assertFalse(dfaLexer->isEof());
+
+		auto_ptr<Lexem> lexem3 = dfaLexer->next(*dt_s);
+		CAssert::assertNull(lexem3.get());
+		CAssert::assertTrue(dfaLexer->isEof());
+	}
+
+	void dt_testNextFloatLong() {
+		*dt_s << "12.34";
+		auto_ptr<Lexem> lexem = dfaLexer->next(*dt_s);
+		CAssert::assertTrue(FloatLexem(12.34) == *(lexem.get()));
+		CAssert::assertTrue(dfaLexer->isEof());
+	}
+
+	void dt_testNextIdentifier() {
+		*dt_s << "_a0";
+		auto_ptr<Lexem> lexem = dfaLexer->next(*dt_s);
+		CAssert::assertTrue(IdentifierLexem("_a0") == *(lexem.get()));
+		CAssert::assertTrue(dfaLexer->isEof());
+	}
+
+	void dt_testSameTokens() {
+		dt_assertSameAsLexer("1+2");
+		dt_assertSameAsLexer("((1))");
+		dt_assertSameAsLexer(" sin(x) * 2.5 ^ -y / (3-4) ~ ");
+		dt_assertSameAsLexer("12 2 3 4 * 10 5 / + * +");
+		dt_assertSameAsLexer("a1b2_c3+_\n\t1.25\r\n2");
+		dt_assertSameAsLexer("1 2\n3 4\n");
+		dt_assertSameAsLexer("x");
+		dt_assertSameAsLexer("");
+		//exponents and the special values
+		dt_assertSameAsLexer("1e5 2.5E-3*7e+2/1E0");
+		dt_assertSameAsLexer("inf nan info nanx e E2 x1e5");
+	}
+
+	void dt_testSameErrors() {
+		//unknown character
+		dt_assertSameAsLexer("1 $");
+		dt_assertSameAsLexer("1$");
+		dt_assertSameAsLexer("ab\n 2 # 3");
+		dt_assertSameAsLexer(".5");
+		//float ending with dot - inside and at the end of the stream
+		dt_assertSameAsLexer("1.+2");
+		dt_assertSameAsLexer("2\n1.");
+		//float without the digits of the exponent
+		dt_assertSameAsLexer("1e+2 1ex");
+		dt_assertSameAsLexer("1e+ 2");
+		dt_assertSameAsLexer("2.5e\n");
+		dt_assertSameAsLexer("3e-");
+	}
+
+	auto_ptr<TestCase> dfaLexerTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("DfaLexerTestCase"),
+			dt_setup, dt_cleanup));
+		tc->addTest("dt_testNextEmpty", dt_testNextEmpty);
+		tc->addTest("dt_testNextStateChangeTwice", dt_testNextStateChangeTwice);
+		tc->addTest("dt_testNextFloatLong", dt_testNextFloatLong);
+		tc->addTest("dt_testNextIdentifier", dt_testNextIdentifier);
+		tc->addTest("dt_testSameTokens", dt_testSameTokens);
+		tc->addTest("dt_testSameErrors", dt_testSameErrors);
+		return tc;
+	}
+
+}
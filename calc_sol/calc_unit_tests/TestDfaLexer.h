@@ -0,0 +1,12 @@
+#ifndef TEST_DFA_LEXER_H
+#define TEST_DFA_LEXER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> dfaLexerTestCase();
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include "stdafx.h"
+
+#include "TestExpressionLibrary.h"
+
+#include "..\calc_parser\ExpressionLibrary.h"
+#include "..\calc_parser\Calculator.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <memory>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* el_flookup = NULL;
+	StdConstantLookupTable* el_clookup = NULL;
+	ExpressionLibrary* el_library = NULL;
+
+	void el_setup() {
+		el_flookup = new StdFunctionLookupTable();
+		el_clookup = new StdConstantLookupTable();
+		el_library = new ExpressionLibrary(string("x"), el_flookup, el_clookup);
+	}
+
+	void el_cleanup() {
+		delete el_library;
+		delete el_flookup;
+		delete el_clookup;
+		el_library = NULL;
+		el_flookup = NULL;
+		el_clookup = NULL;
+	}
+
+	/* the value of the expression of the library */
+	double el_value(const char* name, double x) {
+		return el_library->getProgram(string(name))->calculate(x);
+	}
+
+	void el_testExpressions() {
+		CAssert::assertTrue(el_library->setExpression(string("a"), string("x*2")));
+		CAssert::assertEquals(6.0, el_value("a", 3.0));
+		CAssert::assertTrue(el_library->setExpression(string("a"), string("x*3")));
+		CAssert::assertEquals(9.0, el_value("a", 3.0));
+		CAssert::assertEquals(1, (int)el_library->size());
+		//an error is kept
+		CAssert::assertFalse(el_library->setExpression(string("b"), string("el_f(x) + 1")));
+		CAssert::assertTrue(el_library->getProgram(string("b")).get() == NULL);
+		CAssert::assertEquals(string("Syntax error at 1:10 unknown function el_f"),
+			el_library->getStatus(string("b")).what());
+		CAssert::assertFalse(el_library->setExpression(string("c"), string("x # 1")));
+		CAssert::assertEquals(3, el_library->getStatus(string("c")).getCharNo());
+		//the expression waiting for the function is compiled with it
+		el_library->setFunction(string("el_f(t) = t*t"));
+		CAssert::assertEquals(2, (int)el_library->getRecompiledCount());
+		CAssert::assertTrue(el_library->getStatus(string("b")).isOk());
+		CAssert::assertEquals(10.0, el_value("b", 3.0));
+		CAssert::assertTrue(el_library->getProgram(string("el_unknown")).get() == NULL);
+		CAssert::assertTrue(el_library->getStatus(string("el_unknown")).isOk());
+	}
+
+	void el_testConstant() {
+		CAssert::assertTrue(el_library->setConstant(string("el_k"), 2.0));
+		el_library->setFunction(string("el_f(t) = t*el_k"));
+		el_library->setFunction(string("el_g(t) = el_f(t) + 1"));
+		el_library->setExpression(string("p"), string("el_g(x)"));
+		el_library->setExpression(string("q"), string("x*el_k"));
+		el_library->setExpression(string("r"), string("el_f(x)"));
+		el_library->setExpression(string("s"), string("x+1"));
+		shared_ptr<const Calculator> p = el_library->getProgram(string("p"));
+		shared_ptr<const Calculator> s = el_library->getProgram(string("s"));
+		CAssert::assertEquals(7.0, el_value("p", 3.0));
+
+		//the functions, then the programs which use them; not s
+		el_library->setConstant(string("el_k"), 3.0);
+		CAssert::assertEquals(5, (int)el_library->getRecompiledCount());
+		CAssert::assertEquals(10.0, el_value("p", 3.0));
+		CAssert::assertEquals(9.0, el_value("q", 3.0));
+		CAssert::assertEquals(9.0, el_value("r", 3.0));
+		CAssert::assertTrue(s == el_library->getProgram(string("s")));
+		//the old program stays valid
+		CAssert::assertTrue(p != el_library->getProgram(string("p")));
+		CAssert::assertEquals(7.0, p->calculate(3.0));
+
+		//a constant named as the variable
+		el_library->setConstant(string("x"), 1.0);
+		CAssert::assertEquals(4, (int)el_library->getRecompiledCount());
+		CAssert::assertEquals(2.0, el_value("s", 3.0));
+
+		//a builtin constant is not changed
+		double pi = el_clookup->lookup(string("PI"));
+		el_library->setExpression(string("t"), string("PI*x"));
+		CAssert::assertFalse(el_library->setConstant(string("PI"), 3.0));
+		CAssert::assertEquals(0, (int)el_library->getRecompiledCount());
+		CAssert::assertEquals(pi, el_clookup->lookup(string("PI")));
+		CAssert::assertEquals(pi, el_value("t", 1.0));
+		CAssert::assertTrue(pi != 3.0);
+	}
+
+	void el_testRedefine() {
+		el_library->setFunction(string("el_f(t) = t + 1"));
+		el_library->setFunction(string("el_g(t) = el_f(t)*2"));
+		el_library->setFunction(string("el_h(t) = el_g(t) - el_f(t)"));
+		el_library->setExpression(string("p"), string("el_h(x)"));
+		el_library->setExpression(string("q"), string("el_g(x)"));
+		CAssert::assertEquals(4.0, el_value("p", 3.0));
+		//el_h uses el_f after el_g - redefined after both
+		el_library->setFunction(string("el_f(t) = t - 1"));
+		CAssert::assertEquals(5, (int)el_library->getRecompiledCount());
+		CAssert::assertEquals(2.0, el_value("p", 3.0));
+		CAssert::assertEquals(4.0, el_value("q", 3.0));
+		el_library->setFunction(string("el_h(t) = el_g(t)"));
+		CAssert::assertEquals(2, (int)el_library->getRecompiledCount());
+		CAssert::assertEquals(4.0, el_value("p", 3.0));
+
+		//no recursion; nothing is changed
+		const char* texts[] = {
+			"el_f(t) = el_h(t)", "Syntax error at 1:15 recursive definition el_h",
+			"el_f(t) = el_f(t)", "Syntax error at 1:15 recursive definition el_f",
+			"el_f(t) = t + y", "Syntax error at 1:15 unknown variable y",
+			"sin(t) = t", "Syntax error at 1:4 function already defined sin"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i += 2) {
+			string error;
+			try {
+				el_library->setFunction(string(texts[i]));
+			} catch (SyntaxException& e) {
+				error = e.what();
+			}
+			CAssert::assertEquals(string(texts[i + 1]), error);
+			CAssert::assertEquals(4.0, el_value("p", 3.0));
+		}
+		//a function not called but named is not a recursion
+		el_library->setFunction(string("el_f(el_h) = el_h + 2"));
+		CAssert::assertEquals(10.0, el_value("p", 3.0));
+	}
+
+	std::auto_ptr<cunit::TestCase> expressionLibraryTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(
+			new TestCase(string("ExpressionLibraryTestCase"),
+			el_setup, el_cleanup));
+
+		tc->addTest(string("el_testExpressions"), el_testExpressions);
+		tc->addTest(string("el_testConstant"), el_testConstant);
+		tc->addTest(string("el_testRedefine"), el_testRedefine);
+		return tc;
+	}
+
+}
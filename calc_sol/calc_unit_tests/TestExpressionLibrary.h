@@ -0,0 +1,12 @@
+#ifndef TEST_EXPRESSION_LIBRARY_H
+#define TEST_EXPRESSION_LIBRARY_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> expressionLibraryTestCase();
+
+}
+
+#endif
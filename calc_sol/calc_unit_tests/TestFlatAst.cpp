@@ -0,0 +1,145 @@
+#include "stdafx.h"
+
+#include "TestFlatAst.h"
+
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	FlatAst* fa_ast = NULL;
+	StdFunctionLookupTable* fa_flookup = NULL;
+	StdConstantLookupTable* fa_clookup = NULL;
+
+	void fa_setup() {
+		fa_ast = new FlatAst();
+		fa_flookup = new StdFunctionLookupTable();
+		fa_clookup = new StdConstantLookupTable();
+	}
+
+	void fa_cleanup() {
+		delete fa_ast;
+		delete fa_flookup;
+		delete fa_clookup;
+		fa_ast = NULL;
+		fa_flookup = NULL;
+		fa_clookup = NULL;
+	}
+
+	/* RPN text of the AstNode tree or the error */
+	string fa_parseTree(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser sourceParser(source, fa_clookup, fa_flookup);
+		RPNTextVisitor visitor;
+		try {
+			sourceParser.begin();
+			AstNode* ast = sourceParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	/* the same, parsed into fa_ast */
+	string fa_parseFlat(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser sourceParser(source, fa_clookup, fa_flookup);
+		RPNTextVisitor visitor;
+		try {
+			sourceParser.begin().expr(*fa_ast);
+			fa_ast->visitPostOrder(visitor);
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	void fa_testLayout() {
+		CAssert::assertEquals(string("1 2 x * +"), fa_parseFlat("1+2*x"));
+		//post-order: the arguments before the operator
+		CAssert::assertEquals(5, (int)fa_ast->size());
+		CAssert::assertEquals((int)FO_FLOAT, (int)fa_ast->getOpcode(0));
+		CAssert::assertEquals(2.0, fa_ast->getValue(1));
+		CAssert::assertEquals((int)FO_VARIABLE, (int)fa_ast->getOpcode(2));
+		CAssert::assertEquals((int)SYMBOL_X, fa_ast->getSymbol(2));
+		CAssert::assertEquals((int)FO_MUL, (int)fa_ast->getOpcode(3));
+		CAssert::assertEquals(1, fa_ast->getLeft(3));
+		CAssert::assertEquals(2, fa_ast->getRight(3));
+		CAssert::assertEquals(4, fa_ast->getRoot());
+		CAssert::assertEquals((int)FO_ADD, (int)fa_ast->getOpcode(4));
+		CAssert::assertEquals(0, fa_ast->getLeft(4));
+		CAssert::assertEquals(3, fa_ast->getRight(4));
+
+		//the minus is applied to the factor, before the power
+		CAssert::assertEquals(string("x sin - PI ^ 1 -"), fa_parseFlat("-sin(x)^PI - 1"));
+		CAssert::assertEquals((int)FO_CALL, (int)fa_ast->getOpcode(1));
+		CAssert::assertTrue(fa_ast->getFunction(1) == fa_flookup->lookup(string("sin")));
+		CAssert::assertEquals((int)FO_NEGATION, (int)fa_ast->getOpcode(2));
+		CAssert::assertEquals(1, fa_ast->getLeft(2));
+		CAssert::assertEquals((int)FO_CONSTANT, (int)fa_ast->getOpcode(3));
+		CAssert::assertEquals((int)FO_POWER, (int)fa_ast->getOpcode(4));
+		CAssert::assertEquals(6, fa_ast->getRoot());
+	}
+
+	void fa_testSameAsTree() {
+		const char* texts[] = {
+			"1+2*3", "sin(x+1) - PI", "-(x^2.5)/\n(y-E)", "2^3^-4 * -cos(-E) / 1e-3 - ((x))",
+			"1-2-3+4 * 5/6/7", "1 2", "", "1+", "b(1)+2", "sin(1", "x $"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			CAssert::assertEquals(fa_parseTree(texts[i]), fa_parseFlat(texts[i]));
+		}
+	}
+
+	void fa_testAddTree() {
+		stringstream in("exp(x) * -(2 - x) ^ ONE");
+		Parser streamParser(in, fa_clookup, fa_flookup);
+		AstNode* ast = streamParser.begin().expr();
+		fa_ast->clear();
+		CAssert::assertEquals(8, fa_ast->addTree(ast));
+		RPNTextVisitor treeVisitor;
+		ast->visitPostOrder(treeVisitor);
+		RPNTextVisitor flatVisitor;
+		fa_ast->visitPostOrder(flatVisitor);
+		CAssert::assertEquals(treeVisitor.getRPNText(), flatVisitor.getRPNText());
+		delete ast;
+		CAssert::assertTrue(fa_ast->memorySize() >= 9 * 17);
+	}
+
+	void fa_testCalculator() {
+		string text("exp(x) * -(2 - x) ^ ONE + log(x) / PI");
+		stringstream in(text);
+		Parser streamParser(in, fa_clookup, fa_flookup);
+		AstNode* ast = streamParser.begin().expr();
+		Calculator treeCalculator(string("x"), fa_flookup, fa_clookup, ast);
+		delete ast;
+		fa_parseFlat(text);
+		Calculator flatCalculator(string("x"), fa_flookup, fa_clookup, *fa_ast);
+		CAssert::assertEquals(treeCalculator.calculate(0.5), flatCalculator.calculate(0.5));
+		CAssert::assertEquals(treeCalculator.calculate(3.0), flatCalculator.calculate(3.0));
+	}
+
+	auto_ptr<TestCase> flatAstTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("FlatAstTestCase"),
+			fa_setup, fa_cleanup));
+		tc->addTest("fa_testLayout", fa_testLayout);
+		tc->addTest("fa_testSameAsTree", fa_testSameAsTree);
+		tc->addTest("fa_testAddTree", fa_testAddTree);
+		tc->addTest("fa_testCalculator", fa_testCalculator);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_FLAT_AST_H
+#define TEST_FLAT_AST_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> flatAstTestCase();
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include "stdafx.h"
+
+#include "TestFloatConv.h"
+
+#include "..\calc_parser\FloatConv.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <cstring>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	void fc_setup() {
+	}
+
+	void fc_cleanup() {
+	}
+
+	unsigned long long fc_bits(double value) {
+		unsigned long long bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	double fc_parse(string text) {
+		double value = -1.0;
+		CAssert::assertTrue(parseFloat(text.data(), text.data() + text.size(), value));
+		return value;
+	}
+
+	/* the text must be converted to exactly the expected value */
+	void fc_assertParsed(string text, double expected) {
+		CAssert::assertTrue(fc_bits(expected) == fc_bits(fc_parse(text)));
+	}
+
+	void fc_testParse() {
+		fc_assertParsed("0", 0.0);
+		fc_assertParsed("7", 7.0);
+		fc_assertParsed("0.1", 0.1);
+		fc_assertParsed("000.0001", 0.0001);
+		fc_assertParsed("3.1415926535897932384626433832795", 3.1415926535897932384626433832795);
+		fc_assertParsed("123456789012345678901234567890", 123456789012345678901234567890.0);
+		fc_assertParsed("1e23", 1e23);
+		fc_assertParsed("2.5E-3", 2.5e-3);
+		fc_assertParsed("7e+2", 700.0);
+		fc_assertParsed("1.7976931348623157e308", 1.7976931348623157e308);
+		fc_assertParsed("2.2250738585072011e-308", 2.2250738585072011e-308);
+		fc_assertParsed("4.9406564584124654e-324", 4.9406564584124654e-324);
+		fc_assertParsed("-0.5", -0.5);
+	}
+
+	void fc_testParseRounding() {
+		//exactly halfway between two doubles - rounded to even
+		fc_assertParsed("9007199254740993", 9007199254740992.0);
+		fc_assertParsed("9007199254740995", 9007199254740996.0);
+		fc_assertParsed("1.00000000000000011102230246251565404236316680908203125", 1.0);
+		//just above halfway
+		fc_assertParsed("1.00000000000000011102230246251565404236316680908203126", 1.0000000000000002);
+		//more than 19 digits
+		fc_assertParsed("0.30000000000000001665334536937734810635447502136230468750001", 0.30000000000000004);
+	}
+
+	void fc_testParseLimits() {
+		//overflow to infinity, underflow to zero
+		CAssert::assertTrue(fc_parse("1.8e308") > 1.7976931348623157e308);
+		CAssert::assertTrue(fc_parse("1e99999999") > 1.7976931348623157e308);
+		fc_assertParsed("1e-400", 0.0);
+		fc_assertParsed("-1e-400", -0.0);
+		fc_assertParsed("2.4703282292062328e-324", 4.9406564584124654e-324);
+	}
+
+	void fc_testParseSpecial() {
+		CAssert::assertTrue(fc_parse("inf") > 1.7976931348623157e308);
+		CAssert::assertTrue(fc_parse("-inf") < -1.7976931348623157e308);
+		double nan = fc_parse("nan");
+		CAssert::assertTrue(nan != nan);
+	}
+
+	void fc_testSyntax() {
+		const char* invalid[] = {
+			"", "-", "+1", ".5", "1.", "1.e5", "1e", "1e+", "1x", "0x10", "infinity", "NaN", "1 "
+		};
+		for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+			double value = 0.0;
+			CAssert::assertFalse(parseFloat(invalid[i], invalid[i] + strlen(invalid[i]), value));
+		}
+	}
+
+	void fc_testFormat() {
+		CAssert::assertEquals(string("0.1"), formatFloat(0.1));
+		CAssert::assertEquals(string("123456"), formatFloat(123456.0));
+		CAssert::assertEquals(string("-2.5"), formatFloat(-2.5));
+		CAssert::assertEquals(string("0.3333333333333333"), formatFloat(1.0 / 3.0));
+		CAssert::assertEquals(string("0.30000000000000004"), formatFloat(0.1 + 0.2));
+		CAssert::assertEquals(string("1e+300"), formatFloat(1e300));
+		CAssert::assertEquals(string("5e-324"), formatFloat(4.9406564584124654e-324));
+		//2 digit exponents on every C library
+		CAssert::assertEquals(string("1e+20"), formatFloat(1e20));
+		CAssert::assertEquals(string("1e-05"), formatFloat(1e-5));
+		CAssert::assertEquals(string("1.5e+100"), formatFloat(1.5e100));
+		CAssert::assertEquals(string("-0"), formatFloat(-0.0));
+		CAssert::assertEquals(string("inf"), formatFloat(fc_parse("inf")));
+		CAssert::assertEquals(string("-inf"), formatFloat(fc_parse("-inf")));
+		CAssert::assertEquals(string("nan"), formatFloat(fc_parse("nan")));
+	}
+
+	void fc_testRoundTrip() {
+		//pseudo-random bit patterns: every finite value is read back exactly
+		unsigned long long state = 88172645463325252ULL;
+		for (int i = 0; i < 100000; i++) {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			double value;
+			memcpy(&value, &state, sizeof(value));
+			if (value != value) {
+				continue;
+			}
+			char text[FLOAT_TEXT_SIZE];
+			size_t length = formatFloat(value, text);
+			CAssert::assertTrue(length < FLOAT_TEXT_SIZE);
+			double readBack = 0.0;
+			CAssert::assertTrue(parseFloat(text, text + length, readBack));
+			CAssert::assertTrue(fc_bits(value) == fc_bits(readBack));
+		}
+	}
+
+	auto_ptr<TestCase> floatConvTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("FloatConvTestCase"),
+			fc_setup, fc_cleanup));
+		tc->addTest("fc_testParse", fc_testParse);
+		tc->addTest("fc_testParseRounding", fc_testParseRounding);
+		tc->addTest("fc_testParseLimits", fc_testParseLimits);
+		tc->addTest("fc_testParseSpecial", fc_testParseSpecial);
+		tc->addTest("fc_testSyntax", fc_testSyntax);
+		tc->addTest("fc_testFormat", fc_testFormat);
+		tc->addTest("fc_testRoundTrip", fc_testRoundTrip);
+		return tc;
+	}
+
+}
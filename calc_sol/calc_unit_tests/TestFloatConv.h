@@ -0,0 +1,12 @@
+#ifndef TEST_FLOAT_CONV_H
+#define TEST_FLOAT_CONV_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> floatConvTestCase();
+
+}
+
+#endif
@@ -0,0 +1,285 @@
+#include "stdafx.h"
+
+#include "TestFunctionDefinition.h"
+
+#include "..\calc_parser\FunctionDefinition.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\PushParser.h"
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+#include <cmath>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* fd_flookup = NULL;
+	StdConstantLookupTable* fd_clookup = NULL;
+
+	void fd_setup() {
+		fd_flookup = new StdFunctionLookupTable();
+		fd_clookup = new StdConstantLookupTable();
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("g(t) = t^2 + 1"));
+	}
+
+	void fd_cleanup() {
+		delete fd_flookup;
+		delete fd_clookup;
+		fd_flookup = NULL;
+		fd_clookup = NULL;
+	}
+
+	/* RPN text of the tree or the error, parsed by Parser */
+	string fd_parse(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser parser(source, fd_clookup, fd_flookup);
+		AstNode* ast = NULL;
+		try {
+			ast = parser.begin().expr();
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		RPNTextVisitor visitor;
+		ast->visitPostOrder(visitor);
+		delete ast;
+		return visitor.getRPNText();
+	}
+
+	/* the same, by PrecedenceParser into the flat tree */
+	string fd_parseFlat(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser parser(source, fd_clookup, fd_flookup);
+		FlatAst ast;
+		Status status;
+		if (!parser.begin(status) || !parser.expr(ast, status)) {
+			return string("error: ") + status.what();
+		}
+		RPNTextVisitor visitor;
+		ast.visitPostOrder(visitor);
+		return visitor.getRPNText();
+	}
+
+	/* the error of the definition; empty if defined */
+	string fd_define(const string& text) {
+		Status status;
+		FunctionDefinition::define(*fd_flookup, fd_clookup, text, status);
+		return status.what();
+	}
+
+	/* the saved program of the expression */
+	string fd_compiled(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		stringstream saved;
+		Calculator::compile(string("x"), fd_flookup, fd_clookup, source)->save(saved);
+		return saved.str();
+	}
+
+	void fd_testDefine() {
+		Function1Arg* function = fd_flookup->lookup(string("g"));
+		FunctionDefinition* definition = function->getDefinition();
+		CAssert::assertNotNull(definition);
+		CAssert::assertEquals(string("t"), symbolName(definition->getParameter()));
+		RPNTextVisitor visitor;
+		definition->getBody().visitPostOrder(visitor);
+		CAssert::assertEquals(string("t 2 ^ 1 +"), visitor.getRPNText());
+		CAssert::assertEquals(10.0, function->eval(3.0));
+		//a native function has no definition
+		CAssert::assertNull(fd_flookup->lookup(string("sin"))->getDefinition());
+
+		//the parameter before the constant of its name, a let in the body;
+		//the body is a DAG - the parameter is a single node
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("h(E) = let a = E*PI in a/(1 + E)"));
+		CAssert::assertEquals(6, (int)fd_flookup->lookup(string("h"))->getDefinition()->getBody().size());
+		CAssert::assertEquals(string("y PI * 1 y + /"), fd_parse(string("h(y)")));
+		//the value of a let not used is not a part of the body
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("k(t) = let a = sin(t) in t"));
+		CAssert::assertEquals(1, (int)fd_flookup->lookup(string("k"))->getDefinition()->getBody().size());
+		CAssert::assertEquals(string("y"), fd_parse(string("k(y)")));
+	}
+
+	void fd_testInline() {
+		const char* texts[] = {
+			"g(sin(x))", "x sin 2 ^ 1 +",
+			"2*g(sin(x))", "2 x sin 2 ^ 1 + *",
+			"g(g(x)) - g(1)", "x 2 ^ 1 + 2 ^ 1 + 1 2 ^ 1 + -",
+			"let t = 3 in g(t)*t", "3 2 ^ 1 + 3 *",
+			"-g(x+1)", "x 1 + 2 ^ 1 + -",
+			"g(x", "error: Syntax error at 1:3"
+		};
+		for (size_t i = 1; i < sizeof(texts) / sizeof(texts[0]); i += 2) {
+			string text(texts[i - 1]);
+			string expected(texts[i]);
+			CAssert::assertEquals(expected, fd_parse(text));
+			CAssert::assertEquals(expected, fd_parseFlat(text));
+			//the same in the push parser
+			PushParser pushParser(fd_clookup, fd_flookup);
+			try {
+				pushParser.push(text.data(), text.size());
+				RPNTextVisitor visitor;
+				AstNode* ast = pushParser.finish();
+				ast->visitPostOrder(visitor);
+				delete ast;
+				CAssert::assertEquals(expected, visitor.getRPNText());
+			} catch (std::exception& e) {
+				CAssert::assertEquals(expected, string("error: ") + e.what());
+			}
+		}
+		//the functions defined before are inlined into the body
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("h(u) = g(u)*g(u + 1)"));
+		CAssert::assertEquals(string("x 2 ^ 1 + x 1 + 2 ^ 1 + *"), fd_parse("h(x)"));
+	}
+
+	void fd_testNested() {
+		//each level calls the one before twice: the body is twice the
+		//size of the one before, not its square
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("e0(t) = t*t + t"));
+		const int levels = 16;
+		for (int i = 1; i <= levels; i++) {
+			stringstream name;
+			name << "e" << i;
+			stringstream previous;
+			previous << "e" << (i - 1);
+			FunctionDefinition::define(*fd_flookup, fd_clookup,
+				name.str() + "(t) = " + previous.str() + "(" + previous.str() + "(t))");
+			FunctionDefinition* definition = fd_flookup->lookup(name.str())->getDefinition();
+			CAssert::assertEquals((2 << i) + 1, (int)definition->getBody().size());
+		}
+		Function1Arg* function = fd_flookup->lookup(string("e16"));
+		double expected = -0.5;
+		for (int i = 0; i < (1 << levels); i++) {
+			expected = expected * expected + expected;
+		}
+		CAssert::assertEquals(expected, function->eval(-0.5));
+		string text("e16(x)");
+		SourceBuffer source(text.data(), text.size());
+		auto_ptr<Calculator> calculator = Calculator::compile(string("x"), fd_flookup, fd_clookup, source);
+		CAssert::assertEquals(expected, calculator->calculate(-0.5));
+		//the trees of the parsers are the formula written out: e_i
+		//has the tree of e_(i-1) 9 times
+		string small("e2(x)");
+		SourceBuffer smallSource(small.data(), small.size());
+		PrecedenceParser flatParser(smallSource, fd_clookup, fd_flookup);
+		FlatAst flat;
+		flatParser.begin().expr(flat);
+		CAssert::assertEquals(161, (int)flat.size());
+		CAssert::assertEquals(string("error: Syntax error at 1:6 expression too large"), fd_parseFlat(text));
+		CAssert::assertEquals(fd_parseFlat(text), fd_parse(text));
+		//the bodies double at each level: past the limit the function
+		//is not defined
+		CAssert::assertEquals(string(""), fd_define("e17(t) = e16(e16(t))"));
+		CAssert::assertEquals(string(""), fd_define("e18(t) = e17(e17(t))"));
+		CAssert::assertEquals(string("Syntax error at 1:20 function too large"), fd_define("e19(t) = e18(e18(t))"));
+		CAssert::assertFalse(fd_flookup->exists(string("e19")));
+
+		//the argument copied at every use of the parameter: calls nested
+		//20 times are a tree of 3^20 copies - too large for the parsers
+		//of a tree, not for the DAG of the calculator
+		string nested("x");
+		for (int i = 0; i < 20; i++) {
+			nested = "e0(" + nested + ")";
+		}
+		string tooLarge("error: Syntax error at 1:");
+		string error = fd_parse(nested);
+		CAssert::assertEquals(tooLarge, error.substr(0, tooLarge.size()));
+		CAssert::assertEquals(string("expression too large"), error.substr(error.size() - 20));
+		CAssert::assertEquals(error, fd_parseFlat(nested));
+		PushParser pushParser(fd_clookup, fd_flookup);
+		try {
+			pushParser.push(nested.data(), nested.size());
+			delete pushParser.finish();
+			CAssert::assertTrue(false);
+		} catch (SyntaxException& e) {
+			CAssert::assertEquals(error, string("error: ") + e.what());
+		}
+		SourceBuffer nestedSource(nested.data(), nested.size());
+		expected = -0.5;
+		for (int i = 0; i < 20; i++) {
+			expected = expected * expected + expected;
+		}
+		CAssert::assertEquals(expected,
+			Calculator::compile(string("x"), fd_flookup, fd_clookup, nestedSource)->calculate(-0.5));
+
+		//the operations shared in the body are bound: the trees of the
+		//parsers are the formula written out
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("s(t) = let u = sin(t) in u*u + u"));
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("s2(t) = 1 - s(s(t))"));
+		CAssert::assertEquals(string("1 x sin x sin * x sin + sin x sin x sin * x sin + sin * x sin x sin * x sin + sin + -"),
+			fd_parse(string("s2(x)")));
+		CAssert::assertEquals(fd_parse(string("s2(x)")), fd_parseFlat(string("s2(x)")));
+		CAssert::assertEquals(string("2 2 * 2 + 2 2 * 2 + * 2 2 * 2 + +"), fd_parseFlat(string("e1(2)")));
+		double u = sin(0.3);
+		double v = sin(u * u + u);
+		CAssert::assertEquals(1 - (v * v + v), fd_flookup->lookup(string("s2"))->eval(0.3));
+		text = "s2(x) + s(x)";
+		SourceBuffer sharedSource(text.data(), text.size());
+		CAssert::assertEquals(1 - (v * v + v) + (u * u + u),
+			Calculator::compile(string("x"), fd_flookup, fd_clookup, sharedSource)->calculate(0.3));
+	}
+
+	void fd_testCompile() {
+		//the program of the formula written out, the argument computed once
+		CAssert::assertEquals(fd_compiled("let t = x in t^2 + 1"), fd_compiled("g(x)"));
+		CAssert::assertEquals(fd_compiled("let t = sin(x) in t^2 + 1"), fd_compiled("g(sin(x))"));
+		FunctionDefinition::define(*fd_flookup, fd_clookup, string("q(t) = t*(1 - t)"));
+		string text("q(sin(x)) / g(x)");
+		SourceBuffer source(text.data(), text.size());
+		auto_ptr<Calculator> calculator = Calculator::compile(string("x"), fd_flookup, fd_clookup, source);
+		CAssert::assertEquals(1, calculator->getSlotCount());
+		double s = sin(0.5);
+		CAssert::assertEquals(s * (1 - s) / (0.5 * 0.5 + 1), calculator->calculate(0.5));
+
+		//the RPN input calls the function
+		stringstream rpn("x g 2 *");
+		Calculator rpnCalculator(string("x"), fd_flookup, fd_clookup, rpn);
+		CAssert::assertEquals(2 * (3.0 * 3.0 + 1), rpnCalculator.calculate(3.0));
+
+		//an edit of the argument: the whole text is parsed again
+		IncrementalCompiler compiler(string("x"), fd_flookup, fd_clookup);
+		compiler.compile(string("1 + g(x*2)"));
+		compiler.edit(8, 1, string("3"));
+		stringstream saved;
+		compiler.getCalculator().save(saved);
+		CAssert::assertEquals(string("1 x 3 * 2 ^ 1 + +"), saved.str());
+	}
+
+	void fd_testErrors() {
+		CAssert::assertEquals(string("Syntax error at 1:12 unknown variable y"), fd_define("f(t) = t + y"));
+		CAssert::assertEquals(string("Syntax error at 1:2 function already defined g"), fd_define("g(u) = u"));
+		CAssert::assertEquals(string("Syntax error at 1:4 function already defined sin"), fd_define("sin(u) = u"));
+		//no recursion - the function is not defined in its body
+		CAssert::assertEquals(string("Syntax error at 1:11 unknown function f"), fd_define("f(t) = f(t)"));
+		CAssert::assertEquals(string("Syntax error at 1:4"), fd_define("f t = t"));
+		CAssert::assertEquals(string("Syntax error at 1:6"), fd_define("f(let) = 1"));
+		CAssert::assertEquals(string("Syntax error at 1:10"), fd_define("f(t) = t t"));
+		CAssert::assertFalse(fd_flookup->exists(string("f")));
+		try {
+			FunctionDefinition::define(*fd_flookup, fd_clookup, string("f(t) = #"));
+			CAssert::assertTrue(false);
+		} catch (UnknownTokenException&) {
+		}
+		CAssert::assertEquals(string(""), fd_define("f(t) = t"));
+		CAssert::assertTrue(fd_flookup->exists(string("f")));
+	}
+
+	std::auto_ptr<cunit::TestCase> functionDefinitionTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(
+			new TestCase(string("FunctionDefinitionTestCase"),
+			fd_setup, fd_cleanup));
+
+		tc->addTest(string("fd_testDefine"), fd_testDefine);
+		tc->addTest(string("fd_testInline"), fd_testInline);
+		tc->addTest(string("fd_testNested"), fd_testNested);
+		tc->addTest(string("fd_testCompile"), fd_testCompile);
+		tc->addTest(string("fd_testErrors"), fd_testErrors);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_FUNCTION_DEFINITION_H
+#define TEST_FUNCTION_DEFINITION_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> functionDefinitionTestCase();
+
+}
+
+#endif
@@ -0,0 +1,347 @@
+#include "stdafx.h"
+
+#include "TestIncrementalParser.h"
+
+#include "..\calc_parser\IncrementalParser.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\TokenArray.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	FunctionLookupTable* ip_flookup = NULL;
+	ConstantLookupTable* ip_clookup = NULL;
+	IncrementalParser* ip_parser = NULL;
+
+	class ip_DummyFunction : public Function1Arg {
+	public:
+		virtual double eval(double in) {
+			return in;
+		}
+	};
+
+	void ip_setup() {
+		ip_flookup = new FunctionLookupTable();
+		ip_clookup = new ConstantLookupTable();
+		ip_flookup->add(string("a"), new ip_DummyFunction());
+		ip_clookup->add(string("c"), 1.0);
+		ip_parser = new IncrementalParser(ip_clookup, ip_flookup);
+	}
+
+	void ip_cleanup() {
+		delete ip_parser;
+		delete ip_flookup;
+		delete ip_clookup;
+		ip_parser = NULL;
+		ip_flookup = NULL;
+		ip_clookup = NULL;
+	}
+
+	/* RPN text of the flat tree */
+	string ip_rpn(const FlatAst& ast) {
+		RPNTextVisitor visitor;
+		ast.visitPostOrder(visitor);
+		return visitor.getRPNText();
+	}
+
+	/* RPN text of the tree or the error, the whole text parsed */
+	string ip_parse(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser parser(source, ip_clookup, ip_flookup);
+		FlatAst ast;
+		try {
+			parser.begin();
+			parser.expr(ast);
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return ip_rpn(ast);
+	}
+
+	/* the same, the change parsed by the parser */
+	string ip_edit(size_t offset, size_t removedLength, const string& inserted) {
+		try {
+			ip_parser->edit(offset, removedLength, inserted.data(), inserted.size());
+		} catch (std::exception& e) {
+			CAssert::assertFalse(ip_parser->isParsed());
+			return string("error: ") + e.what();
+		}
+		CAssert::assertTrue(ip_parser->isParsed());
+		return ip_rpn(ip_parser->getAst());
+	}
+
+	/* the tokens and the tree of the parser are those of the text parsed again */
+	void ip_assertSameAsParsed() {
+		const string& text = ip_parser->getText();
+		IncrementalParser parsed(ip_clookup, ip_flookup);
+		parsed.parse(text.data(), text.size());
+		const TokenArray& expected = parsed.getTokens();
+		const TokenArray& tokens = ip_parser->getTokens();
+		CAssert::assertEquals((int)expected.size(), (int)tokens.size());
+		for (size_t i = 0; i < expected.size(); i++) {
+			CAssert::assertTrue(expected.getKind(i) == tokens.getKind(i));
+			CAssert::assertEquals((int)expected.getStart(i), (int)tokens.getStart(i));
+			CAssert::assertEquals((int)expected.getEnd(i), (int)tokens.getEnd(i));
+			CAssert::assertEquals(expected.getText(i).str(), tokens.getText(i).str());
+		}
+		CAssert::assertEquals((int)parsed.getParsedEnd(), (int)ip_parser->getParsedEnd());
+		CAssert::assertEquals((int)parsed.getAst().size(), (int)ip_parser->getAst().size());
+		for (size_t i = 0; i < parsed.getAst().size(); i++) {
+			CAssert::assertEquals((int)parsed.getNodeToken((int)i), (int)ip_parser->getNodeToken((int)i));
+		}
+	}
+
+	/* change the text of the parser; the result is that of the whole text */
+	void ip_assertEdit(size_t offset, size_t removedLength, const string& inserted) {
+		string text = ip_parser->getText();
+		text.replace(offset, removedLength, inserted);
+		string expected = ip_parse(text);
+		CAssert::assertEquals(expected, ip_edit(offset, removedLength, inserted));
+		CAssert::assertEquals(text, ip_parser->getText());
+		if (ip_parser->isParsed()) {
+			ip_assertSameAsParsed();
+		}
+	}
+
+	void ip_testRelex() {
+		string before("12+ab*3");
+		TokenArray previous;
+		previous.tokenize(before.data(), before.size());
+		//"ab" becomes "abc": "ab" read the character after it
+		string after("12+abc*3");
+		TokenArray tokens;
+		size_t first, previousEnd, end;
+		tokens.relex(previous, after.data(), after.size(), 5, 0, 1, first, previousEnd, end);
+		CAssert::assertEquals(2, (int)first);
+		CAssert::assertEquals(3, (int)previousEnd);
+		CAssert::assertEquals(3, (int)end);
+		CAssert::assertEquals(6, (int)tokens.size());
+		CAssert::assertEquals(string("abc"), tokens.getText(2).str());
+		CAssert::assertEquals(string("*"), tokens.getText(3).str());
+		CAssert::assertEquals(7, (int)tokens.getStart(4));
+		CAssert::assertEquals(8, (int)tokens.getStart(5));
+
+		//removing "+" joins the floats
+		before = "12+34*ab";
+		previous.tokenize(before.data(), before.size());
+		string joined("1234*ab");
+		tokens.relex(previous, joined.data(), joined.size(), 2, 1, 0, first, previousEnd, end);
+		CAssert::assertEquals(0, (int)first);
+		CAssert::assertEquals(3, (int)previousEnd);
+		CAssert::assertEquals(1, (int)end);
+		CAssert::assertEquals(1234.0, tokens.getValue(0));
+		CAssert::assertEquals(string("ab"), tokens.getText(2).str());
+		CAssert::assertEquals(5, (int)tokens.getStart(2));
+
+		//a name not interned replaced by another one of its length
+		before = "12+ip_old*3";
+		previous.tokenize(before.data(), before.size());
+		CAssert::assertEquals(NO_SYMBOL, previous.getSymbol(2));
+		string renamed("12+ip_new*3");
+		tokens.relex(previous, renamed.data(), renamed.size(), 6, 3, 3, first, previousEnd, end);
+		CAssert::assertEquals(2, (int)first);
+		CAssert::assertEquals(3, (int)end);
+		CAssert::assertEquals(string("ip_new"), tokens.getText(2).str());
+
+		//the same errors as lexing the whole text
+		string wrong("12+34*ab\n+1.");
+		bool thrown = false;
+		try {
+			tokens.relex(previous, wrong.data(), wrong.size(), 8, 0, 4, first, previousEnd, end);
+		} catch (UnknownTokenException& e) {
+			thrown = true;
+			TokenArray expected;
+			try {
+				expected.tokenize(wrong.data(), wrong.size());
+				CAssert::assertTrue(false);
+			} catch (UnknownTokenException& expectedError) {
+				CAssert::assertEquals(string(expectedError.what()), string(e.what()));
+			}
+		}
+		CAssert::assertTrue(thrown);
+		wrong = "12+3$4*ab";
+		thrown = false;
+		try {
+			tokens.relex(previous, wrong.data(), wrong.size(), 4, 0, 1, first, previousEnd, end);
+		} catch (UnknownTokenException& e) {
+			thrown = true;
+			CAssert::assertEquals(string("Unknown token 1:5"), string(e.what()));
+		}
+		CAssert::assertTrue(thrown);
+	}
+
+	void ip_testEdits() {
+		string text("1 - -2 + 3*(4-5) - a(x) - 1e-3 + 2");
+		ip_parser->parse(text.data(), text.size());
+		CAssert::assertEquals(ip_parse(text), ip_rpn(ip_parser->getAst()));
+		ip_assertSameAsParsed();
+
+		//in parentheses
+		ip_assertEdit(text.find("4-5"), 1, "44");
+		CAssert::assertEquals(4, (int)ip_parser->getParsedTokens());
+		CAssert::assertEquals(1, (int)ip_parser->getLexedTokens());
+		//the argument of a call
+		ip_assertEdit(ip_parser->getText().find("x)"), 1, "x*x");
+		CAssert::assertEquals(1, (int)ip_parser->getRemovedNodes());
+		CAssert::assertEquals(3, (int)ip_parser->getAddedNodes());
+		//outside of parentheses
+		ip_assertEdit(0, 1, "7");
+		//a float split and joined
+		ip_assertEdit(ip_parser->getText().find("-3"), 0, " ");
+		ip_assertEdit(ip_parser->getText().find(" -3"), 1, "");
+		//parentheses added and removed
+		ip_assertEdit(0, 0, "(");
+		ip_assertEdit(ip_parser->getText().size(), 0, ")");
+		ip_assertEdit(0, 1, "");
+		ip_assertEdit(ip_parser->getText().size() - 1, 1, "");
+		ip_assertEdit(ip_parser->getText().find("(44"), 1, "");
+		ip_assertEdit(ip_parser->getText().find("44"), 0, "(");
+		//a call becomes a multiplication
+		ip_assertEdit(ip_parser->getText().find("a("), 1, "c*");
+		//in the rest not parsed
+		ip_assertEdit(ip_parser->getText().size(), 0, " 1 (2");
+		ip_assertEdit(ip_parser->getText().size() - 1, 1, "3");
+		CAssert::assertEquals(0, (int)ip_parser->getParsedTokens());
+	}
+
+	void ip_testErrors() {
+		string text("a(x*(1+2)) - 3");
+		ip_parser->parse(text.data(), text.size());
+		//syntax errors, and the text fixed again
+		ip_assertEdit(7, 1, "");
+		ip_assertEdit(7, 0, "2");
+		ip_assertEdit(5, 0, ")");
+		ip_assertEdit(5, 1, "");
+		//lexer errors
+		ip_assertEdit(7, 0, "$");
+		ip_assertEdit(0, 0, "1.");
+		ip_assertEdit(7 + 2, 1, "");
+		ip_assertEdit(0, 2, "");
+		CAssert::assertEquals(ip_parse(text), ip_rpn(ip_parser->getAst()));
+		//an unknown function
+		ip_assertEdit(0, 1, "b");
+		ip_assertEdit(0, 1, "a");
+		//the whole text parsed with an error, then changed
+		bool thrown = false;
+		try {
+			ip_parser->parse("1+", 2);
+		} catch (SyntaxException&) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+		CAssert::assertFalse(ip_parser->isParsed());
+		ip_assertEdit(2, 0, "2");
+		ip_assertEdit(0, 0, "(");
+		ip_assertEdit(4, 0, ")");
+	}
+
+	void ip_testRandomEdits() {
+		const char* pieces[] = {
+			"1", "+", "-", "*", "/", "^", "(", ")", " ", "x", "c", "a(", "2.5", "e", "e-", ".", "\n", "$"
+		};
+		size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+		string text("(1+x)*a(2-(c+3)/x) - (4^(x-1))*-(5+6) + 7");
+		ip_parser->parse(text.data(), text.size());
+		unsigned int seed = 12345;
+		for (int i = 0; i < 3000; i++) {
+			seed = seed * 1103515245 + 12345;
+			size_t size = ip_parser->getText().size();
+			size_t offset = (seed >> 8) % (size + 1);
+			seed = seed * 1103515245 + 12345;
+			size_t removed = (size > 60 || (seed >> 8) % 3 == 0) ? (seed >> 12) % 3 : 0;
+			if (offset + removed > size) {
+				removed = size - offset;
+			}
+			seed = seed * 1103515245 + 12345;
+			string inserted = (size > 80 && (seed >> 8) % 2 == 0) ? string("") : string(pieces[(seed >> 8) % pieceCount]);
+			ip_assertEdit(offset, removed, inserted);
+		}
+	}
+
+	void ip_testLarge() {
+		stringstream text;
+		for (int i = 0; i < 2000; i++) {
+			text << i << ".5*x - (c+" << i << ")/a(" << i << "-x) + ";
+		}
+		text << "1";
+		string source = text.str();
+		ip_parser->parse(source.data(), source.size());
+		CAssert::assertTrue(ip_parser->getParsedTokens() > 10000);
+
+		//a float in the middle, in parentheses
+		size_t offset = source.find("(c+1000)") + 3;
+		ip_assertEdit(offset, 4, "x*1001");
+		CAssert::assertEquals(3, (int)ip_parser->getLexedTokens());
+		CAssert::assertEquals(6, (int)ip_parser->getParsedTokens());
+		CAssert::assertEquals(3, (int)ip_parser->getRemovedNodes());
+		CAssert::assertEquals(5, (int)ip_parser->getAddedNodes());
+		//outside of parentheses the whole text is parsed again
+		offset = source.find("1000.5");
+		ip_assertEdit(offset, 1, "2");
+		CAssert::assertTrue(ip_parser->getParsedTokens() > 10000);
+	}
+
+	void ip_testLet() {
+		string text("let a = 3*(x+1) in a*(a-1) + 2");
+		ip_parser->parse(text.data(), text.size());
+		CAssert::assertEquals(ip_parse(text), ip_rpn(ip_parser->getAst()));
+		ip_assertSameAsParsed();
+		//the value is copied where used - the whole text is parsed
+		ip_assertEdit(text.find("x+1"), 1, "2*x");
+		CAssert::assertEquals((int)ip_parser->getTokens().size() - 1, (int)ip_parser->getParsedTokens());
+		ip_assertEdit(ip_parser->getText().find("a-1"), 3, "1-a");
+		//the let removed and added
+		ip_assertEdit(0, ip_parser->getText().find("in ") + 3, "");
+		ip_assertEdit(0, 0, "let a = x in ");
+		ip_assertEdit(ip_parser->getText().find("= x"), 1, "");
+	}
+
+	/* let bindings nested depth times, each value using the one before
+	three times*/
+	string ip_nestedLets(int depth) {
+		stringstream text;
+		text << "let a0 = x in ";
+		for (int i = 1; i <= depth; i++) {
+			text << "let a" << i << " = a" << (i - 1) << "*a" << (i - 1) << "+a" << (i - 1) << " in ";
+		}
+		text << "a" << depth;
+		return text.str();
+	}
+
+	void ip_testLetTooLarge() {
+		string text = ip_nestedLets(20);
+		CAssert::assertEquals(string("error: Syntax error at 1:269 expression too large"), ip_parse(text));
+		bool thrown = false;
+		try {
+			ip_parser->parse(text.data(), text.size());
+		} catch (SyntaxException&) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+		CAssert::assertFalse(ip_parser->isParsed());
+		//the first bindings removed: a14 is a variable
+		ip_assertEdit(0, text.find("let a15"), "");
+		CAssert::assertTrue(ip_parser->isParsed());
+	}
+
+	auto_ptr<TestCase> incrementalParserTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("IncrementalParserTestCase"),
+			ip_setup, ip_cleanup));
+		tc->addTest("ip_testRelex", ip_testRelex);
+		tc->addTest("ip_testEdits", ip_testEdits);
+		tc->addTest("ip_testErrors", ip_testErrors);
+		tc->addTest("ip_testRandomEdits", ip_testRandomEdits);
+		tc->addTest("ip_testLarge", ip_testLarge);
+		tc->addTest("ip_testLet", ip_testLet);
+		tc->addTest("ip_testLetTooLarge", ip_testLetTooLarge);
+		return tc;
+	}
+
+}
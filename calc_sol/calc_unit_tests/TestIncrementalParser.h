@@ -0,0 +1,12 @@
+#ifndef TEST_INCREMENTAL_PARSER_H
+#define TEST_INCREMENTAL_PARSER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> incrementalParserTestCase();
+
+}
+
+#endif
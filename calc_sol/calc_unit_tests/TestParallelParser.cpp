@@ -0,0 +1,183 @@
+#include "stdafx.h"
+
+#include "TestParallelParser.h"
+
+#include "..\calc_parser\ParallelParser.h"
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "..\calc_parser\Threads.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	FunctionLookupTable* ppr_flookup = NULL;
+	ConstantLookupTable* ppr_clookup = NULL;
+
+	class ppr_DummyFunction : public Function1Arg {
+	public:
+		virtual double eval(double in) {
+			return in;
+		}
+	};
+
+	void ppr_setup() {
+		ppr_flookup = new FunctionLookupTable();
+		ppr_clookup = new ConstantLookupTable();
+		ppr_flookup->add(string("a"), new ppr_DummyFunction());
+		ppr_clookup->add(string("c"), 1.0);
+	}
+
+	void ppr_cleanup() {
+		delete ppr_flookup;
+		delete ppr_clookup;
+		ppr_flookup = NULL;
+		ppr_clookup = NULL;
+	}
+
+	/* RPN text of the AST or the error, parsed by Parser */
+	string ppr_parse(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser sourceParser(source, ppr_clookup, ppr_flookup);
+		RPNTextVisitor visitor;
+		try {
+			sourceParser.begin();
+			AstNode* ast = sourceParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	/* the same, parsed on the threads */
+	string ppr_parseParallel(const string& text, unsigned int threadCount) {
+		SourceBuffer source(text.data(), text.size());
+		ParallelParser parallelParser(source, ppr_clookup, ppr_flookup, threadCount);
+		//parse even the smallest source in parts
+		parallelParser.setMinParallelLength(0);
+		RPNTextVisitor visitor;
+		try {
+			AstNode* ast = parallelParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	void ppr_assertSameAsParser(const string& text) {
+		string expected = ppr_parse(text);
+		CAssert::assertEquals(expected, ppr_parseParallel(text, 2));
+		CAssert::assertEquals(expected, ppr_parseParallel(text, 3));
+		//more parts than characters
+		CAssert::assertEquals(expected, ppr_parseParallel(text, 8));
+	}
+
+	void ppr_testExpressions() {
+		CAssert::assertEquals(string("1 2 3 * +"), ppr_parseParallel("1+2*3", 2));
+		ppr_assertSameAsParser("1+2*3");
+		ppr_assertSameAsParser("1 - -2 + 3*(4-5) - a(x) - 1e-3 + 2");
+		ppr_assertSameAsParser("-(x^2.5)/\n(y-c) + c - 2^-1");
+		ppr_assertSameAsParser("((1+2)-(3-4))");
+		ppr_assertSameAsParser("x*-1-1--1");
+		ppr_assertSameAsParser("longname1 + 12345.6789e+2 - longname2");
+	}
+
+	void ppr_testErrors() {
+		const char* texts[] = {
+			"", "1+", "(1", "1)+2", "b(1)+2", "1 + $", "1+2 + 3 +", "-", "a(", "1.+2", "2e+1+2e"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			ppr_assertSameAsParser(texts[i]);
+		}
+		CAssert::assertEquals(string("error: Syntax error at 1:2"), ppr_parseParallel("1+", 2));
+	}
+
+	void ppr_testRest() {
+		//like Parser::expr, the expression ends before the next token
+		ppr_assertSameAsParser("1 2");
+		ppr_assertSameAsParser("1+2 3+4");
+		ppr_assertSameAsParser("x)(");
+	}
+
+	/* let bindings nested depth times, each value using the one before
+	three times*/
+	string ppr_nestedLets(int depth) {
+		stringstream text;
+		text << "let a0 = x in ";
+		for (int i = 1; i <= depth; i++) {
+			text << "let a" << i << " = a" << (i - 1) << "*a" << (i - 1) << "+a" << (i - 1) << " in ";
+		}
+		text << "a" << depth;
+		return text.str();
+	}
+
+	void ppr_testLetTooLarge() {
+		string text = ppr_nestedLets(20);
+		CAssert::assertEquals(string("error: Syntax error at 1:269 expression too large"), ppr_parse(text));
+		ppr_assertSameAsParser(text);
+		//the terms parsed in parallel copy the values as well
+		ppr_assertSameAsParser(text + " + " + text);
+	}
+
+	void ppr_testLarge() {
+		stringstream text;
+		for (int i = 0; i < 5000; i++) {
+			text << i << ".5*x - (c+" << i << ")/a(" << i << "-y) + ";
+		}
+		text << "1";
+		ppr_assertSameAsParser(text.str());
+		CAssert::assertEquals(ppr_parse(text.str()), ppr_parseParallel(text.str(), 16));
+	}
+
+	/* counts its runs */
+	class ppr_CountTask : public Task {
+	public:
+		int runs;
+
+		ppr_CountTask() : runs(0) {
+		}
+
+		virtual void run() {
+			runs++;
+		}
+	};
+
+	void ppr_testRunTasks() {
+		CAssert::assertTrue(hardwareThreads() >= 1);
+		vector<ppr_CountTask> counts(100);
+		vector<Task*> tasks;
+		for (size_t i = 0; i < counts.size(); i++) {
+			tasks.push_back(&counts[i]);
+		}
+		runTasks(tasks, 4);
+		runTasks(tasks, 1);
+		for (size_t i = 0; i < counts.size(); i++) {
+			CAssert::assertEquals(2, counts[i].runs);
+		}
+		//nothing to do
+		runTasks(vector<Task*>(), 4);
+	}
+
+	auto_ptr<TestCase> parallelParserTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("ParallelParserTestCase"),
+			ppr_setup, ppr_cleanup));
+		tc->addTest("ppr_testExpressions", ppr_testExpressions);
+		tc->addTest("ppr_testErrors", ppr_testErrors);
+		tc->addTest("ppr_testRest", ppr_testRest);
+		tc->addTest("ppr_testLarge", ppr_testLarge);
+		tc->addTest("ppr_testLetTooLarge", ppr_testLetTooLarge);
+		tc->addTest("ppr_testRunTasks", ppr_testRunTasks);
+		return tc;
+	}
+
+}
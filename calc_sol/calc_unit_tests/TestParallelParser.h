@@ -0,0 +1,12 @@
+#ifndef TEST_PARALLEL_PARSER_H
+#define TEST_PARALLEL_PARSER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> parallelParserTestCase();
+
+}
+
+#endif
@@ -1,233 +1,400 @@
-#include "stdafx.h"
-#include "TestParser.h"
-#include "CAssert.h"
-#include "CUnit.h"
-#include "..\calc_parser\Parser.h"
-#include <sstream>
-
-using namespace std;
-using namespace cunit;
-using namespace parser;
-
-namespace parser_tests{
-	using namespace std;
-
-	Parser* parser = NULL;
-	stringstream* pt_s = NULL;
-	RPNTextVisitor* pt_visitor = NULL;
-	AstNode* pt_ast = NULL;
-	FunctionLookupTable* pt_flookup = NULL;
-	ConstantLookupTable* pt_clookup = NULL;
-
-	void pt_setup() {
-		pt_s = new stringstream();
-		pt_flookup = new FunctionLookupTable();
-		pt_clookup = new ConstantLookupTable();
-		parser = new Parser(*pt_s, pt_clookup, pt_flookup);
-		pt_visitor = new RPNTextVisitor();
-		pt_ast = NULL;
-	}
-
-	void pt_cleanup() {
-		delete parser;
-		delete pt_s;
-		delete pt_visitor;
-		delete pt_flookup;
-		delete pt_clookup;
-		if (pt_ast != NULL) {
-			delete pt_ast;
-			pt_ast = NULL;
-		}
-		parser = NULL;
-		pt_s = NULL;
-		pt_visitor = NULL;
-	}
-
-		/*
-	void testMulExpr1() {
-		*pt_s << "1*2";
-		parser->begin();
-		AstNode* pt_ast = parser->factor();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1.0 2.0 *"), pt_visitor->getRPNText());
-	}
-	*/
-
-	void pt_testFactorFloat() {
-		*pt_s << "1";
-		parser->begin();
-		pt_ast = parser->factor();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1"), pt_visitor->getRPNText());
-	}
-
-	void pt_testFactorParenthesis1() {
-		*pt_s << "(1)";
-		parser->begin();
-		pt_ast = parser->factor();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1"), pt_visitor->getRPNText());
-	}
-
-//	void pt_testFactorParenthesis2() {
-//	}
-
-	//void testFactorUnaryNegation1() {
-	//}
-
-	void pt_testAddExpr1() {
-		*pt_s << "1+2";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 +"), pt_visitor->getRPNText());
-	}
-
-	void pt_testAddExpr2() {
-		*pt_s << "1-2";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 -"), pt_visitor->getRPNText());
-	}
-
-	void pt_testAddExpr3() {
-		*pt_s << "1+2-3";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 + 3 -"), pt_visitor->getRPNText());
-	}
-
-	void pt_testAddExpr4Brackets() {
-		*pt_s << "1+(2-3)";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 3 - +"), pt_visitor->getRPNText());
-	}
-
-	void pt_testAddExpr4AndMul() {
-		*pt_s << "1+2*3";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 3 * +"), pt_visitor->getRPNText());
-	}
-
-	void pt_testMulExpr1() {
-		*pt_s << "1*2";
-		parser->begin();
-		AstNode* pt_ast = parser->mulExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 *"), pt_visitor->getRPNText());
-	}
-
-	void pt_testMulExpr2() {
-		*pt_s << "1/2";
-		parser->begin();
-		AstNode* pt_ast = parser->mulExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 /"), pt_visitor->getRPNText());
-	}
-
-	void pt_testMulExpr3() {
-		*pt_s << "1/2*3";
-		parser->begin();
-		AstNode* pt_ast = parser->mulExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 / 3 *"), pt_visitor->getRPNText());
-	}
-
-	void pt_testPower() {
-		*pt_s << "1^2";
-		parser->begin();
-		AstNode* pt_ast = parser->powExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 2 ^"), pt_visitor->getRPNText());
-	}
-
-	void pt_testIdentifier1() {
-		*pt_s << "a";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("a"), pt_visitor->getRPNText());
-	}
-
-	void pt_testIdentifier2() {
-		*pt_s << "1+abc+2";
-		parser->begin();
-		AstNode* pt_ast = parser->addExpr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("1 abc + 2 +"), pt_visitor->getRPNText());
-	}
-
-	class pt_DummyFunction : public Function1Arg {
-	public:
-		virtual double eval(double in) {
-			return in;
-		}
-	};
-
-	void pt_testFunction1Arg_1() {
-		pt_flookup->add(string("a"), new pt_DummyFunction());
-		*pt_s << "a(b)";
-		parser->begin();
-		AstNode* pt_ast = parser->funcCall();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("b a"), pt_visitor->getRPNText());
-	}
-
-	void pt_testFunction1Arg_2() {
-		pt_flookup->add(string("a"), new pt_DummyFunction());
-		*pt_s << "a(b+1)";
-		parser->begin();
-		AstNode* pt_ast = parser->funcCall();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("b 1 + a"), pt_visitor->getRPNText());
-	}
-
-	void pt_testConstant1() {
-		pt_clookup->add(string("c"), 1.0f);
-		*pt_s << "c";
-		parser->begin();
-		AstNode* pt_ast = parser->variable();
-		pt_ast->visitPostOrder(*pt_visitor);
-		CAssert::assertEquals(string("c"), pt_visitor->getRPNText());
-		CAssert::assertNotNull( dynamic_cast<ConstantAstNode*>(pt_ast) );
-	}
-
-	/*void pt_test() {
-		*pt_s << "x^";
-		parser->begin();
-		AstNode* pt_ast = parser->expr();
-		pt_ast->visitPostOrder(*pt_visitor);
-		
-	}*/
-
-	auto_ptr<cunit::TestCase> parserTestCase() {
-		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("ParserTestCase"), pt_setup, pt_cleanup));
-		tc->addTest("pt_testFactorFloat", pt_testFactorFloat);
-		tc->addTest("pt_testFactorParenthesis1", pt_testFactorParenthesis1);
-		//tc->addTest("pt_testFactorParenthesis2", pt_testFactorParenthesis2);
-		//tc->addTest("pt_testFactorUnaryNegation1", pt_testFactorUnaryNegation1);
-		tc->addTest("pt_testAddExpr1", pt_testAddExpr1);
-		tc->addTest("pt_testAddExpr2", pt_testAddExpr2);
-		tc->addTest("pt_testAddExpr3", pt_testAddExpr3);
-		tc->addTest("pt_testAddExpr4Brackets", pt_testAddExpr4Brackets);
-		tc->addTest("pt_testAddExpr4AndMul", pt_testAddExpr4AndMul);
-		tc->addTest("pt_testMulExpr1", pt_testMulExpr1);
-		tc->addTest("pt_testMulExpr2", pt_testMulExpr2);
-		tc->addTest("pt_testMulExpr3", pt_testMulExpr3);
-		tc->addTest("pt_testPower", pt_testPower);
-		tc->addTest("pt_testIdentifier1", pt_testIdentifier1);
-		tc->addTest("pt_testIdentifier2", pt_testIdentifier2);
-		tc->addTest("pt_testFunction1Arg_1", pt_testFunction1Arg_1);
-		tc->addTest("pt_testFunction1Arg_2", pt_testFunction1Arg_2);
-		tc->addTest("pt_testConstant1", pt_testConstant1);
-	//	tc->addTest("pt_test", pt_test);
-		return tc;
-	}
-
+#include "stdafx.h"
+#include "TestParser.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\Arena.h"
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests{
+	using namespace std;
+
+	Parser* parser = NULL;
+	stringstream* pt_s = NULL;
+	RPNTextVisitor* pt_visitor = NULL;
+	AstNode* pt_ast = NULL;
+	FunctionLookupTable* pt_flookup = NULL;
+	ConstantLookupTable* pt_clookup = NULL;
+
+	void pt_setup() {
+		pt_s = new stringstream();
+		pt_flookup = new FunctionLookupTable();
+		pt_clookup = new ConstantLookupTable();
+		parser = new Parser(*pt_s, pt_clookup, pt_flookup);
+		pt_visitor = new RPNTextVisitor();
+		pt_ast = NULL;
+	}
+
+	void pt_cleanup() {
+		delete parser;
+		delete pt_s;
+		delete pt_visitor;
+		delete pt_flookup;
+		delete pt_clookup;
+		if (pt_ast != NULL) {
+			delete pt_ast;
+			pt_ast = NULL;
+		}
+		parser = NULL;
+		pt_s = NULL;
+		pt_visitor = NULL;
+	}
+
+		/*
+	void testMulExpr1() {
+		*pt_s << "1*2";
+		parser->begin();
+		AstNode* pt_ast = parser->factor();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1.0 2.0 *"), pt_visitor->getRPNText());
+	}
+	*/
+
+	void pt_testFactorFloat() {
+		*pt_s << "1";
+		parser->begin();
+		pt_ast = parser->factor();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1"), pt_visitor->getRPNText());
+	}
+
+	void pt_testFactorParenthesis1() {
+		*pt_s << "(1)";
+		parser->begin();
+		pt_ast = parser->factor();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1"), pt_visitor->getRPNText());
+	}
+
+//	void pt_testFactorParenthesis2() {
+//	}
+
+	//void testFactorUnaryNegation1() {
+	//}
+
+	void pt_testAddExpr1() {
+		*pt_s << "1+2";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 +"), pt_visitor->getRPNText());
+	}
+
+	void pt_testAddExpr2() {
+		*pt_s << "1-2";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 -"), pt_visitor->getRPNText());
+	}
+
+	void pt_testAddExpr3() {
+		*pt_s << "1+2-3";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 + 3 -"), pt_visitor->getRPNText());
+	}
+
+	void pt_testAddExpr4Brackets() {
+		*pt_s << "1+(2-3)";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 3 - +"), pt_visitor->getRPNText());
+	}
+
+	void pt_testAddExpr4AndMul() {
+		*pt_s << "1+2*3";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 3 * +"), pt_visitor->getRPNText());
+	}
+
+	void pt_testMulExpr1() {
+		*pt_s << "1*2";
+		parser->begin();
+		AstNode* pt_ast = parser->mulExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 *"), pt_visitor->getRPNText());
+	}
+
+	void pt_testMulExpr2() {
+		*pt_s << "1/2";
+		parser->begin();
+		AstNode* pt_ast = parser->mulExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 /"), pt_visitor->getRPNText());
+	}
+
+	void pt_testMulExpr3() {
+		*pt_s << "1/2*3";
+		parser->begin();
+		AstNode* pt_ast = parser->mulExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 / 3 *"), pt_visitor->getRPNText());
+	}
+
+	void pt_testPower() {
+		*pt_s << "1^2";
+		parser->begin();
+		AstNode* pt_ast = parser->powExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 2 ^"), pt_visitor->getRPNText());
+	}
+
+	void pt_testIdentifier1() {
+		*pt_s << "a";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("a"), pt_visitor->getRPNText());
+	}
+
+	void pt_testIdentifier2() {
+		*pt_s << "1+abc+2";
+		parser->begin();
+		AstNode* pt_ast = parser->addExpr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("1 abc + 2 +"), pt_visitor->getRPNText());
+	}
+
+	class pt_DummyFunction : public Function1Arg {
+	public:
+		virtual double eval(double in) {
+			return in;
+		}
+	};
+
+	void pt_testFunction1Arg_1() {
+		pt_flookup->add(string("a"), new pt_DummyFunction());
+		*pt_s << "a(b)";
+		parser->begin();
+		AstNode* pt_ast = parser->funcCall();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("b a"), pt_visitor->getRPNText());
+	}
+
+	void pt_testFunction1Arg_2() {
+		pt_flookup->add(string("a"), new pt_DummyFunction());
+		*pt_s << "a(b+1)";
+		parser->begin();
+		AstNode* pt_ast = parser->funcCall();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("b 1 + a"), pt_visitor->getRPNText());
+	}
+
+	void pt_testConstant1() {
+		pt_clookup->add(string("c"), 1.0f);
+		*pt_s << "c";
+		parser->begin();
+		AstNode* pt_ast = parser->variable();
+		pt_ast->visitPostOrder(*pt_visitor);
+		CAssert::assertEquals(string("c"), pt_visitor->getRPNText());
+		CAssert::assertNotNull( dynamic_cast<ConstantAstNode*>(pt_ast) );
+	}
+
+	/* Parse the text from the source buffer.
+	Returns: RPN text or the error message */
+	string pt_parseSource(string text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser sourceParser(source, pt_clookup, pt_flookup);
+		RPNTextVisitor visitor;
+		try {
+			sourceParser.begin();
+			AstNode* ast = sourceParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	/* the same as pt_parseSource, from the stream */
+	string pt_parseStream(string text) {
+		stringstream in(text);
+		Parser streamParser(in, pt_clookup, pt_flookup);
+		RPNTextVisitor visitor;
+		try {
+			streamParser.begin();
+			AstNode* ast = streamParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		return visitor.getRPNText();
+	}
+
+	void pt_testSourceBuffer() {
+		pt_flookup->add(string("a"), new pt_DummyFunction());
+		pt_clookup->add(string("c"), 1.0f);
+		CAssert::assertEquals(string("1 2 3 * +"), pt_parseSource("1+2*3"));
+		CAssert::assertEquals(string("b 1 + a c -"), pt_parseSource("a(b+1) - c"));
+		CAssert::assertEquals(pt_parseStream("-(x^2.5)/\n(y-c)"), pt_parseSource("-(x^2.5)/\n(y-c)"));
+	}
+
+	void pt_testSourceBufferErrors() {
+		pt_flookup->add(string("a"), new pt_DummyFunction());
+		const char* texts[] = {
+			"1+", "(1", "1 2", "a(1", "b(1)", "*", "1+\n  )", "x $"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			string result = pt_parseSource(texts[i]);
+			CAssert::assertEquals(pt_parseStream(texts[i]), result);
+		}
+		CAssert::assertEquals(string("error: Syntax error at 1:2"), pt_parseSource("1+"));
+	}
+
+	void pt_testSymbols() {
+		pt_flookup->add(string("a"), new pt_DummyFunction());
+		pt_clookup->add(SYMBOL_PI, 3.0);
+		*pt_s << "a(x) + PI";
+		parser->begin();
+		pt_ast = parser->expr();
+		AddOperatorAstNode* add = dynamic_cast<AddOperatorAstNode*>(pt_ast);
+		CAssert::assertNotNull(add);
+		FunctionCall1ArgAstNode* call = dynamic_cast<FunctionCall1ArgAstNode*>(add->getLeft());
+		CAssert::assertNotNull(call);
+		CAssert::assertEquals(internSymbol(string("a")), call->getSymbol());
+		CAssert::assertTrue(call->getFunction() == pt_flookup->lookup(string("a")));
+		ConstantAstNode* constant = dynamic_cast<ConstantAstNode*>(add->getRight());
+		CAssert::assertNotNull(constant);
+		CAssert::assertEquals((int)SYMBOL_PI, constant->getSymbol());
+		CAssert::assertEquals(string("PI"), constant->getVarIdentifier());
+		CAssert::assertEquals(3.0, constant->getValue());
+	}
+
+	void pt_testLet() {
+		pt_clookup->add(SYMBOL_PI, 3.0);
+		string text("let a = sin(x) in let b = a*PI in (let PI = b in PI) + a/b - PI");
+		string expected("x sin PI * x sin x sin PI * / + PI -");
+		TokenArray tokens;
+		tokens.tokenize(text.data(), text.size());
+		pt_flookup->add(string("sin"), new pt_DummyFunction());
+		Parser tokenParser(tokens, pt_clookup, pt_flookup);
+		RPNTextVisitor visitor;
+		AstNode* ast = tokenParser.begin().expr();
+		ast->visitPostOrder(visitor);
+		delete ast;
+		CAssert::assertEquals(expected, visitor.getRPNText());
+
+		//the values are copied, the flat tree has no other nodes
+		FlatAst flat;
+		tokenParser.begin().expr(flat);
+		RPNTextVisitor flatVisitor;
+		flat.visitPostOrder(flatVisitor);
+		CAssert::assertEquals(expected, flatVisitor.getRPNText());
+		CAssert::assertEquals(14, (int)flat.size());
+
+		//nothing is deleted in the arena
+		Arena arena;
+		Parser arenaParser(tokens, pt_clookup, pt_flookup, &arena);
+		RPNTextVisitor arenaVisitor;
+		arenaParser.begin().expr()->visitPostOrder(arenaVisitor);
+		CAssert::assertEquals(expected, arenaVisitor.getRPNText());
+	}
+
+	/* let bindings nested depth times, each value using the one before
+	three times: the tree is about 2*3^depth nodes*/
+	string pt_nestedLets(int depth) {
+		stringstream text;
+		text << "let a0 = x in ";
+		for (int i = 1; i <= depth; i++) {
+			text << "let a" << i << " = a" << (i - 1) << "*a" << (i - 1) << "+a" << (i - 1) << " in ";
+		}
+		text << "a" << depth;
+		return text.str();
+	}
+
+	void pt_testLetTooLarge() {
+		//below the limit, the tree is the expression written out
+		string small = pt_nestedLets(10);
+		SourceBuffer smallSource(small.data(), small.size());
+		Parser smallParser(smallSource, pt_clookup, pt_flookup);
+		FlatAst smallFlat;
+		smallParser.begin().expr(smallFlat);
+		CAssert::assertEquals(2 * 59049 - 1, (int)smallFlat.size());
+
+		//the copies past the limit: an error, not a tree of 7 billion nodes
+		string text = pt_nestedLets(20);
+		SourceBuffer source(text.data(), text.size());
+		Parser parser(source, pt_clookup, pt_flookup);
+		string error;
+		try {
+			parser.begin().expr();
+		} catch (SyntaxException& e) {
+			error = e.what();
+		}
+		CAssert::assertEquals(string("Syntax error at 1:269 expression too large"), error);
+		FlatAst flat;
+		error.clear();
+		try {
+			parser.begin().expr(flat);
+		} catch (SyntaxException& e) {
+			error = e.what();
+		}
+		CAssert::assertEquals(string("Syntax error at 1:269 expression too large"), error);
+	}
+
+	void pt_testTokenArrayReused() {
+		string text("1+2*x");
+		TokenArray tokens;
+		tokens.tokenize(text.data(), text.size());
+		for (int i = 0; i < 2; i++) {
+			Parser tokenParser(tokens, pt_clookup, pt_flookup);
+			RPNTextVisitor visitor;
+			AstNode* ast = tokenParser.begin().expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+			CAssert::assertEquals(string("1 2 x * +"), visitor.getRPNText());
+		}
+	}
+
+	/*void pt_test() {
+		*pt_s << "x^";
+		parser->begin();
+		AstNode* pt_ast = parser->expr();
+		pt_ast->visitPostOrder(*pt_visitor);
+		
+	}*/
+
+	auto_ptr<cunit::TestCase> parserTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("ParserTestCase"), pt_setup, pt_cleanup));
+		tc->addTest("pt_testFactorFloat", pt_testFactorFloat);
+		tc->addTest("pt_testFactorParenthesis1", pt_testFactorParenthesis1);
+		//tc->addTest("pt_testFactorParenthesis2", pt_testFactorParenthesis2);
+		//tc->addTest("pt_testFactorUnaryNegation1", pt_testFactorUnaryNegation1);
+		tc->addTest("pt_testAddExpr1", pt_testAddExpr1);
+		tc->addTest("pt_testAddExpr2", pt_testAddExpr2);
+		tc->addTest("pt_testAddExpr3", pt_testAddExpr3);
+		tc->addTest("pt_testAddExpr4Brackets", pt_testAddExpr4Brackets);
+		tc->addTest("pt_testAddExpr4AndMul", pt_testAddExpr4AndMul);
+		tc->addTest("pt_testMulExpr1", pt_testMulExpr1);
+		tc->addTest("pt_testMulExpr2", pt_testMulExpr2);
+		tc->addTest("pt_testMulExpr3", pt_testMulExpr3);
+		tc->addTest("pt_testPower", pt_testPower);
+		tc->addTest("pt_testIdentifier1", pt_testIdentifier1);
+		tc->addTest("pt_testIdentifier2", pt_testIdentifier2);
+		tc->addTest("pt_testFunction1Arg_1", pt_testFunction1Arg_1);
+		tc->addTest("pt_testFunction1Arg_2", pt_testFunction1Arg_2);
+		tc->addTest("pt_testConstant1", pt_testConstant1);
+		tc->addTest("pt_testSourceBuffer", pt_testSourceBuffer);
+		tc->addTest("pt_testSourceBufferErrors", pt_testSourceBufferErrors);
+		tc->addTest("pt_testTokenArrayReused", pt_testTokenArrayReused);
+		tc->addTest("pt_testSymbols", pt_testSymbols);
+		tc->addTest("pt_testLet", pt_testLet);
+		tc->addTest("pt_testLetTooLarge", pt_testLetTooLarge);
+	//	tc->addTest("pt_test", pt_test);
+		return tc;
+	}
+
 }
\ No newline at end of file
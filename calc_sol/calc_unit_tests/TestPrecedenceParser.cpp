@@ -0,0 +1,317 @@
+#include "stdafx.h"
+
+#include "TestPrecedenceParser.h"
+
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* pr_flookup = NULL;
+	StdConstantLookupTable* pr_clookup = NULL;
+
+	void pr_setup() {
+		pr_flookup = new StdFunctionLookupTable();
+		pr_clookup = new StdConstantLookupTable();
+	}
+
+	void pr_cleanup() {
+		delete pr_flookup;
+		delete pr_clookup;
+		pr_flookup = NULL;
+		pr_clookup = NULL;
+	}
+
+	/* RPN text of the AST or the error and the index of the
+	first token not parsed, parsed by Parser*/
+	string pr_parse(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		Parser sourceParser(source, pr_clookup, pr_flookup);
+		RPNTextVisitor visitor;
+		try {
+			sourceParser.begin();
+			AstNode* ast = sourceParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		stringstream result;
+		result << visitor.getRPNText() << " @" << sourceParser.getTokenIndex();
+		return result.str();
+	}
+
+	/* the same, parsed by PrecedenceParser into the tree */
+	string pr_parsePrecedence(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser precedenceParser(source, pr_clookup, pr_flookup);
+		RPNTextVisitor visitor;
+		try {
+			precedenceParser.begin();
+			AstNode* ast = precedenceParser.expr();
+			ast->visitPostOrder(visitor);
+			delete ast;
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		stringstream result;
+		result << visitor.getRPNText() << " @" << precedenceParser.getTokenIndex();
+		return result.str();
+	}
+
+	/* the same, parsed into the flat tree */
+	string pr_parsePrecedenceFlat(const string& text) {
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser precedenceParser(source, pr_clookup, pr_flookup);
+		FlatAst ast;
+		RPNTextVisitor visitor;
+		try {
+			precedenceParser.begin().expr(ast);
+			ast.visitPostOrder(visitor);
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+		stringstream result;
+		result << visitor.getRPNText() << " @" << precedenceParser.getTokenIndex();
+		return result.str();
+	}
+
+	void pr_assertSameAsParser(const string& text) {
+		string expected = pr_parse(text);
+		CAssert::assertEquals(expected, pr_parsePrecedence(text));
+		CAssert::assertEquals(expected, pr_parsePrecedenceFlat(text));
+	}
+
+	void pr_testExpressions() {
+		CAssert::assertEquals(string("1 2 3 * + @5"), pr_parsePrecedence("1+2*3"));
+		//left associative power, the minus belongs to the factor
+		CAssert::assertEquals(string("2 3 ^ 4 ^ @5"), pr_parsePrecedence("2^3^4"));
+		CAssert::assertEquals(string("2 - 2 ^ @4"), pr_parsePrecedence("-2^2"));
+		pr_assertSameAsParser("1+2*3");
+		pr_assertSameAsParser("sin(x+1) - PI");
+		pr_assertSameAsParser("-(x^2.5)/\n(y-E)");
+		pr_assertSameAsParser("2^3^-4 * -cos(-E) / 1e-3 - ((x))");
+		pr_assertSameAsParser("1-2-3+4 * 5/6/7 ^ 8 - 9");
+		pr_assertSameAsParser("x*-1-1--1 + -(-(-x))");
+		pr_assertSameAsParser("exp(-log(x)^2) * ((1+x)*(1-x))/-ONE");
+	}
+
+	void pr_testErrors() {
+		const char* texts[] = {
+			"", "1+", "(1", "sin(1", "b(1)+2", "x $", "-", "--1", "sin(", "1 * (2 + )", "sin()", "(1 2)", "*1",
+			"1+-", "sin(x)(", "cos(1)+b(sin(2))"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			pr_assertSameAsParser(texts[i]);
+		}
+		CAssert::assertEquals(string("error: Syntax error at 1:6 unknown function b"), pr_parsePrecedence("b(1)+2"));
+	}
+
+	void pr_testRest() {
+		//like Parser::expr, the expression ends before the next token
+		pr_assertSameAsParser("1 2");
+		pr_assertSameAsParser("x)(");
+		pr_assertSameAsParser("(1+2) ~ 3");
+		pr_assertSameAsParser("sin(x) sin(x)");
+	}
+
+	/* random expression of the grammar */
+	void pr_randomExpr(stringstream& out, unsigned int& seed, int depth) {
+		//a small linear congruential generator - the same on all platforms
+		seed = seed * 1103515245 + 12345;
+		int terms = 1 + (int)((seed >> 16) % 4);
+		static const char* operators[] = { " + ", "-", "*", " / ", "^" };
+		static const char* names[] = { "x", "PI", "E", "y" };
+		static const char* functions[] = { "sin", "cos", "exp", "log" };
+		for (int i = 0; i < terms; i++) {
+			seed = seed * 1103515245 + 12345;
+			unsigned int r = seed >> 16;
+			if (i > 0) {
+				out << operators[r % 5];
+			}
+			if (r / 5 % 3 == 0) {
+				out << "-";
+			}
+			switch (depth > 0 ? r / 15 % 4 : r / 15 % 2) {
+			case 0:
+				out << r % 100;
+				break;
+			case 1:
+				out << names[r / 60 % 4];
+				break;
+			case 2:
+				out << "(";
+				pr_randomExpr(out, seed, depth - 1);
+				out << ")";
+				break;
+			default:
+				out << functions[r / 60 % 4] << "(";
+				pr_randomExpr(out, seed, depth - 1);
+				out << ")";
+				break;
+			}
+		}
+	}
+
+	void pr_testRandom() {
+		unsigned int seed = 1;
+		for (int i = 0; i < 500; i++) {
+			stringstream out;
+			pr_randomExpr(out, seed, 4);
+			pr_assertSameAsParser(out.str());
+		}
+	}
+
+	void pr_testLet() {
+		CAssert::assertEquals(string("x 1 + x 1 + * @10"), pr_parsePrecedence("let a = x+1 in a*a"));
+		const char* texts[] = {
+			"let a = x+1 in a*a",
+			"let a = 2 in let b = a*x in b/a - b",
+			"let a = let b = sin(x) in b*b in a+a",
+			//the constant and the variable are hidden by the name
+			"-(let E = 2 in E^x) + E",
+			"cos(let x = x*2 in x) * x",
+			"let a = 1 in let a = a+1 in a",
+			"let a = 1 in (a)",
+			//the rest is not parsed
+			"let a = 1 in a in 2",
+			"let a = x in a a",
+			//errors
+			"let", "let a", "let a =", "let a = 1", "let a = 1 in", "let 1 = 2 in 3",
+			"let in = 1 in 2", "let a 1 in a", "(let a = 1)", "(1 in 2)", "1 + let a = 1 in a",
+			"-let a = 1 in a", "x = 1", "let(1)", "in", "sin(let a = 1)", "let a = 1 in (a in 2)",
+			"(let a = 1 in a", "let a = (1 in a", "a(let a = 1 in a)"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			pr_assertSameAsParser(texts[i]);
+		}
+	}
+
+	/* random let expression of the names y and E (a variable and a
+	constant where not bound)*/
+	void pr_randomLet(stringstream& out, unsigned int& seed, int depth) {
+		seed = seed * 1103515245 + 12345;
+		unsigned int r = seed >> 16;
+		if (depth == 0 || r % 3 == 0) {
+			pr_randomExpr(out, seed, 2);
+			return;
+		}
+		out << "let " << (r / 3 % 2 == 0 ? "y" : "E") << " = ";
+		pr_randomLet(out, seed, depth - 1);
+		out << " in ";
+		if (r / 6 % 2 == 0) {
+			out << "(";
+			pr_randomLet(out, seed, depth - 1);
+			out << ")*y";
+		} else {
+			pr_randomLet(out, seed, depth - 1);
+		}
+	}
+
+	void pr_testLetRandom() {
+		unsigned int seed = 7;
+		for (int i = 0; i < 300; i++) {
+			stringstream out;
+			pr_randomLet(out, seed, 3);
+			pr_assertSameAsParser(out.str());
+		}
+	}
+
+	/* let bindings nested depth times, each value using the one before
+	three times*/
+	string pr_nestedLets(int depth) {
+		stringstream text;
+		text << "let a0 = x in ";
+		for (int i = 1; i <= depth; i++) {
+			text << "let a" << i << " = a" << (i - 1) << "*a" << (i - 1) << "+a" << (i - 1) << " in ";
+		}
+		text << "a" << depth;
+		return text.str();
+	}
+
+	void pr_testLetTooLarge() {
+		string text = pr_nestedLets(20);
+		string expected("error: Syntax error at 1:269 expression too large");
+		CAssert::assertEquals(expected, pr_parse(text));
+		CAssert::assertEquals(expected, pr_parsePrecedence(text));
+		CAssert::assertEquals(expected, pr_parsePrecedenceFlat(text));
+		//the error in the status
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser parser(source, pr_clookup, pr_flookup);
+		FlatAst ast;
+		Status status;
+		CAssert::assertTrue(parser.begin(status));
+		CAssert::assertFalse(parser.expr(ast, status));
+		CAssert::assertEquals(expected, string("error: ") + status.what());
+	}
+
+	/* value of the text parsed into the flat tree */
+	double pr_calculateFlat(const string& text, double x) {
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser precedenceParser(source, pr_clookup, pr_flookup);
+		FlatAst ast;
+		precedenceParser.begin().expr(ast);
+		Calculator calculator(string("x"), pr_flookup, pr_clookup, ast);
+		return calculator.calculate(x);
+	}
+
+	void pr_testDeepNesting() {
+		//much deeper than the native stack allows for Parser
+		const int depth = 100000;
+		string parens = string(depth, '(') + "x" + string(depth, ')');
+		CAssert::assertEquals(2.0, pr_calculateFlat(parens, 2.0));
+
+		stringstream negations;
+		for (int i = 0; i < depth; i++) {
+			negations << "-(";
+		}
+		negations << "x" << string(depth, ')');
+		CAssert::assertEquals(2.0, pr_calculateFlat(negations.str(), 2.0));
+
+		stringstream sums;
+		for (int i = 0; i < depth; i++) {
+			sums << "1+exp(0*x)*(";
+		}
+		sums << "x" << string(depth, ')');
+		CAssert::assertEquals(depth + 2.0, pr_calculateFlat(sums.str(), 2.0));
+
+		string unclosed = string(depth, '(') + "x" + string(depth - 1, ')');
+		SourceBuffer source(unclosed.data(), unclosed.size());
+		PrecedenceParser precedenceParser(source, pr_clookup, pr_flookup);
+		FlatAst ast;
+		bool thrown = false;
+		try {
+			precedenceParser.begin().expr(ast);
+		} catch (SyntaxException&) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+	}
+
+	auto_ptr<TestCase> precedenceParserTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("PrecedenceParserTestCase"),
+			pr_setup, pr_cleanup));
+		tc->addTest("pr_testExpressions", pr_testExpressions);
+		tc->addTest("pr_testErrors", pr_testErrors);
+		tc->addTest("pr_testRest", pr_testRest);
+		tc->addTest("pr_testRandom", pr_testRandom);
+		tc->addTest("pr_testDeepNesting", pr_testDeepNesting);
+		tc->addTest("pr_testLet", pr_testLet);
+		tc->addTest("pr_testLetRandom", pr_testLetRandom);
+		tc->addTest("pr_testLetTooLarge", pr_testLetTooLarge);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_PRECEDENCE_PARSER_H
+#define TEST_PRECEDENCE_PARSER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> precedenceParserTestCase();
+
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "stdafx.h"
+
+#include "TestPushLexer.h"
+
+#include "..\calc_parser\PushLexer.h"
+#include "..\calc_parser\DfaLexer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	/* writes every token it receives: kind, text, offset, value, position */
+	class pl_TextSink : public TokenSink {
+	public:
+		stringstream out;
+
+		virtual void token(const Token& token, int lineNo, int charNo) {
+			out << token.kind << "'" << token.text.str() << "'@" << token.offset
+				<< "=" << (token.kind == LK_FLOAT ? token.value : 0.0) << "#" << token.symbol
+				<< "[" << lineNo << ":" << charNo << "] ";
+		}
+	};
+
+	PushLexer* pl_lexer = NULL;
+	pl_TextSink* pl_sink = NULL;
+
+	void pl_setup() {
+		pl_lexer = new PushLexer();
+		pl_sink = new pl_TextSink();
+	}
+
+	void pl_cleanup() {
+		delete pl_lexer;
+		delete pl_sink;
+		pl_lexer = NULL;
+		pl_sink = NULL;
+	}
+
+	/* the same description of all tokens, read by DfaLexer */
+	string pl_dfaTokens(const string& text) {
+		stringstream in(text);
+		stringstream out;
+		DfaLexer lexer;
+		Token token;
+		try {
+			LexemKind kind;
+			do {
+				kind = lexer.next(in, token);
+				out << token.kind << "'" << token.text.str() << "'@" << token.offset
+					<< "=" << (token.kind == LK_FLOAT ? token.value : 0.0) << "#" << token.symbol
+					<< "[" << lexer.getLineNo() << ":" << lexer.getCharNo() << "] ";
+			} while (kind != LK_EOF);
+		} catch (UnknownTokenException& e) {
+			out << "error: " << e.what();
+		}
+		return out.str();
+	}
+
+	/* push the text in chunks of the given sizes (the last one repeated) */
+	string pl_pushTokens(const string& text, size_t first, size_t next) {
+		PushLexer lexer;
+		pl_TextSink sink;
+		try {
+			size_t p = 0;
+			size_t chunk = first;
+			while (p < text.size()) {
+				//copy the chunk - its characters are gone after the call
+				string part = text.substr(p, chunk);
+				lexer.push(part.data(), part.size(), sink);
+				p += part.size();
+				chunk = next;
+			}
+			lexer.finish(sink);
+		} catch (UnknownTokenException& e) {
+			sink.out << "error: " << e.what();
+		}
+		return sink.out.str();
+	}
+
+	/* every split into 2 chunks and chunks of 1 character
+	produce the same tokens as DfaLexer */
+	void pl_assertSameAsDfaLexer(const string& text) {
+		string expected = pl_dfaTokens(text);
+		CAssert::assertEquals(expected, pl_pushTokens(text, text.size(), text.size()));
+		CAssert::assertEquals(expected, pl_pushTokens(text, 1, 1));
+		for (size_t split = 0; split <= text.size(); split++) {
+			CAssert::assertEquals(expected, pl_pushTokens(text, split, text.size()));
+		}
+	}
+
+	void pl_testEmpty() {
+		CAssert::assertEquals(string("0''@0=0#-1[1:0] "), pl_pushTokens("", 1, 1));
+		pl_assertSameAsDfaLexer("");
+		pl_assertSameAsDfaLexer(" \n ");
+	}
+
+	void pl_testTokens() {
+		pl_assertSameAsDfaLexer("1+2");
+		pl_assertSameAsDfaLexer(" sin(x1) *2.5");
+		pl_assertSameAsDfaLexer(" sin(x) * 2.5 ^ -y / (3-4) ~ ");
+		pl_assertSameAsDfaLexer("a1b2_c3+_\n\t1.25\r\n2");
+		pl_assertSameAsDfaLexer("1.5e-3 2E+10 7e2 inf nan info");
+		pl_assertSameAsDfaLexer("123456789.123456789 longidentifier");
+	}
+
+	void pl_testSplitToken() {
+		pl_lexer->push("12", 2, *pl_sink);
+		pl_lexer->push(".", 1, *pl_sink);
+		pl_lexer->push("5e", 2, *pl_sink);
+		CAssert::assertEquals(string(""), pl_sink->out.str());
+		pl_lexer->push("1+a", 3, *pl_sink);
+		CAssert::assertEquals(string("1'12.5e1'@0=125#-1[1:7] 3'+'@6=0#-1[1:8] "), pl_sink->out.str());
+		pl_lexer->finish(*pl_sink);
+		CAssert::assertTrue(pl_lexer->isEof());
+		stringstream expected;
+		expected << "1'12.5e1'@0=125#-1[1:7] 3'+'@6=0#-1[1:8] 2'a'@7=0#"
+			<< internSymbol(string("a")) << "[1:8] 0''@8=0#-1[1:8] ";
+		CAssert::assertEquals(expected.str(), pl_sink->out.str());
+	}
+
+	void pl_testErrors() {
+		pl_assertSameAsDfaLexer("1 +\n $");
+		pl_assertSameAsDfaLexer("1. + 2");
+		pl_assertSameAsDfaLexer("1 + 2.");
+		pl_assertSameAsDfaLexer("3e+");
+		pl_assertSameAsDfaLexer("3e+x");
+		pl_assertSameAsDfaLexer("x1.5");
+	}
+
+	auto_ptr<TestCase> pushLexerTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("PushLexerTestCase"),
+			pl_setup, pl_cleanup));
+		tc->addTest("pl_testEmpty", pl_testEmpty);
+		tc->addTest("pl_testTokens", pl_testTokens);
+		tc->addTest("pl_testSplitToken", pl_testSplitToken);
+		tc->addTest("pl_testErrors", pl_testErrors);
+		return tc;
+	}
+
+}
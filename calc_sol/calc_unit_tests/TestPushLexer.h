@@ -0,0 +1,12 @@
+#ifndef TEST_PUSH_LEXER_H
+#define TEST_PUSH_LEXER_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> pushLexerTestCase();
+
+}
+
+#endif
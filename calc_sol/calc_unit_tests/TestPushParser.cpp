@@ -0,0 +1,181 @@
+#include "stdafx.h"
+
+#include "TestPushParser.h"
+
+#include "..\calc_parser\PushParser.h"
+#include "..\calc_parser\Parser.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	FunctionLookupTable* pp_flookup = NULL;
+	ConstantLookupTable* pp_clookup = NULL;
+
+	class pp_DummyFunction : public Function1Arg {
+	public:
+		virtual double eval(double in) {
+			return in;
+		}
+	};
+
+	void pp_setup() {
+		pp_flookup = new FunctionLookupTable();
+		pp_clookup = new ConstantLookupTable();
+		pp_flookup->add(string("a"), new pp_DummyFunction());
+		pp_clookup->add(string("c"), 1.0);
+	}
+
+	void pp_cleanup() {
+		delete pp_flookup;
+		delete pp_clookup;
+		pp_flookup = NULL;
+		pp_clookup = NULL;
+	}
+
+	string pp_rpnText(AstNode* ast) {
+		RPNTextVisitor visitor;
+		ast->visitPostOrder(visitor);
+		delete ast;
+		return visitor.getRPNText();
+	}
+
+	/* RPN text of the AST or the error, parsed by Parser */
+	string pp_parseStream(const string& text) {
+		stringstream in(text);
+		Parser streamParser(in, pp_clookup, pp_flookup);
+		try {
+			streamParser.begin();
+			return pp_rpnText(streamParser.expr());
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+	}
+
+	/* the same, pushed in chunks of the given sizes (the last one repeated) */
+	string pp_parsePushed(const string& text, size_t first, size_t next) {
+		PushParser pushParser(pp_clookup, pp_flookup);
+		try {
+			size_t p = 0;
+			size_t chunk = first;
+			while (p < text.size()) {
+				//copy the chunk - its characters are gone after the call
+				string part = text.substr(p, chunk);
+				pushParser.push(part.data(), part.size());
+				p += part.size();
+				chunk = next;
+			}
+			return pp_rpnText(pushParser.finish());
+		} catch (std::exception& e) {
+			return string("error: ") + e.what();
+		}
+	}
+
+	/* every split into 2 chunks and chunks of 1 character
+	produce the same AST or error as Parser */
+	void pp_assertSameAsParser(const string& text) {
+		string expected = pp_parseStream(text);
+		CAssert::assertEquals(expected, pp_parsePushed(text, text.size(), text.size()));
+		CAssert::assertEquals(expected, pp_parsePushed(text, 1, 1));
+		for (size_t split = 0; split <= text.size(); split++) {
+			CAssert::assertEquals(expected, pp_parsePushed(text, split, text.size()));
+		}
+	}
+
+	void pp_testExpressions() {
+		CAssert::assertEquals(string("1 2 3 * +"), pp_parsePushed("1+2*3", 1, 1));
+		pp_assertSameAsParser("1+2*3");
+		pp_assertSameAsParser("a(b+1) - c");
+		pp_assertSameAsParser("-(x^2.5)/\n(y-c)");
+		pp_assertSameAsParser("2^3^-4 * -a(-c) / 1e-3 - ((x))");
+		pp_assertSameAsParser("1-2-3+4 * 5/6/7");
+		pp_assertSameAsParser("longname1 + 12345.6789e+2");
+	}
+
+	void pp_testErrors() {
+		const char* texts[] = {
+			"", "1+", "(1", "a(1", "b(1)", "a(1)+b(2)", "*", "1+\n  )", "x $", "-", "a(", "1.", "2e"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			pp_assertSameAsParser(texts[i]);
+		}
+		CAssert::assertEquals(string("error: Syntax error at 1:2"), pp_parsePushed("1+", 1, 1));
+	}
+
+	void pp_testRest() {
+		//like Parser::expr, the expression ends before the next token
+		pp_assertSameAsParser("1 2");
+		pp_assertSameAsParser("x)(");
+		PushParser pushParser(pp_clookup, pp_flookup);
+		pushParser.push("1+x", 3);
+		CAssert::assertFalse(pushParser.isComplete());
+		//the token 7 ends at the space
+		pushParser.push(" 7", 2);
+		CAssert::assertFalse(pushParser.isComplete());
+		pushParser.push(" ", 1);
+		CAssert::assertTrue(pushParser.isComplete());
+		pushParser.push(" 8", 2);
+		CAssert::assertEquals(string("1 x +"), pp_rpnText(pushParser.finish()));
+	}
+
+	void pp_testIncomplete() {
+		//the partial tree is deleted with the parser
+		PushParser pushParser(pp_clookup, pp_flookup);
+		pushParser.push("-(1 + a(2 * ", 12);
+		CAssert::assertFalse(pushParser.isComplete());
+	}
+
+	void pp_testLet() {
+		const char* texts[] = {
+			"let b = x+1 in b*b",
+			"let c = 2 in c*c + a(let d = c in d)",
+			"let b = let d = 1 in d in (b) - b",
+			"let b = 1 in b 2",
+			"let", "let b = 1", "(let b = 1)", "let b = 1 in", "let let = 1 in 2", "1 + in",
+			"let b = 1 in (b in 2)"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			pp_assertSameAsParser(texts[i]);
+		}
+		CAssert::assertEquals(string("x 1 + x 1 + *"), pp_parsePushed("let b = x+1 in b*b", 1, 1));
+	}
+
+	/* let bindings nested depth times, each value using the one before
+	three times*/
+	string pp_nestedLets(int depth) {
+		stringstream text;
+		text << "let a0 = x in ";
+		for (int i = 1; i <= depth; i++) {
+			text << "let a" << i << " = a" << (i - 1) << "*a" << (i - 1) << "+a" << (i - 1) << " in ";
+		}
+		text << "a" << depth;
+		return text.str();
+	}
+
+	void pp_testLetTooLarge() {
+		string text = pp_nestedLets(20);
+		string expected("error: Syntax error at 1:269 expression too large");
+		CAssert::assertEquals(expected, pp_parseStream(text));
+		CAssert::assertEquals(expected, pp_parsePushed(text, text.size(), text.size()));
+		CAssert::assertEquals(expected, pp_parsePushed(text, 1, 1));
+	}
+
+	auto_ptr<TestCase> pushParserTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("PushParserTestCase"),
+			pp_setup, pp_cleanup));
+		tc->addTest("pp_testExpressions", pp_testExpressions);
+		tc->addTest("pp_testErrors", pp_testErrors);
+		tc->addTest("pp_testRest", pp_testRest);
+		tc->addTest("pp_testIncomplete", pp_testIncomplete);
+		tc->addTest("pp_testLet", pp_testLet);
+		tc->addTest("pp_testLetTooLarge", pp_testLetTooLarge);
+		return tc;
+	}
+
+}
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+
+#include "TestSharedAst.h"
+
+#include "..\calc_parser\SharedAst.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\FlatAst.h"
+#include "..\calc_parser\Calculator.h"
+#include "..\calc_parser\SourceBuffer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* sa_flookup = NULL;
+	StdConstantLookupTable* sa_clookup = NULL;
+
+	void sa_setup() {
+		sa_flookup = new StdFunctionLookupTable();
+		sa_clookup = new StdConstantLookupTable();
+	}
+
+	void sa_cleanup() {
+		delete sa_flookup;
+		delete sa_clookup;
+		sa_flookup = NULL;
+		sa_clookup = NULL;
+	}
+
+	/* parse the text into the DAG; returns the nodes eliminated */
+	int sa_build(const string& text, FlatAst& dag, vector<int>& uses) {
+		SourceBuffer source(text.data(), text.size());
+		PrecedenceParser parser(source, sa_clookup, sa_flookup);
+		SharedAstBuilder builder(dag);
+		int root;
+		Status status;
+		parser.begin().expr(builder, root, status);
+		status.raise();
+		builder.countUses(root, uses);
+		//leaves shared are not counted
+		CAssert::assertTrue(dag.size() <= builder.getAddedCount() - builder.getEliminatedCount());
+		return (int)builder.getEliminatedCount();
+	}
+
+	auto_ptr<Calculator> sa_compile(const string& text, bool shareSubexpressions) {
+		SourceBuffer source(text.data(), text.size());
+		return Calculator::compile(string("x"), sa_flookup, sa_clookup, source, shareSubexpressions);
+	}
+
+	void sa_testSharing() {
+		FlatAst dag;
+		vector<int> uses;
+		//x sin, shared by the multiplication
+		CAssert::assertEquals(1, sa_build("sin(x)*sin(x)", dag, uses));
+		CAssert::assertEquals(3, (int)dag.size());
+		CAssert::assertEquals((int)FO_CALL, (int)dag.getOpcode(1));
+		CAssert::assertEquals(2, uses[1]);
+		CAssert::assertEquals(1, dag.getLeft(2));
+		CAssert::assertEquals(1, dag.getRight(2));
+		CAssert::assertEquals(0, uses[2]);
+
+		//the leaves are shared, the differences are not
+		CAssert::assertEquals(0, sa_build("x-1 + (1-x)", dag, uses));
+		CAssert::assertEquals(5, (int)dag.size());
+		CAssert::assertEquals(2, uses[0]);
+		CAssert::assertEquals(2, uses[1]);
+
+		//a shared node uses its arguments once
+		CAssert::assertEquals(2, sa_build("exp(sin(x))/exp(sin(x))", dag, uses));
+		CAssert::assertEquals(1, uses[1]);
+		CAssert::assertEquals(2, uses[2]);
+
+		CAssert::assertEquals(0, sa_build("-(2^PI)", dag, uses));
+		CAssert::assertEquals(4, (int)dag.size());
+	}
+
+	void sa_testCompile() {
+		const char* texts[] = {
+			"x",
+			"sin(x)*sin(x) + sin(x)^2 / (1 + sin(x))",
+			"exp(sin(x))/exp(sin(x)) - sin(x)",
+			"(sin(x)+sin(x)) * (cos(x)+cos(x)) * (sin(x)+sin(x))",
+			"-(x^2.5)/(x-E) * -(x^2.5) / -(-(x^2.5))",
+			"((x+1)*(x+1) - (x+1)) * ((x+1)*(x+1) - (x+1))"
+		};
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			auto_ptr<Calculator> plain = sa_compile(texts[i], false);
+			auto_ptr<Calculator> shared = sa_compile(texts[i], true);
+			//the program is saved as parsed
+			stringstream plainText, sharedText;
+			plain->save(plainText);
+			shared->save(sharedText);
+			CAssert::assertEquals(plainText.str(), sharedText.str());
+			//the same operations on the same values (no NaN - never equal)
+			for (double x = 0.1; x < 4.0; x += 0.3) {
+				CAssert::assertTrue(plain->calculate(x) == shared->calculate(x));
+			}
+			CAssert::assertEquals(0, (int)plain->getEliminatedCount());
+			CAssert::assertEquals(0, plain->getSlotCount());
+		}
+		auto_ptr<Calculator> shared = sa_compile(texts[1], true);
+		//sin(x) loaded 3 times
+		CAssert::assertEquals(3, (int)shared->getEliminatedCount());
+		CAssert::assertEquals(1, shared->getSlotCount());
+		//a leaf is pushed again - no work saved
+		CAssert::assertEquals(0, (int)sa_compile("x+x", true)->getEliminatedCount());
+		//x+1 loaded twice, then the difference - its 5 operations
+		CAssert::assertEquals(1 + 1 + 5, (int)sa_compile(texts[5], true)->getEliminatedCount());
+		//sin(x)+sin(x) is kept while cos(x) is kept
+		shared = sa_compile(texts[3], true);
+		CAssert::assertEquals(2, shared->getSlotCount());
+		//the slot of x+1 is free after its last use, the difference reuses it
+		shared = sa_compile(texts[5], true);
+		CAssert::assertEquals(1, shared->getSlotCount());
+		CAssert::assertEquals(4.0, shared->calculate(1.0));
+	}
+
+	void sa_testErrors() {
+		const char* texts[] = { "1+", "y+1", "y+(1", "sin(y)*sin(y)", "foo(x)" };
+		for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+			string expected, message;
+			try {
+				sa_compile(texts[i], false);
+			} catch (std::exception& e) {
+				expected = e.what();
+			}
+			try {
+				sa_compile(texts[i], true);
+			} catch (std::exception& e) {
+				message = e.what();
+			}
+			CAssert::assertFalse(expected.empty());
+			CAssert::assertEquals(expected, message);
+		}
+	}
+
+	void sa_testDeep() {
+		//every level shares exp(0*x) with all the others
+		const int depth = 100000;
+		stringstream sums;
+		for (int i = 0; i < depth; i++) {
+			sums << "1+exp(0*x)*(";
+		}
+		sums << "x" << string(depth, ')');
+		auto_ptr<Calculator> shared = sa_compile(sums.str(), true);
+		CAssert::assertEquals(depth + 2.0, shared->calculate(2.0));
+		CAssert::assertEquals(1, shared->getSlotCount());
+		//exp and the product of each level but the first
+		CAssert::assertEquals(2 * (depth - 1), (int)shared->getEliminatedCount());
+	}
+
+	auto_ptr<TestCase> sharedAstTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("SharedAstTestCase"),
+			sa_setup, sa_cleanup));
+		tc->addTest("sa_testSharing", sa_testSharing);
+		tc->addTest("sa_testCompile", sa_testCompile);
+		tc->addTest("sa_testErrors", sa_testErrors);
+		tc->addTest("sa_testDeep", sa_testDeep);
+		return tc;
+	}
+
+}
@@ -0,0 +1,271 @@
+#include "stdafx.h"
+
+#include "TestStatus.h"
+
+#include "..\calc_parser\Status.h"
+#include "..\calc_parser\BufferLexer.h"
+#include "..\calc_parser\TokenArray.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\Calculator.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <exception>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+using namespace calc;
+
+namespace parser_tests {
+
+	StdFunctionLookupTable* st_flookup = NULL;
+	StdConstantLookupTable* st_clookup = NULL;
+
+	/* valid and invalid expressions - every kind of error */
+	const char* st_corpus[] = {
+		"x+1",
+		"sin(x)*-2^x",
+		"1 2",
+		"",
+		"#",
+		"1+$",
+		"1.",
+		"1.5e",
+		"2e+ 1",
+		"1+",
+		"(1+2",
+		"1+2)",
+		"sin(x",
+		"sinx(1)",
+		"-(x*",
+		"y+1",
+		"\n\nx*(1+\nz)",
+		"log(x))+((",
+		NULL
+	};
+
+	void st_setup() {
+		st_flookup = new StdFunctionLookupTable();
+		st_clookup = new StdConstantLookupTable();
+	}
+
+	void st_cleanup() {
+		delete st_flookup;
+		delete st_clookup;
+		st_flookup = NULL;
+		st_clookup = NULL;
+	}
+
+	/* message of the exception of raise; empty if none */
+	string st_raised(const Status& status) {
+		try {
+			status.raise();
+		} catch (exception& e) {
+			return string(e.what());
+		}
+		return string();
+	}
+
+	void st_testMessages() {
+		Status status;
+		CAssert::assertTrue(status.isOk());
+		CAssert::assertEquals(string(), status.what());
+		CAssert::assertEquals(string(), st_raised(status));
+
+		status.setUnknownToken(2, 5);
+		CAssert::assertFalse(status.isOk());
+		CAssert::assertEquals((int)Status::ST_UNKNOWN_TOKEN, (int)status.getKind());
+		CAssert::assertEquals(2, status.getLineNo());
+		CAssert::assertEquals(5, status.getCharNo());
+		CAssert::assertEquals(string(UnknownTokenException(2, 5).what()), status.what());
+		CAssert::assertEquals(status.what(), st_raised(status));
+
+		status.setUnknownToken(1, 3, "float cannot end with dot '.'");
+		CAssert::assertEquals(string(UnknownTokenException(1, 3, string("float cannot end with dot '.'")).what()),
+			status.what());
+		CAssert::assertEquals(status.what(), st_raised(status));
+		status.setUnknownToken(-1, -1, "no position");
+		CAssert::assertEquals(string("no position"), status.what());
+		CAssert::assertEquals(status.what(), st_raised(status));
+
+		status.setSyntaxError(1, 7);
+		CAssert::assertEquals(string(SyntaxException(1, 7).what()), status.what());
+		CAssert::assertEquals(status.what(), st_raised(status));
+		status.setSyntaxError(1, 7, "unknown function ", internSymbol(string("foo")));
+		CAssert::assertEquals(string("unknown function foo"), status.getText());
+		CAssert::assertEquals(string(SyntaxException(1, 7, string("unknown function foo")).what()),
+			status.what());
+		CAssert::assertEquals(status.what(), st_raised(status));
+
+		//statement errors are thrown by the calculator
+		status.setStatementError(1, "unknown variable name");
+		CAssert::assertEquals(1, status.getSymbolNo());
+		CAssert::assertEquals(string(StatementException(1, string("unknown variable name")).what()),
+			status.what());
+		CAssert::assertEquals(string(), st_raised(status));
+
+		status.clear();
+		CAssert::assertTrue(status.isOk());
+	}
+
+	void st_testLexer() {
+		string text("1 + $ 2");
+		BufferLexer lexer(text.data(), text.size());
+		Status status;
+		CAssert::assertEquals((int)LK_FLOAT, (int)lexer.next(status));
+		CAssert::assertEquals((int)LK_PLUS, (int)lexer.next(status));
+		CAssert::assertTrue(status.isOk());
+		CAssert::assertEquals((int)LK_EOF, (int)lexer.next(status));
+		CAssert::assertEquals(string("Unknown token 1:5"), status.what());
+		//the lexer stops at the error
+		CAssert::assertTrue(lexer.isEof());
+		CAssert::assertEquals((int)LK_EOF, (int)lexer.next(status));
+
+		for (int i = 0; st_corpus[i] != NULL; i++) {
+			string text(st_corpus[i]);
+			string thrown;
+			TokenArray tokens;
+			try {
+				tokens.tokenize(text.data(), text.size());
+			} catch (UnknownTokenException& e) {
+				thrown = e.what();
+			}
+			Status status;
+			bool ok = tokens.tokenize(text.data(), text.size(), status);
+			CAssert::assertEquals(thrown.empty(), ok);
+			CAssert::assertEquals(thrown, status.what());
+			//the tokens end with LK_EOF anyway
+			CAssert::assertEquals((int)LK_EOF, (int)tokens.getKind(tokens.size() - 1));
+		}
+	}
+
+	void st_testParser() {
+		for (int i = 0; st_corpus[i] != NULL; i++) {
+			string text(st_corpus[i]);
+			SourceBuffer source(text.data(), text.size());
+			string thrown;
+			FlatAst thrownAst;
+			try {
+				PrecedenceParser parser(source, st_clookup, st_flookup);
+				parser.begin().expr(thrownAst);
+			} catch (exception& e) {
+				thrown = e.what();
+			}
+			PrecedenceParser parser(source, st_clookup, st_flookup);
+			Status status;
+			FlatAst ast;
+			bool ok = parser.begin(status) && parser.expr(ast, status);
+			CAssert::assertEquals(thrown.empty(), ok);
+			CAssert::assertEquals(thrown, status.what());
+			if (ok) {
+				CAssert::assertEquals((int)thrownAst.size(), (int)ast.size());
+			}
+		}
+	}
+
+	void st_testCompile() {
+		for (int share = 0; share < 2; share++) {
+			for (int i = 0; st_corpus[i] != NULL; i++) {
+				string text(st_corpus[i]);
+				SourceBuffer source(text.data(), text.size());
+				string thrown;
+				double expected = 0.0;
+				try {
+					auto_ptr<Calculator> calculator = Calculator::compile(string("x"),
+						st_flookup, st_clookup, source, share != 0);
+					expected = calculator->calculate(2.0);
+				} catch (exception& e) {
+					thrown = e.what();
+				}
+				Status status;
+				auto_ptr<Calculator> calculator = Calculator::compile(string("x"),
+					st_flookup, st_clookup, source, status, share != 0);
+				CAssert::assertEquals(thrown, status.what());
+				CAssert::assertEquals(thrown.empty(), calculator.get() != NULL);
+				if (calculator.get() != NULL) {
+					CAssert::assertEquals(expected, calculator->calculate(2.0));
+				}
+			}
+		}
+		//an unknown variable is a statement error
+		Status status;
+		string text("y+1");
+		Calculator::compile(string("x"), st_flookup, st_clookup,
+			SourceBuffer(text.data(), text.size()), status);
+		CAssert::assertEquals((int)Status::ST_STATEMENT_ERROR, (int)status.getKind());
+		//the status is cleared by the next compile
+		Calculator::compile(string("y"), st_flookup, st_clookup,
+			SourceBuffer(text.data(), text.size()), status);
+		CAssert::assertTrue(status.isOk());
+	}
+
+	void st_testCreate() {
+		//RPN programs - every kind of error
+		const char* texts[] = {
+			"x 1 +",
+			"x sin 2 ~ *",
+			"",
+			"1 +",
+			"1 2",
+			"x y +",
+			"sinx",
+			"1 ( +",
+			"1 $",
+			NULL
+		};
+		for (int i = 0; texts[i] != NULL; i++) {
+			string text(texts[i]);
+			string thrown;
+			double expected = 0.0;
+			try {
+				stringstream stream(text);
+				Calculator calculator(string("x"), st_flookup, st_clookup, stream);
+				expected = calculator.calculate(2.0);
+			} catch (exception& e) {
+				thrown = e.what();
+			}
+			SourceBuffer source(text.data(), text.size());
+			Status status;
+			stringstream stream(text);
+			auto_ptr<Calculator> calculators[3];
+			calculators[0] = Calculator::create(string("x"), st_flookup, st_clookup, stream, status);
+			CAssert::assertEquals(thrown, status.what());
+			calculators[1] = Calculator::create(string("x"), st_flookup, st_clookup, source, status);
+			CAssert::assertEquals(thrown, status.what());
+			TokenArray tokens;
+			if (tokens.tokenize(source, status)) {
+				calculators[2] = Calculator::create(string("x"), st_flookup, st_clookup, tokens, status);
+				CAssert::assertEquals(thrown, status.what());
+			}
+			for (int j = 0; j < 3; j++) {
+				if (calculators[j].get() != NULL) {
+					CAssert::assertEquals(expected, calculators[j]->calculate(2.0));
+				}
+			}
+			CAssert::assertEquals(thrown.empty(), calculators[1].get() != NULL);
+		}
+		//the symbol number and the reason of a statement error
+		Status status;
+		string text("x 1 + y");
+		Calculator::create(string("x"), st_flookup, st_clookup,
+			SourceBuffer(text.data(), text.size()), status);
+		CAssert::assertEquals((int)Status::ST_STATEMENT_ERROR, (int)status.getKind());
+		CAssert::assertEquals(4, status.getSymbolNo());
+		CAssert::assertEquals(string("illegal symbol. not a function, constant or variable"),
+			status.getText());
+	}
+
+	auto_ptr<TestCase> statusTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("StatusTestCase"),
+			st_setup, st_cleanup));
+		tc->addTest("st_testMessages", st_testMessages);
+		tc->addTest("st_testLexer", st_testLexer);
+		tc->addTest("st_testParser", st_testParser);
+		tc->addTest("st_testCompile", st_testCompile);
+		tc->addTest("st_testCreate", st_testCreate);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_STATUS_H
+#define TEST_STATUS_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> statusTestCase();
+
+}
+
+#endif
@@ -0,0 +1,264 @@
+#include "stdafx.h"
+
+#include "TestSymbolTable.h"
+
+#include "..\calc_parser\SymbolTable.h"
+#include "..\calc_parser\Parser.h"
+#include "..\calc_parser\PrecedenceParser.h"
+#include "..\calc_parser\PushParser.h"
+#include "..\calc_parser\TokenArray.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	SymbolTable* sy_table = NULL;
+
+	/* tables created by static initializers, maybe before those of
+	the parser library*/
+	ConstantLookupTable sy_staticConstants;
+	FunctionLookupTable sy_staticFunctions;
+	static const unsigned int sy_staticVersion = sy_staticFunctions.getVersion();
+
+	void sy_setup() {
+		sy_table = new SymbolTable();
+	}
+
+	void sy_cleanup() {
+		delete sy_table;
+		sy_table = NULL;
+	}
+
+	void sy_testBuiltins() {
+		CAssert::assertEquals((int)SYMBOL_X, sy_table->find(string("x")));
+		CAssert::assertEquals((int)SYMBOL_SIN, sy_table->find(string("sin")));
+		CAssert::assertEquals((int)SYMBOL_PI, sy_table->intern(string("PI")));
+		CAssert::assertEquals(string("log"), sy_table->getName(SYMBOL_LOG));
+		CAssert::assertEquals((int)BUILTIN_SYMBOL_COUNT, (int)sy_table->size());
+		//the shared table starts with the same symbols
+		CAssert::assertEquals((int)SYMBOL_E, symbolTable().find(string("E")));
+	}
+
+	void sy_testIntern() {
+		CAssert::assertEquals(NO_SYMBOL, sy_table->find(string("abc")));
+		int abc = sy_table->intern(string("abc"));
+		CAssert::assertEquals((int)BUILTIN_SYMBOL_COUNT, abc);
+		CAssert::assertEquals(abc, sy_table->intern("abcd", 3));
+		CAssert::assertEquals(abc, sy_table->find(string("abc")));
+		CAssert::assertTrue(sy_table->intern(string("ab")) != abc);
+		CAssert::assertEquals(string("abc"), sy_table->getName(abc));
+	}
+
+	void sy_testGrow() {
+		//every name keeps its symbol while the hash table grows
+		for (int i = 0; i < 1000; i++) {
+			stringstream name;
+			name << "v" << i;
+			CAssert::assertEquals(BUILTIN_SYMBOL_COUNT + i, sy_table->intern(name.str()));
+		}
+		for (int i = 0; i < 1000; i++) {
+			stringstream name;
+			name << "v" << i;
+			CAssert::assertEquals(BUILTIN_SYMBOL_COUNT + i, sy_table->find(name.str()));
+			CAssert::assertEquals(name.str(), sy_table->getName(BUILTIN_SYMBOL_COUNT + i));
+		}
+		CAssert::assertEquals((int)SYMBOL_COS, sy_table->find(string("cos")));
+	}
+
+	void sy_testLookupTable() {
+		ConstantLookupTable constants;
+		CAssert::assertFalse(constants.exists(SYMBOL_PI));
+		constants.add(SYMBOL_PI, 3.0);
+		constants.add(string("sy_constant"), 2.0);
+		double value = 0.0;
+		CAssert::assertTrue(constants.find(SYMBOL_PI, value));
+		CAssert::assertEquals(3.0, value);
+		CAssert::assertTrue(constants.find(internSymbol(string("sy_constant")), value));
+		CAssert::assertEquals(2.0, value);
+		CAssert::assertEquals(2.0, constants.lookup(string("sy_constant")));
+		CAssert::assertFalse(constants.find(SYMBOL_E, value));
+		CAssert::assertFalse(constants.find(NO_SYMBOL, value));
+		CAssert::assertFalse(constants.exists(string("sy_unknown")));
+	}
+
+	/* the slots of a table */
+	class SySlotsTable : public ConstantLookupTable {
+	public:
+		size_t slots() const {
+			return keys.size();
+		}
+	};
+
+	void sy_testLookupTableSparse() {
+		SySlotsTable constants;
+		//a symbol far above the others takes a slot, not an array of its size
+		constants.add(5000000, 1.0);
+		CAssert::assertEquals(8, (int)constants.slots());
+		//symbols in the same slot are probed
+		for (int i = 1; i <= 100; i++) {
+			constants.add(i * 1024, (double)i);
+		}
+		CAssert::assertEquals(256, (int)constants.slots());
+		for (int i = 1; i <= 100; i += 2) {
+			constants.remove(i * 1024);
+		}
+		for (int i = 1; i <= 100; i++) {
+			CAssert::assertEquals(i % 2 == 0, constants.exists(i * 1024));
+		}
+		CAssert::assertEquals(1.0, constants.lookup(5000000));
+		//the slot of a symbol removed is used again
+		constants.add(3 * 1024, 33.0);
+		CAssert::assertEquals(33.0, constants.lookup(3 * 1024));
+		CAssert::assertEquals(256, (int)constants.slots());
+		CAssert::assertFalse(constants.exists(7));
+	}
+
+	void sy_testLookupTableChange() {
+		static const BuiltinElements<double> builtins = {
+			{ false, false, false, false, false, false, false, true, false, false, false },
+			{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0 }
+		};
+		ConstantLookupTable constants(&builtins);
+		int symbol = internSymbol(string("sy_changed"));
+		unsigned int version = constants.getVersion();
+		//replace adds a new one
+		constants.replace(symbol, 1.0);
+		CAssert::assertEquals(1.0, constants.lookup(symbol));
+		CAssert::assertTrue(constants.getVersion() != version);
+		version = constants.getVersion();
+		constants.replace(symbol, 2.0);
+		CAssert::assertEquals(2.0, constants.lookup(symbol));
+		CAssert::assertTrue(constants.getVersion() != version);
+		version = constants.getVersion();
+		CAssert::assertEquals(2.0, constants.remove(symbol));
+		CAssert::assertFalse(constants.exists(symbol));
+		CAssert::assertTrue(constants.getVersion() != version);
+		constants.add(symbol, 3.0);
+		CAssert::assertEquals(3.0, constants.lookup(symbol));
+		//the builtin ones stay
+		const char* error = NULL;
+		try {
+			constants.replace(SYMBOL_PI, 1.0);
+		} catch (const char* e) {
+			error = e;
+		}
+		CAssert::assertTrue(error != NULL);
+		CAssert::assertEquals(3.0, constants.lookup(SYMBOL_PI));
+	}
+
+	void sy_testStaticLookupTable() {
+		CAssert::assertTrue(sy_staticVersion != 0);
+		CAssert::assertTrue(sy_staticConstants.getVersion() != sy_staticVersion);
+		ConstantLookupTable constants;
+		CAssert::assertTrue(constants.getVersion() != sy_staticConstants.getVersion());
+		CAssert::assertTrue(constants.getVersion() != sy_staticVersion);
+		int symbol = internSymbol(string("sy_static"));
+		sy_staticConstants.add(symbol, 4.0);
+		CAssert::assertEquals(4.0, sy_staticConstants.lookup(symbol));
+		sy_staticConstants.remove(symbol);
+	}
+
+	void sy_testBuiltinHash() {
+		const char* names[] = { "x", "sin", "cos", "exp", "log", "ONE", "ZERO", "PI", "E", "let", "in" };
+		for (int symbol = 0; symbol < BUILTIN_SYMBOL_COUNT; symbol++) {
+			string name(names[symbol]);
+			CAssert::assertEquals(symbol, findBuiltinSymbol(name.data(), name.size()));
+			CAssert::assertEquals(name, sy_table->getName(symbol));
+		}
+		//other names, also in the slots of builtin names
+		const char* others[] = { "", "X", "e", "y", "si", "sinx", "cin", "PIE", "ZERO_", "on", "nis", "lt", "In", NULL };
+		for (int i = 0; others[i] != NULL; i++) {
+			string name(others[i]);
+			CAssert::assertEquals(NO_SYMBOL, findBuiltinSymbol(name.data(), name.size()));
+		}
+		CAssert::assertEquals(NO_SYMBOL, sy_table->find(string("sinx")));
+		CAssert::assertEquals((int)BUILTIN_SYMBOL_COUNT, sy_table->intern(string("sinx")));
+	}
+
+	void sy_testBuiltinElements() {
+		static const BuiltinElements<double> builtins = {
+			{ false, false, false, false, false, false, false, true, false, false, false },
+			{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0 }
+		};
+		ConstantLookupTable constants(&builtins);
+		double value = 0.0;
+		CAssert::assertTrue(constants.exists(SYMBOL_PI));
+		CAssert::assertTrue(constants.find(SYMBOL_PI, value));
+		CAssert::assertEquals(3.0, value);
+		CAssert::assertFalse(constants.find(SYMBOL_E, value));
+		CAssert::assertFalse(constants.find(NO_SYMBOL, value));
+		//the constants added are layered on the builtin ones
+		constants.add(SYMBOL_E, 2.0);
+		constants.add(string("sy_layered"), 4.0);
+		CAssert::assertEquals(2.0, constants.lookup(SYMBOL_E));
+		CAssert::assertEquals(4.0, constants.lookup(string("sy_layered")));
+		CAssert::assertEquals(3.0, constants.lookup(string("PI")));
+		//a builtin is not defined again
+		bool thrown = false;
+		try {
+			constants.add(SYMBOL_PI, 1.0);
+		} catch (const char*) {
+			thrown = true;
+		}
+		CAssert::assertTrue(thrown);
+		CAssert::assertEquals(3.0, constants.lookup(SYMBOL_PI));
+	}
+
+	void sy_testInternDefinedOnly() {
+		//the lexer only finds the names
+		string text("sy_misspelt(1) + 2");
+		TokenArray tokens;
+		tokens.tokenize(text.data(), text.size());
+		CAssert::assertEquals(NO_SYMBOL, tokens.getSymbol(0));
+		//the error names the function, which is not interned
+		FunctionLookupTable functions;
+		PrecedenceParser precedenceParser(tokens, NULL, &functions);
+		FlatAst ast;
+		Status status;
+		CAssert::assertFalse(precedenceParser.begin().expr(ast, status));
+		CAssert::assertEquals(string("Syntax error at 1:17 unknown function sy_misspelt"), status.what());
+		PushParser pushParser(NULL, &functions);
+		try {
+			pushParser.push(text.data(), text.size());
+			pushParser.finish();
+			CAssert::assertTrue(false);
+		} catch (SyntaxException& e) {
+			CAssert::assertEquals(string(status.what()), string(e.what()));
+		}
+		CAssert::assertEquals(NO_SYMBOL, symbolTable().find(string("sy_misspelt")));
+
+		//the let name and the variable of the tree are interned; the
+		//tokens lexed before find them
+		text = "let sy_bound = 1 in sy_bound + sy_free";
+		tokens.tokenize(text.data(), text.size());
+		CAssert::assertEquals(NO_SYMBOL, tokens.getSymbol(1));
+		CAssert::assertTrue(precedenceParser.begin().expr(ast, status));
+		CAssert::assertEquals(tokens.getSymbol(1), tokens.getSymbol(5));
+		CAssert::assertEquals(symbolTable().find(string("sy_bound")), tokens.getSymbol(5));
+		CAssert::assertEquals(symbolTable().find(string("sy_free")), ast.getSymbol(ast.size() - 2));
+		CAssert::assertTrue(tokens.getSymbol(7) != NO_SYMBOL);
+	}
+
+	auto_ptr<TestCase> symbolTableTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("SymbolTableTestCase"),
+			sy_setup, sy_cleanup));
+		tc->addTest("sy_testBuiltins", sy_testBuiltins);
+		tc->addTest("sy_testIntern", sy_testIntern);
+		tc->addTest("sy_testGrow", sy_testGrow);
+		tc->addTest("sy_testLookupTable", sy_testLookupTable);
+		tc->addTest("sy_testLookupTableSparse", sy_testLookupTableSparse);
+		tc->addTest("sy_testLookupTableChange", sy_testLookupTableChange);
+		tc->addTest("sy_testStaticLookupTable", sy_testStaticLookupTable);
+		tc->addTest("sy_testBuiltinHash", sy_testBuiltinHash);
+		tc->addTest("sy_testBuiltinElements", sy_testBuiltinElements);
+		tc->addTest("sy_testInternDefinedOnly", sy_testInternDefinedOnly);
+		return tc;
+	}
+
+}
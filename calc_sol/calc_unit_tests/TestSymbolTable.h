@@ -0,0 +1,12 @@
+#ifndef TEST_SYMBOL_TABLE_H
+#define TEST_SYMBOL_TABLE_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> symbolTableTestCase();
+
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "stdafx.h"
+
+#include "TestToken.h"
+
+#include "..\calc_parser\Token.h"
+#include "..\calc_parser\DfaLexer.h"
+#include "..\calc_parser\BufferLexer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	stringstream* tk_s = NULL;
+
+	void tk_setup() {
+		tk_s = new stringstream();
+	}
+
+	void tk_cleanup() {
+		delete tk_s;
+		tk_s = NULL;
+	}
+
+	/* kind, text, value and offset of every token, or the error message */
+	string tk_dump(TokenSource& lexer) {
+		stringstream out;
+		Token token;
+		try {
+			while (lexer.next(token) != LK_EOF) {
+				out << token.kind << "'" << token.text.str() << "'@" << token.offset
+					<< "#" << token.symbol;
+				if (token.kind == LK_FLOAT) {
+					out << "=" << token.value;
+				}
+				out << " ";
+			}
+			out << "eof@" << token.offset;
+		} catch (UnknownTokenException& e) {
+			out << "error: " << e.what();
+		}
+		out << " line=" << lexer.getLineNo() << " char=" << lexer.getCharNo();
+		return out.str();
+	}
+
+	void tk_assertSameTokens(string text) {
+		stringstream in(text);
+		StreamTokenSource streamLexer(in);
+		BufferLexer bufferLexer(text.data(), text.size());
+		CAssert::assertEquals(tk_dump(bufferLexer), tk_dump(streamLexer));
+	}
+
+	void tk_testStreamTokens() {
+		*tk_s << " sin(x1) *2.5";
+		int x1 = internSymbol(string("x1"));
+		DfaLexer lexer;
+		Token token;
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_IDENTIFIER);
+		CAssert::assertTrue(token.text.equals("sin"));
+		CAssert::assertEquals((int)SYMBOL_SIN, token.symbol);
+		CAssert::assertEquals(1, (int)token.offset);
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_OPAREN);
+		CAssert::assertEquals(4, (int)token.offset);
+		//the same token object is filled again
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_IDENTIFIER);
+		CAssert::assertTrue(token.kind == LK_IDENTIFIER);
+		CAssert::assertEquals(string("x1"), token.text.str());
+		CAssert::assertEquals(5, (int)token.offset);
+		CAssert::assertEquals(x1, token.symbol);
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_CPAREN);
+		CAssert::assertEquals(NO_SYMBOL, token.symbol);
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_MUL);
+		CAssert::assertEquals(9, (int)token.offset);
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_FLOAT);
+		CAssert::assertEquals(2.5, token.value);
+		CAssert::assertEquals(10, (int)token.offset);
+		CAssert::assertTrue(lexer.next(*tk_s, token) == LK_EOF);
+		CAssert::assertTrue(lexer.isEof());
+	}
+
+	void tk_testSameTokens() {
+		tk_assertSameTokens("1+2");
+		tk_assertSameTokens("((1))");
+		tk_assertSameTokens(" sin(x) * 2.5 ^ -y / (3-4) ~ ");
+		tk_assertSameTokens("a1b2_c3+_\n\t1.25\r\n2");
+		tk_assertSameTokens("1 2\n3 4\n");
+		tk_assertSameTokens("");
+		tk_assertSameTokens("1e5 2.5E-3*7e+2/1E0 inf nan info e");
+	}
+
+	void tk_testSameErrors() {
+		tk_assertSameTokens("1 $");
+		tk_assertSameTokens("1$");
+		tk_assertSameTokens("ab\n 2 # 3");
+		tk_assertSameTokens("1.+2");
+		tk_assertSameTokens("2\n1.");
+		tk_assertSameTokens("1e+2 1ex");
+		tk_assertSameTokens("2.5e\n");
+		tk_assertSameTokens("3e-");
+	}
+
+	void tk_testToLexem() {
+		Token token;
+		CAssert::assertNull(toLexem(token).get());
+
+		token.kind = LK_FLOAT;
+		token.value = 1.5;
+		auto_ptr<Lexem> lexem = toLexem(token);
+		FloatLexem* floatLexem = dynamic_cast<FloatLexem*>(lexem.get());
+		CAssert::assertNotNull(floatLexem);
+		CAssert::assertEquals(1.5, floatLexem->getValue());
+
+		string text("abc");
+		token.kind = LK_IDENTIFIER;
+		token.text = TextSpan(text.data(), text.size());
+		lexem = toLexem(token);
+		CAssert::assertNotNull(dynamic_cast<IdentifierLexem*>(lexem.get()));
+		CAssert::assertEquals(string("abc"), lexem->toString());
+
+		token.kind = LK_TILDE;
+		lexem = toLexem(token);
+		CAssert::assertNotNull(dynamic_cast<TildeLexem*>(lexem.get()));
+	}
+
+	auto_ptr<TestCase> tokenTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("TokenTestCase"),
+			tk_setup, tk_cleanup));
+		tc->addTest("tk_testStreamTokens", tk_testStreamTokens);
+		tc->addTest("tk_testSameTokens", tk_testSameTokens);
+		tc->addTest("tk_testSameErrors", tk_testSameErrors);
+		tc->addTest("tk_testToLexem", tk_testToLexem);
+		return tc;
+	}
+
+}
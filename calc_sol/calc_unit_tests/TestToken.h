@@ -0,0 +1,12 @@
+#ifndef TEST_TOKEN_H
+#define TEST_TOKEN_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> tokenTestCase();
+
+}
+
+#endif
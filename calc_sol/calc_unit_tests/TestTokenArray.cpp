@@ -0,0 +1,144 @@
+#include "stdafx.h"
+
+#include "TestTokenArray.h"
+
+#include "..\calc_parser\TokenArray.h"
+#include "..\calc_parser\BufferLexer.h"
+#include "CAssert.h"
+#include "CUnit.h"
+#include <string>
+#include <sstream>
+
+using namespace std;
+using namespace cunit;
+using namespace parser;
+
+namespace parser_tests {
+
+	TokenArray* ta_tokens = NULL;
+
+	void ta_setup() {
+		ta_tokens = new TokenArray();
+	}
+
+	void ta_cleanup() {
+		delete ta_tokens;
+		ta_tokens = NULL;
+	}
+
+	/* the array has the same tokens and positions as BufferLexer */
+	void ta_assertSameAsBufferLexer(string text) {
+		ta_tokens->tokenize(text.data(), text.size());
+		BufferLexer lexer(text.data(), text.size());
+		size_t i = 0;
+		LexemKind kind;
+		do {
+			kind = lexer.next();
+			CAssert::assertTrue(i < ta_tokens->size());
+			CAssert::assertTrue(kind == ta_tokens->getKind(i));
+			CAssert::assertEquals((int)lexer.getToken().offset, (int)ta_tokens->getStart(i));
+			CAssert::assertEquals(lexer.getText().str(), ta_tokens->getText(i).str());
+			if (kind == LK_FLOAT) {
+				CAssert::assertEquals(lexer.getValue(), ta_tokens->getValue(i));
+			}
+			CAssert::assertEquals(lexer.getLineNo(), ta_tokens->getLineNo(i));
+			CAssert::assertEquals(lexer.getCharNo(), ta_tokens->getCharNo(i));
+			i++;
+		} while (kind != LK_EOF);
+		CAssert::assertEquals((int)i, (int)ta_tokens->size());
+	}
+
+	void ta_testEmpty() {
+		ta_tokens->tokenize("", 0);
+		CAssert::assertEquals(1, (int)ta_tokens->size());
+		CAssert::assertTrue(ta_tokens->getKind(0) == LK_EOF);
+		CAssert::assertEquals(1, ta_tokens->getLineNo(0));
+		CAssert::assertEquals(0, ta_tokens->getCharNo(0));
+	}
+
+	void ta_testTokens() {
+		string text(" sin(x1) *2.5");
+		ta_tokens->tokenize(text.data(), text.size());
+		CAssert::assertEquals(7, (int)ta_tokens->size());
+		CAssert::assertTrue(ta_tokens->getKind(0) == LK_IDENTIFIER);
+		CAssert::assertTrue(ta_tokens->getText(0).equals("sin"));
+		CAssert::assertEquals(1, (int)ta_tokens->getStart(0));
+		CAssert::assertEquals(4, (int)ta_tokens->getEnd(0));
+		CAssert::assertTrue(ta_tokens->getKind(1) == LK_OPAREN);
+		CAssert::assertTrue(ta_tokens->getKind(2) == LK_IDENTIFIER);
+		CAssert::assertTrue(ta_tokens->getText(2).begin == text.data() + 5);
+		CAssert::assertTrue(ta_tokens->getKind(3) == LK_CPAREN);
+		CAssert::assertTrue(ta_tokens->getKind(4) == LK_MUL);
+		CAssert::assertTrue(ta_tokens->getKind(5) == LK_FLOAT);
+		CAssert::assertEquals(2.5, ta_tokens->getValue(5));
+		CAssert::assertEquals(10, (int)ta_tokens->getStart(5));
+		CAssert::assertEquals(13, (int)ta_tokens->getEnd(5));
+		CAssert::assertTrue(ta_tokens->getKind(6) == LK_EOF);
+		CAssert::assertEquals(13, (int)ta_tokens->getStart(6));
+		//identifiers are interned
+		CAssert::assertEquals((int)SYMBOL_SIN, ta_tokens->getSymbol(0));
+		CAssert::assertEquals(internSymbol(string("x1")), ta_tokens->getSymbol(2));
+		CAssert::assertEquals(NO_SYMBOL, ta_tokens->getSymbol(5));
+		CAssert::assertEquals(NO_SYMBOL, ta_tokens->getSymbol(6));
+	}
+
+	void ta_testSameAsBufferLexer() {
+		ta_assertSameAsBufferLexer("1+2");
+		ta_assertSameAsBufferLexer("((1))\n");
+		ta_assertSameAsBufferLexer(" sin(x) * 2.5 ^ -y / (3-4) ~ ");
+		ta_assertSameAsBufferLexer("a1b2_c3+_\n\t1.25\r\n2");
+		ta_assertSameAsBufferLexer("1 2\n3 4\n\n");
+	}
+
+	void ta_testStream() {
+		stringstream in("x 2.5\n*");
+		ta_tokens->tokenize(in);
+		CAssert::assertTrue(in.eof());
+		CAssert::assertEquals(4, (int)ta_tokens->size());
+		CAssert::assertTrue(ta_tokens->getKind(0) == LK_IDENTIFIER);
+		CAssert::assertEquals(string("x"), ta_tokens->getText(0).str());
+		CAssert::assertEquals(2.5, ta_tokens->getValue(1));
+		CAssert::assertTrue(ta_tokens->getKind(2) == LK_MUL);
+		CAssert::assertEquals(2, ta_tokens->getLineNo(2));
+		CAssert::assertEquals(1, ta_tokens->getCharNo(2));
+	}
+
+	void ta_testReuse() {
+		ta_tokens->tokenize("1 + 2 + 3", 9);
+		CAssert::assertEquals(6, (int)ta_tokens->size());
+		ta_tokens->tokenize("x", 1);
+		CAssert::assertEquals(2, (int)ta_tokens->size());
+		CAssert::assertTrue(ta_tokens->getKind(0) == LK_IDENTIFIER);
+		CAssert::assertTrue(ta_tokens->getKind(1) == LK_EOF);
+	}
+
+	void ta_testUnknownToken() {
+		string message;
+		try {
+			ta_tokens->tokenize("1 +\n $", 6);
+		} catch (UnknownTokenException& e) {
+			message = e.what();
+		}
+		BufferLexer lexer("1 +\n $", 6);
+		try {
+			while (lexer.next() != LK_EOF) {
+			}
+		} catch (UnknownTokenException& e) {
+			CAssert::assertEquals(string(e.what()), message);
+		}
+		CAssert::assertFalse(message.empty());
+	}
+
+	auto_ptr<TestCase> tokenArrayTestCase() {
+		auto_ptr<TestCase> tc = auto_ptr<TestCase>(new TestCase(string("TokenArrayTestCase"),
+			ta_setup, ta_cleanup));
+		tc->addTest("ta_testEmpty", ta_testEmpty);
+		tc->addTest("ta_testTokens", ta_testTokens);
+		tc->addTest("ta_testSameAsBufferLexer", ta_testSameAsBufferLexer);
+		tc->addTest("ta_testStream", ta_testStream);
+		tc->addTest("ta_testReuse", ta_testReuse);
+		tc->addTest("ta_testUnknownToken", ta_testUnknownToken);
+		return tc;
+	}
+
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_TOKEN_ARRAY_H
+#define TEST_TOKEN_ARRAY_H
+#include "CUnit.h"
+#include <memory>
+
+namespace parser_tests {
+
+	std::auto_ptr<cunit::TestCase> tokenArrayTestCase();
+
+}
+
+#endif
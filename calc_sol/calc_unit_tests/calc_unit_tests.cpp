@@ -1,33 +1,96 @@
-// calc_unit_tests.cpp : Defines the entry point for the console application.
-//
-
-#include "stdafx.h"
-#include "..\calc_parser\Lexer.h"
-#include "CAssert.h"
-#include "TestLexer.h"
-#include "TestParser.h"
-#include "TestCalculator.h"
-
-using namespace cunit;
-using namespace std;
-
-int _tmain(int argc, _TCHAR* argv[])
-{
-
-	auto_ptr<TestCase> lexerTestCase = parser_tests::lexerTestCase();
-	auto_ptr<TestCase> parserTestCase = parser_tests::parserTestCase();
-	auto_ptr<TestCase> calculatorTestCase = parser_tests::calculatorTestCase();
-	vector<TestCase> testCases = vector<TestCase>();
-
-	testCases.push_back( *(lexerTestCase.get()) );
-	testCases.push_back( *(parserTestCase.get()) );
-	testCases.push_back( *(calculatorTestCase.get()) );
-
-	StdoutTestRunner testRunner = StdoutTestRunner(testCases);
-	testRunner.run();
-
-	//read one character from input
-	cin.get();
-	return 0;
-}
-
+// calc_unit_tests.cpp : Defines the entry point for the console application.
+//
+
+#include "stdafx.h"
+#include "..\calc_parser\Lexer.h"
+#include "CAssert.h"
+#include "TestLexer.h"
+#include "TestDfaLexer.h"
+#include "TestBufferLexer.h"
+#include "TestCharScan.h"
+#include "TestFloatConv.h"
+#include "TestSymbolTable.h"
+#include "TestToken.h"
+#include "TestTokenArray.h"
+#include "TestParser.h"
+#include "TestArena.h"
+#include "TestFlatAst.h"
+#include "TestPrecedenceParser.h"
+#include "TestSharedAst.h"
+#include "TestPushLexer.h"
+#include "TestPushParser.h"
+#include "TestParallelParser.h"
+#include "TestIncrementalParser.h"
+#include "TestCalculator.h"
+#include "TestCalculatorCache.h"
+#include "TestStatus.h"
+#include "TestBatchCompiler.h"
+#include "TestFunctionDefinition.h"
+#include "TestExpressionLibrary.h"
+#include "TestBytecode.h"
+
+using namespace cunit;
+using namespace std;
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+
+	auto_ptr<TestCase> lexerTestCase = parser_tests::lexerTestCase();
+	auto_ptr<TestCase> dfaLexerTestCase = parser_tests::dfaLexerTestCase();
+	auto_ptr<TestCase> bufferLexerTestCase = parser_tests::bufferLexerTestCase();
+	auto_ptr<TestCase> charScanTestCase = parser_tests::charScanTestCase();
+	auto_ptr<TestCase> floatConvTestCase = parser_tests::floatConvTestCase();
+	auto_ptr<TestCase> symbolTableTestCase = parser_tests::symbolTableTestCase();
+	auto_ptr<TestCase> tokenTestCase = parser_tests::tokenTestCase();
+	auto_ptr<TestCase> tokenArrayTestCase = parser_tests::tokenArrayTestCase();
+	auto_ptr<TestCase> parserTestCase = parser_tests::parserTestCase();
+	auto_ptr<TestCase> arenaTestCase = parser_tests::arenaTestCase();
+	auto_ptr<TestCase> flatAstTestCase = parser_tests::flatAstTestCase();
+	auto_ptr<TestCase> precedenceParserTestCase = parser_tests::precedenceParserTestCase();
+	auto_ptr<TestCase> sharedAstTestCase = parser_tests::sharedAstTestCase();
+	auto_ptr<TestCase> pushLexerTestCase = parser_tests::pushLexerTestCase();
+	auto_ptr<TestCase> pushParserTestCase = parser_tests::pushParserTestCase();
+	auto_ptr<TestCase> parallelParserTestCase = parser_tests::parallelParserTestCase();
+	auto_ptr<TestCase> incrementalParserTestCase = parser_tests::incrementalParserTestCase();
+	auto_ptr<TestCase> calculatorTestCase = parser_tests::calculatorTestCase();
+	auto_ptr<TestCase> calculatorCacheTestCase = parser_tests::calculatorCacheTestCase();
+	auto_ptr<TestCase> statusTestCase = parser_tests::statusTestCase();
+	auto_ptr<TestCase> batchCompilerTestCase = parser_tests::batchCompilerTestCase();
+	auto_ptr<TestCase> functionDefinitionTestCase = parser_tests::functionDefinitionTestCase();
+	auto_ptr<TestCase> expressionLibraryTestCase = parser_tests::expressionLibraryTestCase();
+	auto_ptr<TestCase> bytecodeTestCase = parser_tests::bytecodeTestCase();
+	vector<TestCase> testCases = vector<TestCase>();
+
+	testCases.push_back( *(lexerTestCase.get()) );
+	testCases.push_back( *(dfaLexerTestCase.get()) );
+	testCases.push_back( *(bufferLexerTestCase.get()) );
+	testCases.push_back( *(charScanTestCase.get()) );
+	testCases.push_back( *(floatConvTestCase.get()) );
+	testCases.push_back( *(symbolTableTestCase.get()) );
+	testCases.push_back( *(tokenTestCase.get()) );
+	testCases.push_back( *(tokenArrayTestCase.get()) );
+	testCases.push_back( *(parserTestCase.get()) );
+	testCases.push_back( *(arenaTestCase.get()) );
+	testCases.push_back( *(flatAstTestCase.get()) );
+	testCases.push_back( *(precedenceParserTestCase.get()) );
+	testCases.push_back( *(sharedAstTestCase.get()) );
+	testCases.push_back( *(pushLexerTestCase.get()) );
+	testCases.push_back( *(pushParserTestCase.get()) );
+	testCases.push_back( *(parallelParserTestCase.get()) );
+	testCases.push_back( *(incrementalParserTestCase.get()) );
+	testCases.push_back( *(calculatorTestCase.get()) );
+	testCases.push_back( *(calculatorCacheTestCase.get()) );
+	testCases.push_back( *(statusTestCase.get()) );
+	testCases.push_back( *(batchCompilerTestCase.get()) );
+	testCases.push_back( *(functionDefinitionTestCase.get()) );
+	testCases.push_back( *(expressionLibraryTestCase.get()) );
+	testCases.push_back( *(bytecodeTestCase.get()) );
+
+	StdoutTestRunner testRunner = StdoutTestRunner(testCases);
+	testRunner.run();
+
+	//read one character from input
+	cin.get();
+	return 0;
+}
+